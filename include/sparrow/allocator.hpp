@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <memory_resource>
@@ -198,6 +199,63 @@ namespace sparrow
         storage_type m_storage;
     };
 
+    /*
+     * Allocator of a buffer wrapping a memory block that was allocated elsewhere,
+     * for instance the storage of a std::vector. The allocator holds the owner of that
+     * block, and destroys it when the block is deallocated, or when the last copy of
+     * the allocator is destroyed if the block never is; the block is not copied. The
+     * other memory blocks are allocated with std::allocator, so that the buffer can
+     * still grow.
+     *
+     * @tparam T value_type of the allocator
+     */
+    template <class T>
+    class adopting_allocator
+    {
+    public:
+
+        using value_type = T;
+
+        /*
+         * @param block The memory block owned by \p owner.
+         * @param owner The object that releases \p block when it is destroyed; it is
+         *        moved to the heap, which keeps \p block where it is for std::vector,
+         *        std::unique_ptr and buffer.
+         */
+        template <class Owner>
+        adopting_allocator(const T* block, Owner&& owner);
+
+        [[nodiscard]] T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n);
+
+        bool operator==(const adopting_allocator& rhs) const;
+
+    private:
+
+        using owner_ptr = std::unique_ptr<void, void (*)(void*)>;
+
+        // Shared by the copies of the allocator, so that the one deallocating the block
+        // releases its owner for all of them. p_block is reset with the owner, so that a
+        // block later allocated at the same address goes back to std::allocator. Copies
+        // may be destroyed on different threads: the one resetting p_block takes the owner.
+        struct adopted_block
+        {
+            adopted_block(const T* block, owner_ptr owner)
+                : p_block(block)
+                , p_owner(std::move(owner))
+            {
+            }
+
+            std::atomic<const T*> p_block;
+            owner_ptr p_owner;
+        };
+
+        template <class Owner>
+        static void delete_owner(void* owner);
+
+        std::shared_ptr<adopted_block> p_adopted;
+    };
+
     /********************************
      * any_allocator implementation *
      ********************************/
@@ -303,4 +361,51 @@ namespace sparrow
     {
         return lhs.equal(rhs);
     }
+
+    /*************************************
+     * adopting_allocator implementation *
+     *************************************/
+
+    template <class T>
+    template <class Owner>
+    adopting_allocator<T>::adopting_allocator(const T* block, Owner&& owner)
+    {
+        using owner_type = std::decay_t<Owner>;
+        owner_ptr ptr(new owner_type(std::forward<Owner>(owner)), &delete_owner<owner_type>);
+        p_adopted = std::make_shared<adopted_block>(block, std::move(ptr));
+    }
+
+    template <class T>
+    [[nodiscard]] T* adopting_allocator<T>::allocate(std::size_t n)
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    template <class T>
+    void adopting_allocator<T>::deallocate(T* p, std::size_t n)
+    {
+        const T* block = p;
+        if (p != nullptr
+            && p_adopted->p_block.compare_exchange_strong(block, nullptr, std::memory_order_acq_rel))
+        {
+            p_adopted->p_owner.reset();
+        }
+        else
+        {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    template <class T>
+    bool adopting_allocator<T>::operator==(const adopting_allocator& rhs) const
+    {
+        return p_adopted == rhs.p_adopted;
+    }
+
+    template <class T>
+    template <class Owner>
+    void adopting_allocator<T>::delete_owner(void* owner)
+    {
+        delete static_cast<Owner*>(owner);
+    }
 }
@@ -0,0 +1,406 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sparrow/allocator.hpp"
+#include "sparrow/array_data.hpp"
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/chunked_array.hpp"
+#include "sparrow/contracts.hpp"
+
+namespace sparrow
+{
+    /**
+     * Default number of rows of a chunk of an appendable_column.
+     */
+    inline constexpr std::size_t default_chunk_capacity = 65536;
+
+    /**
+     * Append-only column written by one thread and read concurrently by any number of
+     * threads, without locks.
+     *
+     * The values are stored in chunks of a fixed capacity, that are never moved nor
+     * reallocated: the writer fills the last chunk, then starts a new one. Each append
+     * publishes the new size with release semantics, so that a reader loading the size
+     * sees every value before it. A snapshot is a chunked_array whose chunks share the
+     * memory of the chunks of the column; the values of a snapshot are never copied, and
+     * its chunks remain valid after the column is destroyed. Only the validity bitmap of
+     * the chunk being filled is copied, since the writer keeps setting its bits.
+     *
+     * The pointers to the chunks are stored in a directory that the writer replaces by a
+     * larger copy when it is full. Readers announce the epoch in which they read the
+     * directory, and the replaced directories are freed once no reader can still read
+     * them. The writer never waits for the readers: a reader that lags behind only
+     * delays the release of the directories.
+     *
+     * push_back, push_back_null and append must be called from a single thread at a time;
+     * size and snapshot can be called from any thread.
+     *
+     * @tparam T The type of the values.
+     */
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    class appendable_column
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using snapshot_type = chunked_array<T>;
+
+        /**
+         * @param chunk_capacity The number of rows of a chunk, rounded up to a multiple of 64
+         *                       so that the chunks do not share bytes of validity bitmap.
+         */
+        explicit appendable_column(size_type chunk_capacity = default_chunk_capacity);
+        ~appendable_column() = default;
+
+        appendable_column(const appendable_column&) = delete;
+        appendable_column& operator=(const appendable_column&) = delete;
+        appendable_column(appendable_column&&) = delete;
+        appendable_column& operator=(appendable_column&&) = delete;
+
+        /**
+         * @return The number of values published so far.
+         */
+        size_type size() const noexcept;
+
+        size_type chunk_capacity() const noexcept;
+
+        void push_back(const T& value);
+        void push_back_null();
+
+        /**
+         * Appends \p values, and publishes them all at once.
+         */
+        void append(std::span<const T> values);
+
+        /**
+         * @return The values published when the call starts, in chunks of at most
+         *         chunk_capacity() rows sharing the memory of the column.
+         */
+        snapshot_type snapshot() const;
+
+    private:
+
+        struct chunk : std::enable_shared_from_this<chunk>
+        {
+            explicit chunk(size_type capacity)
+                : values(new T[capacity])
+                , validity(new std::atomic<std::uint8_t>[capacity / 8u]())
+            {
+            }
+
+            // Full chunks are not written anymore, and share their validity as plain bytes
+            std::uint8_t* validity_bytes() const noexcept
+            {
+                static_assert(sizeof(std::atomic<std::uint8_t>) == sizeof(std::uint8_t));
+                static_assert(std::atomic<std::uint8_t>::is_always_lock_free);
+                return reinterpret_cast<std::uint8_t*>(validity.get());
+            }
+
+            std::unique_ptr<T[]> values;
+            // Readers copying the bitmap of the last chunk load its bytes concurrently
+            std::unique_ptr<std::atomic<std::uint8_t>[]> validity;
+            // Read by the snapshots once the chunk is full only
+            size_type null_count = 0;
+        };
+
+        using directory = std::vector<chunk*>;
+
+        struct retired_directory
+        {
+            std::uint64_t epoch;
+            std::unique_ptr<directory> p_directory;
+        };
+
+        // Registers a reader in the current epoch for its lifetime
+        class reader_guard
+        {
+        public:
+
+            explicit reader_guard(const appendable_column& column);
+            ~reader_guard();
+
+            reader_guard(const reader_guard&) = delete;
+            reader_guard& operator=(const reader_guard&) = delete;
+
+        private:
+
+            const appendable_column& m_column;
+            std::uint64_t m_slot;
+        };
+
+        // Writes the value i of the current chunk, without publishing it
+        void write(size_type i, const T& value, bool valid);
+        chunk& writable_chunk(size_type i);
+        void add_chunk();
+        void reclaim();
+
+        array_data make_snapshot_chunk(const std::shared_ptr<chunk>& c, size_type size) const;
+
+        size_type m_chunk_capacity;
+
+        // Written by the writer only
+        std::vector<std::shared_ptr<chunk>> m_chunks;
+        std::unique_ptr<directory> p_current_directory;
+        std::vector<retired_directory> m_retired;
+
+        alignas(64) std::atomic<size_type> m_size = 0;
+        std::atomic<const directory*> p_directory = nullptr;
+        alignas(64) mutable std::atomic<std::uint64_t> m_epoch = 0;
+        // Number of readers registered in the even and odd epochs
+        alignas(64) mutable std::array<std::atomic<std::size_t>, 2> m_readers = {};
+    };
+
+    /************************************
+     * appendable_column implementation *
+     ************************************/
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    appendable_column<T>::appendable_column(size_type chunk_capacity)
+        : m_chunk_capacity(std::max(bitmap_word_count(chunk_capacity), size_type(1)) * bitmap_word_bits)
+        , p_current_directory(std::make_unique<directory>(size_type(8), nullptr))
+    {
+        p_directory.store(p_current_directory.get(), std::memory_order_release);
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    auto appendable_column<T>::size() const noexcept -> size_type
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    auto appendable_column<T>::chunk_capacity() const noexcept -> size_type
+    {
+        return m_chunk_capacity;
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::push_back(const T& value)
+    {
+        const size_type n = m_size.load(std::memory_order_relaxed);
+        write(n, value, true);
+        m_size.store(n + 1u, std::memory_order_release);
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::push_back_null()
+    {
+        const size_type n = m_size.load(std::memory_order_relaxed);
+        write(n, T(), false);
+        m_size.store(n + 1u, std::memory_order_release);
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::append(std::span<const T> values)
+    {
+        const size_type n = m_size.load(std::memory_order_relaxed);
+        for (size_type i = 0; i < values.size(); ++i)
+        {
+            write(n + i, values[i], true);
+        }
+        m_size.store(n + values.size(), std::memory_order_release);
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    auto appendable_column<T>::snapshot() const -> snapshot_type
+    {
+        std::vector<std::pair<std::shared_ptr<chunk>, size_type>> chunks;
+        {
+            const reader_guard guard(*this);
+            // The size is loaded first: the directory published before it holds its chunks
+            const size_type size = m_size.load(std::memory_order_acquire);
+            const directory& dir = *p_directory.load(std::memory_order_acquire);
+            const size_type chunk_count = (size + m_chunk_capacity - 1u) / m_chunk_capacity;
+            chunks.reserve(chunk_count);
+            for (size_type k = 0; k < chunk_count; ++k)
+            {
+                chunks.emplace_back(
+                    dir[k]->shared_from_this(),
+                    std::min(m_chunk_capacity, size - k * m_chunk_capacity)
+                );
+            }
+        }
+
+        std::vector<typename snapshot_type::chunk_type> arrays;
+        arrays.reserve(chunks.size());
+        for (const auto& [c, chunk_size] : chunks)
+        {
+            arrays.emplace_back(make_snapshot_chunk(c, chunk_size));
+        }
+        return snapshot_type(std::move(arrays));
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::write(size_type i, const T& value, bool valid)
+    {
+        chunk& c = writable_chunk(i);
+        const size_type row = i % m_chunk_capacity;
+        c.values[row] = value;
+        std::atomic<std::uint8_t>& block = c.validity[row / 8u];
+        const std::uint8_t mask = static_cast<std::uint8_t>(1u << (row % 8u));
+        // Only the writer stores the bytes
+        const std::uint8_t current = block.load(std::memory_order_relaxed);
+        block.store(
+            static_cast<std::uint8_t>(valid ? current | mask : current & ~mask),
+            std::memory_order_relaxed
+        );
+        if (!valid)
+        {
+            ++c.null_count;
+        }
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    auto appendable_column<T>::writable_chunk(size_type i) -> chunk&
+    {
+        if (i == m_chunks.size() * m_chunk_capacity)
+        {
+            add_chunk();
+        }
+        return *m_chunks.back();
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::add_chunk()
+    {
+        const size_type k = m_chunks.size();
+        m_chunks.push_back(std::make_shared<chunk>(m_chunk_capacity));
+        if (k == p_current_directory->size())
+        {
+            auto grown = std::make_unique<directory>(2u * k, nullptr);
+            std::copy(p_current_directory->begin(), p_current_directory->end(), grown->begin());
+            (*grown)[k] = m_chunks.back().get();
+            p_directory.store(grown.get(), std::memory_order_release);
+            m_retired.push_back({m_epoch.load(), std::move(p_current_directory)});
+            p_current_directory = std::move(grown);
+            reclaim();
+        }
+        else
+        {
+            // Readers do not read the slots past the published size
+            (*p_current_directory)[k] = m_chunks.back().get();
+        }
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    void appendable_column<T>::reclaim()
+    {
+        // The epoch can move from e to e + 1 once the readers of e - 1 are gone, so the
+        // directories retired in e are not readable anymore from e + 2
+        const std::uint64_t epoch = m_epoch.load();
+        if (m_readers[(epoch + 1u) % 2u].load() == 0u)
+        {
+            m_epoch.store(epoch + 1u);
+        }
+        const std::uint64_t current = m_epoch.load();
+        std::erase_if(
+            m_retired,
+            [current](const retired_directory& retired)
+            {
+                return retired.epoch + 2u <= current;
+            }
+        );
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    array_data appendable_column<T>::make_snapshot_chunk(const std::shared_ptr<chunk>& c, size_type size) const
+    {
+        using byte_type = array_data::buffer_type::value_type;
+        array_data::bitmap_type bitmap;
+        if (size == m_chunk_capacity)
+        {
+            bitmap = array_data::bitmap_type(
+                c->validity_bytes(),
+                size,
+                c->null_count,
+                adopting_allocator<byte_type>(c->validity_bytes(), c)
+            );
+        }
+        else
+        {
+            const size_type block_count = (size + 7u) / 8u;
+            auto* blocks = std::allocator<byte_type>().allocate(block_count);
+            for (size_type i = 0; i < block_count; ++i)
+            {
+                blocks[i] = c->validity[i].load(std::memory_order_relaxed);
+            }
+            // The bits past the size may have been set by the writer since
+            if (size % 8u != 0u)
+            {
+                blocks[block_count - 1u] &= static_cast<byte_type>((1u << (size % 8u)) - 1u);
+            }
+            bitmap = array_data::bitmap_type(blocks, size);
+        }
+        return impl::make_adopted_array_data<T>(
+            impl::adopt_values(c, c->values.get(), size),
+            size,
+            std::move(bitmap),
+            0
+        );
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    appendable_column<T>::reader_guard::reader_guard(const appendable_column& column)
+        : m_column(column)
+    {
+        while (true)
+        {
+            const std::uint64_t epoch = m_column.m_epoch.load();
+            m_slot = epoch % 2u;
+            m_column.m_readers[m_slot].fetch_add(1u);
+            // Otherwise the writer may have checked the readers of this slot already
+            if (m_column.m_epoch.load() == epoch)
+            {
+                return;
+            }
+            m_column.m_readers[m_slot].fetch_sub(1u);
+        }
+    }
+
+    template <fixed_size_value T>
+        requires std::is_trivially_copyable_v<T>
+    appendable_column<T>::reader_guard::~reader_guard()
+    {
+        m_column.m_readers[m_slot].fetch_sub(1u, std::memory_order_release);
+    }
+}
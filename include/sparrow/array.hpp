@@ -15,7 +15,14 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
 #include <variant>
 
 #include "sparrow/data_type.hpp"
@@ -41,6 +48,86 @@ namespace sparrow
         using inner_const_iterator = mpl::transform<array_const_iterator_t, array_variant>;
     };
 
+    namespace impl
+    {
+        /*
+         * Operations of array_iterator on the typed iterator it wraps, resolved once
+         * when the typed iterator is selected rather than at each step.
+         */
+        template <bool is_const>
+        struct array_iterator_ops
+        {
+            using inner_iterator = std::
+                conditional_t<is_const, array_traits::inner_const_iterator, array_traits::inner_iterator>;
+            using reference = std::
+                conditional_t<is_const, array_traits::const_reference, array_traits::reference>;
+
+            const char* (*type_name)();
+            reference (*dereference)(const inner_iterator&);
+            void (*increment)(inner_iterator&);
+            void (*decrement)(inner_iterator&);
+            void (*advance)(inner_iterator&, std::ptrdiff_t);
+            std::ptrdiff_t (*distance_to)(const inner_iterator&, const inner_iterator&);
+            bool (*equal)(const inner_iterator&, const inner_iterator&);
+            bool (*less_than)(const inner_iterator&, const inner_iterator&);
+        };
+
+        template <class It, class V>
+        It& as_inner_iterator(V& iter)
+        {
+            return std::get<It>(iter);
+        }
+
+        template <class It, class V>
+        const It& as_inner_iterator(const V& iter)
+        {
+            return std::get<It>(iter);
+        }
+
+        template <bool is_const, class It>
+        inline constexpr array_iterator_ops<is_const> array_iterator_ops_v = {
+            []()
+            {
+                return typeid(It).name();
+            },
+            [](const auto& iter)
+            {
+                return typename array_iterator_ops<is_const>::reference(*as_inner_iterator<It>(iter));
+            },
+            [](auto& iter)
+            {
+                ++as_inner_iterator<It>(iter);
+            },
+            [](auto& iter)
+            {
+                --as_inner_iterator<It>(iter);
+            },
+            [](auto& iter, std::ptrdiff_t n)
+            {
+                as_inner_iterator<It>(iter) += n;
+            },
+            [](const auto& lhs, const auto& rhs) -> std::ptrdiff_t
+            {
+                return as_inner_iterator<It>(rhs) - as_inner_iterator<It>(lhs);
+            },
+            [](const auto& lhs, const auto& rhs)
+            {
+                return as_inner_iterator<It>(lhs) == as_inner_iterator<It>(rhs);
+            },
+            [](const auto& lhs, const auto& rhs)
+            {
+                return as_inner_iterator<It>(lhs) < as_inner_iterator<It>(rhs);
+            }
+        };
+    }
+
+    /**
+     * Iterator over the elements of a type-erased array.
+     *
+     * The typed iterator is selected when the array_iterator is constructed, together
+     * with the table of its operations, so that stepping through the elements does not
+     * dispatch on their type.
+     */
     template <bool is_const>
     class array_iterator
         : public iterator_base<
@@ -66,6 +153,7 @@ namespace sparrow
             requires(!std::same_as<std::decay_t<It>, array_iterator<is_const>>)
         array_iterator(It&& iter)
             : m_iter(std::forward<It>(iter))
+            , p_ops(&impl::array_iterator_ops_v<is_const, std::decay_t<It>>)
         {
         }
 
@@ -82,17 +170,111 @@ namespace sparrow
         bool equal(const self_type& rhs) const;
         bool less_than(const self_type& rhs) const;
 
-        using iterator_storage = std::conditional_t<
-            is_const,
-            mpl::transform<array_iterator_t, array_traits::array_variant>,
-            mpl::transform<array_const_iterator_t, array_traits::array_variant>>;
-
-        using inner_iterator = std::conditional_t<is_const, array_traits::inner_const_iterator, array_traits::inner_iterator>;
+        using inner_iterator = typename impl::array_iterator_ops<is_const>::inner_iterator;
         inner_iterator m_iter;
+        const impl::array_iterator_ops<is_const>* p_ops = nullptr;
 
         friend class iterator_access;
     };
 
+    namespace impl
+    {
+        /*
+         * Operations of array whose implementation depends on the type of the elements,
+         * resolved once per element type.
+         */
+        struct array_dispatch_table
+        {
+            std::size_t (*size)(const void*);
+            array_traits::const_reference (*element)(const void*, std::size_t);
+            array_iterator<true> (*cbegin)(const void*);
+            array_iterator<true> (*cend)(const void*);
+        };
+
+        template <class T>
+        const typed_array<T>& as_typed_array(const void* p)
+        {
+            return *static_cast<const typed_array<T>*>(p);
+        }
+
+        template <class T>
+        inline constexpr array_dispatch_table array_dispatch_table_v = {
+            [](const void* p)
+            {
+                return as_typed_array<T>(p).size();
+            },
+            [](const void* p, std::size_t i)
+            {
+                return array_traits::const_reference(as_typed_array<T>(p)[i]);
+            },
+            [](const void* p)
+            {
+                return array_iterator<true>(as_typed_array<T>(p).cbegin());
+            },
+            [](const void* p)
+            {
+                return array_iterator<true>(as_typed_array<T>(p).cend());
+            }
+        };
+
+        /*
+         * Calls f.template operator()<T>() with the type T of the elements of the arrays
+         * of data type id.
+         */
+        template <class F>
+        decltype(auto) visit_array_type(data_type id, F&& f)
+        {
+            switch (id)
+            {
+                case data_type::NA:
+                    return f.template operator()<null_type>();
+                case data_type::BOOL:
+                    return f.template operator()<bool>();
+                case data_type::UINT8:
+                    return f.template operator()<std::uint8_t>();
+                case data_type::INT8:
+                    return f.template operator()<std::int8_t>();
+                case data_type::UINT16:
+                    return f.template operator()<std::uint16_t>();
+                case data_type::INT16:
+                    return f.template operator()<std::int16_t>();
+                case data_type::UINT32:
+                    return f.template operator()<std::uint32_t>();
+                case data_type::INT32:
+                    return f.template operator()<std::int32_t>();
+                case data_type::UINT64:
+                    return f.template operator()<std::uint64_t>();
+                case data_type::INT64:
+                    return f.template operator()<std::int64_t>();
+                case data_type::HALF_FLOAT:
+                    return f.template operator()<float16_t>();
+                case data_type::FLOAT:
+                    return f.template operator()<float32_t>();
+                case data_type::DOUBLE:
+                    return f.template operator()<float64_t>();
+                case data_type::STRING:
+                case data_type::FIXED_SIZE_BINARY:
+                    return f.template operator()<std::string>();
+                case data_type::TIMESTAMP:
+                    return f.template operator()<sparrow::timestamp>();
+                default:
+                    // TODO: implement other data types, remove the default use case
+                    // and throw from outside of the switch
+                    throw std::invalid_argument("not supported yet");
+            }
+        }
+    }
+
+    /**
+     * Type-erased array.
+     *
+     * The array is a handle on an array_data shared with its copies, so that copying it
+     * costs a reference count increment; the typed_array viewing that array_data is
+     * built once, in the same allocation. The operations that depend on the type of
+     * the elements go through a table of functions resolved at construction, and visit
+     * dispatches on the data type with a single switch. The non-const accessors copy
+     * the shared array_data first if another array refers to it.
+     */
     class array
     {
     public:
@@ -120,14 +302,99 @@ namespace sparrow
         const_iterator cbegin() const;
         const_iterator cend() const;
 
+        const array_data& get_data() const;
+
+        /**
+         * Calls \p f with the typed_array holding the elements.
+         *
+         * The data type is dispatched once, so that \p f can loop over the elements
+         * without the per-element dispatch of operator[] and of the iterators.
+         *
+         * @param f Callable accepting any typed_array.
+         * @return The result of \p f.
+         */
+        template <class F>
+        decltype(auto) visit(F&& f) const;
+
+        /**
+         * Calls \p f with the mutable typed_array holding the elements, after copying
+         * them if they are shared with another array.
+         *
+         * @param f Callable accepting any typed_array.
+         * @return The result of \p f.
+         */
+        template <class F>
+        decltype(auto) visit(F&& f);
+
+        /**
+         * @return The typed_array holding the elements.
+         * @throws std::invalid_argument if the elements are not of type T.
+         */
+        template <class T>
+        const typed_array<T>& get() const;
+
+        /**
+         * @return The mutable typed_array holding the elements, copied first if they
+         *         are shared with another array.
+         * @throws std::invalid_argument if the elements are not of type T.
+         */
+        template <class T>
+        typed_array<T>& get();
+
     private:
 
-        using array_variant = array_traits::array_variant;
-        array_variant build_array(array_data&& data) const;
+        template <class T>
+        void reset(typed_array<T> typed);
+
+        template <class T>
+        typed_array<T>& unshare();
 
-        array_variant m_array;
+        template <class T>
+        void check_type(std::string_view method) const;
+
+        std::string get_type_name() const;
+
+        std::shared_ptr<const array_data> p_data;
+        const void* p_array = nullptr;
+        const impl::array_dispatch_table* p_dispatch = nullptr;
     };
 
+    /**
+     * Calls \p f with each element of \p ar, as a const_reference of the typed_array
+     * holding the elements. The data type is dispatched once for the whole array.
+     *
+     * @param f Callable accepting the const_reference of any typed_array.
+     */
+    template <class F>
+    void for_each(const array& ar, F&& f);
+
+    /**
+     * @return The number of elements of \p ar satisfying \p pred. The data type is
+     *         dispatched once for the whole array.
+     */
+    template <class P>
+    std::size_t count_if(const array& ar, P&& pred);
+
+    /**
+     * @return The index of the first element of \p ar satisfying \p pred, or the size
+     *         of \p ar if there is none. The data type is dispatched once for the whole
+     *         array.
+     */
+    template <class P>
+    std::size_t find_if(const array& ar, P&& pred);
+
+    /**
+     * @return true if any element of \p ar satisfies \p pred.
+     */
+    template <class P>
+    bool any_of(const array& ar, P&& pred);
+
+    /**
+     * @return true if every element of \p ar satisfies \p pred.
+     */
+    template <class P>
+    bool all_of(const array& ar, P&& pred);
+
     /*********************************
      * array_iterator implementation *
      *********************************/
@@ -135,13 +402,7 @@ namespace sparrow
     template <bool IC>
     std::string array_iterator<IC>::get_type_name() const
     {
-        return std::visit(
-            [](auto&& arg)
-            {
-                return typeid(std::decay_t<decltype(arg)>).name();
-            },
-            m_iter
-        );
+        return p_ops == nullptr ? "empty array_iterator" : p_ops->type_name();
     }
 
     template <bool IC>
@@ -156,174 +417,84 @@ namespace sparrow
     template <bool IC>
     auto array_iterator<IC>::dereference() const -> reference
     {
-        return std::visit(
-            [](auto&& arg)
-            {
-                return reference(*arg);
-            },
-            m_iter
-        );
+        SPARROW_ASSERT_TRUE(p_ops != nullptr);
+        return p_ops->dereference(m_iter);
     }
 
     template <bool IC>
     void array_iterator<IC>::increment()
     {
-        std::visit(
-            [](auto&& arg)
-            {
-                ++arg;
-            },
-            m_iter
-        );
+        SPARROW_ASSERT_TRUE(p_ops != nullptr);
+        p_ops->increment(m_iter);
     }
 
     template <bool IC>
     void array_iterator<IC>::decrement()
     {
-        std::visit(
-            [](auto&& arg)
-            {
-                --arg;
-            },
-            m_iter
-        );
+        SPARROW_ASSERT_TRUE(p_ops != nullptr);
+        p_ops->decrement(m_iter);
     }
 
     template <bool IC>
     void array_iterator<IC>::advance(difference_type n)
     {
-        std::visit(
-            [n](auto&& arg)
-            {
-                arg += n;
-            },
-            m_iter
-        );
+        SPARROW_ASSERT_TRUE(p_ops != nullptr);
+        p_ops->advance(m_iter, n);
     }
 
     template <bool IC>
     auto array_iterator<IC>::distance_to(const self_type& rhs) const -> difference_type
     {
-        if (m_iter.index() != rhs.m_iter.index())
+        if (p_ops != rhs.p_ops)
         {
             throw std::invalid_argument(build_mismatch_message("array_iterator::distance_to", rhs));
         }
-
-        return std::visit(
-            [&rhs](auto&& arg)
-            {
-                return std::get<std::decay_t<decltype(arg)>>(rhs.m_iter) - arg;
-            },
-            m_iter
-        );
+        return p_ops == nullptr ? 0 : p_ops->distance_to(m_iter, rhs.m_iter);
     }
 
     template <bool IC>
     bool array_iterator<IC>::equal(const self_type& rhs) const
     {
-        if (m_iter.index() != rhs.m_iter.index())
+        if (p_ops != rhs.p_ops)
         {
             return false;
         }
-
-        return std::visit(
-            [&rhs](auto&& arg)
-            {
-                return arg == std::get<std::decay_t<decltype(arg)>>(rhs.m_iter);
-            },
-            m_iter
-        );
+        return p_ops == nullptr || p_ops->equal(m_iter, rhs.m_iter);
     }
 
     template <bool IC>
     bool array_iterator<IC>::less_than(const self_type& rhs) const
     {
-        if (m_iter.index() != rhs.m_iter.index())
+        if (p_ops != rhs.p_ops)
         {
             throw std::invalid_argument(build_mismatch_message("array_iterator::less_than", rhs));
         }
-
-        return std::visit(
-            [&rhs](auto&& arg)
-            {
-                return arg <= std::get<std::decay_t<decltype(arg)>>(rhs.m_iter);
-            },
-            m_iter
-        );
+        return p_ops != nullptr && p_ops->less_than(m_iter, rhs.m_iter);
     }
 
     /************************
      * array implementation *
      ************************/
 
-    inline auto array::build_array(array_data&& data) const -> array_variant
-    {
-        data_descriptor dd = data.type;
-        switch (dd.id())
-        {
-            case data_type::NA:
-                return typed_array<null_type>(std::move(data));
-            case data_type::BOOL:
-                return typed_array<bool>(std::move(data));
-            case data_type::UINT8:
-                return typed_array<std::uint8_t>(std::move(data));
-            case data_type::INT8:
-                return typed_array<std::int8_t>(std::move(data));
-            case data_type::UINT16:
-                return typed_array<std::uint16_t>(std::move(data));
-            case data_type::INT16:
-                return typed_array<std::int16_t>(std::move(data));
-            case data_type::UINT32:
-                return typed_array<std::uint32_t>(std::move(data));
-            case data_type::INT32:
-                return typed_array<std::int32_t>(std::move(data));
-            case data_type::UINT64:
-                return typed_array<std::uint64_t>(std::move(data));
-            case data_type::INT64:
-                return typed_array<std::int64_t>(std::move(data));
-            case data_type::HALF_FLOAT:
-                return typed_array<float16_t>(std::move(data));
-            case data_type::FLOAT:
-                return typed_array<float32_t>(std::move(data));
-            case data_type::DOUBLE:
-                return typed_array<float64_t>(std::move(data));
-            case data_type::STRING:
-            case data_type::FIXED_SIZE_BINARY:
-                return typed_array<std::string>(std::move(data));
-            case data_type::TIMESTAMP:
-                return typed_array<sparrow::timestamp>(std::move(data));
-            default:
-                // TODO: implement other data types, remove the default use case
-                // and throw from outside of the switch
-                throw std::invalid_argument("not supported yet");
-        }
-    }
-
     inline array::array(array_data data)
-        : m_array(build_array(std::move(data)))
     {
+        impl::visit_array_type(
+            data.type.id(),
+            [this, &data]<class T>()
+            {
+                reset(typed_array<T>(std::move(data)));
+            }
+        );
     }
 
     inline bool array::empty() const
     {
-        return std::visit(
-            [](auto&& arg)
-            {
-                return arg.empty();
-            },
-            m_array
-        );
+        return size() == 0u;
     }
 
     inline auto array::size() const -> size_type
     {
-        return std::visit(
-            [](auto&& arg)
-            {
-                return arg.size();
-            },
-            m_array
-        );
+        return p_dispatch->size(p_array);
     }
 
     inline auto array::at(size_type i) const -> const_reference
@@ -342,13 +513,7 @@ namespace sparrow
     inline auto array::operator[](size_type i) const -> const_reference
     {
         SPARROW_ASSERT_TRUE(i < size());
-        return std::visit(
-            [i](auto&& arg)
-            {
-                return const_reference(arg[i]);
-            },
-            m_array
-        );
+        return p_dispatch->element(p_array, i);
     }
 
     inline auto array::front() const -> const_reference
@@ -373,25 +538,174 @@ namespace sparrow
         return cend();
     }
 
-    inline auto array::cbegin() const -> const_iterator
+    inline const array_data& array::get_data() const
+    {
+        return *p_data;
+    }
+
+    template <class F>
+    decltype(auto) array::visit(F&& f) const
     {
-        return std::visit(
-            [](auto&& arg)
+        return impl::visit_array_type(
+            p_data->type.id(),
+            [this, &f]<class T>() -> decltype(auto)
             {
-                return const_iterator(arg.cbegin());
-            },
-            m_array
+                return std::forward<F>(f)(impl::as_typed_array<T>(p_array));
+            }
+        );
+    }
+
+    template <class F>
+    decltype(auto) array::visit(F&& f)
+    {
+        return impl::visit_array_type(
+            p_data->type.id(),
+            [this, &f]<class T>() -> decltype(auto)
+            {
+                return std::forward<F>(f)(unshare<T>());
+            }
         );
     }
 
+    template <class T>
+    auto array::get() const -> const typed_array<T>&
+    {
+        check_type<T>("array::get");
+        return impl::as_typed_array<T>(p_array);
+    }
+
+    template <class T>
+    auto array::get() -> typed_array<T>&
+    {
+        check_type<T>("array::get");
+        return unshare<T>();
+    }
+
+    template <class T>
+    void array::reset(typed_array<T> typed)
+    {
+        auto block = std::make_shared<typed_array<T>>(std::move(typed));
+        p_array = block.get();
+        p_data = std::shared_ptr<const array_data>(block, &std::as_const(*block).get_data());
+        p_dispatch = &impl::array_dispatch_table_v<T>;
+    }
+
+    template <class T>
+    typed_array<T>& array::unshare()
+    {
+        if (p_data.use_count() > 1)
+        {
+            reset(impl::as_typed_array<T>(p_array));
+        }
+        // The typed_array is only const through p_array, it was created non-const by reset
+        return const_cast<typed_array<T>&>(impl::as_typed_array<T>(p_array));
+    }
+
+    template <class T>
+    void array::check_type(std::string_view method) const
+    {
+        const bool holds_type = impl::visit_array_type(
+            p_data->type.id(),
+            []<class U>()
+            {
+                return std::same_as<U, T>;
+            }
+        );
+        if (!holds_type)
+        {
+            throw std::invalid_argument(
+                std::string(method) + ": requested " + typeid(typed_array<T>).name() + ", got "
+                + get_type_name()
+            );
+        }
+    }
+
+    inline std::string array::get_type_name() const
+    {
+        return visit(
+            [](const auto& arg)
+            {
+                return typeid(arg).name();
+            }
+        );
+    }
+
+    inline auto array::cbegin() const -> const_iterator
+    {
+        return p_dispatch->cbegin(p_array);
+    }
+
     inline auto array::cend() const -> const_iterator
     {
-        return std::visit(
-            [](auto&& arg)
+        return p_dispatch->cend(p_array);
+    }
+
+    template <class F>
+    void for_each(const array& ar, F&& f)
+    {
+        ar.visit(
+            [&f](const auto& typed)
             {
-                return const_iterator(arg.cend());
-            },
-            m_array
+                for (const auto& element : typed)
+                {
+                    f(element);
+                }
+            }
+        );
+    }
+
+    template <class P>
+    std::size_t count_if(const array& ar, P&& pred)
+    {
+        return ar.visit(
+            [&pred](const auto& typed)
+            {
+                std::size_t res = 0;
+                for (const auto& element : typed)
+                {
+                    res += pred(element) ? 1u : 0u;
+                }
+                return res;
+            }
         );
     }
+
+    template <class P>
+    std::size_t find_if(const array& ar, P&& pred)
+    {
+        return ar.visit(
+            [&pred](const auto& typed)
+            {
+                std::size_t res = 0;
+                for (const auto& element : typed)
+                {
+                    if (pred(element))
+                    {
+                        break;
+                    }
+                    ++res;
+                }
+                return res;
+            }
+        );
+    }
+
+    template <class P>
+    bool any_of(const array& ar, P&& pred)
+    {
+        return find_if(ar, std::forward<P>(pred)) != ar.size();
+    }
+
+    template <class P>
+    bool all_of(const array& ar, P&& pred)
+    {
+        return find_if(
+                   ar,
+                   [&pred](const auto& element)
+                   {
+                       return !pred(element);
+                   }
+               )
+               == ar.size();
+    }
 }
@@ -52,6 +52,28 @@ namespace sparrow
         value_ptr<array_data> dictionary;
     };
 
+    /**
+     * Callback invoked by a reference proxy before it modifies the element it refers
+     * to. The owner of data derived from the elements of a layout, such as the
+     * statistics cached by typed_array, registers one on the layout to discard it.
+     */
+    class modification_hook
+    {
+    public:
+
+        using function_type = void (*)(void*) noexcept;
+
+        modification_hook() = default;
+        modification_hook(function_type function, void* context) noexcept;
+
+        void operator()() const noexcept;
+
+    private:
+
+        function_type p_function = nullptr;
+        void* p_context = nullptr;
+    };
+
     /**
      * CRTP base class for reference types used in
      * layout classes. The reference proxy classes
@@ -155,7 +177,7 @@ namespace sparrow
         using bitmap_reference = typename L::bitmap_reference;
         using size_type = typename L::size_type;
 
-        reference_proxy(reference val_ref, bitmap_reference bit_ref);
+        reference_proxy(reference val_ref, bitmap_reference bit_ref, modification_hook on_modification = {});
         ~reference_proxy() = default;
 
         reference_proxy(const self_type&) = default;
@@ -194,6 +216,7 @@ namespace sparrow
 
         reference m_val_ref;
         bitmap_reference m_bit_ref;
+        modification_hook m_on_modification;
     };
 
     template <class L>
@@ -228,7 +251,11 @@ namespace sparrow
         using bitmap_iterator = std::conditional_t<is_const, typename L::const_bitmap_iterator, typename L::bitmap_iterator>;
 
         layout_iterator() noexcept = default;
-        layout_iterator(value_iterator value_iter, bitmap_iterator bitmap_iter);
+        layout_iterator(
+            value_iterator value_iter,
+            bitmap_iterator bitmap_iter,
+            modification_hook on_modification = {}
+        );
 
     private:
 
@@ -242,10 +269,29 @@ namespace sparrow
 
         value_iterator m_value_iter;
         bitmap_iterator m_bitmap_iter;
+        modification_hook m_on_modification;
 
         friend class iterator_access;
     };
 
+    /************************************
+     * modification_hook implementation *
+     ************************************/
+
+    inline modification_hook::modification_hook(function_type function, void* context) noexcept
+        : p_function(function)
+        , p_context(context)
+    {
+    }
+
+    inline void modification_hook::operator()() const noexcept
+    {
+        if (p_function != nullptr)
+        {
+            p_function(p_context);
+        }
+    }
+
     /***************************************
      * reference_proxy_base implementation *
      ***************************************/
@@ -347,9 +393,10 @@ namespace sparrow
      **********************************/
 
     template <class L>
-    reference_proxy<L>::reference_proxy(reference val_ref, bitmap_reference bit_ref)
+    reference_proxy<L>::reference_proxy(reference val_ref, bitmap_reference bit_ref, modification_hook on_modification)
         : m_val_ref(val_ref)
         , m_bit_ref(bit_ref)
+        , m_on_modification(on_modification)
     {
     }
 
@@ -427,6 +474,7 @@ namespace sparrow
     template <class L>
     void reference_proxy<L>::reset()
     {
+        m_on_modification();
         m_bit_ref = false;
     }
 
@@ -440,6 +488,8 @@ namespace sparrow
         {
             if (rhs_has_value)
             {
+                m_on_modification();
+                rhs.m_on_modification();
                 swap(m_val_ref, rhs.m_val_ref);
             }
             else
@@ -474,6 +524,7 @@ namespace sparrow
     template <class U>
     void reference_proxy<L>::update_value(U&& u)
     {
+        m_on_modification();
         m_bit_ref = true;
         m_val_ref = std::forward<U>(u);
     }
@@ -489,16 +540,28 @@ namespace sparrow
      **********************************/
 
     template <class L, bool is_const>
-    layout_iterator<L, is_const>::layout_iterator(value_iterator value_iter, bitmap_iterator bitmap_iter)
+    layout_iterator<L, is_const>::layout_iterator(
+        value_iterator value_iter,
+        bitmap_iterator bitmap_iter,
+        modification_hook on_modification
+    )
         : m_value_iter(value_iter)
         , m_bitmap_iter(bitmap_iter)
+        , m_on_modification(on_modification)
     {
     }
 
     template <class L, bool is_const>
     auto layout_iterator<L, is_const>::dereference() const -> reference
     {
-        return reference(*m_value_iter, *m_bitmap_iter);
+        if constexpr (is_const)
+        {
+            return reference(*m_value_iter, *m_bitmap_iter);
+        }
+        else
+        {
+            return reference(*m_value_iter, *m_bitmap_iter, m_on_modification);
+        }
     }
 
     template <class L, bool is_const>
@@ -19,14 +19,18 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <ranges>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "sparrow/allocator.hpp"
 #include "sparrow/array_data.hpp"
 #include "sparrow/array_data_concepts.hpp"
+#include "sparrow/buffer.hpp"
 #include "sparrow/contracts.hpp"
 #include "sparrow/data_traits.hpp"
 #include "sparrow/data_type.hpp"
@@ -34,6 +38,7 @@
 #include "sparrow/fixed_size_layout.hpp"
 #include "sparrow/memory.hpp"
 #include "sparrow/mp_utils.hpp"
+#include "sparrow/parallel.hpp"
 #include "sparrow/reference_wrapper_utils.hpp"
 #include "sparrow/variable_size_binary_layout.hpp"
 
@@ -57,24 +62,96 @@ namespace sparrow
         };
     }
 
+    /**
+     * Default allocator of the buffers built by the array_data factories.
+     */
+    using array_data_allocator = array_data::buffer_type::allocator_type;
+
+    /**
+     * Number of values from which the factories taking a thread_pool build the buffers
+     * of a random-access range of values in parallel, on that pool. Below it, starting
+     * the tasks costs more than copying the values.
+     */
+    inline constexpr std::size_t parallel_construction_threshold = std::size_t(1) << 18;
+
+    namespace impl
+    {
+        /*
+         * Buffer of \p n bytes allocated with \p a, that is left uninitialized since the
+         * tasks filling it write every byte.
+         */
+        template <allocator A>
+        array_data::buffer_type make_uninitialized_buffer(std::size_t n, const A& a)
+        {
+            A alloc(a);
+            return array_data::buffer_type(alloc.allocate(n), n, a);
+        }
+
+        /*
+         * Copies \p bitmap into blocks allocated with \p a, one morsel per task.
+         */
+        template <allocator A>
+        array_data::bitmap_type
+        copy_bitmap(const array_data::bitmap_type& bitmap, const parallel_options& options, const A& a)
+        {
+            A alloc(a);
+            std::uint8_t* blocks = alloc.allocate(bitmap.block_count());
+            const std::uint8_t* source = bitmap.data();
+            // Morsels start on multiples of 64 bits, so that the tasks copy distinct blocks
+            parallel_for_chunks(
+                bitmap.size(),
+                options.morsel_size,
+                [blocks, source](const morsel& m)
+                {
+                    std::copy(source + m.begin / 8u, source + (m.end + 7u) / 8u, blocks + m.begin / 8u);
+                },
+                resolve_pool(options)
+            );
+            // Built once the blocks are copied, since the bitmap checks its null count
+            return array_data::bitmap_type(blocks, bitmap.size(), bitmap.null_count(), a);
+        }
+
+        template <class T>
+        decltype(auto) unwrap_value(const T& value)
+        {
+            if constexpr (mpl::is_reference_wrapper_v<T>)
+            {
+                return value.get();
+            }
+            else
+            {
+                return (value);
+            }
+        }
+
+        template <class R>
+        concept parallel_fixed_size_range = std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+                                            && std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+        template <class R>
+        concept parallel_variable_size_range = std::ranges::random_access_range<R>
+                                               && std::ranges::sized_range<R>;
+    }
+
     /**
      * \brief Creates an array_data object for a fixed-size layout.
      *
      * This function creates an array_data object without any input data.
      *
      * @tparam T The type of the array_data object.
+     * @param a The allocator of the buffers of the array_data object.
      * @return The created array_data object.
      */
-    template <typename T>
-    array_data make_array_data_for_fixed_size_layout()
+    template <typename T, allocator A = array_data_allocator>
+    array_data make_array_data_for_fixed_size_layout(const A& a = A())
     {
         using U = get_corresponding_arrow_type_t<T>;
         return {
             .type = data_descriptor(arrow_type_id<U>()),
             .length = 0,
             .offset = 0,
-            .bitmap = {},
-            .buffers = {{}},
+            .bitmap = array_data::bitmap_type(0u, false, a),
+            .buffers = {array_data::buffer_type(a)},
             .child_data = {},
             .dictionary = nullptr
         };
@@ -111,13 +188,15 @@ namespace sparrow
      * @param values The range of values.
      * @param bitmap The bitmap indicating null values.
      * @param offset The offset of the array data.
+     * @param a The allocator of the buffer and of the bitmap of the array_data object.
      * @return The created array_data object.
      */
-    template <constant_range_for_array_data ValueRange>
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
     array_data make_array_data_for_fixed_size_layout(
         ValueRange&& values,
         const array_data::bitmap_type& bitmap,
-        std::int64_t offset
+        std::int64_t offset,
+        const A& a = A()
     )
     {
         using T = std::ranges::range_value_t<ValueRange>;
@@ -129,10 +208,10 @@ namespace sparrow
         SPARROW_ASSERT_TRUE(values.size() == bitmap.size());
         SPARROW_ASSERT_TRUE(std::cmp_greater_equal(values.size(), offset));
 
-        const auto create_buffer = [&values]()
+        const auto create_buffer = [&values, &a]()
         {
             const size_t buffer_size = (values.size() * sizeof(T)) / sizeof(uint8_t);
-            array_data::buffer_type buffer(buffer_size);
+            array_data::buffer_type buffer(buffer_size, a);
             auto data = buffer.data<T>();
             for (const auto& value : values)
             {
@@ -146,29 +225,272 @@ namespace sparrow
             .type = data_descriptor(arrow_type_id<U>()),
             .length = static_cast<int64_t>(values.size()),
             .offset = offset,
-            .bitmap = bitmap,
+            .bitmap = array_data::bitmap_type(bitmap, a),
             .buffers = {create_buffer()},
             .child_data = {},
             .dictionary = nullptr
         };
     }
 
+    /**
+     * Parallel version of make_array_data_for_fixed_size_layout: the values and the
+     * bitmap are copied one morsel per task.
+     *
+     * @param values The range of values.
+     * @param bitmap The bitmap indicating null values.
+     * @param offset The offset of the array data.
+     * @param options The size of the morsels and the pool running the tasks.
+     * @param a The allocator of the buffer and of the bitmap of the array_data object.
+     * @return The created array_data object.
+     */
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
+        requires impl::parallel_fixed_size_range<ValueRange>
+    array_data make_array_data_for_fixed_size_layout(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        const parallel_options& options,
+        const A& a = A()
+    )
+    {
+        using T = std::ranges::range_value_t<ValueRange>;
+        using difference_type = std::ranges::range_difference_t<ValueRange>;
+        if constexpr (std::ranges::range<T>)
+        {
+            SPARROW_ASSERT_TRUE(check_all_elements_have_same_size(values));
+        }
+        SPARROW_ASSERT_TRUE(values.size() == bitmap.size());
+        SPARROW_ASSERT_TRUE(std::cmp_greater_equal(values.size(), offset));
+
+        array_data::buffer_type buffer = impl::make_uninitialized_buffer(values.size() * sizeof(T), a);
+        T* data = buffer.data<T>();
+        const auto first = std::ranges::begin(values);
+        parallel_for_chunks(
+            values.size(),
+            options.morsel_size,
+            [data, first](const morsel& m)
+            {
+                std::copy(
+                    first + static_cast<difference_type>(m.begin),
+                    first + static_cast<difference_type>(m.end),
+                    data + m.begin
+                );
+            },
+            impl::resolve_pool(options)
+        );
+
+        std::vector<array_data::buffer_type> buffers;
+        buffers.push_back(std::move(buffer));
+        using U = std::conditional_t<std::same_as<T, std::string_view>, std::string, T>;
+        return {
+            .type = data_descriptor(arrow_type_id<U>()),
+            .length = static_cast<int64_t>(values.size()),
+            .offset = offset,
+            .bitmap = impl::copy_bitmap(bitmap, options, a),
+            .buffers = std::move(buffers),
+            .child_data = {},
+            .dictionary = nullptr
+        };
+    }
+
+    /**
+     * Creates an array_data object for a fixed-size layout, on \p pool when the
+     * range holds at least parallel_construction_threshold values.
+     *
+     * @param values The range of values.
+     * @param bitmap The bitmap indicating the presence of each value.
+     * @param offset The offset of the array_data object.
+     * @param pool The pool running the tasks.
+     * @param a The allocator of the buffers and of the bitmap of the array_data object.
+     * @return The created array_data object.
+     */
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
+    array_data make_array_data_for_fixed_size_layout(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        thread_pool& pool,
+        const A& a = A()
+    )
+    {
+        if constexpr (impl::parallel_fixed_size_range<ValueRange>)
+        {
+            if (values.size() >= parallel_construction_threshold)
+            {
+                return make_array_data_for_fixed_size_layout(
+                    std::forward<ValueRange>(values),
+                    bitmap,
+                    offset,
+                    parallel_options{.pool = &pool},
+                    a
+                );
+            }
+        }
+        return make_array_data_for_fixed_size_layout(std::forward<ValueRange>(values), bitmap, offset, a);
+    }
+
+    /**
+     * Matches the types whose arrays have a fixed_size_layout, and whose values can
+     * therefore be stored in a buffer allocated outside of sparrow.
+     */
+    template <class T>
+    concept fixed_size_value = is_arrow_base_type<T> and std::same_as<default_layout_t<T>, fixed_size_layout<T>>;
+
+    namespace impl
+    {
+        /*
+         * Wraps the \p size values at \p values, owned by \p owner, in a buffer that
+         * takes ownership of \p owner without copying the values.
+         */
+        template <class T, class Owner>
+        array_data::buffer_type adopt_values(Owner&& owner, T* values, std::size_t size)
+        {
+            using byte_type = array_data::buffer_type::value_type;
+            byte_type* block = reinterpret_cast<byte_type*>(values);
+            return array_data::buffer_type(
+                block,
+                size * sizeof(T),
+                adopting_allocator<byte_type>(block, std::forward<Owner>(owner))
+            );
+        }
+
+        template <class T>
+        array_data make_adopted_array_data(
+            array_data::buffer_type values,
+            std::size_t size,
+            array_data::bitmap_type bitmap,
+            std::int64_t offset
+        )
+        {
+            SPARROW_ASSERT_TRUE(size == bitmap.size());
+            SPARROW_ASSERT_TRUE(std::cmp_greater_equal(size, offset));
+            // Not an initializer_list, which would copy the values
+            std::vector<array_data::buffer_type> buffers;
+            buffers.push_back(std::move(values));
+            return {
+                .type = data_descriptor(arrow_type_id<T>()),
+                .length = static_cast<std::int64_t>(size),
+                .offset = offset,
+                .bitmap = std::move(bitmap),
+                .buffers = std::move(buffers),
+                .child_data = {},
+                .dictionary = nullptr
+            };
+        }
+    }
+
+    /**
+     * Creates an array_data object for a fixed-size layout, that takes ownership of the
+     * storage of \p values instead of copying it: the complexity does not depend on the
+     * number of values. The storage is released when the buffer of the array_data object
+     * (or the last buffer that is moved from it) is destroyed.
+     *
+     * @tparam T The type of the values.
+     * @param values The values, moved into the array_data object.
+     * @param bitmap The bitmap indicating null values, moved into the array_data object.
+     * @param offset The offset of the array data.
+     * @return The created array_data object.
+     */
+    template <fixed_size_value T>
+        requires(not std::same_as<T, bool>)
+    array_data make_array_data_for_fixed_size_layout(
+        std::vector<T>&& values,
+        array_data::bitmap_type bitmap,
+        std::int64_t offset
+    )
+    {
+        const std::size_t size = values.size();
+        T* data = values.data();
+        return impl::make_adopted_array_data<T>(
+            impl::adopt_values(std::move(values), data, size),
+            size,
+            std::move(bitmap),
+            offset
+        );
+    }
+
+    /**
+     * Creates an array_data object for a fixed-size layout, that takes ownership of the
+     * storage of \p values instead of copying it.
+     *
+     * @tparam T The type of the values.
+     * @param values The values, moved into the array_data object.
+     * @param bitmap The bitmap indicating null values, moved into the array_data object.
+     * @param offset The offset of the array data.
+     * @return The created array_data object.
+     */
+    template <fixed_size_value T>
+    array_data make_array_data_for_fixed_size_layout(
+        buffer<T>&& values,
+        array_data::bitmap_type bitmap,
+        std::int64_t offset
+    )
+    {
+        const std::size_t size = values.size();
+        if constexpr (std::same_as<T, array_data::buffer_type::value_type>)
+        {
+            return impl::make_adopted_array_data<T>(std::move(values), size, std::move(bitmap), offset);
+        }
+        else
+        {
+            T* data = values.data();
+            return impl::make_adopted_array_data<T>(
+                impl::adopt_values(std::move(values), data, size),
+                size,
+                std::move(bitmap),
+                offset
+            );
+        }
+    }
+
+    /**
+     * Creates an array_data object for a fixed-size layout, that takes ownership of the
+     * \p size values at \p values instead of copying them. The values are released with
+     * the deleter of \p values, which makes it possible to adopt a raw pointer allocated
+     * by another library, e.g. `std::unique_ptr<T[], void (*)(void*)>(p, &std::free)`.
+     *
+     * @tparam T The type of the values.
+     * @tparam D The type of the deleter of the values.
+     * @param values The values, moved into the array_data object.
+     * @param size The number of values.
+     * @param bitmap The bitmap indicating null values, moved into the array_data object.
+     * @param offset The offset of the array data.
+     * @return The created array_data object.
+     */
+    template <fixed_size_value T, class D>
+    array_data make_array_data_for_fixed_size_layout(
+        std::unique_ptr<T[], D> values,
+        std::size_t size,
+        array_data::bitmap_type bitmap,
+        std::int64_t offset
+    )
+    {
+        T* data = values.get();
+        return impl::make_adopted_array_data<T>(
+            impl::adopt_values(std::move(values), data, size),
+            size,
+            std::move(bitmap),
+            offset
+        );
+    }
+
     /**
      * Creates an empty array_data object for a variable-sized binary layout.
      *
      * @tparam T The data type of the array.
+     * @param a The allocator of the buffers of the array_data object.
      * @return The created array_data object.
      */
-    template <typename T>
-    array_data make_array_data_for_variable_size_binary_layout()
+    template <typename T, allocator A = array_data_allocator>
+    array_data make_array_data_for_variable_size_binary_layout(const A& a = A())
     {
         using U = get_corresponding_arrow_type_t<T>;
         return {
             .type = data_descriptor(arrow_type_id<U>()),
             .length = 0,
             .offset = 0,
-            .bitmap = {},
-            .buffers = {{}, array_data::buffer_type(sizeof(std::int64_t), 0)},
+            .bitmap = array_data::bitmap_type(0u, false, a),
+            .buffers = {array_data::buffer_type(a), array_data::buffer_type(sizeof(std::int64_t), 0, a)},
             .child_data = {},
             .dictionary = nullptr
         };
@@ -183,19 +505,21 @@ namespace sparrow
      * @param values The range of values.
      * @param bitmap The bitmap indicating the presence of each value.
      * @param offset The offset of the array_data object.
+     * @param a The allocator of the buffers and of the bitmap of the array_data object.
      * @return The created array_data object.
      */
-    template <constant_range_for_array_data ValueRange>
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
     array_data make_array_data_for_variable_size_binary_layout(
         ValueRange&& values,
         const array_data::bitmap_type& bitmap,
-        std::int64_t offset
+        std::int64_t offset,
+        const A& a = A()
     )
     {
         SPARROW_ASSERT_TRUE(values.size() == bitmap.size());
         SPARROW_ASSERT_TRUE(std::cmp_greater_equal(values.size(), offset));
 
-        const auto create_buffers = [&values]()
+        const auto create_buffers = [&values, &a]()
         {
             using T = std::ranges::range_value_t<ValueRange>;
             const auto& unwrap_value = [](const T& value)
@@ -210,7 +534,10 @@ namespace sparrow
                 }
             };
 
-            std::vector<array_data::buffer_type> buffers(2);
+            std::vector<array_data::buffer_type> buffers;
+            buffers.reserve(2u);
+            buffers.emplace_back(a);
+            buffers.emplace_back(a);
             buffers[0].resize(sizeof(std::int64_t) * (values.size() + 1), 0);
             buffers[1].resize(std::accumulate(
                 values.begin(),
@@ -246,13 +573,156 @@ namespace sparrow
             .type = data_descriptor(arrow_type_id<U>()),
             .length = static_cast<array_data::length_type>(values.size()),
             .offset = offset,
-            .bitmap = bitmap,
+            .bitmap = array_data::bitmap_type(bitmap, a),
             .buffers = create_buffers(),
             .child_data = {},
             .dictionary = nullptr
         };
     }
 
+    /**
+     * Parallel version of make_array_data_for_variable_size_binary_layout.
+     *
+     * A first pass computes the sizes of the values of each morsel, and their offsets
+     * relative to the start of the morsel; once the offsets of the morsels are known,
+     * a second pass rebases the offsets and copies the values. The bitmap is copied
+     * one morsel per task.
+     *
+     * @param values The range of values.
+     * @param bitmap The bitmap indicating the presence of each value.
+     * @param offset The offset of the array_data object.
+     * @param options The size of the morsels and the pool running the tasks.
+     * @param a The allocator of the buffers and of the bitmap of the array_data object.
+     * @return The created array_data object.
+     */
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
+        requires impl::parallel_variable_size_range<ValueRange>
+    array_data make_array_data_for_variable_size_binary_layout(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        const parallel_options& options,
+        const A& a = A()
+    )
+    {
+        using difference_type = std::ranges::range_difference_t<ValueRange>;
+        SPARROW_ASSERT_TRUE(values.size() == bitmap.size());
+        SPARROW_ASSERT_TRUE(std::cmp_greater_equal(values.size(), offset));
+
+        const std::size_t size = values.size();
+        const std::size_t step = aligned_morsel_size(options.morsel_size);
+        thread_pool& pool = impl::resolve_pool(options);
+        const auto first = std::ranges::begin(values);
+
+        array_data::buffer_type offset_buffer = impl::make_uninitialized_buffer(
+            sizeof(std::int64_t) * (size + 1u),
+            a
+        );
+        std::int64_t* offsets = offset_buffer.data<std::int64_t>();
+        offsets[0] = 0;
+        std::vector<std::int64_t> morsel_offsets((size + step - 1u) / step + 1u, 0);
+        parallel_for_chunks(
+            size,
+            step,
+            [first, offsets, &morsel_offsets](const morsel& m)
+            {
+                std::int64_t morsel_offset = 0;
+                for (std::size_t i = m.begin; i < m.end; ++i)
+                {
+                    const auto& element = first[static_cast<difference_type>(i)];
+                    const std::size_t value_size = std::ranges::size(impl::unwrap_value(element));
+                    SPARROW_ASSERT_TRUE(std::cmp_less(value_size, std::numeric_limits<std::int64_t>::max()));
+                    morsel_offset += static_cast<std::int64_t>(value_size);
+                    offsets[i + 1] = morsel_offset;
+                }
+                morsel_offsets[m.index + 1] = morsel_offset;
+            },
+            pool
+        );
+        std::partial_sum(morsel_offsets.begin(), morsel_offsets.end(), morsel_offsets.begin());
+
+        array_data::buffer_type value_buffer = impl::make_uninitialized_buffer(
+            static_cast<std::size_t>(morsel_offsets.back()),
+            a
+        );
+        std::uint8_t* bytes = value_buffer.data();
+        parallel_for_chunks(
+            size,
+            step,
+            [first, offsets, bytes, &morsel_offsets](const morsel& m)
+            {
+                const std::int64_t base = morsel_offsets[m.index];
+                std::int64_t value_offset = base;
+                for (std::size_t i = m.begin; i < m.end; ++i)
+                {
+                    const auto& element = first[static_cast<difference_type>(i)];
+                    std::ranges::copy(impl::unwrap_value(element), bytes + value_offset);
+                    offsets[i + 1] += base;
+                    value_offset = offsets[i + 1];
+                }
+            },
+            pool
+        );
+
+        using T = std::unwrap_ref_decay_t<std::unwrap_ref_decay_t<std::ranges::range_value_t<ValueRange>>>;
+        using U = get_corresponding_arrow_type_t<T>;
+
+        std::vector<array_data::buffer_type> buffers;
+        buffers.reserve(2u);
+        buffers.push_back(std::move(offset_buffer));
+        buffers.push_back(std::move(value_buffer));
+        return {
+            .type = data_descriptor(arrow_type_id<U>()),
+            .length = static_cast<array_data::length_type>(size),
+            .offset = offset,
+            .bitmap = impl::copy_bitmap(bitmap, options, a),
+            .buffers = std::move(buffers),
+            .child_data = {},
+            .dictionary = nullptr
+        };
+    }
+
+    /**
+     * Creates an array_data object for a variable-size binary layout, on \p pool when the
+     * range holds at least parallel_construction_threshold values.
+     *
+     * @param values The range of values.
+     * @param bitmap The bitmap indicating the presence of each value.
+     * @param offset The offset of the array_data object.
+     * @param pool The pool running the tasks.
+     * @param a The allocator of the buffers and of the bitmap of the array_data object.
+     * @return The created array_data object.
+     */
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
+    array_data make_array_data_for_variable_size_binary_layout(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        thread_pool& pool,
+        const A& a = A()
+    )
+    {
+        if constexpr (impl::parallel_variable_size_range<ValueRange>)
+        {
+            if (values.size() >= parallel_construction_threshold)
+            {
+                return make_array_data_for_variable_size_binary_layout(
+                    std::forward<ValueRange>(values),
+                    bitmap,
+                    offset,
+                    parallel_options{.pool = &pool},
+                    a
+                );
+            }
+        }
+        return make_array_data_for_variable_size_binary_layout(
+            std::forward<ValueRange>(values),
+            bitmap,
+            offset,
+            a
+        );
+    }
+
     /**
      * Helper struct to store values and their indexes for a dictionary-encoded layout.
      *
@@ -334,19 +804,20 @@ namespace sparrow
      * Creates an empty array_data object for dictionary encoded layout.
      *
      * @tparam T The type of the array data.
+     * @param a The allocator of the buffers of the array_data object and of its dictionary.
      * @return The created array_data object.
      */
-    template <typename T>
-    array_data make_array_data_for_dictionary_encoded_layout()
+    template <typename T, allocator A = array_data_allocator>
+    array_data make_array_data_for_dictionary_encoded_layout(const A& a = A())
     {
         return {
             .type = data_descriptor(arrow_type_id<std::uint64_t>()),
             .length = 0,
             .offset = 0,
-            .bitmap = {},
-            .buffers = {array_data::buffer_type(sizeof(std::int64_t), 0)},
+            .bitmap = array_data::bitmap_type(0u, false, a),
+            .buffers = {array_data::buffer_type(sizeof(std::int64_t), 0, a)},
             .child_data = {},
-            .dictionary = value_ptr<array_data>(make_array_data_for_variable_size_binary_layout<T>())
+            .dictionary = value_ptr<array_data>(make_array_data_for_variable_size_binary_layout<T>(a))
         };
     }
 
@@ -359,13 +830,16 @@ namespace sparrow
      * @param values The range of values.
      * @param bitmap The bitmap indicating the presence of values.
      * @param offset The offset for the array data.
+     * @param a The allocator of the buffers and of the bitmaps of the array_data object
+     *          and of its dictionary.
      * @return The created array_data object.
      */
-    template <constant_range_for_array_data ValueRange>
+    template <constant_range_for_array_data ValueRange, allocator A = array_data_allocator>
     array_data make_array_data_for_dictionary_encoded_layout(
         ValueRange&& values,
         const array_data::bitmap_type& bitmap,
-        std::int64_t offset
+        std::int64_t offset,
+        const A& a = A()
     )
     {
         SPARROW_ASSERT_TRUE(values.size() == bitmap.size());
@@ -373,10 +847,10 @@ namespace sparrow
 
         const values_and_indexes<const std::ranges::range_value_t<ValueRange>> vec_and_indexes{values};
         const auto& indexes = vec_and_indexes.indexes;
-        const auto create_buffer = [&indexes]()
+        const auto create_buffer = [&indexes, &a]()
         {
             const size_t buffer_size = indexes.size() * sizeof(size_t) / sizeof(uint8_t);
-            array_data::buffer_type b(buffer_size);
+            array_data::buffer_type b(buffer_size, a);
             std::ranges::copy(indexes, b.data<size_t>());
             return b;
         };
@@ -384,13 +858,14 @@ namespace sparrow
             .type = data_descriptor(arrow_type_id<std::uint64_t>()),
             .length = static_cast<array_data::length_type>(indexes.size()),
             .offset = offset,
-            .bitmap = bitmap,
+            .bitmap = array_data::bitmap_type(bitmap, a),
             .buffers = {create_buffer()},
             .child_data = {},
             .dictionary = value_ptr<array_data>(make_array_data_for_variable_size_binary_layout(
                 vec_and_indexes.values,
                 array_data::bitmap_type(vec_and_indexes.values.size(), true),
-                0
+                0,
+                a
             ))
         };
     }
@@ -403,10 +878,11 @@ namespace sparrow
      * If the layout type is not supported, a static assertion is triggered.
      *
      * @tparam Layout The layout type for the array data.
+     * @param a The allocator of the buffers of the array data object.
      * @return The created array data object.
      */
-    template <arrow_layout Layout>
-    array_data make_default_array_data()
+    template <arrow_layout Layout, allocator A = array_data_allocator>
+    array_data make_default_array_data([[maybe_unused]] const A& a = A())
     {
         if constexpr (std::same_as<Layout, null_layout>)
         {
@@ -414,15 +890,15 @@ namespace sparrow
         }
         else if constexpr (mpl::is_type_instance_of_v<Layout, fixed_size_layout>)
         {
-            return make_array_data_for_fixed_size_layout<typename Layout::inner_value_type>();
+            return make_array_data_for_fixed_size_layout<typename Layout::inner_value_type>(a);
         }
         else if constexpr (mpl::is_type_instance_of_v<Layout, variable_size_binary_layout>)
         {
-            return make_array_data_for_variable_size_binary_layout<typename Layout::inner_value_type>();
+            return make_array_data_for_variable_size_binary_layout<typename Layout::inner_value_type>(a);
         }
         else if constexpr (mpl::is_type_instance_of_v<Layout, dictionary_encoded_layout>)
         {
-            return make_array_data_for_dictionary_encoded_layout<typename Layout::inner_value_type>();
+            return make_array_data_for_dictionary_encoded_layout<typename Layout::inner_value_type>(a);
         }
         else
         {
@@ -446,23 +922,41 @@ namespace sparrow
      * @param values The value range for the array data.
      * @param bitmap The bitmap type for the array data.
      * @param offset The offset for the array data.
+     * @param a The allocator of the buffers and of the bitmap of the array data object.
      * @return The created array data object.
      */
-    template <arrow_layout Layout, constant_range_for_array_data ValueRange>
-    array_data
-    make_default_array_data(ValueRange&& values, const array_data::bitmap_type& bitmap, std::int64_t offset)
+    template <
+        arrow_layout Layout,
+        constant_range_for_array_data ValueRange,
+        allocator A = array_data_allocator>
+    array_data make_default_array_data(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        const A& a = A()
+    )
     {
         if constexpr (mpl::is_type_instance_of_v<Layout, fixed_size_layout>)
         {
-            return make_array_data_for_fixed_size_layout(std::forward<ValueRange>(values), bitmap, offset);
+            return make_array_data_for_fixed_size_layout(std::forward<ValueRange>(values), bitmap, offset, a);
         }
         else if constexpr (mpl::is_type_instance_of_v<Layout, variable_size_binary_layout>)
         {
-            return make_array_data_for_variable_size_binary_layout(std::forward<ValueRange>(values), bitmap, offset);
+            return make_array_data_for_variable_size_binary_layout(
+                std::forward<ValueRange>(values),
+                bitmap,
+                offset,
+                a
+            );
         }
         else if constexpr (mpl::is_type_instance_of_v<Layout, dictionary_encoded_layout>)
         {
-            return make_array_data_for_dictionary_encoded_layout(std::forward<ValueRange>(values), bitmap, offset);
+            return make_array_data_for_dictionary_encoded_layout(
+                std::forward<ValueRange>(values),
+                bitmap,
+                offset,
+                a
+            );
         }
         else
         {
@@ -482,13 +976,18 @@ namespace sparrow
      * @param values The input range of values for the array_data object.
      * @param bitmap The bitmap type for the array_data object.
      * @param offset The offset for the array_data object.
+     * @param a The allocator of the buffers and of the bitmap of the array_data object.
      * @return A new array_data object with the specified layout, values, bitmap, and offset.
      */
-    template <arrow_layout Layout, std::ranges::input_range ValueRange>
+    template <arrow_layout Layout, std::ranges::input_range ValueRange, allocator A = array_data_allocator>
         requires(!mpl::constant_range<ValueRange>)
-    array_data
-    make_default_array_data(ValueRange&& values, const array_data::bitmap_type& bitmap, std::int64_t offset)
+    array_data make_default_array_data(
+        ValueRange&& values,
+        const array_data::bitmap_type& bitmap,
+        std::int64_t offset,
+        const A& a = A()
+    )
     {
-        return make_default_array_data<Layout>(std::as_const(values), bitmap, offset);
+        return make_default_array_data<Layout>(std::as_const(values), bitmap, offset, a);
     }
 }  // namespace sparrow
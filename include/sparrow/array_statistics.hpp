@@ -0,0 +1,76 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace sparrow
+{
+    /**
+     * Default number of rows of the blocks of a zone map.
+     */
+    inline constexpr std::size_t zone_map_block_size = 65536;
+
+    /**
+     * Statistics of a block of consecutive rows of an array.
+     *
+     * The bounds ignore the null elements and the NaNs; they are not set when the block
+     * has no other element.
+     *
+     * @tparam T The type of the elements of the array.
+     */
+    template <class T>
+    struct zone_statistics
+    {
+        std::size_t size = 0;
+        std::size_t null_count = 0;
+        std::size_t nan_count = 0;
+        std::optional<T> min;
+        std::optional<T> max;
+    };
+
+    /**
+     * Statistics of an array, computed in a single pass by compute_statistics.
+     *
+     * A typed_array caches its statistics once computed, until it is modified, so that
+     * kernels can use them: comparisons with a scalar skip the blocks of the zone map
+     * whose bounds decide the result, and the distinct values of sorted arrays are
+     * computed by merging runs instead of hashing.
+     *
+     * @tparam T The type of the elements of the array.
+     */
+    template <class T>
+    struct array_statistics
+    {
+        std::size_t null_count = 0;
+        std::size_t nan_count = 0;
+        /// Smallest element, ignoring nulls and NaNs.
+        std::optional<T> min;
+        /// Largest element, ignoring nulls and NaNs.
+        std::optional<T> max;
+        /// Estimate of the number of distinct non-null elements.
+        double distinct_count = 0.;
+        /// Whether the non-null elements are in non-decreasing order, without NaN.
+        bool is_sorted = true;
+        /// Whether the non-null elements are distinct.
+        bool is_unique = true;
+        /// Number of rows of the blocks of the zone map, a multiple of 64.
+        std::size_t block_size = zone_map_block_size;
+        /// Statistics of the consecutive blocks of block_size rows of the array.
+        std::vector<zone_statistics<T>> zones;
+    };
+}
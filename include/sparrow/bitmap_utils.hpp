@@ -0,0 +1,431 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "sparrow/contracts.hpp"
+#include "sparrow/dynamic_bitset.hpp"
+
+namespace sparrow
+{
+    /**
+     * Word type used by the kernels to process bitmaps 64 bits at a time.
+     */
+    using bitmap_word = std::uint64_t;
+
+    inline constexpr std::size_t bitmap_word_bits = 64;
+
+    /**
+     * @return The number of words needed to hold \p bit_count bits.
+     */
+    constexpr std::size_t bitmap_word_count(std::size_t bit_count) noexcept
+    {
+        return (bit_count + bitmap_word_bits - 1) / bitmap_word_bits;
+    }
+
+    /**
+     * @return A word whose \p bit_count lowest bits are set.
+     */
+    constexpr bitmap_word low_bits_mask(std::size_t bit_count) noexcept
+    {
+        return bit_count >= bitmap_word_bits ? ~bitmap_word(0) : ((bitmap_word(1) << bit_count) - 1);
+    }
+
+    /**
+     * Calls \p f with the position of every set bit of \p word, in increasing order.
+     */
+    template <class F>
+    void for_each_set_bit(bitmap_word word, F&& f)
+    {
+        while (word != 0u)
+        {
+            f(static_cast<std::size_t>(std::countr_zero(word)));
+            word &= word - 1u;
+        }
+    }
+
+    /**
+     * Loads up to \p byte_count bytes into a word, the first byte becoming the
+     * least significant one, independently of the endianness of the platform.
+     */
+    inline bitmap_word load_word_bytes(const std::uint8_t* src, std::size_t byte_count) noexcept
+    {
+        SPARROW_ASSERT_TRUE(byte_count <= sizeof(bitmap_word));
+        bitmap_word res = 0;
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            std::memcpy(&res, src, byte_count);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < byte_count; ++i)
+            {
+                res |= bitmap_word(src[i]) << (8u * i);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Stores the \p byte_count least significant bytes of \p word, the least significant
+     * byte first, independently of the endianness of the platform.
+     */
+    inline void store_word_bytes(std::uint8_t* dst, bitmap_word word, std::size_t byte_count) noexcept
+    {
+        SPARROW_ASSERT_TRUE(byte_count <= sizeof(bitmap_word));
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            std::memcpy(dst, &word, byte_count);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < byte_count; ++i)
+            {
+                dst[i] = static_cast<std::uint8_t>(word >> (8u * i));
+            }
+        }
+    }
+
+    /**
+     * Reads 64 bits of a byte-block bitmap, starting at an arbitrary bit position.
+     *
+     * Bits located past the end of the block buffer are read as zero.
+     *
+     * @param blocks The blocks of the bitmap.
+     * @param block_count The number of blocks in \p blocks.
+     * @param bit_pos The position of the first bit to read.
+     * @return A word whose bit i is the bit at position `bit_pos + i` of the bitmap.
+     */
+    inline bitmap_word
+    load_bitmap_word(const std::uint8_t* blocks, std::size_t block_count, std::size_t bit_pos) noexcept
+    {
+        const std::size_t first_block = bit_pos / 8u;
+        const std::size_t shift = bit_pos % 8u;
+        if (first_block >= block_count)
+        {
+            return 0u;
+        }
+        const std::size_t available = block_count - first_block;
+        bitmap_word res = load_word_bytes(blocks + first_block, std::min(available, sizeof(bitmap_word)));
+        if (shift != 0u)
+        {
+            res >>= shift;
+            if (available > sizeof(bitmap_word))
+            {
+                res |= bitmap_word(blocks[first_block + sizeof(bitmap_word)]) << (bitmap_word_bits - shift);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Packs 8 booleans into the 8 lowest bits of a byte, the first boolean
+     * becoming the least significant bit.
+     *
+     * The booleans are loaded as a single 64-bit integer whose bytes are 0 or 1,
+     * and gathered with one multiplication (SWAR), so that packing runs without
+     * any branch nor per-element shift.
+     */
+    inline std::uint8_t pack_8_bools(const bool* src) noexcept
+    {
+        static_assert(sizeof(bool) == 1);
+        const std::uint64_t bytes = load_word_bytes(reinterpret_cast<const std::uint8_t*>(src), 8u);
+        // Byte k of the multiplier is 2^(7 - k): the top byte of the product gathers
+        // bool i at bit i, and no carry can cross the byte boundaries.
+        return static_cast<std::uint8_t>((bytes * 0x0102040810204080ull) >> 56u);
+    }
+
+    /**
+     * Packs up to 64 booleans into a bitmap word.
+     *
+     * @param src The booleans to pack.
+     * @param count The number of booleans to pack, at most 64.
+     */
+    inline bitmap_word pack_bools(const bool* src, std::size_t count) noexcept
+    {
+        SPARROW_ASSERT_TRUE(count <= bitmap_word_bits);
+        bitmap_word res = 0;
+        std::size_t i = 0;
+        for (; i + 8u <= count; i += 8u)
+        {
+            res |= bitmap_word(pack_8_bools(src + i)) << i;
+        }
+        for (; i < count; ++i)
+        {
+            res |= bitmap_word(src[i]) << i;
+        }
+        return res;
+    }
+
+    /**
+     * Unpacks the \p count lowest bits of \p word into booleans.
+     */
+    inline void unpack_bools(bitmap_word word, std::size_t count, bool* dst) noexcept
+    {
+        SPARROW_ASSERT_TRUE(count <= bitmap_word_bits);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            dst[i] = ((word >> i) & 1u) != 0u;
+        }
+    }
+
+    /**
+     * Sequential reader of a dynamic_bitset, 64 bits at a time, starting at an arbitrary
+     * bit offset.
+     *
+     * A bitmap without any null value, or an empty bitmap, is read as a sequence of set
+     * bits: this matches the semantic of validity bitmaps. Bits past the requested size
+     * are always zero.
+     */
+    class bitmap_word_reader
+    {
+    public:
+
+        using bitmap_type = dynamic_bitset<std::uint8_t>;
+        using size_type = std::size_t;
+
+        /**
+         * @param bitmap The bitmap to read.
+         * @param offset The position of the first bit to read.
+         * @param size The number of bits to read.
+         */
+        bitmap_word_reader(const bitmap_type& bitmap, size_type offset, size_type size) noexcept
+            : p_blocks(bitmap.data())
+            , m_block_count(bitmap.block_count())
+            , m_offset(offset)
+            , m_size(size)
+            , m_all_set(bitmap.size() == 0u || bitmap.null_count() == 0u)
+        {
+            SPARROW_ASSERT_TRUE(m_all_set || offset + size <= bitmap.size());
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        size_type word_count() const noexcept
+        {
+            return bitmap_word_count(m_size);
+        }
+
+        /**
+         * @return true if every bit read is set, without reading the underlying blocks.
+         */
+        bool all_set() const noexcept
+        {
+            return m_all_set;
+        }
+
+        /**
+         * @return The bits [64 * i, 64 * i + 64) of the range.
+         */
+        bitmap_word word(size_type i) const noexcept
+        {
+            const size_type first = i * bitmap_word_bits;
+            SPARROW_ASSERT_TRUE(first < m_size);
+            const bitmap_word mask = low_bits_mask(m_size - first);
+            if (m_all_set)
+            {
+                return mask;
+            }
+            return load_bitmap_word(p_blocks, m_block_count, m_offset + first) & mask;
+        }
+
+    private:
+
+        const std::uint8_t* p_blocks;
+        size_type m_block_count;
+        size_type m_offset;
+        size_type m_size;
+        bool m_all_set;
+    };
+
+    namespace impl
+    {
+        struct bitmap_blocks_deleter
+        {
+            std::size_t block_count;
+
+            void operator()(std::uint8_t* blocks) const
+            {
+                std::allocator<std::uint8_t>().deallocate(blocks, block_count);
+            }
+        };
+
+        /*
+         * Storage of a bitmap being filled, released if filling it throws and handed over
+         * to the dynamic_bitset otherwise.
+         */
+        using bitmap_blocks_ptr = std::unique_ptr<std::uint8_t[], bitmap_blocks_deleter>;
+
+        inline bitmap_blocks_ptr allocate_bitmap_blocks(std::size_t block_count)
+        {
+            return bitmap_blocks_ptr(
+                std::allocator<std::uint8_t>().allocate(block_count),
+                bitmap_blocks_deleter{block_count}
+            );
+        }
+    }
+
+    /**
+     * Builds a bitmap of \p size bits, 64 bits at a time.
+     *
+     * The storage is allocated once and every word is written with a single store;
+     * the null count is computed once the bitmap has been filled.
+     *
+     * @param size The number of bits of the bitmap.
+     * @param word_at Callable returning the bits [64 * i, 64 * i + 64) of the bitmap
+     * when called with i. Bits past \p size are ignored.
+     */
+    template <class F>
+    dynamic_bitset<std::uint8_t> make_bitmap_from_words(std::size_t size, F&& word_at)
+    {
+        const std::size_t block_count = (size + 7u) / 8u;
+        if (block_count == 0u)
+        {
+            return dynamic_bitset<std::uint8_t>();
+        }
+        impl::bitmap_blocks_ptr blocks = impl::allocate_bitmap_blocks(block_count);
+        const std::size_t word_count = bitmap_word_count(size);
+        for (std::size_t i = 0; i < word_count; ++i)
+        {
+            const std::size_t first_block = i * sizeof(bitmap_word);
+            const std::size_t byte_count = std::min(sizeof(bitmap_word), block_count - first_block);
+            const bitmap_word word = word_at(i);
+            store_word_bytes(
+                blocks.get() + first_block,
+                word & low_bits_mask(size - i * bitmap_word_bits),
+                byte_count
+            );
+        }
+        return dynamic_bitset<std::uint8_t>(blocks.release(), size);
+    }
+
+    /**
+     * Builds a bitmap of a known size by appending runs of up to 64 bits.
+     *
+     * Appended runs are spliced with shifts, so that copying a bitmap at an arbitrary
+     * bit position costs one store per output word. The storage is allocated once.
+     */
+    class bitmap_word_writer
+    {
+    public:
+
+        using bitmap_type = dynamic_bitset<std::uint8_t>;
+        using size_type = std::size_t;
+
+        /**
+         * @param size The number of bits of the bitmap to build.
+         */
+        explicit bitmap_word_writer(size_type size)
+            : m_size(size)
+            , m_block_count((size + 7u) / 8u)
+            , p_blocks(m_block_count == 0u ? nullptr : std::allocator<std::uint8_t>().allocate(m_block_count))
+        {
+        }
+
+        ~bitmap_word_writer()
+        {
+            if (p_blocks != nullptr)
+            {
+                std::allocator<std::uint8_t>().deallocate(p_blocks, m_block_count);
+            }
+        }
+
+        bitmap_word_writer(const bitmap_word_writer&) = delete;
+        bitmap_word_writer& operator=(const bitmap_word_writer&) = delete;
+
+        /**
+         * Appends the \p count low bits of \p word.
+         *
+         * @pre \p count must be at most 64.
+         */
+        void append(bitmap_word word, size_type count) noexcept
+        {
+            SPARROW_ASSERT_TRUE(count <= bitmap_word_bits);
+            SPARROW_ASSERT_TRUE(m_written + m_pending_bits + count <= m_size);
+            word &= low_bits_mask(count);
+            m_pending |= word << m_pending_bits;
+            if (m_pending_bits + count < bitmap_word_bits)
+            {
+                m_pending_bits += count;
+                return;
+            }
+            const size_type consumed = bitmap_word_bits - m_pending_bits;
+            flush();
+            m_pending = consumed == bitmap_word_bits ? bitmap_word(0) : word >> consumed;
+            m_pending_bits = count - consumed;
+        }
+
+        /**
+         * Appends the bits read by \p reader.
+         */
+        void append(const bitmap_word_reader& reader) noexcept
+        {
+            for (size_type i = 0; i < reader.word_count(); ++i)
+            {
+                append(reader.word(i), std::min(bitmap_word_bits, reader.size() - i * bitmap_word_bits));
+            }
+        }
+
+        /**
+         * @return The bitmap built.
+         * @pre Exactly `size` bits must have been appended.
+         */
+        bitmap_type finish() &&
+        {
+            if (m_pending_bits != 0u)
+            {
+                flush();
+            }
+            SPARROW_ASSERT_TRUE(m_written == m_size);
+            if (p_blocks == nullptr)
+            {
+                return bitmap_type();
+            }
+            return bitmap_type(std::exchange(p_blocks, nullptr), m_size);
+        }
+
+    private:
+
+        void flush() noexcept
+        {
+            const size_type first_block = m_written / 8u;
+            store_word_bytes(
+                p_blocks + first_block,
+                m_pending,
+                std::min(sizeof(bitmap_word), m_block_count - first_block)
+            );
+            m_written = std::min(m_written + bitmap_word_bits, m_size);
+            m_pending = 0;
+            m_pending_bits = 0;
+        }
+
+        size_type m_size;
+        size_type m_block_count;
+        std::uint8_t* p_blocks;
+        size_type m_written = 0;
+        bitmap_word m_pending = 0;
+        size_type m_pending_bits = 0;
+    };
+}
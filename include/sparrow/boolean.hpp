@@ -0,0 +1,263 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/packed_boolean_array.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Packs an array of booleans stored with one byte per value into a bit-packed array.
+     *
+     * The values are gathered 8 at a time with a single multiplication and combined
+     * with the validity bitmap word by word; no branch depends on the data.
+     *
+     * @param array The array to pack.
+     * @return The packed array, whose value bits are unset for null elements.
+     */
+    inline packed_boolean_array make_packed_boolean_array(const typed_array<bool>& array)
+    {
+        const array_data& data = array.get_data();
+        const std::size_t size = array.size();
+        const bool* values = raw_value_reader<fixed_size_layout<bool>>(data).data();
+        const bitmap_word_reader validity_reader = make_validity_reader(data);
+        array_data::bitmap_type validity = validity_reader.all_set()
+                                               ? array_data::bitmap_type(size, true)
+                                               : make_bitmap_from_words(
+                                                     size,
+                                                     [&validity_reader](std::size_t i)
+                                                     {
+                                                         return validity_reader.word(i);
+                                                     }
+                                                 );
+        array_data::bitmap_type packed = make_bitmap_from_words(
+            size,
+            [values, size, &validity_reader](std::size_t i)
+            {
+                const std::size_t first = i * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, size - first);
+                return pack_bools(values + first, count) & validity_reader.word(i);
+            }
+        );
+        return packed_boolean_array(std::move(packed), std::move(validity));
+    }
+
+    /**
+     * Matches the arrays accepted by the boolean kernels.
+     */
+    template <class A>
+    concept boolean_array = std::same_as<A, packed_boolean_array> || std::same_as<A, typed_array<bool>>;
+
+    namespace impl
+    {
+        inline const packed_boolean_array& as_packed(const packed_boolean_array& array)
+        {
+            return array;
+        }
+
+        inline packed_boolean_array as_packed(const typed_array<bool>& array)
+        {
+            return make_packed_boolean_array(array);
+        }
+
+        /*
+         * Word-level view of a packed_boolean_array.
+         */
+        class packed_boolean_reader
+        {
+        public:
+
+            explicit packed_boolean_reader(const packed_boolean_array& array)
+                : m_values(array.values(), 0u, array.size())
+                , m_validity(array.validity(), 0u, array.size())
+            {
+            }
+
+            bitmap_word values(std::size_t i) const
+            {
+                return m_values.word(i);
+            }
+
+            bitmap_word validity(std::size_t i) const
+            {
+                return m_validity.word(i);
+            }
+
+        private:
+
+            bitmap_word_reader m_values;
+            bitmap_word_reader m_validity;
+        };
+
+        /*
+         * Builds the result of a binary boolean kernel. `validity_word` and `values_word`
+         * take the readers of both operands and a word index; `values_word` must return
+         * a word whose bits are unset where `validity_word` is unset.
+         */
+        template <class VF, class F>
+        packed_boolean_array
+        apply_boolean_kernel(const packed_boolean_array& lhs, const packed_boolean_array& rhs, VF validity_word, F values_word)
+        {
+            SPARROW_ASSERT_TRUE(lhs.size() == rhs.size());
+            const std::size_t size = lhs.size();
+            const packed_boolean_reader lhs_reader(lhs);
+            const packed_boolean_reader rhs_reader(rhs);
+            array_data::bitmap_type validity = make_bitmap_from_words(
+                size,
+                [&](std::size_t i)
+                {
+                    return validity_word(lhs_reader, rhs_reader, i);
+                }
+            );
+            array_data::bitmap_type values = make_bitmap_from_words(
+                size,
+                [&](std::size_t i)
+                {
+                    return values_word(lhs_reader, rhs_reader, i);
+                }
+            );
+            return packed_boolean_array(std::move(values), std::move(validity));
+        }
+
+        inline bitmap_word
+        both_valid_word(const packed_boolean_reader& lhs, const packed_boolean_reader& rhs, std::size_t i)
+        {
+            return lhs.validity(i) & rhs.validity(i);
+        }
+    }
+
+    /**
+     * Element-wise logical and. The result is null where any operand is null.
+     */
+    template <boolean_array A, boolean_array B>
+    packed_boolean_array logical_and(const A& lhs, const B& rhs)
+    {
+        return impl::apply_boolean_kernel(
+            impl::as_packed(lhs),
+            impl::as_packed(rhs),
+            impl::both_valid_word,
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return l.values(i) & r.values(i);
+            }
+        );
+    }
+
+    /**
+     * Element-wise logical or. The result is null where any operand is null.
+     */
+    template <boolean_array A, boolean_array B>
+    packed_boolean_array logical_or(const A& lhs, const B& rhs)
+    {
+        return impl::apply_boolean_kernel(
+            impl::as_packed(lhs),
+            impl::as_packed(rhs),
+            impl::both_valid_word,
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return (l.values(i) | r.values(i)) & impl::both_valid_word(l, r, i);
+            }
+        );
+    }
+
+    /**
+     * Element-wise logical exclusive or. The result is null where any operand is null.
+     */
+    template <boolean_array A, boolean_array B>
+    packed_boolean_array logical_xor(const A& lhs, const B& rhs)
+    {
+        return impl::apply_boolean_kernel(
+            impl::as_packed(lhs),
+            impl::as_packed(rhs),
+            impl::both_valid_word,
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return (l.values(i) ^ r.values(i)) & impl::both_valid_word(l, r, i);
+            }
+        );
+    }
+
+    /**
+     * Element-wise logical negation. The result is null where \p array is null.
+     */
+    template <boolean_array A>
+    packed_boolean_array logical_not(const A& array)
+    {
+        decltype(auto) packed = impl::as_packed(array);
+        const impl::packed_boolean_reader reader(packed);
+        const std::size_t size = packed.size();
+        array_data::bitmap_type values = make_bitmap_from_words(
+            size,
+            [&reader](std::size_t i)
+            {
+                return ~reader.values(i) & reader.validity(i);
+            }
+        );
+        return packed_boolean_array(std::move(values), packed.validity());
+    }
+
+    /**
+     * Element-wise logical and, following the Kleene three-valued logic: a null
+     * operand is an unknown value, so `false and null` is false and `true and null`
+     * is null.
+     */
+    template <boolean_array A, boolean_array B>
+    packed_boolean_array and_kleene(const A& lhs, const B& rhs)
+    {
+        return impl::apply_boolean_kernel(
+            impl::as_packed(lhs),
+            impl::as_packed(rhs),
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                const bitmap_word lhs_false = l.validity(i) & ~l.values(i);
+                const bitmap_word rhs_false = r.validity(i) & ~r.values(i);
+                return impl::both_valid_word(l, r, i) | lhs_false | rhs_false;
+            },
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return l.values(i) & r.values(i);
+            }
+        );
+    }
+
+    /**
+     * Element-wise logical or, following the Kleene three-valued logic: a null
+     * operand is an unknown value, so `true or null` is true and `false or null`
+     * is null.
+     */
+    template <boolean_array A, boolean_array B>
+    packed_boolean_array or_kleene(const A& lhs, const B& rhs)
+    {
+        return impl::apply_boolean_kernel(
+            impl::as_packed(lhs),
+            impl::as_packed(rhs),
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return impl::both_valid_word(l, r, i) | l.values(i) | r.values(i);
+            },
+            [](const impl::packed_boolean_reader& l, const impl::packed_boolean_reader& r, std::size_t i)
+            {
+                return l.values(i) | r.values(i);
+            }
+        );
+    }
+}
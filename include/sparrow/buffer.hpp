@@ -243,9 +243,10 @@ namespace sparrow
         constexpr void resize(size_type new_size, const value_type& value);
         constexpr void swap(buffer& rhs) noexcept;
 
+        using base_type::get_allocator;
+
     private:
 
-        using base_type::get_allocator;
         using base_type::get_data;
 
         template <class F>
@@ -335,7 +336,11 @@ namespace sparrow
     template <class T>
     buffer_base<T>::~buffer_base()
     {
-        deallocate(m_data.p_begin, static_cast<size_type>(m_data.p_storage_end - m_data.p_begin));
+        // Moved-from buffers own no storage, and their allocator may have been moved as well
+        if (m_data.p_begin != nullptr)
+        {
+            deallocate(m_data.p_begin, static_cast<size_type>(m_data.p_storage_end - m_data.p_begin));
+        }
     }
 
     template <class T>
@@ -335,6 +335,20 @@ namespace sparrow
         SPARROW_ASSERT_FALSE(schema == nullptr)
         SPARROW_ASSERT_TRUE(schema->release == std::addressof(delete_schema<Allocator>))
 
+        // The release callback of a schema releases its children and its dictionary
+        for (int64_t i = 0; i < schema->n_children; ++i)
+        {
+            ArrowSchema* child = schema->children[i];
+            if (child->release != nullptr)
+            {
+                child->release(child);
+            }
+        }
+        if (schema->dictionary != nullptr && schema->dictionary->release != nullptr)
+        {
+            schema->dictionary->release(schema->dictionary);
+        }
+
         schema->flags = 0;
         schema->n_children = 0;
         schema->children = nullptr;
@@ -358,7 +372,7 @@ namespace sparrow
         MAP_KEYS_SORTED = 4      // For map types, whether the keys within each map value are sorted.
     };
 
-    arrow_schema_unique_ptr default_arrow_schema()
+    inline arrow_schema_unique_ptr default_arrow_schema()
     {
         auto ptr = arrow_schema_unique_ptr(new ArrowSchema());
         ptr->format = nullptr;
@@ -441,7 +455,7 @@ namespace sparrow
         return schema;
     };
 
-    arrow_array_unique_ptr default_arrow_array()
+    inline arrow_array_unique_ptr default_arrow_array()
     {
         auto ptr = arrow_array_unique_ptr(new ArrowArray());
         ptr->length = 0;
@@ -0,0 +1,763 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/float16_conversion.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Behavior of the cast kernels when a value cannot be represented in the target type.
+     */
+    enum class cast_mode
+    {
+        /// Values out of the range of the target type, and strings that cannot be parsed,
+        /// raise an exception.
+        safe,
+        /// No check is performed: integers wrap around, floating point values saturate and
+        /// strings that cannot be parsed become null.
+        unsafe
+    };
+
+    /**
+     * Matches the integer and floating point types supported by the cast kernels.
+     */
+    template <class T>
+    concept cast_numeric_type = (std::integral<T> && !std::same_as<T, bool>) || std::floating_point<T>;
+
+    /**
+     * Matches the pairs of types between which the cast kernels can convert:
+     * - any two numeric types;
+     * - numeric types from and to strings;
+     * - int64 nanoseconds from and to timestamps.
+     */
+    template <class To, class From>
+    concept castable_types = (cast_numeric_type<To> && cast_numeric_type<From>)
+                             || (cast_numeric_type<To> && std::same_as<From, std::string>)
+                             || (std::same_as<To, std::string> && cast_numeric_type<From>)
+                             || (std::same_as<To, timestamp> && std::same_as<From, std::int64_t>)
+                             || (std::same_as<To, std::int64_t> && std::same_as<From, timestamp>);
+
+    namespace impl
+    {
+        /*
+         * float16_t is converted through float: its constructor taking an integer of
+         * 16 bits reads the raw bits instead of the value.
+         */
+        template <class T>
+        inline constexpr bool is_float16_v = std::same_as<T, float16_t> && !std::same_as<T, float>;
+
+        template <class T>
+        double to_double(const T& value)
+        {
+            if constexpr (std::same_as<T, double>)
+            {
+                return value;
+            }
+            else if constexpr (is_float16_v<T>)
+            {
+                return static_cast<double>(static_cast<float>(value));
+            }
+            else
+            {
+                return static_cast<double>(value);
+            }
+        }
+
+        /*
+         * Bounds of the integral type To, expressed as doubles: [low, high). Both are
+         * powers of two, hence exactly representable.
+         */
+        template <std::integral To>
+        constexpr double integral_low_bound()
+        {
+            return static_cast<double>(std::numeric_limits<To>::min());
+        }
+
+        template <std::integral To>
+        double integral_high_bound()
+        {
+            return std::ldexp(1., std::numeric_limits<To>::digits);
+        }
+
+        /*
+         * Element-wise conversion. Floating point values are saturated when converted to
+         * integers, and NaN becomes 0, so that the conversion is always defined.
+         */
+        template <class To, class From>
+        To convert_value(const From& value)
+        {
+            if constexpr (std::same_as<To, From>)
+            {
+                return value;
+            }
+            else if constexpr (is_float16_v<From>)
+            {
+                return convert_value<To>(static_cast<float>(value));
+            }
+            else if constexpr (is_float16_v<To>)
+            {
+                return To(static_cast<float>(value));
+            }
+            else if constexpr (std::floating_point<From> && std::integral<To>)
+            {
+                const double d = to_double(value);
+                if (d >= integral_low_bound<To>())
+                {
+                    return d < integral_high_bound<To>() ? static_cast<To>(d) : std::numeric_limits<To>::max();
+                }
+                return std::isnan(d) ? To(0) : std::numeric_limits<To>::min();
+            }
+            else
+            {
+                return static_cast<To>(value);
+            }
+        }
+
+        /*
+         * Values are compared in their own type when they are integers, and as doubles
+         * otherwise.
+         */
+        template <class T>
+        auto range_key(const T& value)
+        {
+            if constexpr (std::integral<T>)
+            {
+                return value;
+            }
+            else
+            {
+                return to_double(value);
+            }
+        }
+
+        template <class K>
+        struct valid_value_range
+        {
+            K min;
+            K max;
+            bool has_nan;
+        };
+
+        /*
+         * Computes the minimum and the maximum of the valid values, 64 values at a time.
+         * Null values are replaced with 0, which any numeric type can represent, so that
+         * the loop has no branch and can be vectorized.
+         */
+        template <class From>
+        auto compute_valid_value_range(const From* values, const bitmap_word_reader& validity)
+        {
+            using key_type = decltype(range_key(std::declval<From>()));
+            valid_value_range<key_type> res{key_type(0), key_type(0), false};
+            for (std::size_t i = 0; i < validity.word_count(); ++i)
+            {
+                const bitmap_word valid = validity.word(i);
+                const std::size_t first = i * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, validity.size() - first);
+                key_type block_min = res.min;
+                key_type block_max = res.max;
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    const key_type key = ((valid >> j) & 1u) != 0u ? range_key(values[first + j]) : key_type(0);
+                    block_min = std::min(block_min, key);
+                    block_max = std::max(block_max, key);
+                    if constexpr (std::floating_point<key_type>)
+                    {
+                        res.has_nan |= std::isnan(key);
+                    }
+                }
+                res.min = block_min;
+                res.max = block_max;
+            }
+            return res;
+        }
+
+        /*
+         * Matches the conversions between floating point types that lose range.
+         */
+        template <class To, class From>
+        concept narrowing_float_cast = (std::floating_point<From> || is_float16_v<From>)
+                                       && (std::floating_point<To> || is_float16_v<To>) && sizeof(To) < sizeof(From);
+
+        /*
+         * @return false if a finite valid value becomes infinite when converted to To.
+         */
+        template <class To, class From>
+        bool check_finite_conversion(const From* values, const bitmap_word_reader& validity)
+        {
+            bool res = true;
+            for (std::size_t i = 0; i < validity.word_count(); ++i)
+            {
+                const bitmap_word valid = validity.word(i);
+                const std::size_t first = i * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, validity.size() - first);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    const From value = values[first + j];
+                    const bool overflows = std::isfinite(to_double(value))
+                                           && !std::isfinite(to_double(convert_value<To>(value)));
+                    res = res && (((valid >> j) & 1u) == 0u || !overflows);
+                }
+            }
+            return res;
+        }
+
+        /*
+         * @return false if a valid value cannot be represented in the type To.
+         */
+        template <class To, class From>
+        bool check_cast_range(const From* values, const bitmap_word_reader& validity)
+        {
+            if constexpr (std::integral<From> && std::integral<To>)
+            {
+                if constexpr (std::in_range<To>(std::numeric_limits<From>::min())
+                              && std::in_range<To>(std::numeric_limits<From>::max()))
+                {
+                    return true;
+                }
+                else
+                {
+                    const auto range = compute_valid_value_range(values, validity);
+                    return std::in_range<To>(range.min) && std::in_range<To>(range.max);
+                }
+            }
+            else if constexpr (std::floating_point<From> && std::integral<To>)
+            {
+                const auto range = compute_valid_value_range(values, validity);
+                return !range.has_nan && range.min >= integral_low_bound<To>()
+                       && range.max < integral_high_bound<To>();
+            }
+            else if constexpr (std::integral<From> && is_float16_v<To>)
+            {
+                const auto range = compute_valid_value_range(values, validity);
+                const double max = to_double(std::numeric_limits<To>::max());
+                return to_double(range.min) >= -max && to_double(range.max) <= max;
+            }
+            else if constexpr (narrowing_float_cast<To, From>)
+            {
+                return check_finite_conversion<To>(values, validity);
+            }
+            else
+            {
+                // Conversions to wider floating point types are exact, and integers are
+                // within the range of float and double.
+                return true;
+            }
+        }
+
+        /*
+         * @return The validity bitmap of the elements of data, starting at bit 0.
+         */
+        inline array_data::bitmap_type extract_validity(const array_data& data)
+        {
+            const bitmap_word_reader reader = make_validity_reader(data);
+            if (reader.all_set())
+            {
+                return array_data::bitmap_type(reader.size(), true);
+            }
+            return make_bitmap_from_words(
+                reader.size(),
+                [&reader](std::size_t i)
+                {
+                    return reader.word(i);
+                }
+            );
+        }
+
+        /*
+         * Parallel version of extract_validity.
+         */
+        inline array_data::bitmap_type extract_validity(const array_data& data, const parallel_options& options)
+        {
+            const bitmap_word_reader reader = make_validity_reader(data);
+            if (reader.all_set())
+            {
+                return array_data::bitmap_type(reader.size(), true);
+            }
+            return make_bitmap_from_words(
+                reader.size(),
+                [&reader](std::size_t i)
+                {
+                    return reader.word(i);
+                },
+                options
+            );
+        }
+
+        inline array_data make_cast_result(data_type id, array_data::bitmap_type bitmap, std::vector<array_data::buffer_type> buffers)
+        {
+            return {
+                .type = data_descriptor(id),
+                .length = static_cast<array_data::length_type>(bitmap.size()),
+                .offset = 0,
+                .bitmap = std::move(bitmap),
+                .buffers = std::move(buffers),
+                .child_data = {},
+                .dictionary = nullptr
+            };
+        }
+
+        [[noreturn]] inline void throw_cast_overflow()
+        {
+            throw std::overflow_error("cast: value out of the range of the target type");
+        }
+
+        template <class To, class From>
+        array_data cast_numeric(array_data data, cast_mode mode)
+        {
+            const std::size_t size = array_data_size(data);
+            const From* values = raw_value_reader<fixed_size_layout<From>>(data).data();
+            if (mode == cast_mode::safe && !check_cast_range<To>(values, make_validity_reader(data)))
+            {
+                throw_cast_overflow();
+            }
+
+            if constexpr (std::integral<From> && std::integral<To> && sizeof(From) == sizeof(To))
+            {
+                // Same bit layout: the buffers are reused as is, only the type changes.
+                data.type = data_descriptor(arrow_traits<To>::type_id);
+                return data;
+            }
+            else if constexpr (is_float16_v<From> && std::same_as<To, float>)
+            {
+                return convert_float_array_data<To, From>(data, convert_float16_to_float32);
+            }
+            else if constexpr (std::same_as<From, float> && is_float16_v<To>)
+            {
+                return convert_float_array_data<To, From>(data, convert_float32_to_float16);
+            }
+            else
+            {
+                array_data::buffer_type buffer(size * sizeof(To));
+                To* out = buffer.template data<To>();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    out[i] = convert_value<To>(values[i]);
+                }
+                return make_cast_result(arrow_traits<To>::type_id, extract_validity(data), {std::move(buffer)});
+            }
+        }
+
+        /*
+         * Matches the numeric conversions that convert the values one by one.
+         */
+        template <class To, class From>
+        concept element_wise_numeric_cast = cast_numeric_type<To> && cast_numeric_type<From>
+                                            && !std::same_as<To, From>
+                                            && !(std::integral<From> && std::integral<To> && sizeof(From) == sizeof(To))
+                                            && !(is_float16_v<From> && std::same_as<To, float>)
+                                            && !(std::same_as<From, float> && is_float16_v<To>);
+
+        /*
+         * Parallel version of cast_numeric: the range check and the conversion of each
+         * morsel run in a different task.
+         */
+        template <class To, class From>
+            requires element_wise_numeric_cast<To, From>
+        array_data cast_numeric(const array_data& data, cast_mode mode, const parallel_options& options)
+        {
+            const std::size_t size = array_data_size(data);
+            const From* values = raw_value_reader<fixed_size_layout<From>>(data).data();
+            if (mode == cast_mode::safe)
+            {
+                const bool in_range = parallel_reduce(
+                    size,
+                    options,
+                    true,
+                    [&data, values](const morsel& m)
+                    {
+                        return check_cast_range<To>(values + m.begin, make_validity_reader(data, m));
+                    },
+                    [](bool& res, bool morsel_in_range)
+                    {
+                        res = res && morsel_in_range;
+                    }
+                );
+                if (!in_range)
+                {
+                    throw_cast_overflow();
+                }
+            }
+
+            array_data::buffer_type buffer(size * sizeof(To));
+            To* out = buffer.template data<To>();
+            parallel_for_chunks(
+                size,
+                options.morsel_size,
+                [values, out](const morsel& m)
+                {
+                    for (std::size_t i = m.begin; i < m.end; ++i)
+                    {
+                        out[i] = convert_value<To>(values[i]);
+                    }
+                },
+                resolve_pool(options)
+            );
+            return make_cast_result(
+                arrow_traits<To>::type_id,
+                extract_validity(data, options),
+                {std::move(buffer)}
+            );
+        }
+
+#if defined(__cpp_lib_to_chars)
+        template <class T>
+            requires std::same_as<T, float> || std::same_as<T, double>
+        std::from_chars_result parse_floating(const char* first, const char* last, T& value)
+        {
+            return std::from_chars(first, last, value);
+        }
+
+        template <class T>
+            requires std::same_as<T, float> || std::same_as<T, double>
+        std::to_chars_result format_floating(char* first, char* last, T value)
+        {
+            return std::to_chars(first, last, value);
+        }
+#else
+        /*
+         * Fallbacks for the standard libraries without floating-point from_chars and
+         * to_chars (libc++ before LLVM 20), based on strtod and snprintf. They accept and
+         * produce the same strings as the C locale: the decimal point of the current
+         * locale is replaced by '.'.
+         */
+        inline char locale_decimal_point()
+        {
+            return *std::localeconv()->decimal_point;
+        }
+
+        template <class T>
+            requires std::same_as<T, float> || std::same_as<T, double>
+        std::from_chars_result parse_floating(const char* first, const char* last, T& value)
+        {
+            // strtod skips leading spaces and accepts a plus sign, unlike from_chars
+            if (first == last || std::isspace(static_cast<unsigned char>(*first)) || *first == '+')
+            {
+                return {first, std::errc::invalid_argument};
+            }
+            std::string str(first, last);
+            std::ranges::replace(str, '.', locale_decimal_point());
+            const std::size_t digits = str[0] == '-' ? 1u : 0u;
+            if (str.size() > digits + 1u && str[digits] == '0'
+                && (str[digits + 1u] == 'x' || str[digits + 1u] == 'X'))
+            {
+                // from_chars does not parse hexadecimal numbers, and stops after the 0
+                value = T(0);
+                return {first + digits + 1u, std::errc()};
+            }
+            errno = 0;
+            char* end = nullptr;
+            const double parsed = std::strtod(str.c_str(), &end);
+            if (end == str.c_str())
+            {
+                return {first, std::errc::invalid_argument};
+            }
+            const char* ptr = first + (end - str.c_str());
+            if (errno == ERANGE
+                || (std::isfinite(parsed) && std::abs(parsed) > std::numeric_limits<T>::max()))
+            {
+                return {ptr, std::errc::result_out_of_range};
+            }
+            value = static_cast<T>(parsed);
+            return {ptr, std::errc()};
+        }
+
+        template <class T>
+            requires std::same_as<T, float> || std::same_as<T, double>
+        std::to_chars_result format_floating(char* first, char* last, T value)
+        {
+            // The shortest precision that reads back as the same value
+            std::array<char, 64> buffer{};
+            int length = 0;
+            for (int precision = 1; precision <= std::numeric_limits<T>::max_digits10; ++precision)
+            {
+                length = std::snprintf(
+                    buffer.data(),
+                    buffer.size(),
+                    "%.*g",
+                    precision,
+                    static_cast<double>(value)
+                );
+                if (!std::isfinite(value) || static_cast<T>(std::strtod(buffer.data(), nullptr)) == value)
+                {
+                    break;
+                }
+            }
+            const auto count = static_cast<std::size_t>(length);
+            if (length < 0 || count > static_cast<std::size_t>(last - first))
+            {
+                return {last, std::errc::value_too_large};
+            }
+            std::ranges::replace(buffer.begin(), buffer.begin() + length, locale_decimal_point(), '.');
+            return {std::copy(buffer.data(), buffer.data() + count, first), std::errc()};
+        }
+#endif
+
+        template <class T>
+        std::from_chars_result parse_number(std::string_view str, T& value)
+        {
+            const char* first = str.data();
+            const char* last = str.data() + str.size();
+            if constexpr (is_float16_v<T>)
+            {
+                float f = 0.f;
+                const std::from_chars_result res = parse_floating(first, last, f);
+                value = T(f);
+                return res;
+            }
+            else if constexpr (std::floating_point<T>)
+            {
+                return parse_floating(first, last, value);
+            }
+            else
+            {
+                return std::from_chars(first, last, value);
+            }
+        }
+
+        template <class To>
+        array_data cast_from_string(const array_data& data, cast_mode mode)
+        {
+            using layout_type = typename arrow_traits<std::string>::default_layout;
+            const std::size_t size = array_data_size(data);
+            const raw_value_reader<layout_type> reader(data);
+            array_data::bitmap_type bitmap = extract_validity(data);
+            array_data::buffer_type buffer(size * sizeof(To));
+            To* out = buffer.template data<To>();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = To(0);
+                if (!bitmap.test(i))
+                {
+                    continue;
+                }
+                const std::string_view str = reader[i];
+                const std::from_chars_result res = parse_number(str, out[i]);
+                if (res.ec != std::errc() || res.ptr != str.data() + str.size())
+                {
+                    if (mode == cast_mode::safe)
+                    {
+                        if (res.ec == std::errc::result_out_of_range)
+                        {
+                            throw_cast_overflow();
+                        }
+                        throw std::invalid_argument("cast: cannot parse \"" + std::string(str) + "\" as a number");
+                    }
+                    bitmap.set(i, false);
+                    out[i] = To(0);
+                }
+            }
+            return make_cast_result(arrow_traits<To>::type_id, std::move(bitmap), {std::move(buffer)});
+        }
+
+        template <class From>
+        array_data cast_to_string(const array_data& data)
+        {
+            using offset_type = std::int64_t;
+            // Large enough for any integer and for the shortest representation of any double.
+            constexpr std::size_t max_chars = 32;
+            // Most numbers are shorter than that: the buffer starts with this many
+            // characters per value and grows geometrically.
+            constexpr std::size_t expected_chars = 8;
+            const std::size_t size = array_data_size(data);
+            const From* values = raw_value_reader<fixed_size_layout<From>>(data).data();
+            array_data::bitmap_type bitmap = extract_validity(data);
+
+            array_data::buffer_type offsets_buffer((size + 1) * sizeof(offset_type));
+            offset_type* offsets = offsets_buffer.template data<offset_type>();
+            // Numbers are written in place, and the buffer is shrunk once every value has
+            // been formatted.
+            array_data::buffer_type chars_buffer(std::max(size * expected_chars, max_chars));
+            offsets[0] = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const auto position = static_cast<std::size_t>(offsets[i]);
+                if (chars_buffer.size() - position < max_chars)
+                {
+                    chars_buffer.resize(2u * chars_buffer.size());
+                }
+                char* first = chars_buffer.template data<char>() + position;
+                char* last = first;
+                if (bitmap.test(i))
+                {
+                    std::to_chars_result res{};
+                    if constexpr (is_float16_v<From>)
+                    {
+                        res = format_floating(first, first + max_chars, static_cast<float>(values[i]));
+                    }
+                    else if constexpr (std::floating_point<From>)
+                    {
+                        res = format_floating(first, first + max_chars, values[i]);
+                    }
+                    else
+                    {
+                        res = std::to_chars(first, first + max_chars, values[i]);
+                    }
+                    SPARROW_ASSERT_TRUE(res.ec == std::errc());
+                    last = res.ptr;
+                }
+                const offset_type length = last - first;
+                offsets[i + 1] = offsets[i] + length;
+            }
+            chars_buffer.resize(static_cast<std::size_t>(offsets[size]));
+            chars_buffer.shrink_to_fit();
+
+            std::vector<array_data::buffer_type> buffers;
+            buffers.reserve(2);
+            buffers.push_back(std::move(offsets_buffer));
+            buffers.push_back(std::move(chars_buffer));
+            return make_cast_result(data_type::STRING, std::move(bitmap), std::move(buffers));
+        }
+
+        inline array_data cast_to_timestamp(const array_data& data)
+        {
+            const std::size_t size = array_data_size(data);
+            const std::int64_t* values = raw_value_reader<fixed_size_layout<std::int64_t>>(data).data();
+            array_data::buffer_type buffer(size * sizeof(timestamp));
+            timestamp* out = buffer.template data<timestamp>();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = timestamp(std::chrono::sys_time<std::chrono::nanoseconds>(std::chrono::nanoseconds(values[i])));
+            }
+            return make_cast_result(data_type::TIMESTAMP, extract_validity(data), {std::move(buffer)});
+        }
+
+        inline array_data cast_from_timestamp(const array_data& data)
+        {
+            const std::size_t size = array_data_size(data);
+            const timestamp* values = raw_value_reader<fixed_size_layout<timestamp>>(data).data();
+            array_data::buffer_type buffer(size * sizeof(std::int64_t));
+            std::int64_t* out = buffer.template data<std::int64_t>();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = values[i].get_sys_time().time_since_epoch().count();
+            }
+            return make_cast_result(data_type::INT64, extract_validity(data), {std::move(buffer)});
+        }
+    }
+
+    /**
+     * Converts the values of an array_data holding elements of type From to the type To.
+     *
+     * When From and To are integers of the same size, the buffers are reinterpreted
+     * instead of being copied: passing an rvalue avoids any copy in that case.
+     *
+     * @tparam To The target type.
+     * @tparam From The type of the elements of \p data.
+     * @param data The array_data to convert.
+     * @param mode The behavior on values that cannot be represented in the target type.
+     * @return The converted array_data, with an offset of 0. Null elements stay null.
+     * @throws std::overflow_error in safe mode, if a valid value is out of the range of To.
+     * @throws std::invalid_argument in safe mode, if a string cannot be parsed as a number.
+     */
+    template <class To, class From>
+        requires castable_types<To, From> || std::same_as<To, From>
+    array_data cast_array_data(array_data data, cast_mode mode = cast_mode::safe)
+    {
+        if constexpr (std::same_as<To, From>)
+        {
+            return data;
+        }
+        else if constexpr (std::same_as<From, std::string>)
+        {
+            return impl::cast_from_string<To>(data, mode);
+        }
+        else if constexpr (std::same_as<To, std::string>)
+        {
+            return impl::cast_to_string<From>(data);
+        }
+        else if constexpr (std::same_as<To, timestamp>)
+        {
+            return impl::cast_to_timestamp(data);
+        }
+        else if constexpr (std::same_as<From, timestamp>)
+        {
+            return impl::cast_from_timestamp(data);
+        }
+        else
+        {
+            return impl::cast_numeric<To, From>(std::move(data), mode);
+        }
+    }
+
+    /**
+     * Converts the values of an array to the type To.
+     *
+     * @tparam To The target type.
+     * @param array The array to convert.
+     * @param mode The behavior on values that cannot be represented in the target type.
+     * @return An array of the same size; null elements stay null.
+     * @throws std::overflow_error in safe mode, if a valid value is out of the range of To.
+     * @throws std::invalid_argument in safe mode, if a string cannot be parsed as a number.
+     * @see cast_array_data
+     */
+    template <class To, class From>
+        requires castable_types<To, From> || std::same_as<To, From>
+    typed_array<To> cast(const typed_array<From>& array, cast_mode mode = cast_mode::safe)
+    {
+        return typed_array<To>(cast_array_data<To, From>(array.get_data(), mode));
+    }
+
+    /**
+     * Parallel version of cast.
+     *
+     * Numeric conversions that convert the values one by one are split in morsels run
+     * by the tasks of `options.pool`; the other conversions either reuse the buffers or
+     * run sequentially.
+     *
+     * @see cast
+     */
+    template <class To, class From>
+        requires castable_types<To, From> || std::same_as<To, From>
+    typed_array<To> cast(const typed_array<From>& array, cast_mode mode, const parallel_options& options)
+    {
+        if constexpr (impl::element_wise_numeric_cast<To, From>)
+        {
+            return typed_array<To>(impl::cast_numeric<To, From>(array.get_data(), mode, options));
+        }
+        else
+        {
+            return cast<To>(array, mode);
+        }
+    }
+}
@@ -0,0 +1,606 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array.hpp"
+#include "sparrow/array_data.hpp"
+#include "sparrow/concatenate.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/iterator.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    namespace impl
+    {
+        /*
+         * Prefix sums of the sizes of the chunks of a chunked array: the chunk holding a
+         * row is found by binary search.
+         */
+        class chunk_index
+        {
+        public:
+
+            using size_type = std::size_t;
+
+            size_type size() const noexcept
+            {
+                return m_offsets.back();
+            }
+
+            void push_back(size_type chunk_size)
+            {
+                m_offsets.push_back(m_offsets.back() + chunk_size);
+            }
+
+            void clear()
+            {
+                m_offsets.assign(1u, 0u);
+            }
+
+            /*
+             * @return The first row of the chunk i.
+             */
+            size_type chunk_offset(size_type i) const
+            {
+                return m_offsets[i];
+            }
+
+            /*
+             * @return The chunk holding the row i, and the position of the row in it.
+             */
+            std::pair<size_type, size_type> locate(size_type i) const
+            {
+                SPARROW_ASSERT_TRUE(i < size());
+                const auto it = std::upper_bound(m_offsets.begin(), m_offsets.end(), i);
+                const auto chunk = static_cast<size_type>(std::distance(m_offsets.begin(), it)) - 1u;
+                return {chunk, i - m_offsets[chunk]};
+            }
+
+            [[noreturn]] void throw_out_of_range(std::string_view method, size_type i) const
+            {
+                throw std::out_of_range(
+                    std::string(method) + ": index out of range for chunked array of size "
+                    + std::to_string(size()) + " at index " + std::to_string(i)
+                );
+            }
+
+        private:
+
+            std::vector<size_type> m_offsets = {0u};
+        };
+
+        /*
+         * Splits chunks in runs of consecutive chunks with at least target_rows rows, the
+         * last run excepted. Chunks that reach target_rows by themselves form their own run,
+         * and end the run of smaller chunks preceding them, so that they are never copied.
+         * Calls f(first, last) for each run [first, last).
+         */
+        template <class F>
+        void
+        for_each_chunk_run(const chunk_index& index, std::size_t chunk_count, std::size_t target_rows, F&& f)
+        {
+            const auto is_large = [&index, target_rows](std::size_t i)
+            {
+                return index.chunk_offset(i + 1u) - index.chunk_offset(i) >= target_rows;
+            };
+            std::size_t first = 0;
+            while (first < chunk_count)
+            {
+                std::size_t last = first + 1u;
+                if (!is_large(first))
+                {
+                    while (last < chunk_count
+                           && index.chunk_offset(last) - index.chunk_offset(first) < target_rows
+                           && !is_large(last))
+                    {
+                        ++last;
+                    }
+                }
+                f(first, last);
+                first = last;
+            }
+        }
+    }
+
+    /**
+     * One logical array made of several typed_array chunks.
+     *
+     * Chunks are moved in when they are appended, so that gathering batches never
+     * copies their buffers. Random access finds the chunk holding an element by binary
+     * search on the prefix sums of the chunk sizes, in O(log k) for k chunks; iterators
+     * and for_each_chunk walk the chunks one after the other instead.
+     *
+     * @tparam T The type of the elements.
+     * @tparam Layout The layout of the chunks.
+     */
+    template <class T, class Layout = typename arrow_traits<T>::default_layout>
+    class chunked_array
+    {
+    public:
+
+        using chunk_type = typed_array<T, Layout>;
+        using value_type = typename chunk_type::value_type;
+        using const_reference = typename chunk_type::const_reference;
+        using size_type = std::size_t;
+
+        class const_iterator;
+
+        chunked_array() = default;
+
+        explicit chunked_array(std::vector<chunk_type> chunks);
+
+        /**
+         * Appends a chunk; its buffers are moved, not copied.
+         */
+        void push_back(chunk_type chunk);
+
+        /**
+         * Appends a chunk built from \p data.
+         */
+        void push_back(array_data data);
+
+        bool empty() const;
+        size_type size() const;
+
+        size_type chunk_count() const;
+        const chunk_type& chunk(size_type i) const;
+
+        /**
+         * @return The first row of the chunk \p i.
+         */
+        size_type chunk_offset(size_type i) const;
+
+        const_reference at(size_type i) const;
+        const_reference operator[](size_type i) const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        /**
+         * Calls `f(chunk, offset)` for each chunk, offset being the first row of the chunk.
+         */
+        template <class F>
+        void for_each_chunk(F&& f) const;
+
+        /**
+         * Coalesces consecutive chunks smaller than \p target_rows with concatenate, so
+         * that every chunk but the last has at least \p target_rows rows. Chunks that are
+         * large enough are moved as is.
+         *
+         * @pre \p target_rows must be positive.
+         */
+        void rechunk(size_type target_rows);
+
+    private:
+
+        std::vector<chunk_type> m_chunks;
+        impl::chunk_index m_index;
+    };
+
+    /**
+     * Iterator over the elements of a chunked_array, running the iterator of each chunk
+     * in turn.
+     */
+    template <class T, class Layout>
+    class chunked_array<T, Layout>::const_iterator
+        : public iterator_base<const_iterator, value_type, std::forward_iterator_tag, const_reference>
+    {
+    public:
+
+        using chunk_iterator = typename chunk_type::const_iterator;
+
+        const_iterator() = default;
+
+        const_iterator(const chunked_array* array, size_type chunk);
+
+    private:
+
+        const_reference dereference() const;
+        void increment();
+        bool equal(const const_iterator& rhs) const;
+
+        // Moves to the first element of the next non-empty chunk if the current one is exhausted
+        void skip_exhausted_chunks();
+
+        const chunked_array* p_array = nullptr;
+        size_type m_chunk = 0;
+        chunk_iterator m_iter;
+        chunk_iterator m_chunk_end;
+
+        friend class iterator_access;
+    };
+
+    /**
+     * Type-erased counterpart of chunked_array: one logical array made of several array
+     * chunks with the same data type.
+     */
+    class chunked_column
+    {
+    public:
+
+        using const_reference = array::const_reference;
+        using size_type = std::size_t;
+
+        chunked_column() = default;
+
+        explicit chunked_column(std::vector<array> chunks);
+
+        /**
+         * Appends a chunk; copying an array does not copy its buffers.
+         *
+         * @throws std::invalid_argument if the data type of \p chunk differs from the
+         *         data type of the previous chunks.
+         */
+        void push_back(array chunk);
+
+        void push_back(array_data data);
+
+        bool empty() const;
+        size_type size() const;
+
+        size_type chunk_count() const;
+        const array& chunk(size_type i) const;
+        size_type chunk_offset(size_type i) const;
+
+        const_reference at(size_type i) const;
+        const_reference operator[](size_type i) const;
+
+        /**
+         * Calls `f(chunk, offset)` for each chunk, offset being the first row of the chunk.
+         * Kernels should dispatch once per chunk with array::visit.
+         */
+        template <class F>
+        void for_each_chunk(F&& f) const;
+
+        /**
+         * @see chunked_array::rechunk
+         */
+        void rechunk(size_type target_rows);
+
+    private:
+
+        std::vector<array> m_chunks;
+        std::vector<data_type> m_types;
+        impl::chunk_index m_index;
+    };
+
+    /********************************
+     * chunked_array implementation *
+     ********************************/
+
+    template <class T, class L>
+    chunked_array<T, L>::chunked_array(std::vector<chunk_type> chunks)
+        : m_chunks(std::move(chunks))
+    {
+        for (const chunk_type& c : m_chunks)
+        {
+            m_index.push_back(c.size());
+        }
+    }
+
+    template <class T, class L>
+    void chunked_array<T, L>::push_back(chunk_type chunk)
+    {
+        m_index.push_back(chunk.size());
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    template <class T, class L>
+    void chunked_array<T, L>::push_back(array_data data)
+    {
+        push_back(chunk_type(std::move(data)));
+    }
+
+    template <class T, class L>
+    bool chunked_array<T, L>::empty() const
+    {
+        return size() == 0u;
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::size() const -> size_type
+    {
+        return m_index.size();
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::chunk_count() const -> size_type
+    {
+        return m_chunks.size();
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::chunk(size_type i) const -> const chunk_type&
+    {
+        SPARROW_ASSERT_TRUE(i < chunk_count());
+        return m_chunks[i];
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::chunk_offset(size_type i) const -> size_type
+    {
+        SPARROW_ASSERT_TRUE(i <= chunk_count());
+        return m_index.chunk_offset(i);
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::at(size_type i) const -> const_reference
+    {
+        if (i >= size())
+        {
+            m_index.throw_out_of_range("chunked_array::at", i);
+        }
+        return (*this)[i];
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::operator[](size_type i) const -> const_reference
+    {
+        const auto [chunk, row] = m_index.locate(i);
+        return m_chunks[chunk][row];
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::begin() const -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::end() const -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::cbegin() const -> const_iterator
+    {
+        return const_iterator(this, 0u);
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::cend() const -> const_iterator
+    {
+        return const_iterator(this, chunk_count());
+    }
+
+    template <class T, class L>
+    template <class F>
+    void chunked_array<T, L>::for_each_chunk(F&& f) const
+    {
+        for (size_type i = 0; i < m_chunks.size(); ++i)
+        {
+            f(m_chunks[i], m_index.chunk_offset(i));
+        }
+    }
+
+    template <class T, class L>
+    void chunked_array<T, L>::rechunk(size_type target_rows)
+    {
+        SPARROW_ASSERT_TRUE(target_rows > 0u);
+        std::vector<chunk_type> chunks;
+        // Reserved so that the chunks kept as they are are not copied on reallocation
+        chunks.reserve(m_chunks.size());
+        impl::for_each_chunk_run(
+            m_index,
+            m_chunks.size(),
+            target_rows,
+            [this, &chunks](size_type first, size_type last)
+            {
+                if (last - first == 1u)
+                {
+                    chunks.push_back(std::move(m_chunks[first]));
+                }
+                else
+                {
+                    const std::span<const chunk_type> run(m_chunks.data() + first, last - first);
+                    chunks.push_back(concatenate(run));
+                }
+            }
+        );
+        m_chunks = std::move(chunks);
+        m_index.clear();
+        for (const chunk_type& c : m_chunks)
+        {
+            m_index.push_back(c.size());
+        }
+    }
+
+    /*************************************************
+     * chunked_array::const_iterator implementation *
+     *************************************************/
+
+    template <class T, class L>
+    chunked_array<T, L>::const_iterator::const_iterator(const chunked_array* array, size_type chunk)
+        : p_array(array)
+        , m_chunk(chunk)
+    {
+        if (m_chunk < p_array->chunk_count())
+        {
+            m_iter = p_array->m_chunks[m_chunk].cbegin();
+            m_chunk_end = p_array->m_chunks[m_chunk].cend();
+            skip_exhausted_chunks();
+        }
+    }
+
+    template <class T, class L>
+    auto chunked_array<T, L>::const_iterator::dereference() const -> const_reference
+    {
+        return *m_iter;
+    }
+
+    template <class T, class L>
+    void chunked_array<T, L>::const_iterator::increment()
+    {
+        ++m_iter;
+        skip_exhausted_chunks();
+    }
+
+    template <class T, class L>
+    bool chunked_array<T, L>::const_iterator::equal(const const_iterator& rhs) const
+    {
+        if (p_array != rhs.p_array || m_chunk != rhs.m_chunk)
+        {
+            return false;
+        }
+        return p_array == nullptr || m_chunk == p_array->chunk_count() || m_iter == rhs.m_iter;
+    }
+
+    template <class T, class L>
+    void chunked_array<T, L>::const_iterator::skip_exhausted_chunks()
+    {
+        while (m_iter == m_chunk_end)
+        {
+            ++m_chunk;
+            if (m_chunk == p_array->chunk_count())
+            {
+                return;
+            }
+            m_iter = p_array->m_chunks[m_chunk].cbegin();
+            m_chunk_end = p_array->m_chunks[m_chunk].cend();
+        }
+    }
+
+    /*********************************
+     * chunked_column implementation *
+     *********************************/
+
+    inline chunked_column::chunked_column(std::vector<array> chunks)
+    {
+        m_chunks.reserve(chunks.size());
+        for (array& c : chunks)
+        {
+            push_back(std::move(c));
+        }
+    }
+
+    inline void chunked_column::push_back(array chunk)
+    {
+        const data_type type = chunk.get_data().type.id();
+        if (!m_types.empty() && type != m_types.front())
+        {
+            throw std::invalid_argument(
+                "chunked_column::push_back: all the chunks must have the same data type"
+            );
+        }
+        m_index.push_back(chunk.size());
+        m_types.push_back(type);
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    inline void chunked_column::push_back(array_data data)
+    {
+        push_back(array(std::move(data)));
+    }
+
+    inline bool chunked_column::empty() const
+    {
+        return size() == 0u;
+    }
+
+    inline auto chunked_column::size() const -> size_type
+    {
+        return m_index.size();
+    }
+
+    inline auto chunked_column::chunk_count() const -> size_type
+    {
+        return m_chunks.size();
+    }
+
+    inline const array& chunked_column::chunk(size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < chunk_count());
+        return m_chunks[i];
+    }
+
+    inline auto chunked_column::chunk_offset(size_type i) const -> size_type
+    {
+        SPARROW_ASSERT_TRUE(i <= chunk_count());
+        return m_index.chunk_offset(i);
+    }
+
+    inline auto chunked_column::at(size_type i) const -> const_reference
+    {
+        if (i >= size())
+        {
+            m_index.throw_out_of_range("chunked_column::at", i);
+        }
+        return (*this)[i];
+    }
+
+    inline auto chunked_column::operator[](size_type i) const -> const_reference
+    {
+        const auto [chunk, row] = m_index.locate(i);
+        return m_chunks[chunk][row];
+    }
+
+    template <class F>
+    void chunked_column::for_each_chunk(F&& f) const
+    {
+        for (size_type i = 0; i < m_chunks.size(); ++i)
+        {
+            f(m_chunks[i], m_index.chunk_offset(i));
+        }
+    }
+
+    inline void chunked_column::rechunk(size_type target_rows)
+    {
+        SPARROW_ASSERT_TRUE(target_rows > 0u);
+        std::vector<array> chunks;
+        chunks.reserve(m_chunks.size());
+        impl::for_each_chunk_run(
+            m_index,
+            m_chunks.size(),
+            target_rows,
+            [this, &chunks](size_type first, size_type last)
+            {
+                if (last - first == 1u)
+                {
+                    chunks.push_back(std::move(m_chunks[first]));
+                    return;
+                }
+                std::vector<const array_data*> data;
+                data.reserve(last - first);
+                for (size_type i = first; i < last; ++i)
+                {
+                    data.push_back(&m_chunks[i].get_data());
+                }
+                chunks.emplace_back(concatenate(std::span<const array_data* const>(data)));
+            }
+        );
+        m_chunks.clear();
+        m_types.clear();
+        m_index.clear();
+        for (array& c : chunks)
+        {
+            push_back(std::move(c));
+        }
+    }
+}
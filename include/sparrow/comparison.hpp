@@ -0,0 +1,530 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_statistics.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/packed_boolean_array.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    namespace impl
+    {
+        /*
+         * Projections applied to the elements before they are compared. Values are
+         * compared as is, except:
+         * - float16_t, compared as float to get the IEEE semantic;
+         * - timestamp, compared as time points (the time zone is ignored);
+         * - strings, compared as string views.
+         */
+        template <class T>
+        const T& comparison_key(const T& value)
+        {
+            return value;
+        }
+
+#if !defined(SPARROW_STD_FIXED_FLOAT_SUPPORT)
+        inline float comparison_key(const float16_t& value)
+        {
+            return static_cast<float>(value);
+        }
+#endif
+
+        inline auto comparison_key(const timestamp& value)
+        {
+            return value.get_sys_time();
+        }
+
+        inline std::string_view comparison_key(const std::string& value)
+        {
+            return value;
+        }
+
+        /*
+         * @return The function computing the word i of `pred(j)` for the elements j of a
+         * range of size elements.
+         */
+        template <class Pred>
+        auto predicate_words(std::size_t size, const Pred& pred)
+        {
+            return [&pred, size](std::size_t i)
+            {
+                const std::size_t first = i * bitmap_word_bits;
+                return predicate_word(pred, first, std::min(bitmap_word_bits, size - first));
+            };
+        }
+
+        /*
+         * Builds the result of a comparison kernel: the validity is the intersection of
+         * the given validities, and the value bits are given by `value_word(i)` for valid
+         * elements. The bitmaps are built by `make_bitmap(size, word_at)`.
+         */
+        template <class MakeBitmap, class W, class... R>
+        packed_boolean_array
+        build_comparison_result(const MakeBitmap& make_bitmap, std::size_t size, const W& value_word, const R&... validities)
+        {
+            SPARROW_ASSERT_TRUE(((validities.size() == size) && ...));
+            if ((validities.all_set() && ...))
+            {
+                return packed_boolean_array(make_bitmap(size, value_word), array_data::bitmap_type(size, true));
+            }
+            array_data::bitmap_type validity = make_bitmap(
+                size,
+                [&validities...](std::size_t i)
+                {
+                    return (validities.word(i) & ...);
+                }
+            );
+            const bitmap_word_reader validity_reader(validity, 0u, size);
+            array_data::bitmap_type values = make_bitmap(
+                size,
+                [&value_word, &validity_reader](std::size_t i)
+                {
+                    return value_word(i) & validity_reader.word(i);
+                }
+            );
+            return packed_boolean_array(std::move(values), std::move(validity));
+        }
+
+        template <class W, class... R>
+        packed_boolean_array make_word_comparison_result(std::size_t size, const W& value_word, const R&... validities)
+        {
+            return build_comparison_result(
+                [](std::size_t n, const auto& word_at)
+                {
+                    return make_bitmap_from_words(n, word_at);
+                },
+                size,
+                value_word,
+                validities...
+            );
+        }
+
+        template <class Pred, class... R>
+        packed_boolean_array make_comparison_result(std::size_t size, const Pred& pred, const R&... validities)
+        {
+            return make_word_comparison_result(size, predicate_words(size, pred), validities...);
+        }
+
+        /*
+         * Parallel version of make_comparison_result: each morsel of words is computed
+         * by a different task.
+         */
+        template <class W, class... R>
+        packed_boolean_array make_word_comparison_result(
+            const parallel_options& options,
+            std::size_t size,
+            const W& value_word,
+            const R&... validities
+        )
+        {
+            return build_comparison_result(
+                [&options](std::size_t n, const auto& word_at)
+                {
+                    return make_bitmap_from_words(n, word_at, options);
+                },
+                size,
+                value_word,
+                validities...
+            );
+        }
+
+        template <class Pred, class... R>
+        packed_boolean_array make_comparison_result(
+            const parallel_options& options,
+            std::size_t size,
+            const Pred& pred,
+            const R&... validities
+        )
+        {
+            return make_word_comparison_result(options, size, predicate_words(size, pred), validities...);
+        }
+
+        /*
+         * Result shared by all the elements of a block of a zone map, when the bounds of
+         * the block decide it.
+         */
+        enum class zone_outcome : std::uint8_t
+        {
+            unknown,
+            all_false,
+            all_true
+        };
+
+        template <class Cmp>
+        concept threshold_comparison = std::same_as<Cmp, std::less<>> || std::same_as<Cmp, std::less_equal<>>
+                                       || std::same_as<Cmp, std::greater<>>
+                                       || std::same_as<Cmp, std::greater_equal<>>;
+
+        /*
+         * Whether a scalar compared with the elements of an array is NaN: the bounds of
+         * the blocks of the zone map cannot decide such comparisons.
+         */
+        template <class U>
+        bool is_nan_scalar(const U& value)
+        {
+            if constexpr (std::floating_point<U>)
+            {
+                return std::isnan(value);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        /*
+         * Deduces `cmp(value, rhs)` for all the values of [min, max], for the standard
+         * comparison function objects; the result of any other comparison is unknown.
+         */
+        template <class K, class U, class Cmp>
+        zone_outcome compare_bounds(const K& min, const K& max, const U& rhs, const Cmp& cmp)
+        {
+            if (is_nan_scalar(rhs))
+            {
+                return zone_outcome::unknown;
+            }
+            const auto outcome = [](bool all_true)
+            {
+                return all_true ? zone_outcome::all_true : zone_outcome::all_false;
+            };
+            if constexpr (threshold_comparison<Cmp>)
+            {
+                const bool min_result = cmp(min, rhs);
+                return min_result == cmp(max, rhs) ? outcome(min_result) : zone_outcome::unknown;
+            }
+            else if constexpr (std::same_as<Cmp, std::equal_to<>> || std::same_as<Cmp, std::not_equal_to<>>)
+            {
+                constexpr bool is_equal = std::same_as<Cmp, std::equal_to<>>;
+                if (rhs < min || max < rhs)
+                {
+                    return outcome(!is_equal);
+                }
+                return min < max ? zone_outcome::unknown : outcome(is_equal);
+            }
+            else
+            {
+                return zone_outcome::unknown;
+            }
+        }
+
+        /*
+         * Deduces `low <= value && value <= high` for all the values of [min, max].
+         */
+        template <class K, class U>
+        zone_outcome between_bounds(const K& min, const K& max, const U& low, const U& high)
+        {
+            if (is_nan_scalar(low) || is_nan_scalar(high))
+            {
+                return zone_outcome::unknown;
+            }
+            if (max < low || high < min)
+            {
+                return zone_outcome::all_false;
+            }
+            return low <= min && max <= high ? zone_outcome::all_true : zone_outcome::unknown;
+        }
+
+        /*
+         * Computes the words of the values of a comparison with a scalar, `pred(i)` for the
+         * element i. When statistics are cached for the array, the blocks of its zone map
+         * whose bounds decide the comparison, according to `bounds(min, max)`, are filled
+         * without reading the elements.
+         */
+        template <class A, class Pred, class Bounds>
+        auto zone_pruned_words(const A& array, const Pred& pred, const Bounds& bounds)
+        {
+            std::vector<zone_outcome> outcomes;
+            std::size_t block_size = bitmap_word_bits;
+            if (const auto statistics = array.cached_statistics())
+            {
+                block_size = statistics->block_size;
+                outcomes.reserve(statistics->zones.size());
+                for (const auto& zone : statistics->zones)
+                {
+                    if (zone.nan_count != 0u)
+                    {
+                        outcomes.push_back(zone_outcome::unknown);
+                    }
+                    else if (!zone.min.has_value())
+                    {
+                        // Only null elements, whose value bits are cleared
+                        outcomes.push_back(zone_outcome::all_false);
+                    }
+                    else
+                    {
+                        outcomes.push_back(bounds(comparison_key(*zone.min), comparison_key(*zone.max)));
+                    }
+                }
+            }
+            return [words = predicate_words(array.size(), pred),
+                    outcomes = std::move(outcomes),
+                    block_words = block_size / bitmap_word_bits,
+                    size = array.size()](std::size_t i)
+            {
+                const zone_outcome outcome = outcomes.empty() ? zone_outcome::unknown : outcomes[i / block_words];
+                switch (outcome)
+                {
+                    case zone_outcome::all_false:
+                        return bitmap_word(0);
+                    case zone_outcome::all_true:
+                        return low_bits_mask(size - i * bitmap_word_bits);
+                    default:
+                        return words(i);
+                }
+            };
+        }
+    }
+
+    /**
+     * Matches typed arrays that the comparison kernels support, that is arrays whose values
+     * are stored in a fixed size layout or in a variable size binary layout.
+     */
+    template <class A>
+    concept comparable_typed_array = is_typed_array_v<A> && raw_readable_layout<typename A::layout_type>;
+
+    /**
+     * Compares two arrays element-wise.
+     *
+     * The result is null where any of the operands is null, and `cmp(lhs[i], rhs[i])`
+     * otherwise. The results are computed and packed 64 at a time.
+     *
+     * @param lhs The left operand.
+     * @param rhs The right operand.
+     * @param cmp The comparison function object, such as `std::less<>`.
+     * @pre \p lhs and \p rhs must have the same size.
+     */
+    template <comparable_typed_array A, class Cmp>
+    packed_boolean_array compare(const A& lhs, const A& rhs, Cmp cmp)
+    {
+        SPARROW_ASSERT_TRUE(lhs.size() == rhs.size());
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type lhs_values(lhs.get_data());
+        const reader_type rhs_values(rhs.get_data());
+        return impl::make_comparison_result(
+            lhs.size(),
+            [&](std::size_t i)
+            {
+                return cmp(impl::comparison_key(lhs_values[i]), impl::comparison_key(rhs_values[i]));
+            },
+            make_validity_reader(lhs.get_data()),
+            make_validity_reader(rhs.get_data())
+        );
+    }
+
+    /**
+     * Compares each element of an array to a scalar.
+     *
+     * The result is null where \p lhs is null, and `cmp(lhs[i], rhs)` otherwise.
+     *
+     * @param lhs The array operand.
+     * @param rhs The scalar operand.
+     * @param cmp The comparison function object, such as `std::less<>`.
+     */
+    template <comparable_typed_array A, class U, class Cmp>
+        requires(!is_typed_array_v<U>)
+    packed_boolean_array compare(const A& lhs, const U& rhs, Cmp cmp)
+    {
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type lhs_values(lhs.get_data());
+        const auto& rhs_key = impl::comparison_key(rhs);
+        const auto pred = [&](std::size_t i)
+        {
+            return cmp(impl::comparison_key(lhs_values[i]), rhs_key);
+        };
+        return impl::make_word_comparison_result(
+            lhs.size(),
+            impl::zone_pruned_words(
+                lhs,
+                pred,
+                [&](const auto& min, const auto& max)
+                {
+                    return impl::compare_bounds(min, max, rhs_key, cmp);
+                }
+            ),
+            make_validity_reader(lhs.get_data())
+        );
+    }
+
+    /**
+     * Parallel version of compare for two arrays: the morsels of the result are
+     * computed by the tasks of `options.pool`.
+     */
+    template <comparable_typed_array A, class Cmp>
+    packed_boolean_array compare(const A& lhs, const A& rhs, Cmp cmp, const parallel_options& options)
+    {
+        SPARROW_ASSERT_TRUE(lhs.size() == rhs.size());
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type lhs_values(lhs.get_data());
+        const reader_type rhs_values(rhs.get_data());
+        return impl::make_comparison_result(
+            options,
+            lhs.size(),
+            [&](std::size_t i)
+            {
+                return cmp(impl::comparison_key(lhs_values[i]), impl::comparison_key(rhs_values[i]));
+            },
+            make_validity_reader(lhs.get_data()),
+            make_validity_reader(rhs.get_data())
+        );
+    }
+
+    /**
+     * Parallel version of compare for an array and a scalar.
+     */
+    template <comparable_typed_array A, class U, class Cmp>
+        requires(!is_typed_array_v<U>)
+    packed_boolean_array compare(const A& lhs, const U& rhs, Cmp cmp, const parallel_options& options)
+    {
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type lhs_values(lhs.get_data());
+        const auto& rhs_key = impl::comparison_key(rhs);
+        const auto pred = [&](std::size_t i)
+        {
+            return cmp(impl::comparison_key(lhs_values[i]), rhs_key);
+        };
+        return impl::make_word_comparison_result(
+            options,
+            lhs.size(),
+            impl::zone_pruned_words(
+                lhs,
+                pred,
+                [&](const auto& min, const auto& max)
+                {
+                    return impl::compare_bounds(min, max, rhs_key, cmp);
+                }
+            ),
+            make_validity_reader(lhs.get_data())
+        );
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array equal(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::equal_to<>{});
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array not_equal(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::not_equal_to<>{});
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array less(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::less<>{});
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array less_equal(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::less_equal<>{});
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array greater(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::greater<>{});
+    }
+
+    template <comparable_typed_array A, class U>
+    packed_boolean_array greater_equal(const A& lhs, const U& rhs)
+    {
+        return compare(lhs, rhs, std::greater_equal<>{});
+    }
+
+    /**
+     * Checks whether the elements of an array lie in a closed interval.
+     *
+     * @param values The array to check.
+     * @param low The lower bound of the interval, included.
+     * @param high The upper bound of the interval, included.
+     * @return An array whose element i is null where \p values is null, and
+     * `low <= values[i] && values[i] <= high` otherwise.
+     */
+    template <comparable_typed_array A, class U>
+        requires(!is_typed_array_v<U>)
+    packed_boolean_array between(const A& values, const U& low, const U& high)
+    {
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type reader(values.get_data());
+        const auto& low_key = impl::comparison_key(low);
+        const auto& high_key = impl::comparison_key(high);
+        const auto pred = [&](std::size_t i)
+        {
+            const auto key = impl::comparison_key(reader[i]);
+            return (low_key <= key) & (key <= high_key);
+        };
+        return impl::make_word_comparison_result(
+            values.size(),
+            impl::zone_pruned_words(
+                values,
+                pred,
+                [&](const auto& min, const auto& max)
+                {
+                    return impl::between_bounds(min, max, low_key, high_key);
+                }
+            ),
+            make_validity_reader(values.get_data())
+        );
+    }
+
+    /**
+     * Checks whether the elements of an array lie in element-wise closed intervals.
+     *
+     * @return An array whose element i is null where any operand is null, and
+     * `low[i] <= values[i] && values[i] <= high[i]` otherwise.
+     * @pre \p values, \p low and \p high must have the same size.
+     */
+    template <comparable_typed_array A>
+    packed_boolean_array between(const A& values, const A& low, const A& high)
+    {
+        SPARROW_ASSERT_TRUE(values.size() == low.size());
+        SPARROW_ASSERT_TRUE(values.size() == high.size());
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        const reader_type reader(values.get_data());
+        const reader_type low_reader(low.get_data());
+        const reader_type high_reader(high.get_data());
+        return impl::make_comparison_result(
+            values.size(),
+            [&](std::size_t i)
+            {
+                const auto key = impl::comparison_key(reader[i]);
+                return (impl::comparison_key(low_reader[i]) <= key)
+                       & (key <= impl::comparison_key(high_reader[i]));
+            },
+            make_validity_reader(values.get_data()),
+            make_validity_reader(low.get_data()),
+            make_validity_reader(high.get_data())
+        );
+    }
+}
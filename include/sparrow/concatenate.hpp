@@ -0,0 +1,364 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    namespace impl
+    {
+        /*
+         * @return The number of bytes of a value of a fixed-size layout holding
+         * elements of type \p id.
+         */
+        inline std::size_t fixed_value_width(data_type id)
+        {
+            switch (id)
+            {
+                case data_type::BOOL:
+                case data_type::UINT8:
+                case data_type::INT8:
+                    return 1u;
+                case data_type::UINT16:
+                case data_type::INT16:
+                case data_type::HALF_FLOAT:
+                    return 2u;
+                case data_type::UINT32:
+                case data_type::INT32:
+                case data_type::FLOAT:
+                    return 4u;
+                case data_type::UINT64:
+                case data_type::INT64:
+                case data_type::DOUBLE:
+                    return 8u;
+                case data_type::TIMESTAMP:
+                    return sizeof(timestamp);
+                default:
+                    throw std::invalid_argument("concatenate: unsupported data type");
+            }
+        }
+
+        inline std::size_t total_size(std::span<const array_data* const> arrays)
+        {
+            std::size_t size = 0;
+            for (const array_data* data : arrays)
+            {
+                size += array_data_size(*data);
+            }
+            return size;
+        }
+
+        /*
+         * Splices the validity bitmaps of the arrays. Arrays without null values are not
+         * read at all when none of the arrays has null values.
+         */
+        inline array_data::bitmap_type
+        concatenate_validity(std::span<const array_data* const> arrays, std::size_t size)
+        {
+            const bool all_valid = std::ranges::all_of(
+                arrays,
+                [](const array_data* data)
+                {
+                    return make_validity_reader(*data).all_set();
+                }
+            );
+            if (all_valid)
+            {
+                return array_data::bitmap_type(size, true);
+            }
+            bitmap_word_writer writer(size);
+            for (const array_data* data : arrays)
+            {
+                writer.append(make_validity_reader(*data));
+            }
+            return std::move(writer).finish();
+        }
+
+        inline array_data::buffer_type concatenate_fixed_size_values(
+            std::span<const array_data* const> arrays,
+            std::size_t size,
+            std::size_t width
+        )
+        {
+            array_data::buffer_type buffer(size * width);
+            std::uint8_t* out = buffer.data();
+            for (const array_data* p : arrays)
+            {
+                const array_data& data = *p;
+                const std::size_t count = array_data_size(data) * width;
+                if (count != 0u)
+                {
+                    const std::uint8_t* values = data.buffers[0].data()
+                                                 + static_cast<std::size_t>(data.offset) * width;
+                    std::memcpy(out, values, count);
+                    out += count;
+                }
+            }
+            return buffer;
+        }
+
+        /*
+         * Concatenates the offsets and the bytes of variable-size binary arrays. The offsets
+         * of each array are rebased with a plain add loop, which compilers vectorize.
+         */
+        inline std::vector<array_data::buffer_type>
+        concatenate_variable_size_values(std::span<const array_data* const> arrays, std::size_t size)
+        {
+            using offset_type = std::int64_t;
+            const auto offsets_of = [](const array_data& data)
+            {
+                return data.buffers[0].data<offset_type>() + data.offset;
+            };
+
+            std::size_t byte_count = 0;
+            for (const array_data* data : arrays)
+            {
+                const offset_type* offsets = offsets_of(*data);
+                byte_count += static_cast<std::size_t>(offsets[array_data_size(*data)] - offsets[0]);
+            }
+
+            array_data::buffer_type offsets_buffer(sizeof(offset_type) * (size + 1u));
+            array_data::buffer_type bytes_buffer(byte_count);
+            offset_type* out_offsets = offsets_buffer.data<offset_type>();
+            std::uint8_t* out_bytes = bytes_buffer.data();
+            out_offsets[0] = 0;
+            offset_type base = 0;
+            for (const array_data* p : arrays)
+            {
+                const array_data& data = *p;
+                const std::size_t count = array_data_size(data);
+                const offset_type* offsets = offsets_of(data);
+                const offset_type shift = base - offsets[0];
+                for (std::size_t i = 1; i <= count; ++i)
+                {
+                    out_offsets[i] = offsets[i] + shift;
+                }
+                const offset_type length = offsets[count] - offsets[0];
+                if (length != 0)
+                {
+                    std::memcpy(
+                        out_bytes + base,
+                        data.buffers[1].data() + offsets[0],
+                        static_cast<std::size_t>(length)
+                    );
+                }
+                out_offsets += count;
+                base += length;
+            }
+            std::vector<array_data::buffer_type> buffers;
+            buffers.reserve(2u);
+            buffers.push_back(std::move(offsets_buffer));
+            buffers.push_back(std::move(bytes_buffer));
+            return buffers;
+        }
+
+        /*
+         * Concatenates the indices of dictionary-encoded arrays. When the arrays share the
+         * same dictionary, the indices are copied as they are; otherwise the dictionaries
+         * are concatenated and the indices of each array are offset by the position of its
+         * dictionary in the result.
+         */
+        inline array_data
+        concatenate_dictionaries(std::span<const array_data* const> arrays, std::size_t size);
+    }
+
+    /**
+     * Concatenates arrays of the same type and layout into a single array.
+     *
+     * The sizes of the result are computed first, so that each buffer of the result is
+     * allocated once. Values are copied with memcpy, offsets are rebased with a
+     * vectorizable loop and validity bitmaps are spliced 64 bits at a time.
+     *
+     * @param arrays The arrays to concatenate, passed by address so that gathering
+     * them does not copy their buffers.
+     * @return The array holding the elements of \p arrays, in order, with an offset of 0.
+     * @throws std::invalid_argument if the arrays do not have the same type and layout.
+     * @throws std::overflow_error if the concatenated dictionaries cannot be indexed by
+     * the index type of dictionary-encoded arrays.
+     * @pre \p arrays must not be empty.
+     */
+    inline array_data concatenate(std::span<const array_data* const> arrays)
+    {
+        SPARROW_ASSERT_FALSE(arrays.empty());
+        const array_data& front = *arrays.front();
+        for (const array_data* p : arrays)
+        {
+            const array_data& data = *p;
+            if (data.type.id() != front.type.id() || data.dictionary.has_value() != front.dictionary.has_value()
+                || data.buffers.size() != front.buffers.size())
+            {
+                throw std::invalid_argument("concatenate: arrays must have the same type and layout");
+            }
+        }
+
+        const std::size_t size = impl::total_size(arrays);
+        if (front.dictionary.has_value())
+        {
+            return impl::concatenate_dictionaries(arrays, size);
+        }
+
+        array_data res{
+            .type = front.type,
+            .length = static_cast<array_data::length_type>(size),
+            .offset = 0,
+            .bitmap = {},
+            .buffers = {},
+            .child_data = {},
+            .dictionary = nullptr
+        };
+        if (front.type.id() == data_type::NA)
+        {
+            return res;
+        }
+        res.bitmap = impl::concatenate_validity(arrays, size);
+        if (front.buffers.size() == 2u)
+        {
+            res.buffers = impl::concatenate_variable_size_values(arrays, size);
+        }
+        else
+        {
+            res.buffers.push_back(
+                impl::concatenate_fixed_size_values(arrays, size, impl::fixed_value_width(front.type.id()))
+            );
+        }
+        return res;
+    }
+
+    /**
+     * Concatenates arrays of the same type and layout into a single array.
+     *
+     * @see concatenate(std::span<const array_data* const>)
+     */
+    inline array_data concatenate(std::span<const array_data> arrays)
+    {
+        std::vector<const array_data*> data;
+        data.reserve(arrays.size());
+        for (const array_data& array : arrays)
+        {
+            data.push_back(&array);
+        }
+        return concatenate(std::span<const array_data* const>(data));
+    }
+
+    /**
+     * Concatenates typed arrays of the same type.
+     *
+     * @see concatenate(std::span<const array_data* const>)
+     */
+    template <class T, class Layout>
+    typed_array<T, Layout> concatenate(std::span<const typed_array<T, Layout>> arrays)
+    {
+        std::vector<const array_data*> data;
+        data.reserve(arrays.size());
+        for (const auto& array : arrays)
+        {
+            data.push_back(&array.get_data());
+        }
+        return typed_array<T, Layout>(concatenate(std::span<const array_data* const>(data)));
+    }
+
+    namespace impl
+    {
+        inline array_data
+        concatenate_dictionaries(std::span<const array_data* const> arrays, std::size_t size)
+        {
+            const array_data& front = *arrays.front();
+            const bool shared = std::ranges::all_of(
+                arrays,
+                [&front](const array_data* data)
+                {
+                    return same_dictionary(*data, front);
+                }
+            );
+
+            std::vector<std::size_t> bases(arrays.size(), 0u);
+            value_ptr<array_data> dictionary = front.dictionary;
+            if (!shared)
+            {
+                std::vector<const array_data*> dictionaries;
+                dictionaries.reserve(arrays.size());
+                std::size_t base = 0;
+                for (std::size_t i = 0; i < arrays.size(); ++i)
+                {
+                    bases[i] = base;
+                    base += array_data_size(*arrays[i]->dictionary);
+                    dictionaries.push_back(&*arrays[i]->dictionary);
+                }
+                dictionary = value_ptr<array_data>(
+                    concatenate(std::span<const array_data* const>(dictionaries))
+                );
+            }
+            const std::size_t dictionary_size = array_data_size(*dictionary);
+
+            array_data::buffer_type indices = visit_index_type(
+                front.type.id(),
+                [&]<class IT>() -> array_data::buffer_type
+                {
+                    if (dictionary_size != 0u
+                        && dictionary_size - 1u > static_cast<std::size_t>(std::numeric_limits<IT>::max()))
+                    {
+                        throw std::overflow_error("concatenate: dictionary too large for the index type");
+                    }
+                    if (shared)
+                    {
+                        return concatenate_fixed_size_values(arrays, size, sizeof(IT));
+                    }
+                    array_data::buffer_type buffer(size * sizeof(IT));
+                    IT* out = buffer.template data<IT>();
+                    for (std::size_t i = 0; i < arrays.size(); ++i)
+                    {
+                        const array_data& data = *arrays[i];
+                        const std::size_t count = array_data_size(data);
+                        const IT* in = data.buffers[0].template data<IT>() + data.offset;
+                        const IT base = static_cast<IT>(bases[i]);
+                        for (std::size_t j = 0; j < count; ++j)
+                        {
+                            out[j] = in[j];
+                            out[j] += base;
+                        }
+                        out += count;
+                    }
+                    return buffer;
+                }
+            );
+
+            return {
+                .type = front.type,
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = concatenate_validity(arrays, size),
+                .buffers = {std::move(indices)},
+                .child_data = {},
+                .dictionary = std::move(dictionary)
+            };
+        }
+    }
+}
@@ -0,0 +1,528 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/boolean.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/packed_boolean_array.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Matches typed arrays that the selection kernels support, that is arrays whose values
+     * are stored in a fixed size layout or in a variable size binary layout.
+     */
+    template <class A>
+    concept selectable_typed_array = is_typed_array_v<A> && raw_readable_layout<typename A::layout_type>;
+
+    namespace impl
+    {
+        /*
+         * Source of every element of the output of a selection kernel: bit j of
+         * `word(k, i)` is set if the element 64 * i + j is taken from the source k.
+         * The selections of the different sources are disjoint.
+         */
+        class source_selection
+        {
+        public:
+
+            source_selection(std::size_t size, std::size_t source_count)
+                : m_size(size)
+                , m_word_count(bitmap_word_count(size))
+                , m_source_count(source_count)
+                , m_words(source_count * m_word_count, bitmap_word(0))
+            {
+            }
+
+            std::size_t size() const
+            {
+                return m_size;
+            }
+
+            std::size_t word_count() const
+            {
+                return m_word_count;
+            }
+
+            std::size_t source_count() const
+            {
+                return m_source_count;
+            }
+
+            bitmap_word& word(std::size_t k, std::size_t i)
+            {
+                return m_words[k * m_word_count + i];
+            }
+
+            bitmap_word word(std::size_t k, std::size_t i) const
+            {
+                return m_words[k * m_word_count + i];
+            }
+
+            /*
+             * @return The bits of the elements of the word i that are not taken from any source.
+             */
+            bitmap_word unselected(std::size_t i) const
+            {
+                bitmap_word res = low_bits_mask(m_size - i * bitmap_word_bits);
+                for (std::size_t k = 0; k < m_source_count; ++k)
+                {
+                    res &= ~word(k, i);
+                }
+                return res;
+            }
+
+        private:
+
+            std::size_t m_size;
+            std::size_t m_word_count;
+            std::size_t m_source_count;
+            std::vector<bitmap_word> m_words;
+        };
+
+        /*
+         * Builds the validity bitmap of the output of a selection: an element is valid if
+         * the element it is taken from is valid. Elements that are not taken from any
+         * source are valid only if a fill value is provided.
+         */
+        inline array_data::bitmap_type gather_validity(
+            const source_selection& selection,
+            const std::vector<const array_data*>& sources,
+            bool has_fill_value
+        )
+        {
+            std::vector<bitmap_word_reader> readers;
+            readers.reserve(sources.size());
+            for (const array_data* source : sources)
+            {
+                readers.push_back(make_validity_reader(*source));
+            }
+            return make_bitmap_from_words(
+                selection.size(),
+                [&](std::size_t i)
+                {
+                    bitmap_word res = has_fill_value ? selection.unselected(i) : bitmap_word(0);
+                    for (std::size_t k = 0; k < readers.size(); ++k)
+                    {
+                        res |= selection.word(k, i) & readers[k].word(i);
+                    }
+                    return res;
+                }
+            );
+        }
+
+        /*
+         * Gathers fixed size values. Each word of the selection of each source is applied
+         * as a blend mask: fully selected words are copied, partially selected words are
+         * merged element-wise without branch so that compilers can emit vector blends.
+         */
+        template <class T>
+        array_data::buffer_type gather_fixed_size_values(
+            const source_selection& selection,
+            const std::vector<const array_data*>& sources,
+            const T& fill_value
+        )
+        {
+            SPARROW_ASSERT_TRUE(selection.source_count() == sources.size());
+            const std::size_t size = selection.size();
+            array_data::buffer_type buffer(size * sizeof(T));
+            T* out = buffer.template data<T>();
+            std::fill(out, out + size, fill_value);
+            for (std::size_t k = 0; k < sources.size(); ++k)
+            {
+                const T* in = raw_value_reader<fixed_size_layout<T>>(*sources[k]).data();
+                for (std::size_t i = 0; i < selection.word_count(); ++i)
+                {
+                    const bitmap_word word = selection.word(k, i);
+                    if (word == 0u)
+                    {
+                        continue;
+                    }
+                    const std::size_t first = i * bitmap_word_bits;
+                    const std::size_t count = std::min(bitmap_word_bits, size - first);
+                    if (word == low_bits_mask(count))
+                    {
+                        std::copy(in + first, in + first + count, out + first);
+                    }
+                    else
+                    {
+                        for (std::size_t j = 0; j < count; ++j)
+                        {
+                            out[first + j] = ((word >> j) & 1u) != 0u ? in[first + j] : out[first + j];
+                        }
+                    }
+                }
+            }
+            return buffer;
+        }
+
+        /*
+         * Gathers variable size values in two passes: the first one computes the offsets
+         * of the output from the lengths of the selected values, the second one copies the
+         * bytes once the data buffer has been allocated with its final size.
+         */
+        template <class Layout>
+        std::vector<array_data::buffer_type> gather_variable_size_values(
+            const source_selection& selection,
+            const std::vector<const array_data*>& sources,
+            typename raw_value_reader<Layout>::value_type fill_value
+        )
+        {
+            using reader_type = raw_value_reader<Layout>;
+            using offset_type = typename reader_type::offset_type;
+            using char_type = typename reader_type::char_type;
+
+            SPARROW_ASSERT_TRUE(selection.source_count() == sources.size());
+            const std::size_t size = selection.size();
+            std::vector<reader_type> readers;
+            readers.reserve(sources.size());
+            for (const array_data* source : sources)
+            {
+                readers.emplace_back(*source);
+            }
+
+            array_data::buffer_type offsets_buffer((size + 1) * sizeof(offset_type));
+            offset_type* offsets = offsets_buffer.template data<offset_type>();
+            offsets[0] = 0;
+            std::fill(offsets + 1, offsets + size + 1, static_cast<offset_type>(fill_value.size()));
+            for (std::size_t k = 0; k < readers.size(); ++k)
+            {
+                const offset_type* in_offsets = readers[k].offsets();
+                for (std::size_t i = 0; i < selection.word_count(); ++i)
+                {
+                    const std::size_t first = i * bitmap_word_bits;
+                    for_each_set_bit(
+                        selection.word(k, i),
+                        [&](std::size_t j)
+                        {
+                            const std::size_t row = first + j;
+                            offsets[row + 1] = in_offsets[row + 1] - in_offsets[row];
+                        }
+                    );
+                }
+            }
+            std::inclusive_scan(offsets + 1, offsets + size + 1, offsets + 1);
+
+            array_data::buffer_type data_buffer(static_cast<std::size_t>(offsets[size]) * sizeof(char_type));
+            char_type* out = data_buffer.template data<char_type>();
+            const auto copy_value = [out, offsets](std::size_t row, std::basic_string_view<char_type> value)
+            {
+                std::ranges::copy(value, out + offsets[row]);
+            };
+            for (std::size_t i = 0; i < selection.word_count() && !fill_value.empty(); ++i)
+            {
+                const std::size_t first = i * bitmap_word_bits;
+                for_each_set_bit(
+                    selection.unselected(i),
+                    [&](std::size_t j)
+                    {
+                        copy_value(first + j, fill_value);
+                    }
+                );
+            }
+            for (std::size_t k = 0; k < readers.size(); ++k)
+            {
+                for (std::size_t i = 0; i < selection.word_count(); ++i)
+                {
+                    const std::size_t first = i * bitmap_word_bits;
+                    for_each_set_bit(
+                        selection.word(k, i),
+                        [&](std::size_t j)
+                        {
+                            copy_value(first + j, readers[k][first + j]);
+                        }
+                    );
+                }
+            }
+
+            std::vector<array_data::buffer_type> buffers;
+            buffers.reserve(2);
+            buffers.push_back(std::move(offsets_buffer));
+            buffers.push_back(std::move(data_buffer));
+            return buffers;
+        }
+
+        /*
+         * Builds the array made of the elements selected from the sources. Elements that
+         * are not taken from any source are set to fill_value, or null if it is empty.
+         */
+        template <selectable_typed_array A>
+        A gather_selection(
+            const source_selection& selection,
+            const std::vector<const array_data*>& sources,
+            const std::optional<typename A::layout_type::inner_value_type>& fill_value
+        )
+        {
+            using layout_type = typename A::layout_type;
+            using value_type = typename layout_type::inner_value_type;
+            SPARROW_ASSERT_FALSE(sources.empty());
+
+            std::vector<array_data::buffer_type> buffers;
+            if constexpr (contiguous_layout<layout_type>)
+            {
+                buffers.push_back(gather_fixed_size_values(selection, sources, fill_value.value_or(value_type{})));
+            }
+            else
+            {
+                using view_type = typename raw_value_reader<layout_type>::value_type;
+                buffers = gather_variable_size_values<layout_type>(
+                    selection,
+                    sources,
+                    fill_value.has_value() ? view_type(*fill_value) : view_type()
+                );
+            }
+            return A(array_data{
+                .type = sources.front()->type,
+                .length = static_cast<array_data::length_type>(selection.size()),
+                .offset = 0,
+                .bitmap = gather_validity(selection, sources, fill_value.has_value()),
+                .buffers = std::move(buffers),
+                .child_data = {},
+                .dictionary = nullptr
+            });
+        }
+
+        inline source_selection make_if_else_selection(const packed_boolean_array& condition)
+        {
+            const packed_boolean_reader reader(condition);
+            source_selection selection(condition.size(), 2u);
+            for (std::size_t i = 0; i < selection.word_count(); ++i)
+            {
+                selection.word(0, i) = reader.values(i);
+                selection.word(1, i) = ~reader.values(i) & reader.validity(i);
+            }
+            return selection;
+        }
+
+        /*
+         * Each element is taken from the first source that is valid for this element.
+         */
+        inline source_selection make_coalesce_selection(const std::vector<const array_data*>& sources)
+        {
+            SPARROW_ASSERT_FALSE(sources.empty());
+            const std::size_t size = array_data_size(*sources.front());
+            source_selection selection(size, sources.size());
+            for (std::size_t k = 0; k < sources.size(); ++k)
+            {
+                SPARROW_ASSERT_TRUE(array_data_size(*sources[k]) == size);
+                const bitmap_word_reader reader = make_validity_reader(*sources[k]);
+                for (std::size_t i = 0; i < selection.word_count(); ++i)
+                {
+                    bitmap_word remaining = reader.word(i);
+                    for (std::size_t l = 0; l < k; ++l)
+                    {
+                        remaining &= ~selection.word(l, i);
+                    }
+                    selection.word(k, i) = remaining;
+                }
+            }
+            return selection;
+        }
+
+        /*
+         * Gathers the indices of dictionary-encoded sources sharing the same dictionary.
+         * The result keeps the encoding of the sources.
+         */
+        inline array_data
+        gather_dictionary_selection(const source_selection& selection, const std::vector<const array_data*>& sources)
+        {
+            SPARROW_ASSERT_FALSE(sources.empty());
+            const array_data& front = *sources.front();
+            for (const array_data* source : sources)
+            {
+                if (!source->dictionary.has_value())
+                {
+                    throw std::invalid_argument("dictionary selection kernels require dictionary-encoded arrays");
+                }
+                if (source->type.id() != front.type.id() || !same_dictionary(*source, front))
+                {
+                    throw std::invalid_argument("dictionary selection kernels require arrays sharing the same dictionary");
+                }
+            }
+
+            const auto gather_indices = [&]<class IT>() -> array_data::buffer_type
+            {
+                return gather_fixed_size_values(selection, sources, IT(0));
+            };
+            array_data::buffer_type indices = visit_index_type(front.type.id(), gather_indices);
+            return {
+                .type = front.type,
+                .length = static_cast<array_data::length_type>(selection.size()),
+                .offset = 0,
+                .bitmap = gather_validity(selection, sources, false),
+                .buffers = {std::move(indices)},
+                .child_data = {},
+                .dictionary = front.dictionary
+            };
+        }
+    }
+
+    /**
+     * Selects the elements of \p lhs where \p condition is true, and the elements of
+     * \p rhs where it is false.
+     *
+     * @param condition The boolean array driving the selection.
+     * @param lhs The array providing the elements where \p condition is true.
+     * @param rhs The array providing the elements where \p condition is false.
+     * @return An array whose element i is null where \p condition is null or where the
+     * selected element is null.
+     * @pre \p condition, \p lhs and \p rhs must have the same size.
+     */
+    template <boolean_array C, selectable_typed_array A>
+    A if_else(const C& condition, const A& lhs, const A& rhs)
+    {
+        SPARROW_ASSERT_TRUE(condition.size() == lhs.size());
+        SPARROW_ASSERT_TRUE(condition.size() == rhs.size());
+        return impl::gather_selection<A>(
+            impl::make_if_else_selection(impl::as_packed(condition)),
+            {&lhs.get_data(), &rhs.get_data()},
+            std::nullopt
+        );
+    }
+
+    /**
+     * Selects, for each element, the value of the case matching the first true condition.
+     *
+     * Null conditions are considered false.
+     *
+     * @param conditions The conditions, evaluated in order.
+     * @param cases The cases. If there is one more case than conditions, the last one is
+     * the default case selected when no condition is true; otherwise the result is null
+     * where no condition is true.
+     * @pre \p conditions must not be empty and all the arrays must have the same size.
+     */
+    template <selectable_typed_array A>
+    A case_when(const std::vector<packed_boolean_array>& conditions, const std::vector<A>& cases)
+    {
+        SPARROW_ASSERT_FALSE(conditions.empty());
+        SPARROW_ASSERT_TRUE(cases.size() == conditions.size() || cases.size() == conditions.size() + 1);
+        const std::size_t size = conditions.front().size();
+        std::vector<const array_data*> sources;
+        sources.reserve(cases.size());
+        for (const A& c : cases)
+        {
+            SPARROW_ASSERT_TRUE(c.size() == size);
+            sources.push_back(&c.get_data());
+        }
+
+        impl::source_selection selection(size, cases.size());
+        for (std::size_t k = 0; k < conditions.size(); ++k)
+        {
+            SPARROW_ASSERT_TRUE(conditions[k].size() == size);
+            const impl::packed_boolean_reader reader(conditions[k]);
+            for (std::size_t i = 0; i < selection.word_count(); ++i)
+            {
+                selection.word(k, i) = reader.values(i) & selection.unselected(i);
+            }
+        }
+        if (cases.size() > conditions.size())
+        {
+            for (std::size_t i = 0; i < selection.word_count(); ++i)
+            {
+                selection.word(conditions.size(), i) = selection.unselected(i);
+            }
+        }
+        return impl::gather_selection<A>(selection, sources, std::nullopt);
+    }
+
+    /**
+     * Selects, for each element, the first non-null value among the given arrays.
+     *
+     * @return An array whose element i is null only if the element i of every operand is null.
+     * @pre All the arrays must have the same size.
+     */
+    template <selectable_typed_array A, std::same_as<A>... As>
+    A coalesce(const A& first, const As&... others)
+    {
+        const std::vector<const array_data*> sources = {&first.get_data(), &others.get_data()...};
+        return impl::gather_selection<A>(impl::make_coalesce_selection(sources), sources, std::nullopt);
+    }
+
+    /**
+     * Replaces the null elements of an array with a value.
+     *
+     * @param array The array whose null elements are replaced.
+     * @param value The replacement value.
+     * @return An array without null element.
+     */
+    template <selectable_typed_array A>
+    A fill_null(const A& array, const typename A::layout_type::inner_value_type& value)
+    {
+        const std::vector<const array_data*> sources = {&array.get_data()};
+        return impl::gather_selection<A>(impl::make_coalesce_selection(sources), sources, value);
+    }
+
+    /**
+     * Replaces the null elements of an array with the elements at the same position
+     * in another array.
+     *
+     * @pre \p array and \p replacements must have the same size.
+     */
+    template <selectable_typed_array A>
+    A fill_null(const A& array, const A& replacements)
+    {
+        return coalesce(array, replacements);
+    }
+
+    /**
+     * Dictionary-encoded version of `if_else`: only the indices are selected, and the
+     * result shares the dictionary of the operands instead of being decoded.
+     *
+     * @param condition The boolean array driving the selection.
+     * @param lhs The dictionary-encoded data providing the elements where \p condition is true.
+     * @param rhs The dictionary-encoded data providing the elements where \p condition is false.
+     * @return The dictionary-encoded data of the result.
+     * @throws std::invalid_argument if the operands are not dictionary-encoded with the same
+     * index type and the same dictionary.
+     */
+    template <boolean_array C>
+    array_data dictionary_if_else(const C& condition, const array_data& lhs, const array_data& rhs)
+    {
+        SPARROW_ASSERT_TRUE(condition.size() == array_data_size(lhs));
+        SPARROW_ASSERT_TRUE(condition.size() == array_data_size(rhs));
+        return impl::gather_dictionary_selection(
+            impl::make_if_else_selection(impl::as_packed(condition)),
+            {&lhs, &rhs}
+        );
+    }
+
+    /**
+     * Dictionary-encoded version of `coalesce`, selecting the indices only.
+     *
+     * @throws std::invalid_argument if the operands are not dictionary-encoded with the same
+     * index type and the same dictionary.
+     */
+    inline array_data dictionary_coalesce(const std::vector<const array_data*>& sources)
+    {
+        return impl::gather_dictionary_selection(impl::make_coalesce_selection(sources), sources);
+    }
+}
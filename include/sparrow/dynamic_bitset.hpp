@@ -100,6 +100,8 @@ namespace sparrow
 
         size_type compute_block_count(size_type bits_count) const noexcept;
 
+        const storage_type& storage() const noexcept;
+
     private:
 
         static constexpr std::size_t s_bits_per_block = sizeof(block_type) * CHAR_BIT;
@@ -138,6 +140,7 @@ namespace sparrow
         using block_type = typename base_type::block_type;
         using value_type = typename base_type::value_type;
         using size_type = typename base_type::size_type;
+        using allocator_type = typename storage_type::allocator_type;
 
         dynamic_bitset();
         explicit dynamic_bitset(size_type n);
@@ -145,14 +148,34 @@ namespace sparrow
         dynamic_bitset(block_type* p, size_type n);
         dynamic_bitset(block_type* p, size_type n, size_type null_count);
 
+        /**
+         * Builds a bitset of \p n bits set to \p v, whose blocks are allocated with \p a.
+         */
+        template <allocator A>
+        dynamic_bitset(size_type n, value_type v, const A& a);
+
         ~dynamic_bitset() = default;
         dynamic_bitset(const dynamic_bitset&) = default;
         dynamic_bitset(dynamic_bitset&&) = default;
 
+        /**
+         * Copies \p rhs into blocks allocated with \p a.
+         */
+        template <allocator A>
+        dynamic_bitset(const dynamic_bitset& rhs, const A& a);
+
+        /**
+         * Takes ownership of the blocks at \p p, that were allocated with \p a.
+         */
+        template <allocator A>
+        dynamic_bitset(block_type* p, size_type n, size_type null_count, const A& a);
+
         dynamic_bitset& operator=(const dynamic_bitset&) = default;
         dynamic_bitset& operator=(dynamic_bitset&&) = default;
 
         using base_type::resize;
+
+        const allocator_type& get_allocator() const noexcept;
     };
 
     /**
@@ -434,6 +457,12 @@ namespace sparrow
         SPARROW_ASSERT_TRUE(m_null_count == m_size - count_non_null());
     }
 
+    template <random_access_range B>
+    auto dynamic_bitset_base<B>::storage() const noexcept -> const storage_type&
+    {
+        return m_buffer;
+    }
+
     template <random_access_range B>
     auto dynamic_bitset_base<B>::compute_block_count(size_type bits_count) const noexcept -> size_type
     {
@@ -571,6 +600,37 @@ namespace sparrow
     {
     }
 
+    template <std::integral T>
+    template <allocator A>
+    dynamic_bitset<T>::dynamic_bitset(size_type n, value_type value, const A& a)
+        : base_type(
+              storage_type(this->compute_block_count(n), value ? block_type(~block_type(0)) : block_type(0), a),
+              n,
+              value ? 0u : n
+          )
+    {
+    }
+
+    template <std::integral T>
+    template <allocator A>
+    dynamic_bitset<T>::dynamic_bitset(const dynamic_bitset& rhs, const A& a)
+        : base_type(storage_type(rhs.storage(), a), rhs.size(), rhs.null_count())
+    {
+    }
+
+    template <std::integral T>
+    template <allocator A>
+    dynamic_bitset<T>::dynamic_bitset(block_type* p, size_type n, size_type null_count, const A& a)
+        : base_type(storage_type(p, this->compute_block_count(n), a), n, null_count)
+    {
+    }
+
+    template <std::integral T>
+    auto dynamic_bitset<T>::get_allocator() const noexcept -> const allocator_type&
+    {
+        return this->storage().get_allocator();
+    }
+
     template <std::integral T>
     dynamic_bitset<T>::dynamic_bitset(block_type* p, size_type n)
         : base_type(storage_type(p, this->compute_block_count(n)), n)
@@ -72,8 +72,14 @@ namespace sparrow
         using iterator = layout_iterator<self_type, false>;
         using const_iterator = layout_iterator<self_type, true>;
 
-        explicit fixed_size_layout(array_data& data);
-        void rebind_data(array_data& data);
+        explicit fixed_size_layout(array_data& data) noexcept;
+        void rebind_data(array_data& data) noexcept;
+
+        /**
+         * Sets the hook invoked by the references and iterators returned afterwards
+         * before they modify an element.
+         */
+        void set_modification_hook(modification_hook on_modification) noexcept;
 
         fixed_size_layout(const self_type&) = delete;
         self_type& operator=(const self_type&) = delete;
@@ -120,6 +126,7 @@ namespace sparrow
         const array_data& data_ref() const;
 
         std::reference_wrapper<array_data> m_data;
+        modification_hook m_on_modification;
 
         friend class reference_proxy<fixed_size_layout>;
         friend class const_reference_proxy<fixed_size_layout>;
@@ -130,7 +137,7 @@ namespace sparrow
      ***********************************/
 
     template <class T>
-    fixed_size_layout<T>::fixed_size_layout(array_data& data)
+    fixed_size_layout<T>::fixed_size_layout(array_data& data) noexcept
         : m_data(data)
     {
         // We only require the presence of the bitmap and the first buffer.
@@ -139,11 +146,17 @@ namespace sparrow
     }
 
     template <class T>
-    void fixed_size_layout<T>::rebind_data(array_data& data)
+    void fixed_size_layout<T>::rebind_data(array_data& data) noexcept
     {
         m_data = data;
     }
 
+    template <class T>
+    void fixed_size_layout<T>::set_modification_hook(modification_hook on_modification) noexcept
+    {
+        m_on_modification = on_modification;
+    }
+
     template <class T>
     auto fixed_size_layout<T>::size() const -> size_type
     {
@@ -169,7 +182,7 @@ namespace sparrow
     auto fixed_size_layout<T>::operator[](size_type i) -> reference
     {
         SPARROW_ASSERT_TRUE(i < size());
-        return reference(value(i), has_value(i));
+        return reference(value(i), has_value(i), m_on_modification);
     }
 
     template <class T>
@@ -182,13 +195,13 @@ namespace sparrow
     template <class T>
     auto fixed_size_layout<T>::begin() -> iterator
     {
-        return iterator(value_begin(), bitmap_begin());
+        return iterator(value_begin(), bitmap_begin(), m_on_modification);
     }
 
     template <class T>
     auto fixed_size_layout<T>::end() -> iterator
     {
-        return iterator(value_end(), bitmap_end());
+        return iterator(value_end(), bitmap_end(), m_on_modification);
     }
 
     template <class T>
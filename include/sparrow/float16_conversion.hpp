@@ -0,0 +1,247 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/typed_array.hpp"
+
+// The F16C conversion instructions are selected at runtime on x86 when the compiler
+// supports per-function target attributes.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define SPARROW_F16C_DISPATCH 1
+#    include <immintrin.h>
+#else
+#    define SPARROW_F16C_DISPATCH 0
+#endif
+
+namespace sparrow
+{
+    static_assert(std::is_trivially_copyable_v<float16_t>);
+    static_assert(sizeof(float16_t) == sizeof(std::uint16_t));
+
+    namespace impl
+    {
+        /*
+         * Software conversions. They are written without branch nor lookup table so that
+         * the bulk loops below are vectorized by the compiler; the selections compile to
+         * conditional moves or vector blends.
+         */
+
+        inline float half_bits_to_float(std::uint16_t h) noexcept
+        {
+            constexpr std::uint32_t shifted_exp = 0x7c00u << 13;
+            const std::uint32_t sign = (std::uint32_t(h) & 0x8000u) << 16;
+            const std::uint32_t em = (std::uint32_t(h) & 0x7fffu) << 13;
+            const std::uint32_t exp = em & shifted_exp;
+            // Rebias the exponent from 15 to 127
+            const std::uint32_t normal = em + ((127u - 15u) << 23);
+            // Infinity and NaN keep an exponent of all ones
+            const std::uint32_t inf_nan = normal + ((128u - 16u) << 23);
+            // Subnormal halves become normal floats: renormalize with a float subtraction
+            constexpr float magic = std::bit_cast<float>(113u << 23);
+            const std::uint32_t subnormal = std::bit_cast<std::uint32_t>(
+                std::bit_cast<float>(normal + (1u << 23)) - magic
+            );
+            const std::uint32_t res = exp == shifted_exp ? inf_nan : (exp == 0u ? subnormal : normal);
+            return std::bit_cast<float>(res | sign);
+        }
+
+        /*
+         * Converts a float to the bits of a half, rounding to nearest even. Values too large
+         * for a half become infinite, NaN stays NaN.
+         */
+        inline std::uint16_t float_to_half_bits(float value) noexcept
+        {
+            constexpr std::uint32_t f32_infinity = 255u << 23;
+            constexpr std::uint32_t f16_max = (127u + 16u) << 23;
+            constexpr std::uint32_t denorm_magic_bits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+            constexpr float denorm_magic = std::bit_cast<float>(denorm_magic_bits);
+
+            const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+            const std::uint32_t sign = bits & 0x80000000u;
+            const std::uint32_t abs_bits = bits ^ sign;
+
+            const std::uint32_t overflow = abs_bits > f32_infinity ? 0x7e00u : 0x7c00u;
+            // Subnormal results: the addition aligns the mantissa and rounds to nearest even
+            const std::uint32_t subnormal = std::bit_cast<std::uint32_t>(std::bit_cast<float>(abs_bits) + denorm_magic)
+                                            - denorm_magic_bits;
+            // Normal results: rebias the exponent and round the mantissa to nearest even
+            const std::uint32_t mantissa_odd = (abs_bits >> 13) & 1u;
+            const std::uint32_t normal = (abs_bits + ((15u - 127u) << 23) + 0xfffu + mantissa_odd) >> 13;
+
+            const std::uint32_t res = abs_bits >= f16_max ? overflow
+                                                          : (abs_bits < (113u << 23) ? subnormal : normal);
+            return static_cast<std::uint16_t>(res | (sign >> 16));
+        }
+
+        inline void software_float16_to_float32(const float16_t* src, float* dst, std::size_t size) noexcept
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                dst[i] = half_bits_to_float(std::bit_cast<std::uint16_t>(src[i]));
+            }
+        }
+
+        inline void software_float32_to_float16(const float* src, float16_t* dst, std::size_t size) noexcept
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                dst[i] = std::bit_cast<float16_t>(float_to_half_bits(src[i]));
+            }
+        }
+
+#if SPARROW_F16C_DISPATCH
+        /*
+         * @return true if the CPU supports the F16C and AVX instructions. The detection
+         * runs once.
+         */
+        inline bool has_f16c_support() noexcept
+        {
+            static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+            return supported;
+        }
+
+        __attribute__((target("avx,f16c"))) inline void
+        f16c_float16_to_float32(const float16_t* src, float* dst, std::size_t size) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 8u <= size; i += 8u)
+            {
+                const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+            }
+            software_float16_to_float32(src + i, dst + i, size - i);
+        }
+
+        __attribute__((target("avx,f16c"))) inline void
+        f16c_float32_to_float16(const float* src, float16_t* dst, std::size_t size) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 8u <= size; i += 8u)
+            {
+                const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+            }
+            software_float32_to_float16(src + i, dst + i, size - i);
+        }
+#endif
+    }
+
+    /**
+     * Converts half precision values to single precision values.
+     *
+     * The conversion uses the F16C instructions when the CPU supports them, and a
+     * vectorizable software implementation otherwise.
+     *
+     * @param src The values to convert.
+     * @param dst The destination of the converted values.
+     * @pre \p dst must be at least as large as \p src.
+     */
+    inline void convert_float16_to_float32(std::span<const float16_t> src, std::span<float> dst) noexcept
+    {
+        SPARROW_ASSERT_TRUE(dst.size() >= src.size());
+#if SPARROW_F16C_DISPATCH
+        if (impl::has_f16c_support())
+        {
+            impl::f16c_float16_to_float32(src.data(), dst.data(), src.size());
+            return;
+        }
+#endif
+        impl::software_float16_to_float32(src.data(), dst.data(), src.size());
+    }
+
+    /**
+     * Converts single precision values to half precision values, rounding to nearest even.
+     *
+     * @param src The values to convert.
+     * @param dst The destination of the converted values.
+     * @pre \p dst must be at least as large as \p src.
+     * @see convert_float16_to_float32
+     */
+    inline void convert_float32_to_float16(std::span<const float> src, std::span<float16_t> dst) noexcept
+    {
+        SPARROW_ASSERT_TRUE(dst.size() >= src.size());
+#if SPARROW_F16C_DISPATCH
+        if (impl::has_f16c_support())
+        {
+            impl::f16c_float32_to_float16(src.data(), dst.data(), src.size());
+            return;
+        }
+#endif
+        impl::software_float32_to_float16(src.data(), dst.data(), src.size());
+    }
+
+    namespace impl
+    {
+        template <class To, class From, class F>
+        array_data convert_float_array_data(const array_data& data, F convert)
+        {
+            const std::size_t size = array_data_size(data);
+            const From* values = raw_value_reader<fixed_size_layout<From>>(data).data();
+            array_data::buffer_type buffer(size * sizeof(To));
+            convert(std::span<const From>(values, size), std::span<To>(buffer.template data<To>(), size));
+            const bitmap_word_reader reader = make_validity_reader(data);
+            return {
+                .type = data_descriptor(arrow_traits<To>::type_id),
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = reader.all_set() ? array_data::bitmap_type(size, true)
+                                           : make_bitmap_from_words(
+                                                 size,
+                                                 [&reader](std::size_t i)
+                                                 {
+                                                     return reader.word(i);
+                                                 }
+                                             ),
+                .buffers = {std::move(buffer)},
+                .child_data = {},
+                .dictionary = nullptr
+            };
+        }
+    }
+
+    /**
+     * Converts an array of half precision values to single precision values in bulk.
+     *
+     * @see convert_float16_to_float32
+     */
+    inline typed_array<float> to_float32_array(const typed_array<float16_t>& array)
+    {
+        return typed_array<float>(
+            impl::convert_float_array_data<float, float16_t>(array.get_data(), convert_float16_to_float32)
+        );
+    }
+
+    /**
+     * Converts an array of single precision values to half precision values in bulk.
+     *
+     * @see convert_float32_to_float16
+     */
+    inline typed_array<float16_t> to_float16_array(const typed_array<float>& array)
+    {
+        return typed_array<float16_t>(
+            impl::convert_float_array_data<float16_t, float>(array.get_data(), convert_float32_to_float16)
+        );
+    }
+}
@@ -0,0 +1,564 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array.hpp"
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/mp_utils.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/record_batch.hpp"
+
+namespace sparrow
+{
+    namespace impl
+    {
+        /*
+         * Converts to anything: counts the fields of an aggregate by checking how many of
+         * them brace-initialize it.
+         */
+        struct any_field
+        {
+            template <class U>
+            operator U() const;
+        };
+
+        // The largest number of fields of the aggregates converted by columns_from_rows
+        inline constexpr std::size_t max_row_fields = 12;
+
+        template <class T, std::size_t N>
+        consteval bool is_brace_constructible_with()
+        {
+            return []<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                return requires { T{(static_cast<void>(Is), any_field{})...}; };
+            }(std::make_index_sequence<N>());
+        }
+
+        template <class T, std::size_t N = max_row_fields>
+        consteval std::size_t aggregate_field_count()
+        {
+            if constexpr (N == 0u || is_brace_constructible_with<T, N>())
+            {
+                return N;
+            }
+            else
+            {
+                return aggregate_field_count<T, N - 1u>();
+            }
+        }
+
+        template <class T>
+        concept tuple_like = requires { std::tuple_size<T>::value; };
+
+        /*
+         * @return A tuple of references on the fields of row, a tuple-like type or an
+         *         aggregate with up to max_row_fields fields.
+         */
+        template <class Row>
+        auto tie_fields(const Row& row)
+        {
+            if constexpr (tuple_like<Row>)
+            {
+                return [&row]<std::size_t... Is>(std::index_sequence<Is...>)
+                {
+                    return std::tie(std::get<Is>(row)...);
+                }(std::make_index_sequence<std::tuple_size_v<Row>>());
+            }
+            else
+            {
+                constexpr std::size_t n = aggregate_field_count<Row>();
+                static_assert(n != 0u, "columns_from_rows: rows must be tuple-like or aggregates");
+                if constexpr (n == 1u)
+                {
+                    const auto& [f0] = row;
+                    return std::tie(f0);
+                }
+                else if constexpr (n == 2u)
+                {
+                    const auto& [f0, f1] = row;
+                    return std::tie(f0, f1);
+                }
+                else if constexpr (n == 3u)
+                {
+                    const auto& [f0, f1, f2] = row;
+                    return std::tie(f0, f1, f2);
+                }
+                else if constexpr (n == 4u)
+                {
+                    const auto& [f0, f1, f2, f3] = row;
+                    return std::tie(f0, f1, f2, f3);
+                }
+                else if constexpr (n == 5u)
+                {
+                    const auto& [f0, f1, f2, f3, f4] = row;
+                    return std::tie(f0, f1, f2, f3, f4);
+                }
+                else if constexpr (n == 6u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5);
+                }
+                else if constexpr (n == 7u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6);
+                }
+                else if constexpr (n == 8u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6, f7] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+                }
+                else if constexpr (n == 9u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+                }
+                else if constexpr (n == 10u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+                }
+                else if constexpr (n == 11u)
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+                }
+                else
+                {
+                    const auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = row;
+                    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+                }
+            }
+        }
+
+        template <class Row>
+        using row_fields_t = decltype(tie_fields(std::declval<const Row&>()));
+
+        template <class Row, std::size_t I>
+        using row_field_t = std::remove_cvref_t<std::tuple_element_t<I, row_fields_t<Row>>>;
+
+        template <class F>
+        struct row_field_traits
+        {
+            using value_type = F;
+            static constexpr bool nullable = false;
+        };
+
+        template <class F>
+        struct row_field_traits<std::optional<F>>
+        {
+            using value_type = F;
+            static constexpr bool nullable = true;
+        };
+
+        template <class T>
+        concept string_field = std::same_as<T, std::string> || std::same_as<T, std::string_view>;
+
+        template <class T>
+        concept fixed_size_field = std::is_arithmetic_v<T> && is_arrow_base_type<T>;
+
+        template <class T>
+        consteval data_type row_field_type_id()
+        {
+            if constexpr (string_field<T>)
+            {
+                return data_type::STRING;
+            }
+            else
+            {
+                return arrow_traits<T>::type_id;
+            }
+        }
+
+        /*
+         * Write cursor of a column while the rows are walked. The rows are converted by
+         * blocks, given as morsels starting on multiples of 64: a block writes the values and
+         * the validity words of its rows in place, and appends its string bytes to a buffer
+         * of its own, that finish() splices with the bytes of the other blocks.
+         */
+        template <class F>
+        class column_builder
+        {
+        public:
+
+            using traits = row_field_traits<F>;
+            using value_type = typename traits::value_type;
+            static constexpr bool is_string = string_field<value_type>;
+
+            static_assert(
+                is_string || fixed_size_field<value_type>,
+                "columns_from_rows: the fields must be arithmetic types, std::string, "
+                "std::string_view or std::optional of them"
+            );
+
+            column_builder(std::size_t size, std::size_t block_count, std::size_t string_size_estimate);
+
+            void begin_block(const morsel& block);
+            void write(const morsel& block, std::size_t i, const F& field);
+
+            array_data finish() &&;
+
+        private:
+
+            using offset_type = std::int64_t;
+
+            void write_value(const morsel& block, std::size_t i, const value_type& value);
+
+            std::size_t m_size;
+            std::size_t m_string_size_estimate;
+            std::vector<bitmap_word> m_validity;
+            array_data::buffer_type m_values;
+            std::vector<morsel> m_blocks;
+            std::vector<array_data::buffer_type> m_block_bytes;
+            std::vector<std::size_t> m_block_byte_count;
+        };
+
+        template <class R>
+        using row_t = std::ranges::range_value_t<R>;
+
+        template <class Row>
+        inline constexpr std::size_t row_field_count = std::tuple_size_v<row_fields_t<Row>>;
+    }
+
+    /**
+     * Matches the ranges of rows converted by columns_from_rows: sized random access
+     * ranges of tuple-like types or aggregates with at most 12 fields. The fields must be
+     * arithmetic types, std::string or std::string_view, or std::optional of them.
+     */
+    template <class R>
+    concept row_range = std::ranges::random_access_range<R> && std::ranges::sized_range<R>;
+
+    /**
+     * Default number of bytes reserved per row for each string column.
+     */
+    inline constexpr std::size_t default_string_size_estimate = 16;
+
+    /**
+     * Transposes \p rows into one array_data per field, in a single pass over the rows.
+     *
+     * The buffers of the columns are allocated from the number of rows before the pass,
+     * and the bytes of the string columns from \p string_size_estimate. The columns of
+     * std::optional fields have a null for each empty optional.
+     *
+     * @param rows The rows to convert.
+     * @param string_size_estimate The number of bytes reserved per row for string columns.
+     * @return The columns, in the order of the fields.
+     */
+    template <row_range R>
+    std::vector<array_data>
+    columns_from_rows(const R& rows, std::size_t string_size_estimate = default_string_size_estimate);
+
+    /**
+     * Parallel version of columns_from_rows: the rows of each morsel are converted by a
+     * different task.
+     */
+    template <row_range R>
+    std::vector<array_data> columns_from_rows(
+        const R& rows,
+        const parallel_options& options,
+        std::size_t string_size_estimate = default_string_size_estimate
+    );
+
+    /**
+     * @return The record_batch made of the columns converted from \p rows, whose fields
+     *         are named after \p names. The fields of std::optional type are nullable.
+     * @throws std::invalid_argument if \p names has not one name per field of the rows.
+     */
+    template <row_range R>
+    record_batch record_batch_from_rows(
+        const R& rows,
+        std::vector<std::string> names,
+        std::size_t string_size_estimate = default_string_size_estimate
+    );
+
+    /****************************
+     * from_rows implementation *
+     ****************************/
+
+    namespace impl
+    {
+        template <class F>
+        column_builder<F>::column_builder(
+            std::size_t size,
+            std::size_t block_count,
+            std::size_t string_size_estimate
+        )
+            : m_size(size)
+            , m_string_size_estimate(string_size_estimate)
+        {
+            if constexpr (traits::nullable)
+            {
+                m_validity.assign(bitmap_word_count(size), bitmap_word(0));
+            }
+            if constexpr (is_string)
+            {
+                m_values = array_data::buffer_type(sizeof(offset_type) * (size + 1u));
+                m_values.template data<offset_type>()[0] = 0;
+                m_blocks.resize(block_count);
+                m_block_bytes.resize(block_count);
+                m_block_byte_count.assign(block_count, 0u);
+            }
+            else
+            {
+                m_values = array_data::buffer_type(sizeof(value_type) * size);
+            }
+        }
+
+        template <class F>
+        void column_builder<F>::begin_block(const morsel& block)
+        {
+            if constexpr (is_string)
+            {
+                m_blocks[block.index] = block;
+                m_block_bytes[block.index] = array_data::buffer_type(block.size() * m_string_size_estimate);
+            }
+        }
+
+        template <class F>
+        void column_builder<F>::write(const morsel& block, std::size_t i, const F& field)
+        {
+            if constexpr (traits::nullable)
+            {
+                if (field.has_value())
+                {
+                    m_validity[i / bitmap_word_bits] |= bitmap_word(1) << (i % bitmap_word_bits);
+                    write_value(block, i, *field);
+                }
+                else
+                {
+                    write_value(block, i, value_type());
+                }
+            }
+            else
+            {
+                write_value(block, i, field);
+            }
+        }
+
+        template <class F>
+        void column_builder<F>::write_value(const morsel& block, std::size_t i, const value_type& value)
+        {
+            if constexpr (is_string)
+            {
+                const std::string_view str(value);
+                array_data::buffer_type& bytes = m_block_bytes[block.index];
+                std::size_t& count = m_block_byte_count[block.index];
+                if (count + str.size() > bytes.size())
+                {
+                    bytes.resize(std::max(2u * bytes.size(), count + str.size()));
+                }
+                if (!str.empty())
+                {
+                    std::memcpy(bytes.data() + count, str.data(), str.size());
+                }
+                count += str.size();
+                // Relative to the bytes of the block until the column is finished
+                m_values.template data<offset_type>()[i + 1u] = static_cast<offset_type>(count);
+            }
+            else
+            {
+                m_values.template data<value_type>()[i] = value;
+            }
+        }
+
+        template <class F>
+        array_data column_builder<F>::finish() &&
+        {
+            array_data res{
+                .type = data_descriptor(row_field_type_id<value_type>()),
+                .length = static_cast<array_data::length_type>(m_size),
+                .offset = 0,
+                .bitmap = {},
+                .buffers = {},
+                .child_data = {},
+                .dictionary = nullptr
+            };
+            if constexpr (traits::nullable)
+            {
+                res.bitmap = make_bitmap_from_words(
+                    m_size,
+                    [this](std::size_t k)
+                    {
+                        return m_validity[k];
+                    }
+                );
+            }
+            else
+            {
+                res.bitmap = array_data::bitmap_type(m_size, true);
+            }
+            res.buffers.push_back(std::move(m_values));
+
+            if constexpr (is_string)
+            {
+                array_data::buffer_type bytes;
+                if (m_blocks.size() == 1u)
+                {
+                    bytes = std::move(m_block_bytes.front());
+                    bytes.resize(m_block_byte_count.front());
+                }
+                else
+                {
+                    std::size_t byte_count = 0;
+                    for (const std::size_t count : m_block_byte_count)
+                    {
+                        byte_count += count;
+                    }
+                    bytes = array_data::buffer_type(byte_count);
+                    offset_type* offsets = res.buffers.front().template data<offset_type>();
+                    std::size_t base = 0;
+                    for (std::size_t b = 0; b < m_blocks.size(); ++b)
+                    {
+                        for (std::size_t i = m_blocks[b].begin; i < m_blocks[b].end; ++i)
+                        {
+                            offsets[i + 1u] += static_cast<offset_type>(base);
+                        }
+                        if (m_block_byte_count[b] != 0u)
+                        {
+                            std::memcpy(bytes.data() + base, m_block_bytes[b].data(), m_block_byte_count[b]);
+                        }
+                        base += m_block_byte_count[b];
+                    }
+                }
+                res.buffers.push_back(std::move(bytes));
+            }
+            return res;
+        }
+
+        template <class R, class Builders, std::size_t... Is>
+        void
+        convert_rows(const R& rows, Builders& builders, const morsel& block, std::index_sequence<Is...>)
+        {
+            (std::get<Is>(builders).begin_block(block), ...);
+            auto it = std::ranges::begin(rows) + static_cast<std::ranges::range_difference_t<R>>(block.begin);
+            for (std::size_t i = block.begin; i < block.end; ++i, ++it)
+            {
+                const auto fields = tie_fields(*it);
+                (std::get<Is>(builders).write(block, i, std::get<Is>(fields)), ...);
+            }
+        }
+
+        /*
+         * Converts rows with one column_builder per field; `run(convert)` must call
+         * `convert(block)` for each of the \p block_count blocks of rows.
+         */
+        template <class R, class Run>
+        std::vector<array_data> build_columns(
+            const R& rows,
+            std::size_t block_count,
+            std::size_t string_size_estimate,
+            const Run& run
+        )
+        {
+            using row_type = row_t<R>;
+            return [&]<std::size_t... Is>(std::index_sequence<Is...> fields)
+            {
+                const std::size_t size = std::ranges::size(rows);
+                std::tuple<column_builder<row_field_t<row_type, Is>>...> builders(
+                    column_builder<row_field_t<row_type, Is>>(size, block_count, string_size_estimate)...
+                );
+                run(
+                    [&rows, &builders, fields](const morsel& block)
+                    {
+                        convert_rows(rows, builders, block, fields);
+                    }
+                );
+                std::vector<array_data> res;
+                res.reserve(sizeof...(Is));
+                (res.push_back(std::move(std::get<Is>(builders)).finish()), ...);
+                return res;
+            }(std::make_index_sequence<row_field_count<row_type>>());
+        }
+    }
+
+    template <row_range R>
+    std::vector<array_data> columns_from_rows(const R& rows, std::size_t string_size_estimate)
+    {
+        const std::size_t size = std::ranges::size(rows);
+        return impl::build_columns(
+            rows,
+            1u,
+            string_size_estimate,
+            [size](const auto& convert)
+            {
+                convert(morsel{0u, 0u, size});
+            }
+        );
+    }
+
+    template <row_range R>
+    std::vector<array_data>
+    columns_from_rows(const R& rows, const parallel_options& options, std::size_t string_size_estimate)
+    {
+        const std::size_t size = std::ranges::size(rows);
+        const std::size_t step = aligned_morsel_size(options.morsel_size);
+        return impl::build_columns(
+            rows,
+            (size + step - 1u) / step,
+            string_size_estimate,
+            [size, step, &options](const auto& convert)
+            {
+                parallel_for_chunks(size, step, convert, impl::resolve_pool(options));
+            }
+        );
+    }
+
+    template <row_range R>
+    record_batch
+    record_batch_from_rows(const R& rows, std::vector<std::string> names, std::size_t string_size_estimate)
+    {
+        using row_type = impl::row_t<R>;
+        constexpr std::size_t field_count = impl::row_field_count<row_type>;
+        if (names.size() != field_count)
+        {
+            throw std::invalid_argument("record_batch_from_rows: one name per field is required");
+        }
+        std::vector<array_data> data = columns_from_rows(rows, string_size_estimate);
+        std::vector<field> fields;
+        std::vector<array> columns;
+        fields.reserve(field_count);
+        columns.reserve(field_count);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            (fields.push_back(field{
+                 .name = std::move(names[Is]),
+                 .type = data[Is].type.id(),
+                 .nullable = impl::row_field_traits<impl::row_field_t<row_type, Is>>::nullable
+             }),
+             ...);
+        }(std::make_index_sequence<field_count>());
+        for (array_data& d : data)
+        {
+            columns.emplace_back(std::move(d));
+        }
+        return record_batch(schema(std::move(fields)), std::move(columns));
+    }
+}
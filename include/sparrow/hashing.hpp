@@ -0,0 +1,1192 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/array_statistics.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/comparison.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/packed_boolean_array.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Matches the value types supported by the hashing kernels.
+     */
+    template <class T>
+    concept hashable_value_type = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float>
+                                  || std::same_as<T, double> || std::same_as<T, std::string>;
+
+    namespace impl
+    {
+        inline constexpr std::uint64_t hash_multiplier = 0x9e3779b97f4a7c15ull;
+
+        /*
+         * Finalizer of MurmurHash3: every bit of the input affects every bit of the result.
+         */
+        constexpr std::uint64_t mix_hash(std::uint64_t h) noexcept
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        template <std::integral T>
+        constexpr std::uint64_t to_u64(T value) noexcept
+        {
+            if constexpr (std::same_as<T, std::uint64_t>)
+            {
+                return value;
+            }
+            else
+            {
+                // Sign extension keeps the order of the differences computed modulo 2^64
+                return static_cast<std::uint64_t>(value);
+            }
+        }
+
+        /*
+         * Hashes a byte sequence 8 bytes at a time.
+         */
+        inline std::uint64_t hash_bytes(std::string_view bytes) noexcept
+        {
+            const auto* data = reinterpret_cast<const std::uint8_t*>(bytes.data());
+            const std::size_t size = bytes.size();
+            std::uint64_t h = size * hash_multiplier;
+            std::size_t i = 0;
+            for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+            {
+                h = std::rotl(h ^ (load_word_bytes(data + i, sizeof(std::uint64_t)) * hash_multiplier), 27) * 5u
+                    + 0x52dce729u;
+            }
+            if (i < size)
+            {
+                h ^= load_word_bytes(data + i, size - i) * hash_multiplier;
+            }
+            return mix_hash(h);
+        }
+
+        /*
+         * Key type, hash and equality of the values of type T. Floating point keys are
+         * normalized so that all NaNs are equal, and so are both zeros.
+         */
+        template <class T>
+        struct hash_key_traits
+        {
+            using key_type = T;
+
+            static key_type normalize(T value) noexcept
+            {
+                if constexpr (std::floating_point<T>)
+                {
+                    return std::isnan(value) ? std::numeric_limits<T>::quiet_NaN() : (value == T(0) ? T(0) : value);
+                }
+                else
+                {
+                    return value;
+                }
+            }
+
+            static std::uint64_t hash(key_type key) noexcept
+            {
+                if constexpr (std::same_as<T, float>)
+                {
+                    return mix_hash(std::bit_cast<std::uint32_t>(key));
+                }
+                else if constexpr (std::same_as<T, double>)
+                {
+                    return mix_hash(std::bit_cast<std::uint64_t>(key));
+                }
+                else
+                {
+                    return mix_hash(to_u64(key));
+                }
+            }
+
+            static bool equal(key_type lhs, key_type rhs) noexcept
+            {
+                if constexpr (std::same_as<T, float>)
+                {
+                    return std::bit_cast<std::uint32_t>(lhs) == std::bit_cast<std::uint32_t>(rhs);
+                }
+                else if constexpr (std::same_as<T, double>)
+                {
+                    return std::bit_cast<std::uint64_t>(lhs) == std::bit_cast<std::uint64_t>(rhs);
+                }
+                else
+                {
+                    return lhs == rhs;
+                }
+            }
+        };
+
+        template <>
+        struct hash_key_traits<std::string>
+        {
+            using key_type = std::string_view;
+
+            static key_type normalize(std::string_view value) noexcept
+            {
+                return value;
+            }
+
+            static std::uint64_t hash(key_type key) noexcept
+            {
+                return hash_bytes(key);
+            }
+
+            static bool equal(key_type lhs, key_type rhs) noexcept
+            {
+                return lhs == rhs;
+            }
+        };
+
+        /*
+         * Open-addressing hash set assigning dense ids to its keys, in insertion order.
+         *
+         * Slots are organized in groups of 8, each slot having a control byte holding
+         * either the 7 low bits of the hash of its key or an empty marker. A probe loads
+         * the 8 control bytes of a group as one word and finds the candidate slots with
+         * SWAR byte comparisons, so that most lookups compare a single key. Keys are
+         * never erased, hence there are no tombstones.
+         */
+        template <class T>
+        class hash_set_index
+        {
+        public:
+
+            using traits = hash_key_traits<T>;
+            using key_type = typename traits::key_type;
+            using size_type = std::size_t;
+
+            static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+            hash_set_index()
+            {
+                rehash(8u * group_width);
+            }
+
+            size_type size() const noexcept
+            {
+                return m_keys.size();
+            }
+
+            /**
+             * @return The keys, in insertion order.
+             */
+            const std::vector<key_type>& keys() const noexcept
+            {
+                return m_keys;
+            }
+
+            /**
+             * @return The id of \p key, or npos if the set does not hold it.
+             */
+            size_type find(key_type key) const noexcept
+            {
+                return probe(key, traits::hash(key)).id;
+            }
+
+            /**
+             * Inserts \p key if the set does not hold it yet.
+             *
+             * @return The id of \p key, and true if it has been inserted.
+             */
+            std::pair<size_type, bool> insert(key_type key)
+            {
+                const std::uint64_t h = traits::hash(key);
+                probe_result res = probe(key, h);
+                if (res.id != npos)
+                {
+                    return {res.id, false};
+                }
+                if ((m_keys.size() + 1u) * 8u > m_control.size() * 7u)
+                {
+                    rehash(2u * m_control.size());
+                    res.slot = find_empty_slot(h);
+                }
+                SPARROW_ASSERT_TRUE(m_keys.size() < std::numeric_limits<std::uint32_t>::max());
+                const size_type id = m_keys.size();
+                m_control[res.slot] = control_tag(h);
+                m_slots[res.slot] = static_cast<std::uint32_t>(id);
+                m_keys.push_back(key);
+                m_hashes.push_back(h);
+                return {id, true};
+            }
+
+        private:
+
+            static constexpr size_type group_width = sizeof(std::uint64_t);
+            static constexpr std::uint8_t empty_control = 0x80u;
+            static constexpr std::uint64_t low_bytes = 0x0101010101010101ull;
+            static constexpr std::uint64_t high_bytes = 0x8080808080808080ull;
+
+            struct probe_result
+            {
+                size_type id;
+                // First empty slot met when the key is not found
+                size_type slot;
+            };
+
+            static std::uint8_t control_tag(std::uint64_t h) noexcept
+            {
+                return static_cast<std::uint8_t>(h & 0x7fu);
+            }
+
+            size_type first_group(std::uint64_t h) const noexcept
+            {
+                return (h >> 7) & m_group_mask;
+            }
+
+            std::uint64_t load_group(size_type group) const noexcept
+            {
+                return load_word_bytes(m_control.data() + group * group_width, group_width);
+            }
+
+            static size_type slot_in_group(std::uint64_t byte_mask) noexcept
+            {
+                return static_cast<size_type>(std::countr_zero(byte_mask)) / 8u;
+            }
+
+            probe_result probe(key_type key, std::uint64_t h) const noexcept
+            {
+                const std::uint64_t tag_bytes = low_bytes * control_tag(h);
+                for (size_type group = first_group(h);; group = (group + 1u) & m_group_mask)
+                {
+                    const std::uint64_t control = load_group(group);
+                    // High bit of the bytes equal to the tag; false positives are possible
+                    // only above a true match and are rejected by the key comparison.
+                    const std::uint64_t diff = control ^ tag_bytes;
+                    for (std::uint64_t matches = (diff - low_bytes) & ~diff & high_bytes; matches != 0u;
+                         matches &= matches - 1u)
+                    {
+                        const size_type slot = group * group_width + slot_in_group(matches);
+                        const size_type id = m_slots[slot];
+                        if (traits::equal(m_keys[id], key))
+                        {
+                            return {id, slot};
+                        }
+                    }
+                    const std::uint64_t empties = control & high_bytes;
+                    if (empties != 0u)
+                    {
+                        return {npos, group * group_width + slot_in_group(empties)};
+                    }
+                }
+            }
+
+            size_type find_empty_slot(std::uint64_t h) const noexcept
+            {
+                for (size_type group = first_group(h);; group = (group + 1u) & m_group_mask)
+                {
+                    const std::uint64_t empties = load_group(group) & high_bytes;
+                    if (empties != 0u)
+                    {
+                        return group * group_width + slot_in_group(empties);
+                    }
+                }
+            }
+
+            void rehash(size_type capacity)
+            {
+                SPARROW_ASSERT_TRUE(std::has_single_bit(capacity) && capacity >= group_width);
+                m_control.assign(capacity, empty_control);
+                m_slots.resize(capacity);
+                m_group_mask = capacity / group_width - 1u;
+                for (size_type id = 0; id < m_keys.size(); ++id)
+                {
+                    const size_type slot = find_empty_slot(m_hashes[id]);
+                    m_control[slot] = control_tag(m_hashes[id]);
+                    m_slots[slot] = static_cast<std::uint32_t>(id);
+                }
+            }
+
+            std::vector<std::uint8_t> m_control;
+            std::vector<std::uint32_t> m_slots;
+            std::vector<key_type> m_keys;
+            std::vector<std::uint64_t> m_hashes;
+            size_type m_group_mask = 0;
+        };
+
+        /*
+         * Integers spanning at most this many values are counted and looked up in tables
+         * indexed by their distance to the minimum, instead of a hash set.
+         */
+        inline constexpr std::uint64_t direct_map_max_range = std::uint64_t(1) << 16;
+
+        inline bool use_direct_map(std::uint64_t range, std::size_t element_count) noexcept
+        {
+            return range <= direct_map_max_range && range <= 16u * element_count + 1024u;
+        }
+
+        /*
+         * Calls f(i) for every valid element i, reading the validity 64 bits at a time.
+         */
+        template <class F>
+        void for_each_valid(const bitmap_word_reader& validity, F&& f)
+        {
+            for (std::size_t w = 0; w < validity.word_count(); ++w)
+            {
+                const std::size_t first = w * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, validity.size() - first);
+                const bitmap_word word = validity.word(w);
+                if (word == low_bits_mask(count))
+                {
+                    for (std::size_t j = 0; j < count; ++j)
+                    {
+                        f(first + j);
+                    }
+                }
+                else
+                {
+                    for (bitmap_word bits = word; bits != 0u; bits &= bits - 1u)
+                    {
+                        f(first + static_cast<std::size_t>(std::countr_zero(bits)));
+                    }
+                }
+            }
+        }
+
+        /*
+         * @return The range of the valid values of an integer array, as its minimum and
+         * the number of values it spans, or nothing if every value is null.
+         */
+        template <std::integral T>
+        std::optional<std::pair<T, std::uint64_t>> valid_integer_range(const T* values, const bitmap_word_reader& validity)
+        {
+            T lo = std::numeric_limits<T>::max();
+            T hi = std::numeric_limits<T>::lowest();
+            bool any = false;
+            for_each_valid(
+                validity,
+                [&](std::size_t i)
+                {
+                    lo = std::min(lo, values[i]);
+                    hi = std::max(hi, values[i]);
+                    any = true;
+                }
+            );
+            if (!any)
+            {
+                return std::nullopt;
+            }
+            const std::uint64_t span = to_u64(hi) - to_u64(lo);
+            return std::make_pair(lo, span == std::numeric_limits<std::uint64_t>::max() ? span : span + 1u);
+        }
+
+        /*
+         * Distinct values of an array, in order of first occurrence, with their number of
+         * occurrences. A null element is reported once, at the position of its first
+         * occurrence.
+         */
+        template <class T>
+        struct distinct_values
+        {
+            using key_type = typename hash_key_traits<T>::key_type;
+
+            std::vector<key_type> values;
+            std::vector<std::int64_t> counts;
+            std::optional<std::size_t> null_position;
+            std::int64_t null_count = 0;
+        };
+
+        /*
+         * Counts the null elements of res, and returns the position of the first of them.
+         */
+        template <class T>
+        std::optional<std::size_t> count_nulls(const bitmap_word_reader& validity, distinct_values<T>& res)
+        {
+            std::optional<std::size_t> first_null;
+            for (std::size_t w = 0; w < validity.word_count(); ++w)
+            {
+                const std::size_t first = w * bitmap_word_bits;
+                const bitmap_word nulls = ~validity.word(w) & low_bits_mask(validity.size() - first);
+                if (nulls != 0u && !first_null.has_value())
+                {
+                    first_null = first + static_cast<std::size_t>(std::countr_zero(nulls));
+                }
+                res.null_count += std::popcount(nulls);
+            }
+            return first_null;
+        }
+
+        template <hashable_value_type T>
+        distinct_values<T> compute_distinct_values(const typed_array<T>& array)
+        {
+            using traits = hash_key_traits<T>;
+            const array_data& data = array.get_data();
+            const raw_value_reader<typename typed_array<T>::layout_type> values(data);
+            const bitmap_word_reader validity = make_validity_reader(data);
+
+            distinct_values<T> res;
+            const std::optional<std::size_t> first_null = count_nulls(validity, res);
+            // The null is reported before the values first met after it
+            const auto note_null = [&res, &first_null](std::size_t i, std::size_t distinct_count)
+            {
+                if (first_null.has_value() && !res.null_position.has_value() && *first_null < i)
+                {
+                    res.null_position = distinct_count;
+                }
+            };
+
+            const std::shared_ptr<const array_statistics<T>> statistics = array.cached_statistics();
+            if (statistics != nullptr && statistics->is_sorted)
+            {
+                // Equal values are adjacent: runs are merged without hashing
+                for_each_valid(
+                    validity,
+                    [&](std::size_t i)
+                    {
+                        note_null(i, res.values.size());
+                        const auto key = traits::normalize(values[i]);
+                        if (res.values.empty() || !traits::equal(res.values.back(), key))
+                        {
+                            res.values.push_back(key);
+                            res.counts.push_back(0);
+                        }
+                        ++res.counts.back();
+                    }
+                );
+            }
+            else
+            {
+                if constexpr (std::integral<T>)
+                {
+                    const auto range = valid_integer_range(values.data(), validity);
+                    if (range.has_value() && use_direct_map(range->second, array.size()))
+                    {
+                        const std::uint64_t lo = to_u64(range->first);
+                        std::vector<std::int64_t> counts(range->second, 0);
+                        for_each_valid(
+                            validity,
+                            [&](std::size_t i)
+                            {
+                                note_null(i, res.values.size());
+                                if (counts[to_u64(values[i]) - lo]++ == 0)
+                                {
+                                    res.values.push_back(values[i]);
+                                }
+                            }
+                        );
+                        res.counts.reserve(res.values.size());
+                        for (const T value : res.values)
+                        {
+                            res.counts.push_back(counts[to_u64(value) - lo]);
+                        }
+                    }
+                }
+                if (res.counts.empty())
+                {
+                    hash_set_index<T> set;
+                    for_each_valid(
+                        validity,
+                        [&](std::size_t i)
+                        {
+                            note_null(i, set.size());
+                            const auto [id, inserted] = set.insert(traits::normalize(values[i]));
+                            if (inserted)
+                            {
+                                res.counts.push_back(0);
+                            }
+                            ++res.counts[id];
+                        }
+                    );
+                    res.values = set.keys();
+                }
+            }
+            if (first_null.has_value() && !res.null_position.has_value())
+            {
+                res.null_position = res.values.size();
+            }
+            return res;
+        }
+
+        /*
+         * Distinct values of a morsel, with their number of occurrences and the row of
+         * their first occurrence. The ids of the values are also split by hash partition,
+         * so that the tables of the morsels can be merged one partition at a time.
+         */
+        template <class T>
+        struct morsel_distinct_values
+        {
+            hash_set_index<T> set;
+            std::vector<std::int64_t> counts;
+            std::vector<std::size_t> first_rows;
+            std::vector<std::vector<std::size_t>> partitions;
+        };
+
+        inline std::size_t hash_partition(std::uint64_t h, std::size_t partition_count) noexcept
+        {
+            // The low bits of the hash select the slots of the tables
+            return (h >> 32) % partition_count;
+        }
+
+        /*
+         * Parallel version of compute_distinct_values. Each morsel is deduplicated by a
+         * task in its own table; the tables are then merged by hash partition, each
+         * partition by a task, and the merged values are sorted by their first row, so
+         * that the result is the same as the sequential one.
+         */
+        template <hashable_value_type T>
+        distinct_values<T> compute_distinct_values(const typed_array<T>& array, const parallel_options& options)
+        {
+            using traits = hash_key_traits<T>;
+            using key_type = typename traits::key_type;
+            const array_data& data = array.get_data();
+            const raw_value_reader<typename typed_array<T>::layout_type> values(data);
+            thread_pool& pool = resolve_pool(options);
+            const std::size_t partition_count = pool.thread_count();
+            const std::size_t step = aligned_morsel_size(options.morsel_size);
+
+            std::vector<morsel_distinct_values<T>> morsels((array.size() + step - 1u) / step);
+            parallel_for_chunks(
+                array.size(),
+                step,
+                [&](const morsel& m)
+                {
+                    morsel_distinct_values<T>& local = morsels[m.index];
+                    local.partitions.resize(partition_count);
+                    for_each_valid(
+                        make_validity_reader(data, m),
+                        [&](std::size_t j)
+                        {
+                            const key_type key = traits::normalize(values[m.begin + j]);
+                            const auto [id, inserted] = local.set.insert(key);
+                            if (inserted)
+                            {
+                                local.counts.push_back(0);
+                                local.first_rows.push_back(m.begin + j);
+                                local.partitions[hash_partition(traits::hash(key), partition_count)].push_back(id);
+                            }
+                            ++local.counts[id];
+                        }
+                    );
+                },
+                pool
+            );
+
+            // The morsels are merged in order, so that the first insertion of a value in
+            // the table of its partition holds its first row
+            std::vector<morsel_distinct_values<T>> partitions(partition_count);
+            pool.run(
+                partition_count,
+                [&morsels, &partitions](std::size_t p)
+                {
+                    morsel_distinct_values<T>& merged = partitions[p];
+                    for (const morsel_distinct_values<T>& local : morsels)
+                    {
+                        for (const std::size_t id : local.partitions[p])
+                        {
+                            const auto [merged_id, inserted] = merged.set.insert(local.set.keys()[id]);
+                            if (inserted)
+                            {
+                                merged.counts.push_back(0);
+                                merged.first_rows.push_back(local.first_rows[id]);
+                            }
+                            merged.counts[merged_id] += local.counts[id];
+                        }
+                    }
+                }
+            );
+
+            struct distinct_entry
+            {
+                std::size_t first_row;
+                std::size_t partition;
+                std::size_t id;
+            };
+            std::vector<distinct_entry> entries;
+            for (std::size_t p = 0; p < partition_count; ++p)
+            {
+                for (std::size_t id = 0; id < partitions[p].first_rows.size(); ++id)
+                {
+                    entries.push_back({partitions[p].first_rows[id], p, id});
+                }
+            }
+            std::ranges::sort(entries, std::less<>{}, &distinct_entry::first_row);
+
+            distinct_values<T> res;
+            res.values.reserve(entries.size());
+            res.counts.reserve(entries.size());
+            for (const distinct_entry& entry : entries)
+            {
+                res.values.push_back(partitions[entry.partition].set.keys()[entry.id]);
+                res.counts.push_back(partitions[entry.partition].counts[entry.id]);
+            }
+            // The null is reported before the values first met after it
+            const std::optional<std::size_t> first_null = count_nulls(make_validity_reader(data), res);
+            if (first_null.has_value())
+            {
+                const auto after_null = std::ranges::lower_bound(
+                    entries,
+                    *first_null,
+                    std::less<>{},
+                    &distinct_entry::first_row
+                );
+                res.null_position = static_cast<std::size_t>(after_null - entries.begin());
+            }
+            return res;
+        }
+
+        /*
+         * Builds an array of the given values, with a null inserted at \p null_position.
+         */
+        template <hashable_value_type T>
+        array_data make_distinct_values_result(
+            const std::vector<typename hash_key_traits<T>::key_type>& values,
+            std::optional<std::size_t> null_position
+        )
+        {
+            using key_type = typename hash_key_traits<T>::key_type;
+            const std::size_t size = values.size() + (null_position.has_value() ? 1u : 0u);
+            const std::size_t null_index = null_position.value_or(size);
+            const auto value_at = [&values, null_index](std::size_t i) -> key_type
+            {
+                if (i == null_index)
+                {
+                    return key_type();
+                }
+                return values[i < null_index ? i : i - 1u];
+            };
+
+            array_data::bitmap_type validity(size, true);
+            if (null_position.has_value())
+            {
+                validity.set(null_index, false);
+            }
+            std::vector<array_data::buffer_type> buffers;
+            if constexpr (std::same_as<T, std::string>)
+            {
+                using offset_type = std::int64_t;
+                array_data::buffer_type offsets_buffer((size + 1u) * sizeof(offset_type));
+                offset_type* offsets = offsets_buffer.data<offset_type>();
+                offsets[0] = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    offsets[i + 1] = offsets[i] + static_cast<offset_type>(value_at(i).size());
+                }
+                array_data::buffer_type bytes_buffer(static_cast<std::size_t>(offsets[size]));
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    const std::string_view value = value_at(i);
+                    if (!value.empty())
+                    {
+                        std::memcpy(bytes_buffer.data() + offsets[i], value.data(), value.size());
+                    }
+                }
+                buffers.push_back(std::move(offsets_buffer));
+                buffers.push_back(std::move(bytes_buffer));
+            }
+            else
+            {
+                array_data::buffer_type buffer(size * sizeof(T));
+                T* out = buffer.data<T>();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    out[i] = value_at(i);
+                }
+                buffers.push_back(std::move(buffer));
+            }
+            return {
+                .type = data_descriptor(arrow_traits<T>::type_id),
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = std::move(validity),
+                .buffers = std::move(buffers),
+                .child_data = {},
+                .dictionary = nullptr
+            };
+        }
+
+        /*
+         * Looks values up in a value set. Integer value sets spanning a small range are
+         * stored in a table indexed by the distance to their minimum, other value sets in
+         * a hash_set_index.
+         */
+        template <hashable_value_type T>
+        class value_set_lookup
+        {
+        public:
+
+            using traits = hash_key_traits<T>;
+            using key_type = typename traits::key_type;
+
+            /*
+             * @param value_set The values to look up; null values are ignored.
+             * @param lookup_count The expected number of lookups, used to choose between
+             * the table and the hash set.
+             */
+            value_set_lookup(const typed_array<T>& value_set, std::size_t lookup_count)
+            {
+                const array_data& data = value_set.get_data();
+                const raw_value_reader<typename typed_array<T>::layout_type> values(data);
+                const bitmap_word_reader validity = make_validity_reader(data);
+                SPARROW_ASSERT_TRUE(value_set.size() <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()));
+                if constexpr (std::integral<T>)
+                {
+                    const auto range = valid_integer_range(values.data(), validity);
+                    if (range.has_value() && use_direct_map(range->second, lookup_count))
+                    {
+                        m_direct = true;
+                        m_min = to_u64(range->first);
+                        m_positions.assign(range->second, -1);
+                        for_each_valid(
+                            validity,
+                            [&](std::size_t i)
+                            {
+                                std::int32_t& position = m_positions[to_u64(values[i]) - m_min];
+                                position = position < 0 ? static_cast<std::int32_t>(i) : position;
+                            }
+                        );
+                        return;
+                    }
+                }
+                for_each_valid(
+                    validity,
+                    [&](std::size_t i)
+                    {
+                        if (m_set.insert(traits::normalize(values[i])).second)
+                        {
+                            m_positions.push_back(static_cast<std::int32_t>(i));
+                        }
+                    }
+                );
+            }
+
+            /*
+             * @return The position of the first occurrence of \p value in the value set,
+             * or -1 if the value set does not hold it.
+             */
+            std::int32_t operator()(key_type value) const noexcept
+            {
+                if constexpr (std::integral<T>)
+                {
+                    if (m_direct)
+                    {
+                        const std::uint64_t distance = to_u64(value) - m_min;
+                        return distance < m_positions.size() ? m_positions[distance] : -1;
+                    }
+                }
+                const std::size_t id = m_set.find(traits::normalize(value));
+                return id == hash_set_index<T>::npos ? -1 : m_positions[id];
+            }
+
+        private:
+
+            hash_set_index<T> m_set;
+            // Indexed by the distance to m_min in direct mode, by the id in m_set otherwise
+            std::vector<std::int32_t> m_positions;
+            std::uint64_t m_min = 0;
+            bool m_direct = false;
+        };
+
+        /*
+         * Builds the result of index_in from the positions of the elements, where a
+         * negative position denotes an element that was not found. The positions are
+         * computed by fill(out), and the bitmap built by make_bitmap(size, word_at).
+         */
+        template <class Fill, class MakeBitmap>
+        typed_array<std::int32_t> build_index_in_result(
+            std::size_t size,
+            const Fill& fill,
+            const MakeBitmap& make_bitmap,
+            const bitmap_word_reader& validity
+        )
+        {
+            array_data::buffer_type buffer(size * sizeof(std::int32_t));
+            std::int32_t* out = buffer.data<std::int32_t>();
+            fill(out);
+            array_data::bitmap_type bitmap = make_bitmap(
+                size,
+                [out, size, &validity](std::size_t w)
+                {
+                    const std::size_t first = w * bitmap_word_bits;
+                    const auto found = [out](std::size_t i)
+                    {
+                        return out[i] >= 0;
+                    };
+                    return predicate_word(found, first, std::min(bitmap_word_bits, size - first)) & validity.word(w);
+                }
+            );
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = std::max(out[i], std::int32_t(0));
+            }
+            return typed_array<std::int32_t>(array_data{
+                .type = data_descriptor(data_type::INT32),
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = std::move(bitmap),
+                .buffers = {std::move(buffer)},
+                .child_data = {},
+                .dictionary = nullptr
+            });
+        }
+
+        template <class F>
+        typed_array<std::int32_t> make_index_in_result(std::size_t size, F position_at, const bitmap_word_reader& validity)
+        {
+            return build_index_in_result(
+                size,
+                [size, &position_at](std::int32_t* out)
+                {
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        out[i] = position_at(i);
+                    }
+                },
+                [](std::size_t n, const auto& word_at)
+                {
+                    return make_bitmap_from_words(n, word_at);
+                },
+                validity
+            );
+        }
+
+        /*
+         * Parallel version of make_index_in_result: the positions and the bitmap of each
+         * morsel are computed by a different task.
+         */
+        template <class F>
+        typed_array<std::int32_t> make_index_in_result(
+            const parallel_options& options,
+            std::size_t size,
+            const F& position_at,
+            const bitmap_word_reader& validity
+        )
+        {
+            return build_index_in_result(
+                size,
+                [size, &position_at, &options](std::int32_t* out)
+                {
+                    parallel_for_chunks(
+                        size,
+                        options.morsel_size,
+                        [out, &position_at](const morsel& m)
+                        {
+                            for (std::size_t i = m.begin; i < m.end; ++i)
+                            {
+                                out[i] = position_at(i);
+                            }
+                        },
+                        resolve_pool(options)
+                    );
+                },
+                [&options](std::size_t n, const auto& word_at)
+                {
+                    return make_bitmap_from_words(n, word_at, options);
+                },
+                validity
+            );
+        }
+
+        /*
+         * Evaluates the lookup once per dictionary entry.
+         *
+         * @return The position in \p value_set of each entry of the dictionary of \p array,
+         * -1 for the entries not found.
+         */
+        template <hashable_value_type T>
+        std::vector<std::int32_t> dictionary_entry_positions(const array_data& array, const typed_array<T>& value_set)
+        {
+            if (!array.dictionary.has_value())
+            {
+                throw std::invalid_argument("dictionary kernels require a dictionary-encoded array");
+            }
+            const array_data& dictionary = *array.dictionary;
+            const std::size_t entry_count = array_data_size(dictionary);
+            const value_set_lookup<T> lookup(value_set, entry_count);
+            const raw_value_reader<typename typed_array<T>::layout_type> entries(dictionary);
+            std::vector<std::int32_t> positions(entry_count, -1);
+            for_each_valid(
+                make_validity_reader(dictionary),
+                [&](std::size_t i)
+                {
+                    positions[i] = lookup(entries[i]);
+                }
+            );
+            return positions;
+        }
+
+        /*
+         * Calls f with the position of the dictionary entry of each element, through a
+         * callable mapping an element index to a position.
+         */
+        template <class F>
+        decltype(auto) visit_dictionary_positions(const array_data& array, const std::vector<std::int32_t>& positions, F&& f)
+        {
+            return visit_index_type(
+                array.type.id(),
+                [&]<class IT>()
+                {
+                    const IT* indices = raw_value_reader<fixed_size_layout<IT>>(array).data();
+                    return f(
+                        [indices, &positions](std::size_t i)
+                        {
+                            // Indices of null elements may be out of the dictionary
+                            const std::uint64_t index = to_u64(indices[i]);
+                            return index < positions.size() ? positions[index] : std::int32_t(-1);
+                        }
+                    );
+                }
+            );
+        }
+    }
+
+    /**
+     * Computes the distinct values of an array, in order of first occurrence.
+     *
+     * Arrays whose cached statistics tell they are sorted are deduplicated by merging
+     * runs of equal values, integer arrays whose values span a small range with a table
+     * indexed by value, other arrays with an open-addressing hash set. All NaNs are
+     * considered equal, and so are both zeros.
+     *
+     * @param array The array.
+     * @return The distinct values; if \p array has null elements, the result holds one
+     * null element, at the position of the first null element.
+     */
+    template <hashable_value_type T>
+    typed_array<T> unique(const typed_array<T>& array)
+    {
+        const impl::distinct_values<T> distinct = impl::compute_distinct_values(array);
+        return typed_array<T>(impl::make_distinct_values_result<T>(distinct.values, distinct.null_position));
+    }
+
+    /**
+     * Parallel version of unique: each morsel is deduplicated by a task of
+     * `options.pool` in its own hash table, then the tables are merged by hash
+     * partition, one partition per task. The result is the same as the sequential one.
+     */
+    template <hashable_value_type T>
+    typed_array<T> unique(const typed_array<T>& array, const parallel_options& options)
+    {
+        const impl::distinct_values<T> distinct = impl::compute_distinct_values(array, options);
+        return typed_array<T>(impl::make_distinct_values_result<T>(distinct.values, distinct.null_position));
+    }
+
+    /**
+     * Result of value_counts.
+     */
+    template <hashable_value_type T>
+    struct value_counts_result
+    {
+        /// The distinct values, as computed by unique.
+        typed_array<T> values;
+        /// The number of occurrences of each distinct value, nulls included.
+        typed_array<std::int64_t> counts;
+    };
+
+    namespace impl
+    {
+        template <hashable_value_type T>
+        value_counts_result<T> make_value_counts_result(distinct_values<T> distinct)
+        {
+            if (distinct.null_position.has_value())
+            {
+                const auto position = static_cast<std::ptrdiff_t>(*distinct.null_position);
+                distinct.counts.insert(distinct.counts.begin() + position, distinct.null_count);
+            }
+            return {
+                typed_array<T>(make_distinct_values_result<T>(distinct.values, distinct.null_position)),
+                typed_array<std::int64_t>(make_distinct_values_result<std::int64_t>(distinct.counts, std::nullopt))
+            };
+        }
+    }
+
+    /**
+     * Counts the occurrences of each distinct value of an array.
+     *
+     * @see unique
+     */
+    template <hashable_value_type T>
+    value_counts_result<T> value_counts(const typed_array<T>& array)
+    {
+        return impl::make_value_counts_result(impl::compute_distinct_values(array));
+    }
+
+    /**
+     * Parallel version of value_counts.
+     *
+     * @see unique(const typed_array<T>&, const parallel_options&)
+     */
+    template <hashable_value_type T>
+    value_counts_result<T> value_counts(const typed_array<T>& array, const parallel_options& options)
+    {
+        return impl::make_value_counts_result(impl::compute_distinct_values(array, options));
+    }
+
+    /**
+     * Tests whether each element of an array is in a set of values.
+     *
+     * The result is null where \p array is null; null elements of \p value_set are
+     * ignored.
+     *
+     * @param array The values to look up.
+     * @param value_set The set of values.
+     * @return The bit-packed membership of each element of \p array.
+     */
+    template <hashable_value_type T>
+    packed_boolean_array is_in(const typed_array<T>& array, const typed_array<T>& value_set)
+    {
+        const impl::value_set_lookup<T> lookup(value_set, array.size());
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        return impl::make_comparison_result(
+            array.size(),
+            [&](std::size_t i)
+            {
+                return lookup(values[i]) >= 0;
+            },
+            make_validity_reader(array.get_data())
+        );
+    }
+
+    /**
+     * Computes the position in a set of values of each element of an array.
+     *
+     * @param array The values to look up.
+     * @param value_set The set of values.
+     * @return The position of the first occurrence of each element of \p array in
+     * \p value_set; null where \p array is null or where the element is not found.
+     */
+    template <hashable_value_type T>
+    typed_array<std::int32_t> index_in(const typed_array<T>& array, const typed_array<T>& value_set)
+    {
+        const impl::value_set_lookup<T> lookup(value_set, array.size());
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        return impl::make_index_in_result(
+            array.size(),
+            [&](std::size_t i)
+            {
+                return lookup(values[i]);
+            },
+            make_validity_reader(array.get_data())
+        );
+    }
+
+    /**
+     * Parallel version of is_in: the lookup table of \p value_set is built once, then
+     * probed by the tasks of `options.pool`, each one for a morsel of \p array.
+     */
+    template <hashable_value_type T>
+    packed_boolean_array
+    is_in(const typed_array<T>& array, const typed_array<T>& value_set, const parallel_options& options)
+    {
+        const impl::value_set_lookup<T> lookup(value_set, array.size());
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        return impl::make_comparison_result(
+            options,
+            array.size(),
+            [&](std::size_t i)
+            {
+                return lookup(values[i]) >= 0;
+            },
+            make_validity_reader(array.get_data())
+        );
+    }
+
+    /**
+     * Parallel version of index_in.
+     *
+     * @see is_in(const typed_array<T>&, const typed_array<T>&, const parallel_options&)
+     */
+    template <hashable_value_type T>
+    typed_array<std::int32_t>
+    index_in(const typed_array<T>& array, const typed_array<T>& value_set, const parallel_options& options)
+    {
+        const impl::value_set_lookup<T> lookup(value_set, array.size());
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        return impl::make_index_in_result(
+            options,
+            array.size(),
+            [&](std::size_t i)
+            {
+                return lookup(values[i]);
+            },
+            make_validity_reader(array.get_data())
+        );
+    }
+
+    /**
+     * Dictionary-encoded version of is_in: the lookup is evaluated once per dictionary
+     * entry, then gathered through the indices.
+     *
+     * @param array A dictionary-encoded array whose dictionary holds values of type T.
+     * @param value_set The set of values.
+     * @throws std::invalid_argument if \p array is not dictionary-encoded.
+     */
+    template <hashable_value_type T>
+    packed_boolean_array dictionary_is_in(const array_data& array, const typed_array<T>& value_set)
+    {
+        const std::vector<std::int32_t> positions = impl::dictionary_entry_positions(array, value_set);
+        return impl::visit_dictionary_positions(
+            array,
+            positions,
+            [&array](const auto& position_at)
+            {
+                return impl::make_comparison_result(
+                    array_data_size(array),
+                    [&position_at](std::size_t i)
+                    {
+                        return position_at(i) >= 0;
+                    },
+                    make_validity_reader(array)
+                );
+            }
+        );
+    }
+
+    /**
+     * Dictionary-encoded version of index_in.
+     *
+     * @see dictionary_is_in
+     */
+    template <hashable_value_type T>
+    typed_array<std::int32_t> dictionary_index_in(const array_data& array, const typed_array<T>& value_set)
+    {
+        const std::vector<std::int32_t> positions = impl::dictionary_entry_positions(array, value_set);
+        return impl::visit_dictionary_positions(
+            array,
+            positions,
+            [&array](const auto& position_at)
+            {
+                return impl::make_index_in_result(array_data_size(array), position_at, make_validity_reader(array));
+            }
+        );
+    }
+}
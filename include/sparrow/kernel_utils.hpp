@@ -0,0 +1,254 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/fixed_size_layout.hpp"
+#include "sparrow/mp_utils.hpp"
+#include "sparrow/variable_size_binary_layout.hpp"
+
+namespace sparrow
+{
+    /**
+     * @return The number of elements of \p data, that is its length minus its offset.
+     */
+    inline std::size_t array_data_size(const array_data& data)
+    {
+        SPARROW_ASSERT_TRUE(data.offset <= data.length);
+        return static_cast<std::size_t>(data.length - data.offset);
+    }
+
+    /**
+     * @return A reader over the validity bitmap of the elements of \p data.
+     */
+    inline bitmap_word_reader make_validity_reader(const array_data& data)
+    {
+        return bitmap_word_reader(data.bitmap, static_cast<std::size_t>(data.offset), array_data_size(data));
+    }
+
+    /**
+     * Unchecked random access to the values of an array_data, ignoring its validity bitmap.
+     *
+     * This is the building block of the kernels: it resolves the buffers once, so that
+     * accessing an element is a plain memory access instead of a reference proxy
+     * construction. Index 0 denotes the first element after the offset of the array_data.
+     *
+     * @tparam Layout The layout of the array_data.
+     */
+    template <class Layout>
+    class raw_value_reader;
+
+    /**
+     * Specialization for fixed size layouts: the values are contiguous.
+     */
+    template <class T>
+    class raw_value_reader<fixed_size_layout<T>>
+    {
+    public:
+
+        using value_type = T;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+
+        explicit raw_value_reader(const array_data& data)
+            : p_values(data.buffers[0].template data<T>() + data.offset)
+        {
+            SPARROW_ASSERT_FALSE(data.buffers.empty());
+        }
+
+        const_reference operator[](size_type i) const
+        {
+            return p_values[i];
+        }
+
+        const T* data() const
+        {
+            return p_values;
+        }
+
+    private:
+
+        const T* p_values;
+    };
+
+    /**
+     * Specialization for variable size binary layouts: values are returned as views
+     * on the data buffer.
+     */
+    template <class T, class R, class CR, layout_offset OT>
+    class raw_value_reader<variable_size_binary_layout<T, R, CR, OT>>
+    {
+    public:
+
+        using char_type = typename T::value_type;
+        using value_type = std::basic_string_view<char_type>;
+        using const_reference = value_type;
+        using offset_type = OT;
+        using size_type = std::size_t;
+
+        explicit raw_value_reader(const array_data& data)
+            : p_offsets(data.buffers[0].template data<OT>() + data.offset)
+            , p_data(data.buffers[1].template data<char_type>())
+        {
+            SPARROW_ASSERT_TRUE(data.buffers.size() == 2u);
+        }
+
+        const_reference operator[](size_type i) const
+        {
+            return value_type(p_data + p_offsets[i], static_cast<size_type>(p_offsets[i + 1] - p_offsets[i]));
+        }
+
+        /*
+         * @return The offsets of the elements, the value i spans [offsets()[i], offsets()[i + 1]).
+         */
+        const OT* offsets() const
+        {
+            return p_offsets;
+        }
+
+        const char_type* bytes() const
+        {
+            return p_data;
+        }
+
+    private:
+
+        const OT* p_offsets;
+        const char_type* p_data;
+    };
+
+    /**
+     * Matches layouts storing fixed size values contiguously.
+     */
+    template <class Layout>
+    concept contiguous_layout = mpl::is_type_instance_of_v<Layout, fixed_size_layout>;
+
+    /**
+     * Matches layouts whose values can be read with a `raw_value_reader`.
+     */
+    template <class Layout>
+    concept raw_readable_layout = contiguous_layout<Layout>
+                                  || mpl::is_type_instance_of_v<Layout, variable_size_binary_layout>;
+
+    /**
+     * Evaluates a predicate on up to 64 consecutive indices and packs the results.
+     *
+     * The loop has no branch and, for full words, a constant trip count, so that
+     * compilers can turn it into vector compare + mask extraction instructions.
+     *
+     * @param pred Callable taking an index and returning a bool.
+     * @param first The first index to evaluate.
+     * @param count The number of indices to evaluate, at most 64.
+     * @return A word whose bit j is `pred(first + j)`.
+     */
+    template <class Pred>
+    bitmap_word predicate_word(const Pred& pred, std::size_t first, std::size_t count)
+    {
+        bitmap_word res = 0;
+        if (count == bitmap_word_bits)
+        {
+            for (std::size_t j = 0; j < bitmap_word_bits; ++j)
+            {
+                res |= bitmap_word(pred(first + j)) << j;
+            }
+        }
+        else
+        {
+            SPARROW_ASSERT_TRUE(count < bitmap_word_bits);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                res |= bitmap_word(pred(first + j)) << j;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Builds the bitmap of \p size bits whose bit i is `pred(i)`.
+     */
+    template <class Pred>
+    dynamic_bitset<std::uint8_t> make_bitmap_from_predicate(std::size_t size, const Pred& pred)
+    {
+        return make_bitmap_from_words(
+            size,
+            [&pred, size](std::size_t i)
+            {
+                const std::size_t first = i * bitmap_word_bits;
+                return predicate_word(pred, first, std::min(bitmap_word_bits, size - first));
+            }
+        );
+    }
+
+    /**
+     * Calls \p f with the integral type of the dictionary indices described by \p id,
+     * as `f.template operator()<T>()`.
+     *
+     * @return The result of \p f.
+     * @throws std::invalid_argument if \p id does not denote an integral type.
+     */
+    template <class F>
+    decltype(auto) visit_index_type(data_type id, F&& f)
+    {
+        switch (id)
+        {
+            case data_type::UINT8:
+                return f.template operator()<std::uint8_t>();
+            case data_type::INT8:
+                return f.template operator()<std::int8_t>();
+            case data_type::UINT16:
+                return f.template operator()<std::uint16_t>();
+            case data_type::INT16:
+                return f.template operator()<std::int16_t>();
+            case data_type::UINT32:
+                return f.template operator()<std::uint32_t>();
+            case data_type::INT32:
+                return f.template operator()<std::int32_t>();
+            case data_type::UINT64:
+                return f.template operator()<std::uint64_t>();
+            case data_type::INT64:
+                return f.template operator()<std::int64_t>();
+            default:
+                throw std::invalid_argument("dictionary indices must be of integral type");
+        }
+    }
+
+    namespace impl
+    {
+        inline bool same_bitmap(const array_data::bitmap_type& lhs, const array_data::bitmap_type& rhs)
+        {
+            return lhs.size() == rhs.size() && lhs.null_count() == rhs.null_count()
+                   && std::equal(lhs.data(), lhs.data() + lhs.block_count(), rhs.data());
+        }
+
+        inline bool same_dictionary(const array_data& lhs, const array_data& rhs)
+        {
+            SPARROW_ASSERT_TRUE(lhs.dictionary.has_value() && rhs.dictionary.has_value());
+            const array_data& ldict = *lhs.dictionary;
+            const array_data& rdict = *rhs.dictionary;
+            return ldict.type.id() == rdict.type.id() && ldict.length == rdict.length
+                   && ldict.offset == rdict.offset && ldict.buffers == rdict.buffers
+                   && same_bitmap(ldict.bitmap, rdict.bitmap);
+        }
+    }
+}
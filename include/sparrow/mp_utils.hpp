@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <string_view>
 #include <type_traits>
 
 namespace sparrow::mpl
@@ -393,6 +396,25 @@ namespace sparrow::mpl
     template <class T>
     concept constant_range = std::ranges::input_range<T> && constant_iterator<std::ranges::iterator_t<T>>;
 
+    /// String literal usable as a template argument, such as the name of a column.
+    ///
+    /// @tparam N The size of the literal, including its terminating null character.
+    template <std::size_t N>
+    struct fixed_string
+    {
+        constexpr fixed_string(const char (&str)[N])
+        {
+            std::copy_n(str, N, value);
+        }
+
+        constexpr std::string_view view() const
+        {
+            return std::string_view(value, N - 1);
+        }
+
+        char value[N] = {};
+    };
+
     /// Invokes undefined behavior. An implementation may use this to optimize impossible code branches
     /// away (typically, in optimized builds) or to trap them to prevent further execution (typically, in
     /// debug builds).
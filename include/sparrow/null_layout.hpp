@@ -90,8 +90,8 @@ namespace sparrow
         using const_value_range = std::ranges::subrange<const_value_iterator>;
         using const_bitmap_range = std::ranges::subrange<const_bitmap_iterator>;
 
-        explicit null_layout(array_data& data);
-        void rebind_data(array_data& data);
+        explicit null_layout(array_data& data) noexcept;
+        void rebind_data(array_data& data) noexcept;
 
         size_type size() const;
 
@@ -173,13 +173,13 @@ namespace sparrow
      * null_layout implementation *
      ******************************/
 
-    inline null_layout::null_layout(array_data& data)
+    inline null_layout::null_layout(array_data& data) noexcept
         : m_data(data)
     {
         SPARROW_ASSERT_TRUE(data_ref().buffers.size() == 0u);
     }
 
-    inline void null_layout::rebind_data(array_data& data)
+    inline void null_layout::rebind_data(array_data& data) noexcept
     {
         SPARROW_ASSERT_TRUE(data_ref().buffers.size() == 0u);
         m_data = data;
@@ -0,0 +1,179 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+
+namespace sparrow
+{
+    /**
+     * Bit-packed array of nullable booleans.
+     *
+     * This is the result type of the comparison and boolean kernels. Contrary to
+     * `typed_array<bool>`, which stores one byte per value, both the values and the
+     * validity are stored as bitmaps, so that predicates can be combined 64 rows at
+     * a time.
+     *
+     * Invariant: the value bit of a null element is always unset.
+     */
+    class packed_boolean_array
+    {
+    public:
+
+        using bitmap_type = array_data::bitmap_type;
+        using size_type = std::size_t;
+        using value_type = std::optional<bool>;
+
+        packed_boolean_array() = default;
+
+        /**
+         * @param values The bitmap of the values.
+         * @param validity The validity bitmap.
+         * @pre \p values and \p validity must have the same size.
+         * @pre The bits of \p values must be unset where the bits of \p validity are unset.
+         */
+        packed_boolean_array(bitmap_type values, bitmap_type validity);
+
+        bool empty() const;
+        size_type size() const;
+
+        /*
+         * @return The number of null elements.
+         */
+        size_type null_count() const;
+
+        /*
+         * @return The number of non-null elements whose value is true.
+         */
+        size_type true_count() const;
+
+        /*
+         * @return The element at index \p i, std::nullopt if it is null.
+         */
+        value_type operator[](size_type i) const;
+
+        const bitmap_type& values() const;
+        const bitmap_type& validity() const;
+
+        /**
+         * Unpacks the array into an array_data usable with `typed_array<bool>`, that is
+         * with one byte per value.
+         */
+        array_data to_array_data() const;
+
+    private:
+
+        bitmap_type m_values;
+        bitmap_type m_validity;
+    };
+
+    bool operator==(const packed_boolean_array& lhs, const packed_boolean_array& rhs);
+
+    /***************************************
+     * packed_boolean_array implementation *
+     ***************************************/
+
+    inline packed_boolean_array::packed_boolean_array(bitmap_type values, bitmap_type validity)
+        : m_values(std::move(values))
+        , m_validity(std::move(validity))
+    {
+        SPARROW_ASSERT_TRUE(m_values.size() == m_validity.size());
+    }
+
+    inline bool packed_boolean_array::empty() const
+    {
+        return size() == 0u;
+    }
+
+    inline auto packed_boolean_array::size() const -> size_type
+    {
+        return m_validity.size();
+    }
+
+    inline auto packed_boolean_array::null_count() const -> size_type
+    {
+        return m_validity.null_count();
+    }
+
+    inline auto packed_boolean_array::true_count() const -> size_type
+    {
+        return m_values.size() - m_values.null_count();
+    }
+
+    inline auto packed_boolean_array::operator[](size_type i) const -> value_type
+    {
+        SPARROW_ASSERT_TRUE(i < size());
+        if (!m_validity.test(i))
+        {
+            return std::nullopt;
+        }
+        return m_values.test(i);
+    }
+
+    inline auto packed_boolean_array::values() const -> const bitmap_type&
+    {
+        return m_values;
+    }
+
+    inline auto packed_boolean_array::validity() const -> const bitmap_type&
+    {
+        return m_validity;
+    }
+
+    inline array_data packed_boolean_array::to_array_data() const
+    {
+        const size_type n = size();
+        array_data::buffer_type values_buffer(n * sizeof(bool));
+        bool* out = values_buffer.data<bool>();
+        const bitmap_word_reader reader(m_values, 0u, n);
+        for (size_type i = 0; i < reader.word_count(); ++i)
+        {
+            const size_type first = i * bitmap_word_bits;
+            unpack_bools(reader.word(i), std::min(bitmap_word_bits, n - first), out + first);
+        }
+        return {
+            .type = data_descriptor(data_type::BOOL),
+            .length = static_cast<array_data::length_type>(n),
+            .offset = 0,
+            .bitmap = m_validity,
+            .buffers = {std::move(values_buffer)},
+            .child_data = {},
+            .dictionary = nullptr
+        };
+    }
+
+    inline bool operator==(const packed_boolean_array& lhs, const packed_boolean_array& rhs)
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (lhs[i] != rhs[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
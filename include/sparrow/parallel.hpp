@@ -0,0 +1,522 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/dynamic_bitset.hpp"
+#include "sparrow/kernel_utils.hpp"
+
+namespace sparrow
+{
+    // Not included, since array_data_factory.hpp, which typed_array.hpp includes, uses
+    // this header
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    class typed_array;
+
+    /**
+     * Pool of threads running batches of indexed tasks.
+     *
+     * The tasks of a batch are split in contiguous ranges, one per thread. A thread
+     * runs the tasks of its range in order, and once it is exhausted, steals the second
+     * half of the remaining range of another thread. The thread submitting a batch runs
+     * tasks too, and returns once every task has run.
+     *
+     * Batches submitted from a task run sequentially in the calling thread, so that
+     * kernels using the pool can be nested without deadlock. Batches submitted
+     * concurrently from different threads run one after the other.
+     */
+    class thread_pool
+    {
+    public:
+
+        /**
+         * @param thread_count The number of threads running the tasks, including the
+         *                     thread submitting them.
+         */
+        explicit thread_pool(std::size_t thread_count = default_thread_count());
+        ~thread_pool();
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        thread_pool(thread_pool&&) = delete;
+        thread_pool& operator=(thread_pool&&) = delete;
+
+        /**
+         * @return The number of threads running the tasks, including the submitting thread.
+         */
+        std::size_t thread_count() const noexcept;
+
+        /**
+         * Runs `f(i)` for each i in [0, task_count), and waits for all of them.
+         *
+         * \p f is called concurrently from different threads. If a task throws, the tasks
+         * that have not started yet are skipped, and the first exception is rethrown.
+         */
+        template <class F>
+        void run(std::size_t task_count, const F& f);
+
+        /**
+         * @return The pool used by the parallel kernels when none is specified, with one
+         *         thread per hardware thread.
+         */
+        static thread_pool& default_pool();
+
+        static std::size_t default_thread_count() noexcept;
+
+    private:
+
+        // Remaining tasks of a thread, on their own cache line
+        struct alignas(64) task_range
+        {
+            std::mutex mutex;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+        };
+
+        using invoke_type = void (*)(const void*, std::size_t);
+
+        void worker_loop(std::size_t slot);
+        void run_tasks(std::size_t slot);
+        bool pop_task(std::size_t slot, std::size_t& task);
+        void execute(std::size_t task);
+
+        static bool& in_task() noexcept;
+
+        std::vector<task_range> m_ranges;
+        std::vector<std::thread> m_threads;
+        // Serializes the batches
+        std::mutex m_run_mutex;
+        // Protects the state below, and the transitions of the ranges between batches
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::size_t m_generation = 0;
+        std::size_t m_active_workers = 0;
+        bool m_stop = false;
+        invoke_type m_invoke = nullptr;
+        const void* p_callable = nullptr;
+        std::exception_ptr m_exception;
+        std::atomic<std::size_t> m_remaining = 0;
+        std::atomic<bool> m_failed = false;
+    };
+
+    /**
+     * Default number of rows of a morsel: the values and the bitmap of a morsel of a
+     * numeric array fit in the L2 cache.
+     */
+    inline constexpr std::size_t default_morsel_size = 16384;
+
+    /**
+     * Parameters of the parallel overloads of the kernels.
+     */
+    struct parallel_options
+    {
+        /// The number of rows processed by a task, rounded up to a multiple of 64.
+        std::size_t morsel_size = default_morsel_size;
+        /// The pool running the tasks, thread_pool::default_pool() if null.
+        thread_pool* pool = nullptr;
+    };
+
+    /**
+     * Range of rows [begin, end) processed by a task.
+     */
+    struct morsel
+    {
+        /// The position of the morsel in the array.
+        std::size_t index;
+        std::size_t begin;
+        std::size_t end;
+
+        std::size_t size() const noexcept
+        {
+            return end - begin;
+        }
+    };
+
+    namespace impl
+    {
+        inline thread_pool& resolve_pool(const parallel_options& options)
+        {
+            return options.pool != nullptr ? *options.pool : thread_pool::default_pool();
+        }
+    }
+
+    /**
+     * @return A reader over the validity bitmap of the elements of \p data in the morsel \p m.
+     */
+    inline bitmap_word_reader make_validity_reader(const array_data& data, const morsel& m)
+    {
+        return bitmap_word_reader(data.bitmap, static_cast<std::size_t>(data.offset) + m.begin, m.size());
+    }
+
+    /**
+     * @return \p morsel_size rounded up to a multiple of 64, so that morsels start on a
+     *         word boundary of the bitmaps.
+     */
+    constexpr std::size_t aligned_morsel_size(std::size_t morsel_size) noexcept
+    {
+        return std::max(bitmap_word_count(morsel_size), std::size_t(1)) * bitmap_word_bits;
+    }
+
+    /**
+     * Calls `f(m)` in parallel for each morsel m of the rows [0, size).
+     *
+     * Morsels start on multiples of 64 rows, so that tasks writing the bitmap of a result
+     * never write the same word.
+     *
+     * @param size The number of rows.
+     * @param morsel_size The number of rows of a morsel, rounded up to a multiple of 64.
+     * @param f Callable taking a const morsel&.
+     * @param pool The pool running the tasks.
+     */
+    template <class F>
+    void parallel_for_chunks(std::size_t size, std::size_t morsel_size, const F& f, thread_pool& pool = thread_pool::default_pool())
+    {
+        const std::size_t step = aligned_morsel_size(morsel_size);
+        pool.run(
+            (size + step - 1u) / step,
+            [&f, size, step](std::size_t i)
+            {
+                f(morsel{i, i * step, std::min(size, (i + 1u) * step)});
+            }
+        );
+    }
+
+    /**
+     * Calls `f(m)` in parallel for each morsel m of the elements of \p data. The rows of
+     * the morsels are relative to the offset of \p data.
+     */
+    template <class F>
+    void parallel_for_chunks(const array_data& data, std::size_t morsel_size, const F& f, thread_pool& pool = thread_pool::default_pool())
+    {
+        parallel_for_chunks(array_data_size(data), morsel_size, f, pool);
+    }
+
+    /**
+     * Calls `f(m)` in parallel for each morsel m of the elements of \p array.
+     */
+    template <class T, class Layout, class F>
+    void parallel_for_chunks(
+        const typed_array<T, Layout>& array,
+        std::size_t morsel_size,
+        const F& f,
+        thread_pool& pool = thread_pool::default_pool()
+    )
+    {
+        parallel_for_chunks(array.get_data(), morsel_size, f, pool);
+    }
+
+    /**
+     * Computes `map(m)` in parallel for each morsel m of the rows [0, size), and folds
+     * the results with `combine(accumulator, std::move(result))` in the order of the
+     * morsels.
+     *
+     * The fold is sequential and ordered, so that the result does not depend on the
+     * number of threads nor on the scheduling of the tasks.
+     *
+     * @param init The initial value of the accumulator.
+     * @return The accumulator.
+     */
+    template <class R, class Map, class Combine>
+    R parallel_reduce(std::size_t size, const parallel_options& options, R init, const Map& map, const Combine& combine)
+    {
+        const std::size_t step = aligned_morsel_size(options.morsel_size);
+        std::vector<std::optional<R>> partials((size + step - 1u) / step);
+        parallel_for_chunks(
+            size,
+            step,
+            [&partials, &map](const morsel& m)
+            {
+                partials[m.index].emplace(map(m));
+            },
+            impl::resolve_pool(options)
+        );
+        for (std::optional<R>& partial : partials)
+        {
+            combine(init, std::move(*partial));
+        }
+        return init;
+    }
+
+    /**
+     * Parallel version of make_bitmap_from_words: the words of each morsel are computed
+     * by a different task.
+     */
+    template <class F>
+    dynamic_bitset<std::uint8_t> make_bitmap_from_words(std::size_t size, const F& word_at, const parallel_options& options)
+    {
+        const std::size_t block_count = (size + 7u) / 8u;
+        if (block_count == 0u)
+        {
+            return dynamic_bitset<std::uint8_t>();
+        }
+        impl::bitmap_blocks_ptr blocks = impl::allocate_bitmap_blocks(block_count);
+        parallel_for_chunks(
+            size,
+            options.morsel_size,
+            [out = blocks.get(), block_count, size, &word_at](const morsel& m)
+            {
+                for (std::size_t i = m.begin / bitmap_word_bits; i < bitmap_word_count(m.end); ++i)
+                {
+                    const std::size_t first_block = i * sizeof(bitmap_word);
+                    const std::size_t byte_count = std::min(sizeof(bitmap_word), block_count - first_block);
+                    const bitmap_word word = word_at(i);
+                    store_word_bytes(
+                        out + first_block,
+                        word & low_bits_mask(size - i * bitmap_word_bits),
+                        byte_count
+                    );
+                }
+            },
+            impl::resolve_pool(options)
+        );
+        return dynamic_bitset<std::uint8_t>(blocks.release(), size);
+    }
+
+    /******************************
+     * thread_pool implementation *
+     ******************************/
+
+    inline thread_pool::thread_pool(std::size_t thread_count)
+        : m_ranges(std::max(thread_count, std::size_t(1)))
+    {
+        m_threads.reserve(m_ranges.size() - 1u);
+        for (std::size_t slot = 1; slot < m_ranges.size(); ++slot)
+        {
+            m_threads.emplace_back(
+                [this, slot]
+                {
+                    worker_loop(slot);
+                }
+            );
+        }
+    }
+
+    inline thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    inline std::size_t thread_pool::thread_count() const noexcept
+    {
+        return m_ranges.size();
+    }
+
+    template <class F>
+    void thread_pool::run(std::size_t task_count, const F& f)
+    {
+        if (m_threads.empty() || task_count <= 1u || in_task())
+        {
+            for (std::size_t i = 0; i < task_count; ++i)
+            {
+                f(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(m_run_mutex);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // A worker woken late by the previous batch may still be looking for tasks
+            m_idle.wait(
+                lock,
+                [this]
+                {
+                    return m_active_workers == 0u;
+                }
+            );
+            for (std::size_t slot = 0; slot < m_ranges.size(); ++slot)
+            {
+                std::lock_guard<std::mutex> range_lock(m_ranges[slot].mutex);
+                m_ranges[slot].begin = task_count * slot / m_ranges.size();
+                m_ranges[slot].end = task_count * (slot + 1u) / m_ranges.size();
+            }
+            m_invoke = [](const void* callable, std::size_t task)
+            {
+                (*static_cast<const F*>(callable))(task);
+            };
+            p_callable = std::addressof(f);
+            m_exception = nullptr;
+            m_failed.store(false, std::memory_order_relaxed);
+            m_remaining.store(task_count, std::memory_order_relaxed);
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        in_task() = true;
+        run_tasks(0u);
+        in_task() = false;
+
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(
+                lock,
+                [this]
+                {
+                    return m_remaining.load(std::memory_order_acquire) == 0u && m_active_workers == 0u;
+                }
+            );
+            exception = std::exchange(m_exception, nullptr);
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    inline thread_pool& thread_pool::default_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    inline std::size_t thread_pool::default_thread_count() noexcept
+    {
+        return std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+    }
+
+    inline void thread_pool::worker_loop(std::size_t slot)
+    {
+        in_task() = true;
+        std::size_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(
+                    lock,
+                    [this, generation]
+                    {
+                        return m_stop || m_generation != generation;
+                    }
+                );
+                if (m_stop)
+                {
+                    return;
+                }
+                generation = m_generation;
+                ++m_active_workers;
+            }
+            run_tasks(slot);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_active_workers;
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    inline void thread_pool::run_tasks(std::size_t slot)
+    {
+        std::size_t task = 0;
+        while (pop_task(slot, task))
+        {
+            execute(task);
+        }
+    }
+
+    inline bool thread_pool::pop_task(std::size_t slot, std::size_t& task)
+    {
+        task_range& own = m_ranges[slot];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end)
+            {
+                task = own.begin++;
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < m_ranges.size(); ++i)
+        {
+            task_range& victim = m_ranges[(slot + i) % m_ranges.size()];
+            std::size_t first = 0;
+            std::size_t last = 0;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                const std::size_t count = victim.end - victim.begin;
+                if (count == 0u)
+                {
+                    continue;
+                }
+                last = victim.end;
+                first = last - (count + 1u) / 2u;
+                victim.end = first;
+            }
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = first + 1u;
+            own.end = last;
+            task = first;
+            return true;
+        }
+        return false;
+    }
+
+    inline void thread_pool::execute(std::size_t task)
+    {
+        if (!m_failed.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                m_invoke(p_callable, task);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_exception)
+                {
+                    m_exception = std::current_exception();
+                }
+                m_failed.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (m_remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_idle.notify_all();
+        }
+    }
+
+    inline bool& thread_pool::in_task() noexcept
+    {
+        static thread_local bool res = false;
+        return res;
+    }
+}
@@ -0,0 +1,443 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "sparrow/contracts.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/sketch.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    template <class T>
+    concept quantile_value_type = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float>
+                                  || std::same_as<T, double>;
+
+    /**
+     * Merging t-digest (Dunning and Ertl, "Computing extremely accurate quantiles
+     * using t-digests", 2019) estimating the quantiles of numeric arrays.
+     *
+     * Values are appended to a buffer, which is sorted and merged into the centroids
+     * once full. The size of the centroids is bounded by the k1 scale function, so
+     * that their number is about the compression and the estimates are the most
+     * accurate near the extreme quantiles. NaN values are ignored.
+     *
+     * Digests can be merged, so that arrays can be sketched by different threads or
+     * in different batches.
+     */
+    class tdigest
+    {
+    public:
+
+        struct centroid
+        {
+            double mean;
+            double weight;
+
+            friend bool operator==(const centroid&, const centroid&) = default;
+        };
+
+        /// Largest compression of a digest.
+        static constexpr double max_compression = 1e5;
+
+        /**
+         * @param compression Bound of the number of centroids; larger values trade
+         *                    memory for accuracy.
+         * @pre \p compression must be in [10, max_compression].
+         */
+        explicit tdigest(double compression = 100.);
+
+        double compression() const noexcept;
+
+        /**
+         * @return The total weight of the values added to the digest.
+         */
+        double count() const noexcept;
+
+        /**
+         * @return The smallest value added to the digest, or NaN if it is empty.
+         */
+        double min() const noexcept;
+
+        /**
+         * @return The largest value added to the digest, or NaN if it is empty.
+         */
+        double max() const noexcept;
+
+        /**
+         * Adds the non-null elements of \p array to the digest.
+         */
+        template <quantile_value_type T>
+        void update(const typed_array<T>& array);
+
+        /**
+         * Parallel version of update: each morsel of \p array is added to its own digest,
+         * and the digests are merged in the order of the morsels.
+         */
+        template <quantile_value_type T>
+        void update(const typed_array<T>& array, const parallel_options& options);
+
+        /**
+         * Adds \p value with the weight \p weight.
+         *
+         * @pre \p weight must be positive.
+         */
+        void add(double value, double weight = 1.);
+
+        /**
+         * Adds the values summarized by \p other.
+         */
+        void merge(const tdigest& other);
+
+        /**
+         * @param q The quantile to estimate, in [0, 1].
+         * @return The estimated value of the quantile \p q, or NaN if the digest is empty.
+         */
+        double quantile(double q) const;
+
+        /**
+         * @return The centroids of the digest, sorted by mean.
+         */
+        std::span<const centroid> centroids() const;
+
+        std::vector<std::uint8_t> serialize() const;
+
+        /**
+         * @throws std::invalid_argument if \p bytes does not hold a serialized digest.
+         */
+        static tdigest deserialize(std::span<const std::uint8_t> bytes);
+
+    private:
+
+        template <quantile_value_type T>
+        void update_morsel(const typed_array<T>& array, const morsel& m);
+
+        double scale(double q) const noexcept;
+        double inverse_scale(double k) const noexcept;
+        void compress() const;
+
+        double m_compression;
+        std::size_t m_buffer_capacity;
+        double m_min = std::numeric_limits<double>::infinity();
+        double m_max = -std::numeric_limits<double>::infinity();
+        // Queries compress the pending values, which does not change the
+        // summarized distribution.
+        mutable double m_weight = 0.;
+        mutable std::vector<centroid> m_centroids;
+        mutable std::vector<centroid> m_buffer;
+    };
+
+    /**************************
+     * tdigest implementation *
+     **************************/
+
+    inline tdigest::tdigest(double compression)
+        : m_compression(compression)
+        , m_buffer_capacity(static_cast<std::size_t>(8. * compression))
+    {
+        SPARROW_ASSERT_TRUE(compression >= 10. && compression <= max_compression);
+        m_buffer.reserve(m_buffer_capacity);
+    }
+
+    inline double tdigest::compression() const noexcept
+    {
+        return m_compression;
+    }
+
+    inline double tdigest::count() const noexcept
+    {
+        double res = m_weight;
+        for (const centroid& c : m_buffer)
+        {
+            res += c.weight;
+        }
+        return res;
+    }
+
+    inline double tdigest::min() const noexcept
+    {
+        return m_min <= m_max ? m_min : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    inline double tdigest::max() const noexcept
+    {
+        return m_min <= m_max ? m_max : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    template <quantile_value_type T>
+    void tdigest::update(const typed_array<T>& array)
+    {
+        update_morsel(array, morsel{0u, 0u, array.size()});
+    }
+
+    template <quantile_value_type T>
+    void tdigest::update(const typed_array<T>& array, const parallel_options& options)
+    {
+        const tdigest res = parallel_reduce(
+            array.size(),
+            options,
+            tdigest(m_compression),
+            [this, &array](const morsel& m)
+            {
+                tdigest digest(m_compression);
+                digest.update_morsel(array, m);
+                return digest;
+            },
+            [](tdigest& digest, const tdigest& morsel_digest)
+            {
+                digest.merge(morsel_digest);
+            }
+        );
+        merge(res);
+    }
+
+    template <quantile_value_type T>
+    void tdigest::update_morsel(const typed_array<T>& array, const morsel& m)
+    {
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        impl::for_each_valid(
+            make_validity_reader(array.get_data(), m),
+            [this, &values, &m](std::size_t i)
+            {
+                if constexpr (std::same_as<T, double>)
+                {
+                    add(values[m.begin + i]);
+                }
+                else
+                {
+                    add(static_cast<double>(values[m.begin + i]));
+                }
+            }
+        );
+    }
+
+    inline void tdigest::add(double value, double weight)
+    {
+        SPARROW_ASSERT_TRUE(weight > 0.);
+        if (std::isnan(value))
+        {
+            return;
+        }
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        m_buffer.push_back({value, weight});
+        if (m_buffer.size() >= m_buffer_capacity)
+        {
+            compress();
+        }
+    }
+
+    inline void tdigest::merge(const tdigest& other)
+    {
+        other.compress();
+        // Copied first, since other may be this digest
+        const std::vector<centroid> incoming = other.m_centroids;
+        for (const centroid& c : incoming)
+        {
+            m_buffer.push_back(c);
+            if (m_buffer.size() >= m_buffer_capacity)
+            {
+                compress();
+            }
+        }
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    inline double tdigest::quantile(double q) const
+    {
+        SPARROW_ASSERT_TRUE(q >= 0. && q <= 1.);
+        compress();
+        if (m_centroids.empty())
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if (m_centroids.size() == 1u)
+        {
+            return m_centroids.front().mean;
+        }
+
+        // Each centroid is a mass located at its mean; the quantile is interpolated
+        // linearly between the centers of the two centroids around its rank, and
+        // between the extreme centroids and the extreme values.
+        const double rank = q * m_weight;
+        const centroid& first = m_centroids.front();
+        if (rank < first.weight / 2.)
+        {
+            return m_min + (first.mean - m_min) * rank / (first.weight / 2.);
+        }
+        double weight_so_far = first.weight / 2.;
+        for (std::size_t i = 0; i + 1u < m_centroids.size(); ++i)
+        {
+            const centroid& lhs = m_centroids[i];
+            const centroid& rhs = m_centroids[i + 1u];
+            const double delta = (lhs.weight + rhs.weight) / 2.;
+            if (weight_so_far + delta > rank)
+            {
+                return lhs.mean + (rhs.mean - lhs.mean) * (rank - weight_so_far) / delta;
+            }
+            weight_so_far += delta;
+        }
+        const centroid& last = m_centroids.back();
+        const double tail = std::min(rank - weight_so_far, last.weight / 2.);
+        return last.mean + (m_max - last.mean) * tail / (last.weight / 2.);
+    }
+
+    inline auto tdigest::centroids() const -> std::span<const centroid>
+    {
+        compress();
+        return m_centroids;
+    }
+
+    inline std::vector<std::uint8_t> tdigest::serialize() const
+    {
+        compress();
+        impl::byte_writer writer;
+        impl::write_sketch_header(writer, impl::tdigest_kind);
+        writer.write(m_compression);
+        writer.write(m_min);
+        writer.write(m_max);
+        writer.write<std::uint64_t>(m_centroids.size());
+        for (const centroid& c : m_centroids)
+        {
+            writer.write(c.mean);
+            writer.write(c.weight);
+        }
+        return std::move(writer).release();
+    }
+
+    inline tdigest tdigest::deserialize(std::span<const std::uint8_t> bytes)
+    {
+        impl::byte_reader reader(bytes);
+        impl::read_sketch_header(reader, impl::tdigest_kind);
+        const double compression = reader.read<double>();
+        if (!(compression >= 10. && compression <= max_compression))
+        {
+            throw std::invalid_argument("deserialize: invalid tdigest compression");
+        }
+        tdigest res(compression);
+        res.m_min = reader.read<double>();
+        res.m_max = reader.read<double>();
+        const std::size_t size = reader.read<std::uint64_t>();
+        if (size > bytes.size())
+        {
+            throw std::invalid_argument("deserialize: invalid tdigest size");
+        }
+        // An empty digest keeps the inverted infinite bounds it was constructed with
+        const bool valid_bounds = size == 0u ? res.m_min == std::numeric_limits<double>::infinity()
+                                                   && res.m_max == -std::numeric_limits<double>::infinity()
+                                             : res.m_min <= res.m_max;
+        if (!valid_bounds)
+        {
+            throw std::invalid_argument("deserialize: invalid tdigest bounds");
+        }
+        res.m_centroids.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const double mean = reader.read<double>();
+            const double weight = reader.read<double>();
+            // The quantiles rely on finite centroids sorted by mean
+            if (!std::isfinite(mean) || !std::isfinite(weight) || !(weight > 0.)
+                || (i != 0u && mean < res.m_centroids.back().mean))
+            {
+                throw std::invalid_argument("deserialize: invalid tdigest centroid");
+            }
+            res.m_centroids.push_back({mean, weight});
+            res.m_weight += weight;
+        }
+        if (!std::isfinite(res.m_weight))
+        {
+            throw std::invalid_argument("deserialize: invalid tdigest centroid");
+        }
+        if (!reader.at_end())
+        {
+            throw std::invalid_argument("deserialize: unexpected trailing bytes");
+        }
+        return res;
+    }
+
+    /*
+     * k1 scale function, k(q) = compression / (2 pi) * asin(2q - 1): a centroid may
+     * span at most one unit of k.
+     */
+    inline double tdigest::scale(double q) const noexcept
+    {
+        return m_compression / (2. * std::numbers::pi) * std::asin(2. * q - 1.);
+    }
+
+    inline double tdigest::inverse_scale(double k) const noexcept
+    {
+        if (k >= m_compression / 4.)
+        {
+            return 1.;
+        }
+        return (std::sin(k * 2. * std::numbers::pi / m_compression) + 1.) / 2.;
+    }
+
+    /*
+     * Sorts the buffered values with the centroids, and merges consecutive ones as
+     * long as the merged centroid satisfies the size bound of the scale function.
+     */
+    inline void tdigest::compress() const
+    {
+        if (m_buffer.empty())
+        {
+            return;
+        }
+        m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+        std::ranges::sort(m_buffer, {}, &centroid::mean);
+        double total = 0.;
+        for (const centroid& c : m_buffer)
+        {
+            total += c.weight;
+        }
+
+        m_centroids.clear();
+        centroid current = m_buffer.front();
+        double weight_so_far = 0.;
+        double limit = total * inverse_scale(scale(0.) + 1.);
+        for (std::size_t i = 1; i < m_buffer.size(); ++i)
+        {
+            const centroid& next = m_buffer[i];
+            if (weight_so_far + current.weight + next.weight <= limit)
+            {
+                current.weight += next.weight;
+                current.mean += (next.mean - current.mean) * next.weight / current.weight;
+            }
+            else
+            {
+                weight_so_far += current.weight;
+                m_centroids.push_back(current);
+                limit = total * inverse_scale(scale(weight_so_far / total) + 1.);
+                current = next;
+            }
+        }
+        m_centroids.push_back(current);
+        m_weight = total;
+        m_buffer.clear();
+    }
+}
@@ -0,0 +1,904 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array.hpp"
+#include "sparrow/array_data.hpp"
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/c_interface.hpp"
+#include "sparrow/concatenate.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+
+namespace sparrow
+{
+    /**
+     * Key-value pairs attached to a field or to a schema, in order.
+     */
+    using key_value_metadata = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * Name, data type and metadata of a column.
+     */
+    struct field
+    {
+        std::string name;
+        data_type type = data_type::NA;
+        bool nullable = true;
+        key_value_metadata metadata = {};
+
+        bool operator==(const field&) const = default;
+    };
+
+    /**
+     * Ordered list of the fields of a record_batch or of a table.
+     */
+    class schema
+    {
+    public:
+
+        using size_type = std::size_t;
+
+        schema() = default;
+
+        explicit schema(std::vector<field> fields, key_value_metadata metadata = {});
+
+        size_type size() const;
+
+        const field& operator[](size_type i) const;
+        const std::vector<field>& fields() const;
+        const key_value_metadata& metadata() const;
+
+        /**
+         * @return The index of the first field named \p name, if any.
+         */
+        std::optional<size_type> field_index(std::string_view name) const;
+
+        /**
+         * @return The schema made of the fields at \p indices, in this order, with the
+         *         metadata of this schema.
+         */
+        schema select(std::span<const size_type> indices) const;
+
+        bool operator==(const schema&) const = default;
+
+    private:
+
+        std::vector<field> m_fields;
+        key_value_metadata m_metadata;
+    };
+
+    /**
+     * Equal-length named columns.
+     *
+     * Columns are arrays, that share their buffers when copied: projecting columns and
+     * slicing rows never copy the values. A slice keeps the columns as they are and
+     * records the range of rows it spans, that starts at offset() in each column; use
+     * value() to access the elements of a slice, or compact() to copy its rows into
+     * columns of their own.
+     */
+    class record_batch
+    {
+    public:
+
+        using size_type = std::size_t;
+        using const_reference = array::const_reference;
+
+        /**
+         * @throws std::invalid_argument if the columns do not match the fields of
+         *         \p batch_schema, or if their sizes differ.
+         */
+        record_batch(sparrow::schema batch_schema, std::vector<array> columns);
+
+        const sparrow::schema& get_schema() const;
+
+        size_type num_rows() const;
+        size_type num_columns() const;
+
+        /**
+         * @return The row of the columns where the batch starts.
+         */
+        size_type offset() const;
+
+        const array& column(size_type i) const;
+
+        /**
+         * @throws std::out_of_range if no field is named \p name.
+         */
+        const array& column(std::string_view name) const;
+
+        /**
+         * @return The element of the column \p i at the row \p row of the batch.
+         */
+        const_reference value(size_type i, size_type row) const;
+
+        /**
+         * @return The batch made of the columns at \p indices; no value is copied.
+         */
+        record_batch select(std::span<const size_type> indices) const;
+
+        /**
+         * @throws std::out_of_range if no field is named after one of \p names.
+         */
+        record_batch select(std::span<const std::string_view> names) const;
+
+        /**
+         * @return The batch made of the rows [\p offset, \p offset + \p length); no value
+         *         is copied.
+         */
+        record_batch slice(size_type offset, size_type length) const;
+
+        /**
+         * @return A batch with the rows of this one, whose columns hold exactly these rows.
+         *         The values are copied only if this batch is a slice.
+         */
+        record_batch compact() const;
+
+    private:
+
+        record_batch(
+            sparrow::schema batch_schema,
+            std::vector<array> columns,
+            size_type offset,
+            size_type length
+        );
+
+        size_type column_index(std::string_view name) const;
+
+        sparrow::schema m_schema;
+        std::vector<array> m_columns;
+        size_type m_offset = 0;
+        size_type m_num_rows = 0;
+    };
+
+    /**
+     * Exports \p batch through the Arrow C data interface, as a struct array whose
+     * children are the columns of the batch.
+     *
+     * The buffers of the columns are not copied: the exported array shares them until
+     * it is released. Boolean columns, that store one byte per value, are bit-packed.
+     *
+     * @throws std::invalid_argument if a column has a data type that the C data
+     *         interface export does not support yet (timestamps, fixed-size binaries and
+     *         dictionary-encoded arrays).
+     */
+    arrow_array_unique_ptr to_arrow_array(const record_batch& batch);
+
+    /**
+     * Exports \p batch_schema through the Arrow C data interface, as the schema of a
+     * struct array.
+     */
+    arrow_schema_unique_ptr to_arrow_schema(const schema& batch_schema);
+
+    /**
+     * Imports a struct array from the Arrow C data interface.
+     *
+     * The values are copied, since array_data owns its buffers; \p arrow_array is released
+     * afterwards and \p array_schema is left untouched. The rows that are null in the
+     * struct array are null in every column.
+     *
+     * @throws std::invalid_argument if \p array_schema is not the schema of a struct
+     *         array, or if a child has a data type that sparrow does not support.
+     */
+    record_batch from_arrow(ArrowArray& arrow_array, const ArrowSchema& array_schema);
+
+    /*************************
+     * schema implementation *
+     *************************/
+
+    inline schema::schema(std::vector<field> fields, key_value_metadata metadata)
+        : m_fields(std::move(fields))
+        , m_metadata(std::move(metadata))
+    {
+    }
+
+    inline auto schema::size() const -> size_type
+    {
+        return m_fields.size();
+    }
+
+    inline const field& schema::operator[](size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < size());
+        return m_fields[i];
+    }
+
+    inline const std::vector<field>& schema::fields() const
+    {
+        return m_fields;
+    }
+
+    inline const key_value_metadata& schema::metadata() const
+    {
+        return m_metadata;
+    }
+
+    inline auto schema::field_index(std::string_view name) const -> std::optional<size_type>
+    {
+        for (size_type i = 0; i < m_fields.size(); ++i)
+        {
+            if (m_fields[i].name == name)
+            {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    inline schema schema::select(std::span<const size_type> indices) const
+    {
+        std::vector<field> fields;
+        fields.reserve(indices.size());
+        for (const size_type i : indices)
+        {
+            fields.push_back((*this)[i]);
+        }
+        return schema(std::move(fields), m_metadata);
+    }
+
+    namespace impl
+    {
+        inline const array_data& get_array_data(const array& ar)
+        {
+            return ar.get_data();
+        }
+
+        /*
+         * Copies the rows [first, first + count) of data into a new array_data with an
+         * offset of 0. Dictionary-encoded arrays keep their whole dictionary.
+         */
+        inline array_data copy_rows(const array_data& data, std::size_t first, std::size_t count)
+        {
+            SPARROW_ASSERT_TRUE(first + count <= array_data_size(data));
+            const data_type id = data.type.id();
+            array_data res{
+                .type = data.type,
+                .length = static_cast<array_data::length_type>(count),
+                .offset = 0,
+                .bitmap = {},
+                .buffers = {},
+                .child_data = {},
+                .dictionary = nullptr
+            };
+            if (id == data_type::NA)
+            {
+                return res;
+            }
+
+            const std::size_t begin = static_cast<std::size_t>(data.offset) + first;
+            const bitmap_word_reader validity(data.bitmap, begin, count);
+            if (validity.all_set())
+            {
+                res.bitmap = array_data::bitmap_type(count, true);
+            }
+            else
+            {
+                bitmap_word_writer writer(count);
+                writer.append(validity);
+                res.bitmap = std::move(writer).finish();
+            }
+
+            if (data.dictionary.has_value())
+            {
+                const std::size_t width = sizeof(std::uint64_t);
+                array_data::buffer_type indices(count * width);
+                if (count != 0u)
+                {
+                    std::memcpy(indices.data(), data.buffers[0].data() + begin * width, count * width);
+                }
+                res.buffers.push_back(std::move(indices));
+                res.dictionary = value_ptr<array_data>(array_data(*data.dictionary));
+            }
+            else if (id == data_type::STRING)
+            {
+                using offset_type = std::int64_t;
+                const offset_type* offsets = data.buffers[0].data<offset_type>() + begin;
+                array_data::buffer_type offsets_buffer(sizeof(offset_type) * (count + 1u));
+                offset_type* out_offsets = offsets_buffer.data<offset_type>();
+                for (std::size_t i = 0; i <= count; ++i)
+                {
+                    out_offsets[i] = offsets[i] - offsets[0];
+                }
+                const auto byte_count = static_cast<std::size_t>(offsets[count] - offsets[0]);
+                array_data::buffer_type bytes(byte_count);
+                if (byte_count != 0u)
+                {
+                    std::memcpy(bytes.data(), data.buffers[1].data() + offsets[0], byte_count);
+                }
+                res.buffers.push_back(std::move(offsets_buffer));
+                res.buffers.push_back(std::move(bytes));
+            }
+            else
+            {
+                const std::size_t width = fixed_value_width(id);
+                array_data::buffer_type values(count * width);
+                if (count != 0u)
+                {
+                    std::memcpy(values.data(), data.buffers[0].data() + begin * width, count * width);
+                }
+                res.buffers.push_back(std::move(values));
+            }
+            return res;
+        }
+
+        /*
+         * Format string of the Arrow C data interface for the data type id.
+         */
+        inline std::string_view arrow_format(data_type id)
+        {
+            switch (id)
+            {
+                case data_type::NA:
+                    return "n";
+                case data_type::BOOL:
+                    return "b";
+                case data_type::UINT8:
+                    return "C";
+                case data_type::INT8:
+                    return "c";
+                case data_type::UINT16:
+                    return "S";
+                case data_type::INT16:
+                    return "s";
+                case data_type::UINT32:
+                    return "I";
+                case data_type::INT32:
+                    return "i";
+                case data_type::UINT64:
+                    return "L";
+                case data_type::INT64:
+                    return "l";
+                case data_type::HALF_FLOAT:
+                    return "e";
+                case data_type::FLOAT:
+                    return "f";
+                case data_type::DOUBLE:
+                    return "g";
+                case data_type::STRING:
+                    return "U";
+                default:
+                    throw std::invalid_argument("C data interface: unsupported data type");
+            }
+        }
+
+        /*
+         * @return The data type described by the format string of the Arrow C data
+         *         interface, and whether its offsets are 32-bit (small string format).
+         */
+        inline std::pair<data_type, bool> data_type_from_arrow_format(std::string_view format)
+        {
+            if (format.size() == 1u)
+            {
+                switch (format[0])
+                {
+                    case 'n':
+                        return {data_type::NA, false};
+                    case 'b':
+                        return {data_type::BOOL, false};
+                    case 'C':
+                        return {data_type::UINT8, false};
+                    case 'c':
+                        return {data_type::INT8, false};
+                    case 'S':
+                        return {data_type::UINT16, false};
+                    case 's':
+                        return {data_type::INT16, false};
+                    case 'I':
+                        return {data_type::UINT32, false};
+                    case 'i':
+                        return {data_type::INT32, false};
+                    case 'L':
+                        return {data_type::UINT64, false};
+                    case 'l':
+                        return {data_type::INT64, false};
+                    case 'e':
+                        return {data_type::HALF_FLOAT, false};
+                    case 'f':
+                        return {data_type::FLOAT, false};
+                    case 'g':
+                        return {data_type::DOUBLE, false};
+                    case 'U':
+                        return {data_type::STRING, false};
+                    case 'u':
+                        return {data_type::STRING, true};
+                    default:
+                        break;
+                }
+            }
+            throw std::invalid_argument("C data interface: unsupported format " + std::string(format));
+        }
+
+        /*
+         * Metadata of the Arrow C data interface: the number of pairs, then the length and
+         * the bytes of each key and value, lengths being native 32-bit integers.
+         */
+        inline std::vector<char> encode_arrow_metadata(const key_value_metadata& metadata)
+        {
+            std::vector<char> res;
+            const auto write_int = [&res](std::size_t value)
+            {
+                const auto n = static_cast<std::int32_t>(value);
+                const char* bytes = reinterpret_cast<const char*>(&n);
+                res.insert(res.end(), bytes, bytes + sizeof(n));
+            };
+            write_int(metadata.size());
+            for (const auto& [key, value] : metadata)
+            {
+                write_int(key.size());
+                res.insert(res.end(), key.begin(), key.end());
+                write_int(value.size());
+                res.insert(res.end(), value.begin(), value.end());
+            }
+            return res;
+        }
+
+        inline key_value_metadata decode_arrow_metadata(const char* metadata)
+        {
+            key_value_metadata res;
+            if (metadata == nullptr)
+            {
+                return res;
+            }
+            const auto read_int = [&metadata]()
+            {
+                std::int32_t n = 0;
+                std::memcpy(&n, metadata, sizeof(n));
+                metadata += sizeof(n);
+                return static_cast<std::size_t>(n);
+            };
+            const auto read_string = [&metadata, &read_int]()
+            {
+                const std::size_t size = read_int();
+                std::string s(metadata, size);
+                metadata += size;
+                return s;
+            };
+            const std::size_t count = read_int();
+            res.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::string key = read_string();
+                res.emplace_back(std::move(key), read_string());
+            }
+            return res;
+        }
+
+        /*
+         * Private data of the arrays exported by to_arrow_array: the exported column keeps
+         * the buffers alive until the array is released.
+         */
+        struct exported_array_private_data
+        {
+            std::optional<array> column;
+            array_data::buffer_type packed_values;
+            std::vector<const void*> buffers;
+            std::vector<arrow_array_unique_ptr> children;
+            std::vector<ArrowArray*> children_raw_ptr_vec;
+        };
+
+        inline void release_exported_array(ArrowArray* arrow_array)
+        {
+            SPARROW_ASSERT_FALSE(arrow_array == nullptr)
+            delete static_cast<exported_array_private_data*>(arrow_array->private_data);
+            arrow_array->private_data = nullptr;
+            arrow_array->buffers = nullptr;
+            arrow_array->children = nullptr;
+            arrow_array->release = nullptr;
+        }
+
+        inline arrow_array_unique_ptr
+        export_column(const array& column, std::size_t first, std::size_t count)
+        {
+            const array_data& data = get_array_data(column);
+            const data_type id = data.type.id();
+            if (data.dictionary.has_value())
+            {
+                throw std::invalid_argument("C data interface: dictionary-encoded arrays are not supported");
+            }
+            // Throws for the data types that cannot be exported
+            arrow_format(id);
+
+            auto private_data = std::make_unique<exported_array_private_data>();
+            private_data->column.emplace(column);
+            const std::size_t begin = static_cast<std::size_t>(data.offset) + first;
+
+            arrow_array_unique_ptr res = default_arrow_array();
+            res->length = static_cast<std::int64_t>(count);
+            res->offset = static_cast<std::int64_t>(begin);
+            if (id == data_type::NA)
+            {
+                res->null_count = res->length;
+            }
+            else
+            {
+                const bitmap_word_reader validity(data.bitmap, begin, count);
+                res->null_count = validity.all_set() ? 0 : -1;
+                private_data->buffers.push_back(validity.all_set() ? nullptr : data.bitmap.data());
+                if (id == data_type::BOOL)
+                {
+                    const std::size_t end = begin + count;
+                    private_data->packed_values = array_data::buffer_type((end + 7u) / 8u, 0);
+                    const std::uint8_t* bytes = data.buffers[0].data();
+                    std::uint8_t* bits = private_data->packed_values.data();
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        bits[i / 8u] |= static_cast<std::uint8_t>((bytes[i] != 0u ? 1u : 0u) << (i % 8u));
+                    }
+                    private_data->buffers.push_back(private_data->packed_values.data());
+                }
+                else
+                {
+                    for (const array_data::buffer_type& b : data.buffers)
+                    {
+                        private_data->buffers.push_back(b.data());
+                    }
+                }
+            }
+            res->n_buffers = static_cast<std::int64_t>(private_data->buffers.size());
+            res->buffers = private_data->buffers.data();
+            res->private_data = private_data.release();
+            res->release = release_exported_array;
+            return res;
+        }
+
+        inline array_data
+        import_column(const ArrowArray& column, std::string_view format, std::size_t first, std::size_t count)
+        {
+            const auto [id, small_offsets] = data_type_from_arrow_format(format);
+            if (id == data_type::NA)
+            {
+                return make_array_data_for_null_layout(count);
+            }
+            const std::size_t begin = static_cast<std::size_t>(column.offset) + first;
+            const auto* validity = static_cast<const std::uint8_t*>(column.buffers[0]);
+            const auto bit = [](const void* bits, std::size_t i)
+            {
+                return ((static_cast<const std::uint8_t*>(bits)[i / 8u] >> (i % 8u)) & 1u) != 0u;
+            };
+
+            array_data res{
+                .type = data_descriptor(id),
+                .length = static_cast<array_data::length_type>(count),
+                .offset = 0,
+                .bitmap = array_data::bitmap_type(count, true),
+                .buffers = {},
+                .child_data = {},
+                .dictionary = nullptr
+            };
+            if (validity != nullptr && column.null_count != 0)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res.bitmap.set(i, bit(validity, begin + i));
+                }
+            }
+
+            if (id == data_type::STRING)
+            {
+                using offset_type = std::int64_t;
+                const auto offset_at = [&column, small = small_offsets](std::size_t i) -> offset_type
+                {
+                    if (small)
+                    {
+                        return static_cast<const std::int32_t*>(column.buffers[1])[i];
+                    }
+                    return static_cast<const std::int64_t*>(column.buffers[1])[i];
+                };
+                const offset_type base = offset_at(begin);
+                array_data::buffer_type offsets(sizeof(offset_type) * (count + 1u));
+                offset_type* out_offsets = offsets.data<offset_type>();
+                for (std::size_t i = 0; i <= count; ++i)
+                {
+                    out_offsets[i] = offset_at(begin + i) - base;
+                }
+                const auto byte_count = static_cast<std::size_t>(out_offsets[count]);
+                array_data::buffer_type bytes(byte_count);
+                if (byte_count != 0u)
+                {
+                    const auto* data = static_cast<const std::uint8_t*>(column.buffers[2]);
+                    std::memcpy(bytes.data(), data + base, byte_count);
+                }
+                res.buffers.push_back(std::move(offsets));
+                res.buffers.push_back(std::move(bytes));
+            }
+            else if (id == data_type::BOOL)
+            {
+                array_data::buffer_type values(count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    values.data()[i] = bit(column.buffers[1], begin + i) ? 1u : 0u;
+                }
+                res.buffers.push_back(std::move(values));
+            }
+            else
+            {
+                const std::size_t width = fixed_value_width(id);
+                array_data::buffer_type values(count * width);
+                if (count != 0u)
+                {
+                    std::memcpy(
+                        values.data(),
+                        static_cast<const std::uint8_t*>(column.buffers[1]) + begin * width,
+                        count * width
+                    );
+                }
+                res.buffers.push_back(std::move(values));
+            }
+            return res;
+        }
+    }
+
+    /*******************************
+     * record_batch implementation *
+     *******************************/
+
+    inline record_batch::record_batch(sparrow::schema batch_schema, std::vector<array> columns)
+        : m_schema(std::move(batch_schema))
+        , m_columns(std::move(columns))
+        , m_num_rows(m_columns.empty() ? 0u : m_columns.front().size())
+    {
+        if (m_columns.size() != m_schema.size())
+        {
+            throw std::invalid_argument(
+                "record_batch: the number of columns differs from the number of fields"
+            );
+        }
+        for (size_type i = 0; i < m_columns.size(); ++i)
+        {
+            if (impl::get_array_data(m_columns[i]).type.id() != m_schema[i].type)
+            {
+                throw std::invalid_argument(
+                    "record_batch: the data type of column " + m_schema[i].name + " differs from its field"
+                );
+            }
+            if (m_columns[i].size() != m_num_rows)
+            {
+                throw std::invalid_argument("record_batch: the columns must have the same size");
+            }
+        }
+    }
+
+    inline record_batch::record_batch(
+        sparrow::schema batch_schema,
+        std::vector<array> columns,
+        size_type offset,
+        size_type length
+    )
+        : m_schema(std::move(batch_schema))
+        , m_columns(std::move(columns))
+        , m_offset(offset)
+        , m_num_rows(length)
+    {
+    }
+
+    inline const schema& record_batch::get_schema() const
+    {
+        return m_schema;
+    }
+
+    inline auto record_batch::num_rows() const -> size_type
+    {
+        return m_num_rows;
+    }
+
+    inline auto record_batch::num_columns() const -> size_type
+    {
+        return m_columns.size();
+    }
+
+    inline auto record_batch::offset() const -> size_type
+    {
+        return m_offset;
+    }
+
+    inline const array& record_batch::column(size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < num_columns());
+        return m_columns[i];
+    }
+
+    inline const array& record_batch::column(std::string_view name) const
+    {
+        return m_columns[column_index(name)];
+    }
+
+    inline auto record_batch::value(size_type i, size_type row) const -> const_reference
+    {
+        SPARROW_ASSERT_TRUE(i < num_columns());
+        SPARROW_ASSERT_TRUE(row < num_rows());
+        return m_columns[i][m_offset + row];
+    }
+
+    inline record_batch record_batch::select(std::span<const size_type> indices) const
+    {
+        std::vector<array> columns;
+        columns.reserve(indices.size());
+        for (const size_type i : indices)
+        {
+            columns.push_back(column(i));
+        }
+        return record_batch(m_schema.select(indices), std::move(columns), m_offset, m_num_rows);
+    }
+
+    inline record_batch record_batch::select(std::span<const std::string_view> names) const
+    {
+        std::vector<size_type> indices;
+        indices.reserve(names.size());
+        for (const std::string_view name : names)
+        {
+            indices.push_back(column_index(name));
+        }
+        return select(std::span<const size_type>(indices));
+    }
+
+    inline record_batch record_batch::slice(size_type offset, size_type length) const
+    {
+        SPARROW_ASSERT_TRUE(offset + length <= num_rows());
+        return record_batch(m_schema, m_columns, m_offset + offset, length);
+    }
+
+    inline record_batch record_batch::compact() const
+    {
+        if (m_offset == 0u && std::ranges::all_of(
+                m_columns,
+                [this](const array& c)
+                {
+                    return c.size() == m_num_rows;
+                }
+            ))
+        {
+            return *this;
+        }
+        std::vector<array> columns;
+        columns.reserve(m_columns.size());
+        for (const array& c : m_columns)
+        {
+            columns.emplace_back(impl::copy_rows(impl::get_array_data(c), m_offset, m_num_rows));
+        }
+        return record_batch(m_schema, std::move(columns), 0u, m_num_rows);
+    }
+
+    inline auto record_batch::column_index(std::string_view name) const -> size_type
+    {
+        const std::optional<size_type> i = m_schema.field_index(name);
+        if (!i.has_value())
+        {
+            throw std::out_of_range("record_batch: no column named " + std::string(name));
+        }
+        return *i;
+    }
+
+    /***********************************
+     * C data interface implementation *
+     ***********************************/
+
+    inline arrow_array_unique_ptr to_arrow_array(const record_batch& batch)
+    {
+        auto private_data = std::make_unique<impl::exported_array_private_data>();
+        for (std::size_t i = 0; i < batch.num_columns(); ++i)
+        {
+            private_data->children.push_back(
+                impl::export_column(batch.column(i), batch.offset(), batch.num_rows())
+            );
+        }
+        private_data->children_raw_ptr_vec = to_raw_ptr_vec(private_data->children);
+        // The struct array has a validity buffer, absent since the rows cannot be null
+        private_data->buffers.push_back(nullptr);
+
+        arrow_array_unique_ptr res = default_arrow_array();
+        res->length = static_cast<std::int64_t>(batch.num_rows());
+        res->n_buffers = 1;
+        res->buffers = private_data->buffers.data();
+        res->n_children = static_cast<std::int64_t>(batch.num_columns());
+        res->children = private_data->children_raw_ptr_vec.data();
+        res->private_data = private_data.release();
+        res->release = impl::release_exported_array;
+        return res;
+    }
+
+    inline arrow_schema_unique_ptr to_arrow_schema(const schema& batch_schema)
+    {
+        std::vector<arrow_schema_unique_ptr> children;
+        children.reserve(batch_schema.size());
+        for (const field& f : batch_schema.fields())
+        {
+            std::vector<char> metadata = impl::encode_arrow_metadata(f.metadata);
+            children.push_back(make_arrow_schema<std::allocator>(
+                impl::arrow_format(f.type),
+                f.name,
+                f.metadata.empty() ? std::optional<std::span<char>>() : std::span<char>(metadata),
+                f.nullable ? std::optional(ArrowFlag::NULLABLE) : std::nullopt,
+                {},
+                nullptr
+            ));
+        }
+        std::vector<char> metadata = impl::encode_arrow_metadata(batch_schema.metadata());
+        return make_arrow_schema<std::allocator>(
+            "+s",
+            "",
+            batch_schema.metadata().empty() ? std::optional<std::span<char>>() : std::span<char>(metadata),
+            std::nullopt,
+            std::move(children),
+            nullptr
+        );
+    }
+
+    inline record_batch from_arrow(ArrowArray& arrow_array, const ArrowSchema& array_schema)
+    {
+        if (std::string_view(array_schema.format) != "+s"
+            || arrow_array.n_children != array_schema.n_children)
+        {
+            throw std::invalid_argument("from_arrow: a struct array is expected");
+        }
+        const auto first = static_cast<std::size_t>(arrow_array.offset);
+        const auto count = static_cast<std::size_t>(arrow_array.length);
+        const auto* parent_validity = arrow_array.n_buffers > 0 && arrow_array.null_count != 0
+                                          ? static_cast<const std::uint8_t*>(arrow_array.buffers[0])
+                                          : nullptr;
+        std::vector<field> fields;
+        std::vector<array> columns;
+        for (std::int64_t i = 0; i < arrow_array.n_children; ++i)
+        {
+            const ArrowSchema& child_schema = *array_schema.children[i];
+            array_data data = impl::import_column(
+                *arrow_array.children[i],
+                child_schema.format,
+                first,
+                count
+            );
+            // A null struct row is a null row of every child
+            if (parent_validity != nullptr && data.type.id() != data_type::NA)
+            {
+                for (std::size_t row = 0; row < count; ++row)
+                {
+                    const std::size_t bit = first + row;
+                    if (((parent_validity[bit / 8u] >> (bit % 8u)) & 1u) == 0u)
+                    {
+                        data.bitmap.set(row, false);
+                    }
+                }
+            }
+            fields.push_back(
+                {.name = child_schema.name == nullptr ? std::string() : std::string(child_schema.name),
+                 .type = data.type.id(),
+                 .nullable = (child_schema.flags & static_cast<std::int64_t>(ArrowFlag::NULLABLE)) != 0,
+                 .metadata = impl::decode_arrow_metadata(child_schema.metadata)}
+            );
+            columns.emplace_back(std::move(data));
+        }
+        if (arrow_array.release != nullptr)
+        {
+            arrow_array.release(&arrow_array);
+        }
+        return record_batch(
+            schema(std::move(fields), impl::decode_arrow_metadata(array_schema.metadata)),
+            std::move(columns)
+        );
+    }
+}
@@ -0,0 +1,744 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/concatenate.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Description of the packed rows built by encode_rows.
+     *
+     * A row starts with a validity bitmap holding one bit per field, set when the field
+     * is not null, followed by the fixed-width slot of each field, packed without any
+     * padding: fixed-size values are stored as they are, except timestamps, stored as
+     * the int64 number of nanoseconds since the epoch, and variable-size values as a
+     * row_heap_ref. The bytes of the variable-size values follow the slots, in the order
+     * of the fields, in the heap of the row.
+     */
+    class row_layout
+    {
+    public:
+
+        using size_type = std::size_t;
+
+        row_layout() = default;
+
+        /**
+         * @param types The data types of the fields, fixed-size types or STRING.
+         * @throws std::invalid_argument if one of the types is not supported.
+         */
+        explicit row_layout(std::vector<data_type> types);
+
+        /**
+         * @return The number of fields of a row.
+         */
+        size_type size() const;
+
+        data_type type(size_type i) const;
+        bool is_variable_size(size_type i) const;
+
+        /**
+         * @return The number of bytes of the validity bitmap at the start of a row.
+         */
+        size_type validity_size() const;
+
+        /**
+         * @return The position of the slot of the field \p i in a row.
+         */
+        size_type field_offset(size_type i) const;
+
+        /**
+         * @return The number of bytes of a row before its heap.
+         */
+        size_type fixed_size() const;
+
+        bool operator==(const row_layout&) const = default;
+
+    private:
+
+        std::vector<data_type> m_types;
+        std::vector<size_type> m_offsets;
+        size_type m_validity_size = 0;
+        size_type m_fixed_size = 0;
+    };
+
+    /**
+     * Slot of a variable-size value in a row: the position of its bytes, from the start
+     * of the row, and their number.
+     */
+    struct row_heap_ref
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    /**
+     * Rows packed according to a row_layout, stored contiguously.
+     */
+    class row_buffer
+    {
+    public:
+
+        using size_type = std::size_t;
+        using buffer_type = array_data::buffer_type;
+
+        row_buffer() = default;
+
+        /**
+         * @param layout The layout of the rows.
+         * @param data The bytes of the rows.
+         * @param offsets The positions of the rows in \p data, followed by the size of
+         *        \p data.
+         */
+        row_buffer(row_layout layout, buffer_type data, std::vector<size_type> offsets);
+
+        const row_layout& layout() const;
+
+        /**
+         * @return The number of rows.
+         */
+        size_type size() const;
+
+        /**
+         * @return The bytes of the row \p i.
+         */
+        std::span<const std::uint8_t> row(size_type i) const;
+
+        /**
+         * @return true if the field \p field of the row \p i is not null.
+         */
+        bool is_valid(size_type i, size_type field) const;
+
+        const buffer_type& data() const;
+        const std::vector<size_type>& offsets() const;
+
+    private:
+
+        row_layout m_layout;
+        buffer_type m_data;
+        std::vector<size_type> m_offsets = {0u};
+    };
+
+    /**
+     * Default number of rows converted at once by encode_rows and decode_rows: the rows
+     * of a block stay in the cache while each of the columns is processed.
+     */
+    inline constexpr std::size_t default_row_block_size = 1024;
+
+    /**
+     * Packs the elements of \p columns into rows, one row per element.
+     *
+     * The sizes of the rows are computed first so that the rows are allocated once. The
+     * rows are then filled by blocks of \p block_size rows, one column after the other,
+     * so that the source columns are read sequentially while the rows of the block stay
+     * in the cache. Null elements have their validity bit cleared; their slot is still
+     * written.
+     *
+     * @param columns The columns to pack; they must have the same size.
+     * @param block_size The number of rows of a block, rounded up to a multiple of 64.
+     * @throws std::invalid_argument if the columns have different sizes, a data type
+     *         that is not supported by row_layout, or are dictionary-encoded.
+     * @throws std::overflow_error if a row is larger than 4 GiB.
+     */
+    inline row_buffer
+    encode_rows(std::span<const array_data> columns, std::size_t block_size = default_row_block_size);
+
+    /**
+     * Packs the elements of typed arrays into rows.
+     *
+     * @see encode_rows(std::span<const array_data>, std::size_t)
+     */
+    template <class... T, class... Layout>
+    row_buffer encode_rows(const typed_array<T, Layout>&... arrays);
+
+    /**
+     * Unpacks \p rows into one array_data per field of their layout, with an offset of 0.
+     * The columns are filled by blocks of \p block_size rows, like in encode_rows.
+     */
+    inline std::vector<array_data>
+    decode_rows(const row_buffer& rows, std::size_t block_size = default_row_block_size);
+
+    /*****************************
+     * row_layout implementation *
+     *****************************/
+
+    namespace impl
+    {
+        /*
+         * @return The number of bytes of the slot of a fixed-size value of type \p id
+         * in a row.
+         */
+        inline std::size_t row_value_width(data_type id)
+        {
+            return id == data_type::TIMESTAMP ? sizeof(std::int64_t) : fixed_value_width(id);
+        }
+    }
+
+    inline row_layout::row_layout(std::vector<data_type> types)
+        : m_types(std::move(types))
+        , m_validity_size((m_types.size() + 7u) / 8u)
+    {
+        m_offsets.reserve(m_types.size());
+        size_type offset = m_validity_size;
+        for (const data_type type : m_types)
+        {
+            if (type == data_type::NA || type == data_type::FIXED_SIZE_BINARY)
+            {
+                throw std::invalid_argument("row_layout: unsupported data type");
+            }
+            m_offsets.push_back(offset);
+            offset += type == data_type::STRING ? sizeof(row_heap_ref) : impl::row_value_width(type);
+        }
+        m_fixed_size = offset;
+    }
+
+    inline auto row_layout::size() const -> size_type
+    {
+        return m_types.size();
+    }
+
+    inline data_type row_layout::type(size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < size());
+        return m_types[i];
+    }
+
+    inline bool row_layout::is_variable_size(size_type i) const
+    {
+        return type(i) == data_type::STRING;
+    }
+
+    inline auto row_layout::validity_size() const -> size_type
+    {
+        return m_validity_size;
+    }
+
+    inline auto row_layout::field_offset(size_type i) const -> size_type
+    {
+        SPARROW_ASSERT_TRUE(i < size());
+        return m_offsets[i];
+    }
+
+    inline auto row_layout::fixed_size() const -> size_type
+    {
+        return m_fixed_size;
+    }
+
+    /*****************************
+     * row_buffer implementation *
+     *****************************/
+
+    inline row_buffer::row_buffer(row_layout layout, buffer_type data, std::vector<size_type> offsets)
+        : m_layout(std::move(layout))
+        , m_data(std::move(data))
+        , m_offsets(std::move(offsets))
+    {
+        SPARROW_ASSERT_FALSE(m_offsets.empty());
+        SPARROW_ASSERT_TRUE(m_offsets.back() == m_data.size());
+    }
+
+    inline const row_layout& row_buffer::layout() const
+    {
+        return m_layout;
+    }
+
+    inline auto row_buffer::size() const -> size_type
+    {
+        return m_offsets.size() - 1u;
+    }
+
+    inline std::span<const std::uint8_t> row_buffer::row(size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < size());
+        return std::span<const std::uint8_t>(m_data.data() + m_offsets[i], m_offsets[i + 1u] - m_offsets[i]);
+    }
+
+    inline bool row_buffer::is_valid(size_type i, size_type field) const
+    {
+        SPARROW_ASSERT_TRUE(field < m_layout.size());
+        return (row(i)[field / 8u] & (1u << (field % 8u))) != 0u;
+    }
+
+    inline auto row_buffer::data() const -> const buffer_type&
+    {
+        return m_data;
+    }
+
+    inline auto row_buffer::offsets() const -> const std::vector<size_type>&
+    {
+        return m_offsets;
+    }
+
+    /******************************
+     * encode_rows implementation *
+     ******************************/
+
+    namespace impl
+    {
+        /*
+         * Calls `f(width)` with a std::integral_constant for the common widths, so that
+         * the copies of the values compile to plain loads and stores.
+         */
+        template <class F>
+        void visit_value_width(std::size_t width, const F& f)
+        {
+            switch (width)
+            {
+                case 1u:
+                    f(std::integral_constant<std::size_t, 1u>());
+                    break;
+                case 2u:
+                    f(std::integral_constant<std::size_t, 2u>());
+                    break;
+                case 4u:
+                    f(std::integral_constant<std::size_t, 4u>());
+                    break;
+                case 8u:
+                    f(std::integral_constant<std::size_t, 8u>());
+                    break;
+                default:
+                    f(width);
+                    break;
+            }
+        }
+
+        inline const std::int64_t* string_offsets(const array_data& data)
+        {
+            return data.buffers[0].data<std::int64_t>() + data.offset;
+        }
+
+        /*
+         * Sets the validity bit of the field \p field in the rows of \p block.
+         */
+        inline void encode_validity(
+            const array_data& data,
+            const morsel& block,
+            std::size_t field,
+            std::uint8_t* rows,
+            const std::size_t* row_offsets
+        )
+        {
+            const bitmap_word_reader reader = make_validity_reader(data, block);
+            const std::size_t byte = field / 8u;
+            const auto bit = static_cast<std::uint8_t>(1u << (field % 8u));
+            for (std::size_t k = 0; k < reader.word_count(); ++k)
+            {
+                const bitmap_word word = reader.word(k);
+                const std::size_t first = block.begin + k * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, block.end - first);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    if (((word >> j) & 1u) != 0u)
+                    {
+                        rows[row_offsets[first + j] + byte] |= bit;
+                    }
+                }
+            }
+        }
+
+        inline void encode_fixed_size_values(
+            const array_data& data,
+            const morsel& block,
+            std::size_t slot,
+            std::uint8_t* rows,
+            const std::size_t* row_offsets
+        )
+        {
+            if (data.type.id() == data_type::TIMESTAMP)
+            {
+                // The time zone of a timestamp is a pointer, only valid in this process
+                const timestamp* values = data.buffers[0].data<timestamp>() + data.offset;
+                for (std::size_t i = block.begin; i < block.end; ++i)
+                {
+                    const std::int64_t count = values[i].get_sys_time().time_since_epoch().count();
+                    std::memcpy(rows + row_offsets[i] + slot, &count, sizeof(count));
+                }
+                return;
+            }
+            visit_value_width(
+                fixed_value_width(data.type.id()),
+                [&](auto width)
+                {
+                    const std::uint8_t* values = data.buffers[0].data()
+                                                 + static_cast<std::size_t>(data.offset) * width;
+                    for (std::size_t i = block.begin; i < block.end; ++i)
+                    {
+                        std::memcpy(rows + row_offsets[i] + slot, values + i * width, width);
+                    }
+                }
+            );
+        }
+
+        /*
+         * Appends the strings of \p block to the heaps of their rows; \p heap_ends holds
+         * the end of the heap of each row of the block, relative to the start of the row.
+         */
+        inline void encode_strings(
+            const array_data& data,
+            const morsel& block,
+            std::size_t slot,
+            std::uint8_t* rows,
+            const std::size_t* row_offsets,
+            std::uint32_t* heap_ends
+        )
+        {
+            const std::int64_t* offsets = string_offsets(data);
+            const std::uint8_t* bytes = data.buffers[1].data();
+            for (std::size_t i = block.begin; i < block.end; ++i)
+            {
+                std::uint8_t* row = rows + row_offsets[i];
+                std::uint32_t& heap_end = heap_ends[i - block.begin];
+                const auto length = static_cast<std::uint32_t>(offsets[i + 1u] - offsets[i]);
+                const row_heap_ref ref{heap_end, length};
+                std::memcpy(row + slot, &ref, sizeof(row_heap_ref));
+                if (length != 0u)
+                {
+                    std::memcpy(row + heap_end, bytes + offsets[i], length);
+                }
+                heap_end += length;
+            }
+        }
+
+        inline std::vector<std::size_t>
+        row_offsets(std::span<const array_data* const> columns, const row_layout& layout)
+        {
+            const std::size_t size = columns.empty() ? 0u : array_data_size(*columns.front());
+            std::vector<std::size_t> sizes(size, layout.fixed_size());
+            for (std::size_t c = 0; c < columns.size(); ++c)
+            {
+                if (layout.is_variable_size(c))
+                {
+                    const std::int64_t* offsets = string_offsets(*columns[c]);
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        sizes[i] += static_cast<std::size_t>(offsets[i + 1u] - offsets[i]);
+                    }
+                }
+            }
+            std::vector<std::size_t> res(size + 1u);
+            res[0] = 0u;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (sizes[i] > std::numeric_limits<std::uint32_t>::max())
+                {
+                    throw std::overflow_error("encode_rows: rows are limited to 4 GiB");
+                }
+                res[i + 1u] = res[i] + sizes[i];
+            }
+            return res;
+        }
+
+        /*
+         * Implementation of encode_rows, taking the columns by address so that the
+         * overload taking typed arrays does not copy them.
+         */
+        inline row_buffer encode_rows(std::span<const array_data* const> columns, std::size_t block_size)
+        {
+            const std::size_t size = columns.empty() ? 0u : array_data_size(*columns.front());
+            std::vector<data_type> types;
+            types.reserve(columns.size());
+            for (const array_data* column : columns)
+            {
+                const array_data& data = *column;
+                if (array_data_size(data) != size)
+                {
+                    throw std::invalid_argument("encode_rows: the columns must have the same size");
+                }
+                if (data.dictionary.has_value())
+                {
+                    throw std::invalid_argument("encode_rows: dictionary-encoded columns are not supported");
+                }
+                types.push_back(data.type.id());
+            }
+            row_layout layout(std::move(types));
+
+            std::vector<std::size_t> offsets = row_offsets(columns, layout);
+            row_buffer::buffer_type rows(offsets.back(), std::uint8_t(0));
+            const std::size_t step = aligned_morsel_size(block_size);
+            std::vector<std::uint32_t> heap_ends(std::min(step, size));
+            for (std::size_t first = 0; first < size; first += step)
+            {
+                const morsel block{first / step, first, std::min(size, first + step)};
+                std::fill_n(heap_ends.begin(), block.size(), static_cast<std::uint32_t>(layout.fixed_size()));
+                for (std::size_t c = 0; c < columns.size(); ++c)
+                {
+                    encode_validity(*columns[c], block, c, rows.data(), offsets.data());
+                    if (layout.is_variable_size(c))
+                    {
+                        encode_strings(
+                            *columns[c],
+                            block,
+                            layout.field_offset(c),
+                            rows.data(),
+                            offsets.data(),
+                            heap_ends.data()
+                        );
+                    }
+                    else
+                    {
+                        encode_fixed_size_values(
+                            *columns[c],
+                            block,
+                            layout.field_offset(c),
+                            rows.data(),
+                            offsets.data()
+                        );
+                    }
+                }
+            }
+            return row_buffer(std::move(layout), std::move(rows), std::move(offsets));
+        }
+    }
+
+    inline row_buffer encode_rows(std::span<const array_data> columns, std::size_t block_size)
+    {
+        std::vector<const array_data*> addresses;
+        addresses.reserve(columns.size());
+        for (const array_data& data : columns)
+        {
+            addresses.push_back(&data);
+        }
+        return impl::encode_rows(addresses, block_size);
+    }
+
+    template <class... T, class... Layout>
+    row_buffer encode_rows(const typed_array<T, Layout>&... arrays)
+    {
+        const std::array<const array_data*, sizeof...(arrays)> columns = {&arrays.get_data()...};
+        return impl::encode_rows(columns, default_row_block_size);
+    }
+
+    /******************************
+     * decode_rows implementation *
+     ******************************/
+
+    namespace impl
+    {
+        inline row_heap_ref read_heap_ref(const std::uint8_t* row, std::size_t slot)
+        {
+            row_heap_ref ref;
+            std::memcpy(&ref, row + slot, sizeof(row_heap_ref));
+            return ref;
+        }
+
+        /*
+         * Sets the bits of the rows of \p block in \p words, the validity words of the
+         * field \p field; blocks start on multiples of 64, so that they do not share words.
+         */
+        inline void decode_validity(
+            const row_buffer& rows,
+            const morsel& block,
+            std::size_t field,
+            std::vector<bitmap_word>& words
+        )
+        {
+            const std::uint8_t* data = rows.data().data();
+            const std::size_t* offsets = rows.offsets().data();
+            const std::size_t byte = field / 8u;
+            const unsigned shift = static_cast<unsigned>(field % 8u);
+            for (std::size_t first = block.begin; first < block.end; first += bitmap_word_bits)
+            {
+                const std::size_t count = std::min(bitmap_word_bits, block.end - first);
+                bitmap_word word = 0;
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    word |= bitmap_word((data[offsets[first + j] + byte] >> shift) & 1u) << j;
+                }
+                words[first / bitmap_word_bits] = word;
+            }
+        }
+
+        inline void decode_timestamps(const row_buffer& rows, const morsel& block, std::size_t slot, timestamp* values)
+        {
+            const std::uint8_t* data = rows.data().data();
+            const std::size_t* offsets = rows.offsets().data();
+            for (std::size_t i = block.begin; i < block.end; ++i)
+            {
+                std::int64_t count = 0;
+                std::memcpy(&count, data + offsets[i] + slot, sizeof(count));
+                values[i] = timestamp(std::chrono::sys_time<std::chrono::nanoseconds>(std::chrono::nanoseconds(count)));
+            }
+        }
+
+        inline void decode_fixed_size_values(
+            const row_buffer& rows,
+            const morsel& block,
+            std::size_t slot,
+            std::size_t width,
+            std::uint8_t* values
+        )
+        {
+            const std::uint8_t* data = rows.data().data();
+            const std::size_t* offsets = rows.offsets().data();
+            visit_value_width(
+                width,
+                [&](auto w)
+                {
+                    for (std::size_t i = block.begin; i < block.end; ++i)
+                    {
+                        std::memcpy(values + i * w, data + offsets[i] + slot, w);
+                    }
+                }
+            );
+        }
+
+        inline void decode_strings(
+            const row_buffer& rows,
+            const morsel& block,
+            std::size_t slot,
+            const std::int64_t* string_offsets,
+            std::uint8_t* bytes
+        )
+        {
+            const std::uint8_t* data = rows.data().data();
+            const std::size_t* offsets = rows.offsets().data();
+            for (std::size_t i = block.begin; i < block.end; ++i)
+            {
+                const std::uint8_t* row = data + offsets[i];
+                const row_heap_ref ref = read_heap_ref(row, slot);
+                if (ref.length != 0u)
+                {
+                    std::memcpy(bytes + string_offsets[i], row + ref.offset, ref.length);
+                }
+            }
+        }
+
+        /*
+         * Allocates the buffers of the field \p field; the offsets of a string field are
+         * computed from the lengths in the rows, so that its bytes are allocated once.
+         */
+        inline std::vector<array_data::buffer_type>
+        make_decoded_buffers(const row_buffer& rows, std::size_t field)
+        {
+            const row_layout& layout = rows.layout();
+            const std::size_t size = rows.size();
+            std::vector<array_data::buffer_type> buffers;
+            if (layout.is_variable_size(field))
+            {
+                array_data::buffer_type offsets(sizeof(std::int64_t) * (size + 1u));
+                std::int64_t* out = offsets.data<std::int64_t>();
+                out[0] = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    const row_heap_ref ref = read_heap_ref(rows.row(i).data(), layout.field_offset(field));
+                    out[i + 1u] = out[i] + static_cast<std::int64_t>(ref.length);
+                }
+                const auto byte_count = static_cast<std::size_t>(out[size]);
+                buffers.push_back(std::move(offsets));
+                buffers.emplace_back(byte_count);
+            }
+            else
+            {
+                buffers.emplace_back(size * fixed_value_width(layout.type(field)));
+            }
+            return buffers;
+        }
+    }
+
+    inline std::vector<array_data> decode_rows(const row_buffer& rows, std::size_t block_size)
+    {
+        const row_layout& layout = rows.layout();
+        const std::size_t size = rows.size();
+        const std::size_t field_count = layout.size();
+
+        std::vector<std::vector<array_data::buffer_type>> buffers;
+        std::vector<std::vector<bitmap_word>> validity(
+            field_count,
+            std::vector<bitmap_word>(bitmap_word_count(size))
+        );
+        buffers.reserve(field_count);
+        for (std::size_t f = 0; f < field_count; ++f)
+        {
+            buffers.push_back(impl::make_decoded_buffers(rows, f));
+        }
+
+        const std::size_t step = aligned_morsel_size(block_size);
+        for (std::size_t first = 0; first < size; first += step)
+        {
+            const morsel block{first / step, first, std::min(size, first + step)};
+            for (std::size_t f = 0; f < field_count; ++f)
+            {
+                impl::decode_validity(rows, block, f, validity[f]);
+                if (layout.is_variable_size(f))
+                {
+                    impl::decode_strings(
+                        rows,
+                        block,
+                        layout.field_offset(f),
+                        buffers[f][0].data<std::int64_t>(),
+                        buffers[f][1].data()
+                    );
+                }
+                else if (layout.type(f) == data_type::TIMESTAMP)
+                {
+                    impl::decode_timestamps(rows, block, layout.field_offset(f), buffers[f][0].data<timestamp>());
+                }
+                else
+                {
+                    impl::decode_fixed_size_values(
+                        rows,
+                        block,
+                        layout.field_offset(f),
+                        impl::fixed_value_width(layout.type(f)),
+                        buffers[f][0].data()
+                    );
+                }
+            }
+        }
+
+        std::vector<array_data> res;
+        res.reserve(field_count);
+        for (std::size_t f = 0; f < field_count; ++f)
+        {
+            const std::vector<bitmap_word>& words = validity[f];
+            res.push_back(array_data{
+                .type = data_descriptor(layout.type(f)),
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = make_bitmap_from_words(
+                    size,
+                    [&words](std::size_t k)
+                    {
+                        return words[k];
+                    }
+                ),
+                .buffers = std::move(buffers[f]),
+                .child_data = {},
+                .dictionary = nullptr
+            });
+        }
+        return res;
+    }
+}
@@ -0,0 +1,564 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/comparison.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Position returned by a search in a sorted array when the searched value is equal
+     * to some of its elements.
+     */
+    enum class search_side
+    {
+        /// The position of the first equal element.
+        left,
+        /// The position following the last equal element.
+        right
+    };
+
+    /**
+     * Number of values looked up together by the batched searches: the steps of their
+     * binary searches are interleaved, so that their memory accesses overlap.
+     */
+    inline constexpr std::size_t search_batch_size = 16;
+
+    /**
+     * Matches the typed arrays that can be searched, that is arrays whose values are
+     * stored in a fixed size layout or in a variable size binary layout.
+     */
+    template <class A>
+    concept searchable_typed_array = is_typed_array_v<A> && raw_readable_layout<typename A::layout_type>;
+
+    /**
+     * Finds the position where a value should be inserted in a sorted array to keep it
+     * sorted.
+     *
+     * Values are compared as by the comparison kernels. The null elements of \p array
+     * must be at its end; they are not searched. The search is a binary search without
+     * branch.
+     *
+     * @param array The sorted array.
+     * @param value The value to search.
+     * @param side Which position to return when \p array holds elements equal to \p value.
+     * @return The position, in [0, n], n being the number of non-null elements of \p array.
+     * @pre \p array must be sorted in increasing order.
+     */
+    template <searchable_typed_array A, class U>
+        requires(!is_typed_array_v<U>)
+    std::size_t search_sorted(const A& array, const U& value, search_side side = search_side::left);
+
+    /**
+     * Batched version of search_sorted: \p values are looked up search_batch_size at a
+     * time, the accesses of the following steps of the searches being prefetched.
+     *
+     * @return The position of each element of \p values, null where \p values is null.
+     */
+    template <searchable_typed_array A>
+    typed_array<std::int64_t> search_sorted(const A& array, const A& values, search_side side = search_side::left);
+
+    /**
+     * Finds the elements of a sorted array that lie in a closed interval.
+     *
+     * @return The range [first, last) of the positions of the elements in [low, high].
+     * @pre \p array must be sorted in increasing order, its null elements at its end.
+     */
+    template <searchable_typed_array A, class U>
+        requires(!is_typed_array_v<U>)
+    std::pair<std::size_t, std::size_t> search_range(const A& array, const U& low, const U& high);
+
+    /**
+     * Search index of a sorted array, storing its keys in Eytzinger order.
+     *
+     * The keys are laid out as the nodes of a complete binary search tree traversed in
+     * breadth-first order, so that the first levels of all the searches share the same
+     * cache lines and the nodes visited a few levels further are contiguous, which lets
+     * a search prefetch them. The index holds a copy of the keys and their positions;
+     * the keys of binary arrays are views on the array, which must outlive the index.
+     *
+     * @tparam A The type of the array.
+     */
+    template <searchable_typed_array A>
+    class sorted_search_index
+    {
+    public:
+
+        using reader_type = raw_value_reader<typename A::layout_type>;
+        using key_type = std::remove_cvref_t<
+            decltype(impl::comparison_key(std::declval<typename reader_type::const_reference>()))>;
+        using size_type = std::size_t;
+
+        /**
+         * @pre \p array must be sorted in increasing order, its null elements at its end.
+         */
+        explicit sorted_search_index(const A& array);
+
+        /**
+         * @return The number of keys, that is of non-null elements of the array.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @see search_sorted
+         */
+        template <class U>
+            requires(!is_typed_array_v<U>)
+        size_type search(const U& value, search_side side = search_side::left) const;
+
+        /**
+         * @see search_sorted
+         */
+        typed_array<std::int64_t> search(const A& values, search_side side = search_side::left) const;
+
+        /**
+         * @see search_range
+         */
+        template <class U>
+            requires(!is_typed_array_v<U>)
+        std::pair<size_type, size_type> range(const U& low, const U& high) const;
+
+    private:
+
+        template <class Before>
+        void search_batch(const key_type* values, size_type count, size_type* out, const Before& before) const;
+
+        // Nodes are numbered from 1, m_keys[0] and m_positions[0] are unused
+        std::vector<key_type> m_keys;
+        std::vector<size_type> m_positions;
+    };
+
+    /********************************
+     * search_sorted implementation *
+     ********************************/
+
+    namespace impl
+    {
+        inline void prefetch(const void* address) noexcept
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(address);
+#else
+            static_cast<void>(address);
+#endif
+        }
+
+        /*
+         * Predicates telling whether the element key goes before the insertion position of
+         * value, for each side.
+         */
+        struct before_left
+        {
+            template <class K, class V>
+            bool operator()(const K& key, const V& value) const
+            {
+                return key < value;
+            }
+        };
+
+        struct before_right
+        {
+            template <class K, class V>
+            bool operator()(const K& key, const V& value) const
+            {
+                return !(value < key);
+            }
+        };
+
+        template <class F>
+        decltype(auto) visit_search_side(search_side side, F&& f)
+        {
+            return side == search_side::left ? f(before_left{}) : f(before_right{});
+        }
+
+        /*
+         * @return The number of elements before the first null element; null elements are
+         * at the end, hence the words of the validity are searched by bisection.
+         */
+        inline std::size_t valid_prefix_size(const bitmap_word_reader& validity)
+        {
+            if (validity.all_set())
+            {
+                return validity.size();
+            }
+            std::size_t first = 0;
+            std::size_t last = validity.word_count();
+            while (first < last)
+            {
+                const std::size_t middle = first + (last - first) / 2;
+                const std::size_t count = std::min(bitmap_word_bits, validity.size() - middle * bitmap_word_bits);
+                if (validity.word(middle) == low_bits_mask(count))
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            const std::size_t position = first * bitmap_word_bits;
+            return position == validity.size()
+                       ? position
+                       : position + static_cast<std::size_t>(std::countr_one(validity.word(first)));
+        }
+
+        /*
+         * The non-null elements of a sorted array, read as comparison keys.
+         */
+        template <searchable_typed_array A>
+        class sorted_keys
+        {
+        public:
+
+            using reader_type = raw_value_reader<typename A::layout_type>;
+
+            explicit sorted_keys(const A& array)
+                : m_reader(array.get_data())
+                , m_size(valid_prefix_size(make_validity_reader(array.get_data())))
+            {
+                if (const auto statistics = array.cached_statistics())
+                {
+                    SPARROW_ASSERT_TRUE(statistics->is_sorted);
+                    SPARROW_ASSERT_TRUE(statistics->null_count == array.size() - m_size);
+                }
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+            auto operator[](std::size_t i) const
+            {
+                return comparison_key(m_reader[i]);
+            }
+
+            const void* address(std::size_t i) const
+            {
+                if constexpr (contiguous_layout<typename A::layout_type>)
+                {
+                    return m_reader.data() + i;
+                }
+                else
+                {
+                    return m_reader.offsets() + i;
+                }
+            }
+
+        private:
+
+            reader_type m_reader;
+            std::size_t m_size;
+        };
+
+        /*
+         * Binary search whose steps select the next range with a conditional move rather
+         * than a branch: the range length only depends on the number of keys.
+         */
+        template <class Keys, class V, class Before>
+        std::size_t branchless_search(const Keys& keys, const V& value, const Before& before)
+        {
+            std::size_t length = keys.size();
+            if (length == 0u)
+            {
+                return 0u;
+            }
+            std::size_t base = 0;
+            while (length > 1u)
+            {
+                const std::size_t half = length / 2;
+                base += before(keys[base + half - 1], value) ? half : 0u;
+                length -= half;
+            }
+            return base + (before(keys[base], value) ? 1u : 0u);
+        }
+
+        /*
+         * Runs the branchless searches of count <= search_batch_size values, step by step:
+         * once the range of a value is updated, the key its next step compares is
+         * prefetched, while the other values are processed.
+         */
+        template <class Keys, class V, class Before>
+        void batched_search(const Keys& keys, const V* values, std::size_t count, std::size_t* out, const Before& before)
+        {
+            SPARROW_ASSERT_TRUE(count <= search_batch_size);
+            std::size_t length = keys.size();
+            if (length == 0u)
+            {
+                std::fill(out, out + count, std::size_t(0));
+                return;
+            }
+            std::array<std::size_t, search_batch_size> bases{};
+            while (length > 1u)
+            {
+                const std::size_t half = length / 2;
+                const std::size_t next_half = (length - half) / 2;
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    bases[j] += before(keys[bases[j] + half - 1], values[j]) ? half : 0u;
+                    if (next_half != 0u)
+                    {
+                        prefetch(keys.address(bases[j] + next_half - 1));
+                    }
+                }
+                length -= half;
+            }
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                out[j] = bases[j] + (before(keys[bases[j]], values[j]) ? 1u : 0u);
+            }
+        }
+
+        /*
+         * Builds the result of a batched search: search(first, count, out) writes the
+         * positions of the values [first, first + count) to out.
+         */
+        template <searchable_typed_array A, class F>
+        typed_array<std::int64_t> make_search_result(const A& values, F&& search)
+        {
+            using key_type = std::remove_cvref_t<decltype(comparison_key(
+                std::declval<typename raw_value_reader<typename A::layout_type>::const_reference>()
+            ))>;
+            const raw_value_reader<typename A::layout_type> reader(values.get_data());
+            const bitmap_word_reader validity = make_validity_reader(values.get_data());
+            const std::size_t size = values.size();
+
+            array_data::buffer_type buffer(size * sizeof(std::int64_t));
+            std::int64_t* out = buffer.data<std::int64_t>();
+            std::array<key_type, search_batch_size> keys;
+            std::array<std::size_t, search_batch_size> positions;
+            for (std::size_t first = 0; first < size; first += search_batch_size)
+            {
+                const std::size_t count = std::min(search_batch_size, size - first);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    // The values of null elements are searched as well, and then ignored
+                    keys[j] = comparison_key(reader[first + j]);
+                }
+                search(keys.data(), count, positions.data());
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    out[first + j] = static_cast<std::int64_t>(positions[j]);
+                }
+            }
+            std::vector<array_data::buffer_type> buffers;
+            buffers.push_back(std::move(buffer));
+            return typed_array<std::int64_t>(array_data{
+                .type = data_descriptor(data_type::INT64),
+                .length = static_cast<array_data::length_type>(size),
+                .offset = 0,
+                .bitmap = make_bitmap_from_words(
+                    size,
+                    [&validity](std::size_t w)
+                    {
+                        return validity.word(w);
+                    }
+                ),
+                .buffers = std::move(buffers),
+                .child_data = {},
+                .dictionary = nullptr
+            });
+        }
+    }
+
+    template <searchable_typed_array A, class U>
+        requires(!is_typed_array_v<U>)
+    std::size_t search_sorted(const A& array, const U& value, search_side side)
+    {
+        const impl::sorted_keys<A> keys(array);
+        const auto& key = impl::comparison_key(value);
+        return impl::visit_search_side(
+            side,
+            [&](const auto& before)
+            {
+                return impl::branchless_search(keys, key, before);
+            }
+        );
+    }
+
+    template <searchable_typed_array A>
+    typed_array<std::int64_t> search_sorted(const A& array, const A& values, search_side side)
+    {
+        const impl::sorted_keys<A> keys(array);
+        return impl::visit_search_side(
+            side,
+            [&](const auto& before)
+            {
+                return impl::make_search_result(
+                    values,
+                    [&](const auto* batch, std::size_t count, std::size_t* out)
+                    {
+                        impl::batched_search(keys, batch, count, out, before);
+                    }
+                );
+            }
+        );
+    }
+
+    template <searchable_typed_array A, class U>
+        requires(!is_typed_array_v<U>)
+    std::pair<std::size_t, std::size_t> search_range(const A& array, const U& low, const U& high)
+    {
+        const impl::sorted_keys<A> keys(array);
+        const std::size_t first = impl::branchless_search(keys, impl::comparison_key(low), impl::before_left{});
+        const std::size_t last = impl::branchless_search(keys, impl::comparison_key(high), impl::before_right{});
+        return {first, std::max(first, last)};
+    }
+
+    /**************************************
+     * sorted_search_index implementation *
+     **************************************/
+
+    template <searchable_typed_array A>
+    sorted_search_index<A>::sorted_search_index(const A& array)
+    {
+        const impl::sorted_keys<A> keys(array);
+        const size_type size = keys.size();
+        m_keys.resize(size + 1u);
+        m_positions.resize(size + 1u);
+        // In-order traversal of the tree, iterative to bound the stack size
+        size_type position = 0;
+        size_type node = 1;
+        std::vector<size_type> stack;
+        while (node <= size || !stack.empty())
+        {
+            while (node <= size)
+            {
+                stack.push_back(node);
+                node *= 2;
+            }
+            node = stack.back();
+            stack.pop_back();
+            m_keys[node] = keys[position];
+            m_positions[node] = position;
+            ++position;
+            node = 2 * node + 1;
+        }
+    }
+
+    template <searchable_typed_array A>
+    auto sorted_search_index<A>::size() const noexcept -> size_type
+    {
+        return m_keys.size() - 1u;
+    }
+
+    template <searchable_typed_array A>
+    template <class U>
+        requires(!is_typed_array_v<U>)
+    auto sorted_search_index<A>::search(const U& value, search_side side) const -> size_type
+    {
+        const key_type key(impl::comparison_key(value));
+        size_type res = 0;
+        impl::visit_search_side(
+            side,
+            [&](const auto& before)
+            {
+                search_batch(&key, 1u, &res, before);
+            }
+        );
+        return res;
+    }
+
+    template <searchable_typed_array A>
+    typed_array<std::int64_t> sorted_search_index<A>::search(const A& values, search_side side) const
+    {
+        return impl::visit_search_side(
+            side,
+            [&](const auto& before)
+            {
+                return impl::make_search_result(
+                    values,
+                    [&](const key_type* batch, size_type count, size_type* out)
+                    {
+                        search_batch(batch, count, out, before);
+                    }
+                );
+            }
+        );
+    }
+
+    template <searchable_typed_array A>
+    template <class U>
+        requires(!is_typed_array_v<U>)
+    auto sorted_search_index<A>::range(const U& low, const U& high) const -> std::pair<size_type, size_type>
+    {
+        const size_type first = search(low, search_side::left);
+        const size_type last = search(high, search_side::right);
+        return {first, std::max(first, last)};
+    }
+
+    /*
+     * The search descends from the root, going right when the node goes before the
+     * value; the nodes 2^d levels below are contiguous, those of the level whose first
+     * node fills a cache line are prefetched. The last node from which the search went
+     * left is the first node that does not go before the value, it is found by removing
+     * the trailing right moves of the path.
+     */
+    template <searchable_typed_array A>
+    template <class Before>
+    void sorted_search_index<A>::search_batch(
+        const key_type* values,
+        size_type count,
+        size_type* out,
+        const Before& before
+    ) const
+    {
+        SPARROW_ASSERT_TRUE(count <= search_batch_size);
+        constexpr size_type prefetch_stride = std::max(size_type(1), 64u / sizeof(key_type));
+        const size_type size = this->size();
+        const key_type* keys = m_keys.data();
+        std::array<size_type, search_batch_size> nodes;
+        std::fill(nodes.begin(), nodes.begin() + static_cast<std::ptrdiff_t>(count), size_type(1));
+        // All the searches go through the full levels of the tree
+        size_type full_levels = 0;
+        for (size_type n = size + 1u; n > 1u; n /= 2)
+        {
+            ++full_levels;
+        }
+        for (size_type level = 0; level < full_levels; ++level)
+        {
+            for (size_type j = 0; j < count; ++j)
+            {
+                impl::prefetch(keys + std::min(nodes[j] * prefetch_stride, size));
+                nodes[j] = 2 * nodes[j] + (before(keys[nodes[j]], values[j]) ? 1u : 0u);
+            }
+        }
+        for (size_type j = 0; j < count; ++j)
+        {
+            size_type node = nodes[j];
+            if (node <= size)
+            {
+                node = 2 * node + (before(keys[node], values[j]) ? 1u : 0u);
+            }
+            node >>= std::countr_one(node) + 1;
+            out[j] = node == 0u ? size : m_positions[node];
+        }
+    }
+}
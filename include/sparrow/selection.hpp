@@ -0,0 +1,757 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/dynamic_bitset.hpp"
+#include "sparrow/hashing.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/packed_boolean_array.hpp"
+#include "sparrow/typed_array.hpp"
+#include "sparrow/window.hpp"
+
+namespace sparrow
+{
+    /**
+     * Number of rows per selected row from which a selection_vector stores the indices of
+     * the selected rows instead of a bitmap: an index takes 32 bits, a row one bit of
+     * bitmap.
+     */
+    inline constexpr std::size_t selection_index_density = 32;
+
+    /**
+     * The rows of an array that are selected by a sequence of filters.
+     *
+     * Sparse selections are stored as the sorted indices of the selected rows, dense
+     * selections as a bitmap of the rows; the representation is chosen from the number
+     * of selected rows each time a selection is built, see selection_index_density.
+     * Either way, the rows are visited in increasing order.
+     *
+     * The rows are those of arrays of less than 2^32 elements, such as record batches.
+     */
+    class selection_vector
+    {
+    public:
+
+        using size_type = std::size_t;
+        using index_type = std::uint32_t;
+        using bitmap_type = dynamic_bitset<std::uint8_t>;
+
+        enum class kind
+        {
+            indices,
+            bitmap
+        };
+
+        /**
+         * Builds an empty selection of an empty array.
+         */
+        selection_vector() = default;
+
+        /**
+         * Selects the true elements of \p mask; null elements are not selected.
+         */
+        explicit selection_vector(const packed_boolean_array& mask);
+
+        /**
+         * @return The selection of every row of an array of \p source_size elements.
+         */
+        static selection_vector all(size_type source_size);
+
+        /**
+         * @pre \p indices must be strictly increasing and less than \p source_size.
+         */
+        static selection_vector from_indices(std::vector<index_type> indices, size_type source_size);
+
+        /**
+         * Selects the set bits of \p bitmap.
+         */
+        static selection_vector from_bitmap(bitmap_type bitmap);
+
+        /**
+         * @return The number of selected rows.
+         */
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        /**
+         * @return The number of rows of the array the selection applies to.
+         */
+        size_type source_size() const noexcept;
+
+        /**
+         * @return The ratio of selected rows, 1 for the selection of an empty array.
+         */
+        double selectivity() const noexcept;
+
+        kind representation() const noexcept;
+
+        /**
+         * @pre representation() must be kind::indices.
+         */
+        std::span<const index_type> indices() const;
+
+        /**
+         * @pre representation() must be kind::bitmap.
+         */
+        const bitmap_type& bitmap() const;
+
+        bool contains(size_type row) const;
+
+        /**
+         * Calls `f(row)` for each selected row, in increasing order.
+         */
+        template <class F>
+        void for_each(F&& f) const;
+
+        /**
+         * Calls `f(row)` for each selected row whose bit is set in \p mask.
+         */
+        template <class F>
+        void for_each(const bitmap_word_reader& mask, F&& f) const;
+
+        /**
+         * @return The selected rows for which `keep(row)` returns true; \p keep is only
+         *         called on the selected rows.
+         */
+        template <class Pred>
+        selection_vector refine(Pred&& keep) const;
+
+        /**
+         * @return The selected rows whose bit is set in \p mask. Bitmap selections are
+         *         combined with \p mask 64 rows at a time.
+         */
+        selection_vector intersect(const bitmap_word_reader& mask) const;
+
+        /**
+         * @return The selected rows that are true in \p mask.
+         */
+        selection_vector intersect(const packed_boolean_array& mask) const;
+
+    private:
+
+        selection_vector(std::vector<index_type> indices, bitmap_type bitmap, kind k, size_type source_size);
+
+        static bool use_indices(size_type count, size_type source_size) noexcept;
+
+        std::vector<index_type> m_indices;
+        bitmap_type m_bitmap;
+        kind m_kind = kind::indices;
+        size_type m_source_size = 0;
+    };
+
+    /**
+     * Matches the typed arrays that can be viewed through a selection.
+     */
+    template <class A>
+    concept filterable_typed_array = is_typed_array_v<A> && raw_readable_layout<typename A::layout_type>;
+
+    /**
+     * The rows of a typed_array selected by a selection_vector.
+     *
+     * Filtering a view refines its selection without copying any value, so that the
+     * predicates, aggregations and lookups that follow only read the selected rows; the
+     * values are gathered once, by take. The view refers to the array, which must
+     * outlive it.
+     *
+     * @tparam A The type of the array.
+     */
+    template <filterable_typed_array A>
+    class selection_view
+    {
+    public:
+
+        using array_type = A;
+        using layout_type = typename A::layout_type;
+        using size_type = std::size_t;
+
+        /**
+         * Selects every row of \p array.
+         */
+        explicit selection_view(const A& array);
+
+        /**
+         * @pre The source size of \p selection must be the size of \p array.
+         */
+        selection_view(const A& array, selection_vector selection);
+
+        const A& array() const noexcept;
+        const selection_vector& selection() const noexcept;
+
+        /**
+         * @return The number of selected rows.
+         */
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+    private:
+
+        const A* p_array;
+        selection_vector m_selection;
+    };
+
+    namespace impl
+    {
+        /*
+         * Calls f with the rows of the set bits of the words of reader.
+         */
+        template <class F>
+        void for_each_set_row(const bitmap_word_reader& reader, F& f)
+        {
+            for (std::size_t w = 0; w < reader.word_count(); ++w)
+            {
+                const std::size_t first = w * bitmap_word_bits;
+                for_each_set_bit(
+                    reader.word(w),
+                    [&f, first](std::size_t j)
+                    {
+                        f(first + j);
+                    }
+                );
+            }
+        }
+
+        inline bool test_bit(const bitmap_word_reader& reader, std::size_t i) noexcept
+        {
+            return reader.all_set() || ((reader.word(i / bitmap_word_bits) >> (i % bitmap_word_bits)) & 1u) != 0u;
+        }
+
+        template <filterable_typed_array A>
+        bitmap_word_reader make_validity_reader(const A& array)
+        {
+            return ::sparrow::make_validity_reader(array.get_data());
+        }
+    }
+
+    /**
+     * Keeps the selected rows whose value is valid and satisfies \p pred; \p pred is only
+     * evaluated on these rows. This covers the comparisons with a scalar, e.g.
+     * `filter(view, [](double v) { return v > 10.; })`.
+     *
+     * @param view The rows to filter.
+     * @param pred Callable taking a value of the layout, as read by raw_value_reader.
+     */
+    template <filterable_typed_array A, class Pred>
+        requires std::predicate<Pred&, typename raw_value_reader<typename A::layout_type>::value_type>
+    selection_view<A> filter(const selection_view<A>& view, Pred&& pred);
+
+    /**
+     * Keeps the selected rows that are true in \p mask, such as the result of a
+     * comparison of the whole array.
+     */
+    template <filterable_typed_array A>
+    selection_view<A> filter(const selection_view<A>& view, const packed_boolean_array& mask);
+
+    /**
+     * Keeps the selected rows whose value is in \p value_set; the value set is looked up
+     * for the valid selected rows only.
+     *
+     * @see is_in
+     */
+    template <hashable_value_type T>
+    selection_view<typed_array<T>> filter_is_in(
+        const selection_view<typed_array<T>>& view,
+        const typed_array<T>& value_set
+    );
+
+    /**
+     * @return The number of selected rows that are not null.
+     */
+    template <filterable_typed_array A>
+    std::size_t count(const selection_view<A>& view);
+
+    /**
+     * @return The sum of the valid selected values, 0 if there is none.
+     */
+    template <window_value_type T>
+    window_sum_t<T> sum(const selection_view<typed_array<T>>& view);
+
+    /**
+     * @return The smallest valid selected value, std::nullopt if there is none.
+     */
+    template <window_value_type T>
+    std::optional<T> min(const selection_view<typed_array<T>>& view);
+
+    /**
+     * @return The largest valid selected value, std::nullopt if there is none.
+     */
+    template <window_value_type T>
+    std::optional<T> max(const selection_view<typed_array<T>>& view);
+
+    /**
+     * Gathers the selected rows in a new array, in a single pass over the selection.
+     */
+    template <filterable_typed_array A>
+    A take(const selection_view<A>& view);
+
+    /***********************************
+     * selection_vector implementation *
+     ***********************************/
+
+    inline selection_vector::selection_vector(const packed_boolean_array& mask)
+        // The values of null elements are unset
+        : selection_vector(from_bitmap(mask.values()))
+    {
+    }
+
+    inline selection_vector::selection_vector(
+        std::vector<index_type> indices,
+        bitmap_type bitmap,
+        kind k,
+        size_type source_size
+    )
+        : m_indices(std::move(indices))
+        , m_bitmap(std::move(bitmap))
+        , m_kind(k)
+        , m_source_size(source_size)
+    {
+        SPARROW_ASSERT_TRUE(source_size <= size_type(std::numeric_limits<index_type>::max()) + 1u);
+    }
+
+    inline selection_vector selection_vector::all(size_type source_size)
+    {
+        return from_bitmap(bitmap_type(source_size, true));
+    }
+
+    inline selection_vector selection_vector::from_indices(std::vector<index_type> indices, size_type source_size)
+    {
+        SPARROW_ASSERT_TRUE(std::ranges::adjacent_find(indices, std::greater_equal<>()) == indices.end());
+        SPARROW_ASSERT_TRUE(indices.empty() || indices.back() < source_size);
+        if (use_indices(indices.size(), source_size))
+        {
+            return selection_vector(std::move(indices), bitmap_type(), kind::indices, source_size);
+        }
+        bitmap_type bitmap(source_size, false);
+        for (const index_type i : indices)
+        {
+            bitmap.set(i, true);
+        }
+        return selection_vector({}, std::move(bitmap), kind::bitmap, source_size);
+    }
+
+    inline selection_vector selection_vector::from_bitmap(bitmap_type bitmap)
+    {
+        const size_type source_size = bitmap.size();
+        const size_type count = source_size - bitmap.null_count();
+        if (!use_indices(count, source_size))
+        {
+            return selection_vector({}, std::move(bitmap), kind::bitmap, source_size);
+        }
+        std::vector<index_type> indices;
+        indices.reserve(count);
+        const auto push = [&indices](size_type i)
+        {
+            indices.push_back(static_cast<index_type>(i));
+        };
+        impl::for_each_set_row(bitmap_word_reader(bitmap, 0u, source_size), push);
+        return selection_vector(std::move(indices), bitmap_type(), kind::indices, source_size);
+    }
+
+    inline auto selection_vector::size() const noexcept -> size_type
+    {
+        return m_kind == kind::indices ? m_indices.size() : m_bitmap.size() - m_bitmap.null_count();
+    }
+
+    inline bool selection_vector::empty() const noexcept
+    {
+        return size() == 0u;
+    }
+
+    inline auto selection_vector::source_size() const noexcept -> size_type
+    {
+        return m_source_size;
+    }
+
+    inline double selection_vector::selectivity() const noexcept
+    {
+        return m_source_size == 0u ? 1. : static_cast<double>(size()) / static_cast<double>(m_source_size);
+    }
+
+    inline auto selection_vector::representation() const noexcept -> kind
+    {
+        return m_kind;
+    }
+
+    inline auto selection_vector::indices() const -> std::span<const index_type>
+    {
+        SPARROW_ASSERT_TRUE(m_kind == kind::indices);
+        return m_indices;
+    }
+
+    inline auto selection_vector::bitmap() const -> const bitmap_type&
+    {
+        SPARROW_ASSERT_TRUE(m_kind == kind::bitmap);
+        return m_bitmap;
+    }
+
+    inline bool selection_vector::contains(size_type row) const
+    {
+        SPARROW_ASSERT_TRUE(row < m_source_size);
+        if (m_kind == kind::indices)
+        {
+            return std::ranges::binary_search(m_indices, static_cast<index_type>(row));
+        }
+        return m_bitmap.test(row);
+    }
+
+    template <class F>
+    void selection_vector::for_each(F&& f) const
+    {
+        if (m_kind == kind::indices)
+        {
+            for (const index_type i : m_indices)
+            {
+                f(static_cast<size_type>(i));
+            }
+        }
+        else
+        {
+            impl::for_each_set_row(bitmap_word_reader(m_bitmap, 0u, m_source_size), f);
+        }
+    }
+
+    template <class F>
+    void selection_vector::for_each(const bitmap_word_reader& mask, F&& f) const
+    {
+        SPARROW_ASSERT_TRUE(mask.size() == m_source_size);
+        if (mask.all_set())
+        {
+            for_each(f);
+        }
+        else if (m_kind == kind::indices)
+        {
+            for (const index_type i : m_indices)
+            {
+                if (impl::test_bit(mask, i))
+                {
+                    f(static_cast<size_type>(i));
+                }
+            }
+        }
+        else
+        {
+            const bitmap_word_reader reader(m_bitmap, 0u, m_source_size);
+            for (size_type w = 0; w < reader.word_count(); ++w)
+            {
+                const size_type first = w * bitmap_word_bits;
+                for_each_set_bit(
+                    reader.word(w) & mask.word(w),
+                    [&f, first](size_type j)
+                    {
+                        f(first + j);
+                    }
+                );
+            }
+        }
+    }
+
+    template <class Pred>
+    selection_vector selection_vector::refine(Pred&& keep) const
+    {
+        if (m_kind == kind::indices)
+        {
+            std::vector<index_type> indices;
+            indices.reserve(m_indices.size());
+            for (const index_type i : m_indices)
+            {
+                if (keep(static_cast<size_type>(i)))
+                {
+                    indices.push_back(i);
+                }
+            }
+            return from_indices(std::move(indices), m_source_size);
+        }
+        const bitmap_word_reader reader(m_bitmap, 0u, m_source_size);
+        return from_bitmap(make_bitmap_from_words(
+            m_source_size,
+            [&reader, &keep](size_type w)
+            {
+                bitmap_word res = 0;
+                for_each_set_bit(
+                    reader.word(w),
+                    [&res, &keep, w](size_type j)
+                    {
+                        if (keep(w * bitmap_word_bits + j))
+                        {
+                            res |= bitmap_word(1) << j;
+                        }
+                    }
+                );
+                return res;
+            }
+        ));
+    }
+
+    inline selection_vector selection_vector::intersect(const bitmap_word_reader& mask) const
+    {
+        SPARROW_ASSERT_TRUE(mask.size() == m_source_size);
+        if (mask.all_set())
+        {
+            return *this;
+        }
+        if (m_kind == kind::indices)
+        {
+            return refine(
+                [&mask](size_type i)
+                {
+                    return impl::test_bit(mask, i);
+                }
+            );
+        }
+        const bitmap_word_reader reader(m_bitmap, 0u, m_source_size);
+        return from_bitmap(make_bitmap_from_words(
+            m_source_size,
+            [&reader, &mask](size_type w)
+            {
+                return reader.word(w) & mask.word(w);
+            }
+        ));
+    }
+
+    inline selection_vector selection_vector::intersect(const packed_boolean_array& mask) const
+    {
+        return intersect(bitmap_word_reader(mask.values(), 0u, mask.size()));
+    }
+
+    inline bool selection_vector::use_indices(size_type count, size_type source_size) noexcept
+    {
+        return count * selection_index_density < source_size;
+    }
+
+    /*********************************
+     * selection_view implementation *
+     *********************************/
+
+    template <filterable_typed_array A>
+    selection_view<A>::selection_view(const A& array)
+        : selection_view(array, selection_vector::all(array.size()))
+    {
+    }
+
+    template <filterable_typed_array A>
+    selection_view<A>::selection_view(const A& array, selection_vector selection)
+        : p_array(&array)
+        , m_selection(std::move(selection))
+    {
+        SPARROW_ASSERT_TRUE(m_selection.source_size() == array.size());
+    }
+
+    template <filterable_typed_array A>
+    const A& selection_view<A>::array() const noexcept
+    {
+        return *p_array;
+    }
+
+    template <filterable_typed_array A>
+    const selection_vector& selection_view<A>::selection() const noexcept
+    {
+        return m_selection;
+    }
+
+    template <filterable_typed_array A>
+    auto selection_view<A>::size() const noexcept -> size_type
+    {
+        return m_selection.size();
+    }
+
+    template <filterable_typed_array A>
+    bool selection_view<A>::empty() const noexcept
+    {
+        return m_selection.empty();
+    }
+
+    /**************************
+     * kernels implementation *
+     **************************/
+
+    template <filterable_typed_array A, class Pred>
+        requires std::predicate<Pred&, typename raw_value_reader<typename A::layout_type>::value_type>
+    selection_view<A> filter(const selection_view<A>& view, Pred&& pred)
+    {
+        const raw_value_reader<typename A::layout_type> values(view.array().get_data());
+        return selection_view<A>(
+            view.array(),
+            view.selection()
+                .intersect(impl::make_validity_reader(view.array()))
+                .refine(
+                    [&values, &pred](std::size_t i)
+                    {
+                        return static_cast<bool>(pred(values[i]));
+                    }
+                )
+        );
+    }
+
+    template <filterable_typed_array A>
+    selection_view<A> filter(const selection_view<A>& view, const packed_boolean_array& mask)
+    {
+        SPARROW_ASSERT_TRUE(mask.size() == view.array().size());
+        return selection_view<A>(view.array(), view.selection().intersect(mask));
+    }
+
+    template <hashable_value_type T>
+    selection_view<typed_array<T>> filter_is_in(
+        const selection_view<typed_array<T>>& view,
+        const typed_array<T>& value_set
+    )
+    {
+        const impl::value_set_lookup<T> lookup(value_set, view.size());
+        return filter(
+            view,
+            [&lookup](const auto& value)
+            {
+                return lookup(value) >= 0;
+            }
+        );
+    }
+
+    template <filterable_typed_array A>
+    std::size_t count(const selection_view<A>& view)
+    {
+        std::size_t res = 0;
+        view.selection().for_each(
+            impl::make_validity_reader(view.array()),
+            [&res](std::size_t)
+            {
+                ++res;
+            }
+        );
+        return res;
+    }
+
+    template <window_value_type T>
+    window_sum_t<T> sum(const selection_view<typed_array<T>>& view)
+    {
+        const raw_value_reader<typename typed_array<T>::layout_type> values(view.array().get_data());
+        window_sum_t<T> res = 0;
+        view.selection().for_each(
+            impl::make_validity_reader(view.array()),
+            [&res, &values](std::size_t i)
+            {
+                res += static_cast<window_sum_t<T>>(values[i]);
+            }
+        );
+        return res;
+    }
+
+    template <window_value_type T>
+    std::optional<T> min(const selection_view<typed_array<T>>& view)
+    {
+        const raw_value_reader<typename typed_array<T>::layout_type> values(view.array().get_data());
+        std::optional<T> res;
+        view.selection().for_each(
+            impl::make_validity_reader(view.array()),
+            [&res, &values](std::size_t i)
+            {
+                res = res.has_value() ? std::min(*res, values[i]) : values[i];
+            }
+        );
+        return res;
+    }
+
+    template <window_value_type T>
+    std::optional<T> max(const selection_view<typed_array<T>>& view)
+    {
+        const raw_value_reader<typename typed_array<T>::layout_type> values(view.array().get_data());
+        std::optional<T> res;
+        view.selection().for_each(
+            impl::make_validity_reader(view.array()),
+            [&res, &values](std::size_t i)
+            {
+                res = res.has_value() ? std::max(*res, values[i]) : values[i];
+            }
+        );
+        return res;
+    }
+
+    template <filterable_typed_array A>
+    A take(const selection_view<A>& view)
+    {
+        using layout_type = typename A::layout_type;
+        const array_data& source = view.array().get_data();
+        const raw_value_reader<layout_type> values(source);
+        const bitmap_word_reader validity = make_validity_reader(source);
+        const selection_vector& selection = view.selection();
+        const std::size_t size = selection.size();
+
+        bitmap_word_writer bitmap(size);
+        std::vector<array_data::buffer_type> buffers;
+        if constexpr (contiguous_layout<layout_type>)
+        {
+            using value_type = typename raw_value_reader<layout_type>::value_type;
+            array_data::buffer_type buffer(size * sizeof(value_type));
+            value_type* out = buffer.data<value_type>();
+            selection.for_each(
+                [&](std::size_t i)
+                {
+                    *out++ = values[i];
+                    bitmap.append(impl::test_bit(validity, i) ? 1u : 0u, 1u);
+                }
+            );
+            buffers.push_back(std::move(buffer));
+        }
+        else
+        {
+            using offset_type = typename raw_value_reader<layout_type>::offset_type;
+            array_data::buffer_type offsets((size + 1u) * sizeof(offset_type));
+            offset_type* out_offsets = offsets.data<offset_type>();
+            out_offsets[0] = 0;
+            std::size_t byte_count = 0;
+            selection.for_each(
+                [&](std::size_t i)
+                {
+                    byte_count += values[i].size();
+                }
+            );
+            array_data::buffer_type bytes(byte_count);
+            auto* out = bytes.data<typename raw_value_reader<layout_type>::char_type>();
+            std::size_t k = 0;
+            selection.for_each(
+                [&](std::size_t i)
+                {
+                    const auto value = values[i];
+                    out = std::copy(value.begin(), value.end(), out);
+                    out_offsets[k + 1] = out_offsets[k] + static_cast<offset_type>(value.size());
+                    ++k;
+                    bitmap.append(impl::test_bit(validity, i) ? 1u : 0u, 1u);
+                }
+            );
+            buffers.push_back(std::move(offsets));
+            buffers.push_back(std::move(bytes));
+        }
+        return A(array_data{
+            .type = source.type,
+            .length = static_cast<array_data::length_type>(size),
+            .offset = 0,
+            .bitmap = std::move(bitmap).finish(),
+            .buffers = std::move(buffers),
+            .child_data = {},
+            .dictionary = nullptr
+        });
+    }
+}
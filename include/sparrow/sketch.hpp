@@ -0,0 +1,1101 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/hashing.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    namespace impl
+    {
+        /*
+         * Calls f with the hash of each non-null element of an array in the morsel m. The hashes of 64
+         * consecutive elements are computed in a loop without branch, which compilers
+         * vectorize for numeric types, before the null elements are skipped.
+         */
+        template <hashable_value_type T, class F>
+        void for_each_valid_hash(const typed_array<T>& array, const morsel& m, F&& f)
+        {
+            using traits = hash_key_traits<T>;
+            const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+            const bitmap_word_reader validity = make_validity_reader(array.get_data(), m);
+            std::array<std::uint64_t, bitmap_word_bits> hashes;
+            for (std::size_t w = 0; w < validity.word_count(); ++w)
+            {
+                const std::size_t first = w * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, validity.size() - first);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    hashes[j] = traits::hash(traits::normalize(values[m.begin + first + j]));
+                }
+                const bitmap_word word = validity.word(w);
+                if (word == low_bits_mask(count))
+                {
+                    for (std::size_t j = 0; j < count; ++j)
+                    {
+                        f(hashes[j]);
+                    }
+                }
+                else
+                {
+                    for (bitmap_word bits = word; bits != 0u; bits &= bits - 1u)
+                    {
+                        f(hashes[static_cast<std::size_t>(std::countr_zero(bits))]);
+                    }
+                }
+            }
+        }
+
+        /*
+         * Appends values to a byte buffer, in little endian order.
+         */
+        class byte_writer
+        {
+        public:
+
+            template <class U>
+                requires std::is_arithmetic_v<U>
+            void write(U value)
+            {
+                using bits_type = std::conditional_t<
+                    sizeof(U) == 1u,
+                    std::uint8_t,
+                    std::conditional_t<sizeof(U) == 2u, std::uint16_t, std::conditional_t<sizeof(U) == 4u, std::uint32_t, std::uint64_t>>>;
+                const auto bits = std::bit_cast<bits_type>(value);
+                for (std::size_t i = 0; i < sizeof(U); ++i)
+                {
+                    m_bytes.push_back(static_cast<std::uint8_t>((bits >> (8u * i)) & 0xffu));
+                }
+            }
+
+            void write_bytes(std::span<const std::uint8_t> bytes)
+            {
+                m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+            }
+
+            std::vector<std::uint8_t> release() &&
+            {
+                return std::move(m_bytes);
+            }
+
+        private:
+
+            std::vector<std::uint8_t> m_bytes;
+        };
+
+        /*
+         * Reads values written by byte_writer.
+         */
+        class byte_reader
+        {
+        public:
+
+            explicit byte_reader(std::span<const std::uint8_t> bytes)
+                : m_bytes(bytes)
+            {
+            }
+
+            template <class U>
+                requires std::is_arithmetic_v<U>
+            U read()
+            {
+                using bits_type = std::conditional_t<
+                    sizeof(U) == 1u,
+                    std::uint8_t,
+                    std::conditional_t<sizeof(U) == 2u, std::uint16_t, std::conditional_t<sizeof(U) == 4u, std::uint32_t, std::uint64_t>>>;
+                const std::span<const std::uint8_t> bytes = read_bytes(sizeof(U));
+                std::uint64_t bits = 0;
+                for (std::size_t i = 0; i < sizeof(U); ++i)
+                {
+                    bits |= std::uint64_t{bytes[i]} << (8u * i);
+                }
+                if constexpr (sizeof(U) == sizeof(std::uint64_t))
+                {
+                    return std::bit_cast<U>(bits);
+                }
+                else
+                {
+                    return std::bit_cast<U>(static_cast<bits_type>(bits));
+                }
+            }
+
+            std::span<const std::uint8_t> read_bytes(std::size_t count)
+            {
+                if (m_bytes.size() - m_position < count)
+                {
+                    throw std::invalid_argument("deserialize: truncated input");
+                }
+                const std::span<const std::uint8_t> res = m_bytes.subspan(m_position, count);
+                m_position += count;
+                return res;
+            }
+
+            bool at_end() const noexcept
+            {
+                return m_position == m_bytes.size();
+            }
+
+            std::size_t remaining() const noexcept
+            {
+                return m_bytes.size() - m_position;
+            }
+
+        private:
+
+            std::span<const std::uint8_t> m_bytes;
+            std::size_t m_position = 0;
+        };
+
+        /*
+         * Reads and checks the header written by write_sketch_header.
+         */
+        inline void read_sketch_header(byte_reader& reader, std::uint8_t kind)
+        {
+            constexpr std::uint8_t version = 1;
+            if (reader.read<std::uint8_t>() != kind || reader.read<std::uint8_t>() != version)
+            {
+                throw std::invalid_argument("deserialize: unexpected sketch kind or version");
+            }
+        }
+
+        inline void write_sketch_header(byte_writer& writer, std::uint8_t kind)
+        {
+            constexpr std::uint8_t version = 1;
+            writer.write(kind);
+            writer.write(version);
+        }
+
+        inline constexpr std::uint8_t hyperloglog_kind = 1;
+        inline constexpr std::uint8_t count_min_kind = 2;
+        inline constexpr std::uint8_t space_saving_kind = 3;
+        inline constexpr std::uint8_t tdigest_kind = 4;
+
+        // Largest capacity accepted when deserializing a space_saving summary
+        inline constexpr std::size_t space_saving_max_capacity = std::size_t(1) << 24;
+    }
+
+    /**
+     * HyperLogLog sketch estimating the number of distinct values of arrays.
+     *
+     * The sketch uses 64-bit hashes, which removes the large range correction of the
+     * original algorithm, and the improved estimator of Ertl ("New cardinality
+     * estimation algorithms for HyperLogLog sketches", 2017), which is unbiased from
+     * small to large cardinalities without the empirical bias tables of HyperLogLog++.
+     * The relative standard error is about 1.04 / sqrt(2^precision).
+     *
+     * Sketches with the same precision can be merged, so that arrays can be sketched
+     * by different threads or in different batches.
+     */
+    class hyperloglog
+    {
+    public:
+
+        static constexpr std::uint8_t min_precision = 4;
+        static constexpr std::uint8_t max_precision = 18;
+
+        /**
+         * @param precision The base 2 logarithm of the number of registers.
+         * @throws std::invalid_argument if \p precision is not in [4, 18].
+         */
+        explicit hyperloglog(std::uint8_t precision = 14);
+
+        std::uint8_t precision() const noexcept;
+
+        /**
+         * Adds the non-null elements of \p array to the sketch.
+         */
+        template <hashable_value_type T>
+        void update(const typed_array<T>& array);
+
+        /**
+         * Parallel version of update: each morsel of \p array is added to its own sketch,
+         * and the sketches are merged.
+         */
+        template <hashable_value_type T>
+        void update(const typed_array<T>& array, const parallel_options& options);
+
+        /**
+         * Adds a value given by its 64-bit hash.
+         */
+        void update_hash(std::uint64_t hash) noexcept;
+
+        /**
+         * Adds the values of \p other to the sketch.
+         *
+         * @throws std::invalid_argument if the sketches have different precisions.
+         */
+        void merge(const hyperloglog& other);
+
+        /**
+         * @return The estimated number of distinct values added to the sketch.
+         */
+        double estimate() const;
+
+        std::vector<std::uint8_t> serialize() const;
+
+        /**
+         * @throws std::invalid_argument if \p bytes does not hold a serialized hyperloglog.
+         */
+        static hyperloglog deserialize(std::span<const std::uint8_t> bytes);
+
+        friend bool operator==(const hyperloglog&, const hyperloglog&) = default;
+
+    private:
+
+        std::uint8_t m_precision;
+        std::vector<std::uint8_t> m_registers;
+    };
+
+    /**
+     * Count-Min sketch estimating the number of occurrences of values.
+     *
+     * The estimate of a value never underestimates its count; with a width w and a
+     * depth d, it overestimates it by more than 2N/w with probability at most 2^-d,
+     * N being the total count. Sketches with the same dimensions can be merged.
+     */
+    class count_min_sketch
+    {
+    public:
+
+        /**
+         * @param width The number of counters per row, rounded up to a power of two.
+         * @param depth The number of rows.
+         * @pre \p width and \p depth must be positive.
+         */
+        count_min_sketch(std::size_t width, std::size_t depth);
+
+        std::size_t width() const noexcept;
+        std::size_t depth() const noexcept;
+
+        /**
+         * @return The sum of the counts added to the sketch.
+         */
+        std::uint64_t total_count() const noexcept;
+
+        /**
+         * Adds the non-null elements of \p array to the sketch.
+         */
+        template <hashable_value_type T>
+        void update(const typed_array<T>& array);
+
+        /**
+         * Parallel version of update: each morsel of \p array is added to its own sketch,
+         * and the sketches are merged.
+         */
+        template <hashable_value_type T>
+        void update(const typed_array<T>& array, const parallel_options& options);
+
+        /**
+         * Adds \p count occurrences of a value given by its 64-bit hash.
+         */
+        void update_hash(std::uint64_t hash, std::uint64_t count = 1) noexcept;
+
+        /**
+         * @return The estimated number of occurrences of \p value.
+         */
+        template <hashable_value_type T>
+        std::uint64_t estimate(const typename impl::hash_key_traits<T>::key_type& value) const;
+
+        /**
+         * @return The estimated number of occurrences of the value of hash \p hash.
+         */
+        std::uint64_t estimate_hash(std::uint64_t hash) const noexcept;
+
+        /**
+         * Adds the counts of \p other to the sketch.
+         *
+         * @throws std::invalid_argument if the sketches have different dimensions.
+         */
+        void merge(const count_min_sketch& other);
+
+        std::vector<std::uint8_t> serialize() const;
+
+        /**
+         * @throws std::invalid_argument if \p bytes does not hold a serialized sketch.
+         */
+        static count_min_sketch deserialize(std::span<const std::uint8_t> bytes);
+
+        friend bool operator==(const count_min_sketch&, const count_min_sketch&) = default;
+
+    private:
+
+        template <class F>
+        void for_each_counter(std::uint64_t hash, F&& f) const;
+
+        std::size_t m_width;
+        std::size_t m_depth;
+        std::uint64_t m_total_count = 0;
+        std::vector<std::uint64_t> m_counters;
+    };
+
+    /**
+     * Space-Saving summary of the most frequent values of arrays.
+     *
+     * The summary monitors at most `capacity` values. Every value whose number of
+     * occurrences is larger than N / capacity is monitored, N being the total count,
+     * and the count of a monitored value overestimates its number of occurrences by
+     * at most its error. Summaries are merged following Agarwal et al., "Mergeable
+     * summaries" (2012).
+     */
+    template <hashable_value_type T>
+    class space_saving
+    {
+    public:
+
+        using key_type = typename impl::hash_key_traits<T>::key_type;
+
+        struct entry
+        {
+            T value;
+            /// Upper bound of the number of occurrences of the value.
+            std::uint64_t count;
+            /// Maximal overestimation of count.
+            std::uint64_t error;
+
+            friend bool operator==(const entry&, const entry&) = default;
+        };
+
+        /**
+         * @param capacity The maximal number of monitored values.
+         * @pre \p capacity must be positive.
+         */
+        explicit space_saving(std::size_t capacity);
+
+        std::size_t capacity() const noexcept;
+        std::size_t size() const noexcept;
+
+        /**
+         * Adds the non-null elements of \p array to the summary.
+         */
+        void update(const typed_array<T>& array);
+
+        /**
+         * Adds \p count occurrences of \p value.
+         */
+        void update(key_type value, std::uint64_t count = 1);
+
+        /**
+         * Adds the occurrences summarized by \p other.
+         */
+        void merge(const space_saving& other);
+
+        /**
+         * @return The \p k monitored values with the largest counts, by decreasing count.
+         */
+        std::vector<entry> top(std::size_t k) const;
+
+        std::vector<std::uint8_t> serialize() const;
+
+        /**
+         * @throws std::invalid_argument if \p bytes does not hold a serialized summary.
+         */
+        static space_saving deserialize(std::span<const std::uint8_t> bytes);
+
+    private:
+
+        struct key_hash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(key_type value) const noexcept
+            {
+                using traits = impl::hash_key_traits<T>;
+                return traits::hash(traits::normalize(value));
+            }
+        };
+
+        struct key_equal
+        {
+            using is_transparent = void;
+
+            bool operator()(key_type lhs, key_type rhs) const noexcept
+            {
+                using traits = impl::hash_key_traits<T>;
+                return traits::equal(traits::normalize(lhs), traits::normalize(rhs));
+            }
+        };
+
+        static T to_value(key_type value);
+        std::uint64_t min_count() const noexcept;
+        void sift_down(std::size_t position);
+        void swap_heap(std::size_t lhs, std::size_t rhs);
+        void rebuild(std::vector<entry> entries);
+
+        std::size_t m_capacity;
+        // Monitored values; their slots never move
+        std::vector<entry> m_entries;
+        // Min-heap of slots in m_entries, ordered by count
+        std::vector<std::size_t> m_heap;
+        // Position in m_heap of each slot
+        std::vector<std::size_t> m_heap_positions;
+        std::unordered_map<T, std::size_t, key_hash, key_equal> m_slots;
+    };
+
+    /******************************
+     * hyperloglog implementation *
+     ******************************/
+
+    inline hyperloglog::hyperloglog(std::uint8_t precision)
+        : m_precision(precision)
+    {
+        if (precision < min_precision || precision > max_precision)
+        {
+            throw std::invalid_argument("hyperloglog: precision must be in [4, 18]");
+        }
+        m_registers.assign(std::size_t(1) << precision, 0u);
+    }
+
+    inline std::uint8_t hyperloglog::precision() const noexcept
+    {
+        return m_precision;
+    }
+
+    template <hashable_value_type T>
+    void hyperloglog::update(const typed_array<T>& array)
+    {
+        impl::for_each_valid_hash(
+            array,
+            morsel{0u, 0u, array.size()},
+            [this](std::uint64_t hash)
+            {
+                update_hash(hash);
+            }
+        );
+    }
+
+    template <hashable_value_type T>
+    void hyperloglog::update(const typed_array<T>& array, const parallel_options& options)
+    {
+        const hyperloglog res = parallel_reduce(
+            array.size(),
+            options,
+            hyperloglog(m_precision),
+            [this, &array](const morsel& m)
+            {
+                hyperloglog sketch(m_precision);
+                impl::for_each_valid_hash(
+                    array,
+                    m,
+                    [&sketch](std::uint64_t hash)
+                    {
+                        sketch.update_hash(hash);
+                    }
+                );
+                return sketch;
+            },
+            [](hyperloglog& sketch, const hyperloglog& morsel_sketch)
+            {
+                sketch.merge(morsel_sketch);
+            }
+        );
+        merge(res);
+    }
+
+    inline void hyperloglog::update_hash(std::uint64_t hash) noexcept
+    {
+        const std::size_t index = hash >> (64u - m_precision);
+        // The sentinel bit bounds the rank to 64 - precision + 1
+        const std::uint64_t rest = (hash << m_precision) | (std::uint64_t(1) << (m_precision - 1u));
+        const auto rank = static_cast<std::uint8_t>(std::countl_zero(rest) + 1);
+        m_registers[index] = std::max(m_registers[index], rank);
+    }
+
+    inline void hyperloglog::merge(const hyperloglog& other)
+    {
+        if (other.m_precision != m_precision)
+        {
+            throw std::invalid_argument("hyperloglog: cannot merge sketches of different precisions");
+        }
+        for (std::size_t i = 0; i < m_registers.size(); ++i)
+        {
+            m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+        }
+    }
+
+    inline double hyperloglog::estimate() const
+    {
+        const std::size_t q = 64u - m_precision;
+        const auto m = static_cast<double>(m_registers.size());
+        std::vector<std::size_t> histogram(q + 2u, 0u);
+        for (const std::uint8_t r : m_registers)
+        {
+            ++histogram[r];
+        }
+        if (histogram[0] == m_registers.size())
+        {
+            return 0.;
+        }
+
+        const auto sigma = [](double x)
+        {
+            double y = 1.;
+            double z = x;
+            for (double previous = -1.; z != previous;)
+            {
+                x *= x;
+                previous = z;
+                z += x * y;
+                y += y;
+            }
+            return z;
+        };
+        const auto tau = [](double x)
+        {
+            if (x == 0. || x == 1.)
+            {
+                return 0.;
+            }
+            double y = 1.;
+            double z = 1. - x;
+            for (double previous = -1.; z != previous;)
+            {
+                x = std::sqrt(x);
+                previous = z;
+                y *= 0.5;
+                z -= (1. - x) * (1. - x) * y;
+            }
+            return z / 3.;
+        };
+
+        double z = m * tau(1. - static_cast<double>(histogram[q + 1u]) / m);
+        for (std::size_t k = q; k >= 1u; --k)
+        {
+            z = 0.5 * (z + static_cast<double>(histogram[k]));
+        }
+        z += m * sigma(static_cast<double>(histogram[0]) / m);
+        return m * m / (2. * std::numbers::ln2 * z);
+    }
+
+    inline std::vector<std::uint8_t> hyperloglog::serialize() const
+    {
+        impl::byte_writer writer;
+        impl::write_sketch_header(writer, impl::hyperloglog_kind);
+        writer.write(m_precision);
+        writer.write_bytes(m_registers);
+        return std::move(writer).release();
+    }
+
+    inline hyperloglog hyperloglog::deserialize(std::span<const std::uint8_t> bytes)
+    {
+        impl::byte_reader reader(bytes);
+        impl::read_sketch_header(reader, impl::hyperloglog_kind);
+        hyperloglog res(reader.read<std::uint8_t>());
+        const std::span<const std::uint8_t> registers = reader.read_bytes(res.m_registers.size());
+        // estimate() counts the registers in a histogram of 64 - precision + 2 ranks
+        const auto max_rank = static_cast<std::uint8_t>(64u - res.m_precision + 1u);
+        if (std::ranges::any_of(
+                registers,
+                [max_rank](std::uint8_t r)
+                {
+                    return r > max_rank;
+                }
+            ))
+        {
+            throw std::invalid_argument("deserialize: invalid hyperloglog register");
+        }
+        std::ranges::copy(registers, res.m_registers.begin());
+        if (!reader.at_end())
+        {
+            throw std::invalid_argument("deserialize: unexpected trailing bytes");
+        }
+        return res;
+    }
+
+    /***********************************
+     * count_min_sketch implementation *
+     ***********************************/
+
+    inline count_min_sketch::count_min_sketch(std::size_t width, std::size_t depth)
+        : m_width(std::bit_ceil(width))
+        , m_depth(depth)
+        , m_counters(m_width * depth, 0u)
+    {
+        SPARROW_ASSERT_TRUE(width > 0u && depth > 0u);
+    }
+
+    inline std::size_t count_min_sketch::width() const noexcept
+    {
+        return m_width;
+    }
+
+    inline std::size_t count_min_sketch::depth() const noexcept
+    {
+        return m_depth;
+    }
+
+    inline std::uint64_t count_min_sketch::total_count() const noexcept
+    {
+        return m_total_count;
+    }
+
+    /*
+     * The rows use the hashes h1 + i * h2 derived from a single 64-bit hash (Kirsch and
+     * Mitzenmacher, "Less hashing, same performance", 2006).
+     */
+    template <class F>
+    void count_min_sketch::for_each_counter(std::uint64_t hash, F&& f) const
+    {
+        const std::uint64_t h1 = hash;
+        const std::uint64_t h2 = impl::mix_hash(hash) | 1u;
+        const std::uint64_t mask = m_width - 1u;
+        for (std::size_t row = 0; row < m_depth; ++row)
+        {
+            f(row * m_width + ((h1 + row * h2) & mask));
+        }
+    }
+
+    template <hashable_value_type T>
+    void count_min_sketch::update(const typed_array<T>& array)
+    {
+        impl::for_each_valid_hash(
+            array,
+            morsel{0u, 0u, array.size()},
+            [this](std::uint64_t hash)
+            {
+                update_hash(hash);
+            }
+        );
+    }
+
+    template <hashable_value_type T>
+    void count_min_sketch::update(const typed_array<T>& array, const parallel_options& options)
+    {
+        const count_min_sketch res = parallel_reduce(
+            array.size(),
+            options,
+            count_min_sketch(m_width, m_depth),
+            [this, &array](const morsel& m)
+            {
+                count_min_sketch sketch(m_width, m_depth);
+                impl::for_each_valid_hash(
+                    array,
+                    m,
+                    [&sketch](std::uint64_t hash)
+                    {
+                        sketch.update_hash(hash);
+                    }
+                );
+                return sketch;
+            },
+            [](count_min_sketch& sketch, const count_min_sketch& morsel_sketch)
+            {
+                sketch.merge(morsel_sketch);
+            }
+        );
+        merge(res);
+    }
+
+    inline void count_min_sketch::update_hash(std::uint64_t hash, std::uint64_t count) noexcept
+    {
+        for_each_counter(
+            hash,
+            [this, count](std::size_t i)
+            {
+                m_counters[i] += count;
+            }
+        );
+        m_total_count += count;
+    }
+
+    template <hashable_value_type T>
+    std::uint64_t count_min_sketch::estimate(const typename impl::hash_key_traits<T>::key_type& value) const
+    {
+        using traits = impl::hash_key_traits<T>;
+        return estimate_hash(traits::hash(traits::normalize(value)));
+    }
+
+    inline std::uint64_t count_min_sketch::estimate_hash(std::uint64_t hash) const noexcept
+    {
+        std::uint64_t res = std::numeric_limits<std::uint64_t>::max();
+        for_each_counter(
+            hash,
+            [this, &res](std::size_t i)
+            {
+                res = std::min(res, m_counters[i]);
+            }
+        );
+        return res;
+    }
+
+    inline void count_min_sketch::merge(const count_min_sketch& other)
+    {
+        if (other.m_width != m_width || other.m_depth != m_depth)
+        {
+            throw std::invalid_argument("count_min_sketch: cannot merge sketches of different dimensions");
+        }
+        for (std::size_t i = 0; i < m_counters.size(); ++i)
+        {
+            m_counters[i] += other.m_counters[i];
+        }
+        m_total_count += other.m_total_count;
+    }
+
+    inline std::vector<std::uint8_t> count_min_sketch::serialize() const
+    {
+        impl::byte_writer writer;
+        impl::write_sketch_header(writer, impl::count_min_kind);
+        writer.write<std::uint64_t>(m_width);
+        writer.write<std::uint64_t>(m_depth);
+        writer.write(m_total_count);
+        for (const std::uint64_t counter : m_counters)
+        {
+            writer.write(counter);
+        }
+        return std::move(writer).release();
+    }
+
+    inline count_min_sketch count_min_sketch::deserialize(std::span<const std::uint8_t> bytes)
+    {
+        impl::byte_reader reader(bytes);
+        impl::read_sketch_header(reader, impl::count_min_kind);
+        const std::size_t width = reader.read<std::uint64_t>();
+        const std::size_t depth = reader.read<std::uint64_t>();
+        // The total count is followed by exactly width * depth counters; the
+        // division keeps the product from wrapping around on forged dimensions.
+        const std::size_t remaining = reader.remaining();
+        const std::size_t word_count = remaining / sizeof(std::uint64_t);
+        if (width == 0u || depth == 0u || !std::has_single_bit(width) || word_count == 0u
+            || remaining % sizeof(std::uint64_t) != 0u || depth > (word_count - 1u) / width
+            || width * depth != word_count - 1u)
+        {
+            throw std::invalid_argument("deserialize: invalid count_min_sketch dimensions");
+        }
+        count_min_sketch res(width, depth);
+        res.m_total_count = reader.read<std::uint64_t>();
+        for (std::uint64_t& counter : res.m_counters)
+        {
+            counter = reader.read<std::uint64_t>();
+        }
+        if (!reader.at_end())
+        {
+            throw std::invalid_argument("deserialize: unexpected trailing bytes");
+        }
+        return res;
+    }
+
+    /*******************************
+     * space_saving implementation *
+     *******************************/
+
+    template <hashable_value_type T>
+    space_saving<T>::space_saving(std::size_t capacity)
+        : m_capacity(capacity)
+    {
+        SPARROW_ASSERT_TRUE(capacity > 0u);
+        m_entries.reserve(capacity);
+        m_heap.reserve(capacity);
+        m_heap_positions.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    template <hashable_value_type T>
+    std::size_t space_saving<T>::capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    template <hashable_value_type T>
+    std::size_t space_saving<T>::size() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    template <hashable_value_type T>
+    void space_saving<T>::update(const typed_array<T>& array)
+    {
+        const raw_value_reader<typename typed_array<T>::layout_type> values(array.get_data());
+        impl::for_each_valid(
+            make_validity_reader(array.get_data()),
+            [this, &values](std::size_t i)
+            {
+                update(values[i]);
+            }
+        );
+    }
+
+    template <hashable_value_type T>
+    void space_saving<T>::update(key_type value, std::uint64_t count)
+    {
+        if (const auto it = m_slots.find(value); it != m_slots.end())
+        {
+            m_entries[it->second].count += count;
+            sift_down(m_heap_positions[it->second]);
+            return;
+        }
+        if (m_entries.size() < m_capacity)
+        {
+            const std::size_t slot = m_entries.size();
+            m_entries.push_back({to_value(value), count, 0u});
+            m_heap.push_back(slot);
+            m_heap_positions.push_back(slot);
+            m_slots.emplace(m_entries.back().value, slot);
+            // Existing counts are at least 1: move the new entry up the heap
+            for (std::size_t position = m_heap.size() - 1u; position > 0u;)
+            {
+                const std::size_t parent = (position - 1u) / 2u;
+                if (m_entries[m_heap[parent]].count <= m_entries[m_heap[position]].count)
+                {
+                    break;
+                }
+                swap_heap(parent, position);
+                position = parent;
+            }
+            return;
+        }
+        // The value replaces the value with the smallest count, whose count bounds its
+        // number of previous occurrences
+        const std::size_t slot = m_heap.front();
+        entry& evicted = m_entries[slot];
+        m_slots.erase(m_slots.find(evicted.value));
+        const std::uint64_t min = evicted.count;
+        evicted = {to_value(value), min + count, min};
+        m_slots.emplace(evicted.value, slot);
+        sift_down(0u);
+    }
+
+    template <hashable_value_type T>
+    T space_saving<T>::to_value(key_type value)
+    {
+        if constexpr (std::same_as<T, std::string>)
+        {
+            return std::string(value);
+        }
+        else
+        {
+            return value;
+        }
+    }
+
+    template <hashable_value_type T>
+    std::uint64_t space_saving<T>::min_count() const noexcept
+    {
+        return m_entries.size() < m_capacity ? 0u : m_entries[m_heap.front()].count;
+    }
+
+    template <hashable_value_type T>
+    void space_saving<T>::merge(const space_saving& other)
+    {
+        // A value missing from a full summary occurred at most min_count times in it
+        const std::uint64_t min = min_count();
+        const std::uint64_t other_min = other.min_count();
+        std::vector<entry> merged;
+        merged.reserve(m_entries.size() + other.m_entries.size());
+        for (const entry& e : m_entries)
+        {
+            const auto it = other.m_slots.find(e.value);
+            if (it != other.m_slots.end())
+            {
+                const entry& o = other.m_entries[it->second];
+                merged.push_back({e.value, e.count + o.count, e.error + o.error});
+            }
+            else
+            {
+                merged.push_back({e.value, e.count + other_min, e.error + other_min});
+            }
+        }
+        for (const entry& o : other.m_entries)
+        {
+            if (!m_slots.contains(o.value))
+            {
+                merged.push_back({o.value, o.count + min, o.error + min});
+            }
+        }
+        rebuild(std::move(merged));
+    }
+
+    template <hashable_value_type T>
+    auto space_saving<T>::top(std::size_t k) const -> std::vector<entry>
+    {
+        std::vector<entry> res = m_entries;
+        const auto by_count = [](const entry& lhs, const entry& rhs)
+        {
+            return lhs.count > rhs.count;
+        };
+        k = std::min(k, res.size());
+        std::partial_sort(res.begin(), res.begin() + static_cast<std::ptrdiff_t>(k), res.end(), by_count);
+        res.resize(k);
+        return res;
+    }
+
+    template <hashable_value_type T>
+    std::vector<std::uint8_t> space_saving<T>::serialize() const
+    {
+        impl::byte_writer writer;
+        impl::write_sketch_header(writer, impl::space_saving_kind);
+        writer.write<std::uint64_t>(m_capacity);
+        writer.write<std::uint64_t>(m_entries.size());
+        for (const entry& e : m_entries)
+        {
+            if constexpr (std::same_as<T, std::string>)
+            {
+                writer.write<std::uint64_t>(e.value.size());
+                writer.write_bytes(std::span(reinterpret_cast<const std::uint8_t*>(e.value.data()), e.value.size()));
+            }
+            else
+            {
+                writer.write(e.value);
+            }
+            writer.write(e.count);
+            writer.write(e.error);
+        }
+        return std::move(writer).release();
+    }
+
+    template <hashable_value_type T>
+    auto space_saving<T>::deserialize(std::span<const std::uint8_t> bytes) -> space_saving
+    {
+        impl::byte_reader reader(bytes);
+        impl::read_sketch_header(reader, impl::space_saving_kind);
+        const std::size_t capacity = reader.read<std::uint64_t>();
+        const std::size_t size = reader.read<std::uint64_t>();
+        if (capacity == 0u || capacity > impl::space_saving_max_capacity || size > capacity
+            || size > bytes.size())
+        {
+            throw std::invalid_argument("deserialize: invalid space_saving size");
+        }
+        std::vector<entry> entries;
+        entries.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            entry e{};
+            if constexpr (std::same_as<T, std::string>)
+            {
+                const std::size_t length = reader.read<std::uint64_t>();
+                const std::span<const std::uint8_t> chars = reader.read_bytes(length);
+                e.value.assign(chars.begin(), chars.end());
+            }
+            else
+            {
+                e.value = reader.read<T>();
+            }
+            e.count = reader.read<std::uint64_t>();
+            e.error = reader.read<std::uint64_t>();
+            entries.push_back(std::move(e));
+        }
+        if (!reader.at_end())
+        {
+            throw std::invalid_argument("deserialize: unexpected trailing bytes");
+        }
+        // The index maps each value to a single slot
+        std::unordered_map<T, std::size_t, key_hash, key_equal> values;
+        values.reserve(entries.size());
+        for (const entry& e : entries)
+        {
+            if (!values.emplace(e.value, 0u).second)
+            {
+                throw std::invalid_argument("deserialize: duplicate space_saving value");
+            }
+        }
+        space_saving res(capacity);
+        res.rebuild(std::move(entries));
+        return res;
+    }
+
+    template <hashable_value_type T>
+    void space_saving<T>::sift_down(std::size_t position)
+    {
+        const std::size_t size = m_heap.size();
+        while (true)
+        {
+            const std::size_t left = 2u * position + 1u;
+            if (left >= size)
+            {
+                return;
+            }
+            const std::size_t right = left + 1u;
+            std::size_t smallest = left;
+            if (right < size && m_entries[m_heap[right]].count < m_entries[m_heap[left]].count)
+            {
+                smallest = right;
+            }
+            if (m_entries[m_heap[position]].count <= m_entries[m_heap[smallest]].count)
+            {
+                return;
+            }
+            swap_heap(position, smallest);
+            position = smallest;
+        }
+    }
+
+    template <hashable_value_type T>
+    void space_saving<T>::swap_heap(std::size_t lhs, std::size_t rhs)
+    {
+        std::swap(m_heap[lhs], m_heap[rhs]);
+        m_heap_positions[m_heap[lhs]] = lhs;
+        m_heap_positions[m_heap[rhs]] = rhs;
+    }
+
+    /*
+     * Keeps the entries with the largest counts and rebuilds the heap and the index.
+     */
+    template <hashable_value_type T>
+    void space_saving<T>::rebuild(std::vector<entry> entries)
+    {
+        const auto by_count = [](const entry& lhs, const entry& rhs)
+        {
+            return lhs.count > rhs.count;
+        };
+        if (entries.size() > m_capacity)
+        {
+            std::nth_element(
+                entries.begin(),
+                entries.begin() + static_cast<std::ptrdiff_t>(m_capacity),
+                entries.end(),
+                by_count
+            );
+            entries.resize(m_capacity);
+        }
+        // Sorting by increasing count gives a valid min-heap
+        std::ranges::sort(
+            entries,
+            [](const entry& lhs, const entry& rhs)
+            {
+                return lhs.count < rhs.count;
+            }
+        );
+        m_entries = std::move(entries);
+        m_heap.resize(m_entries.size());
+        m_heap_positions.resize(m_entries.size());
+        m_slots.clear();
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot)
+        {
+            m_heap[slot] = slot;
+            m_heap_positions[slot] = slot;
+            m_slots.emplace(m_entries[slot].value, slot);
+        }
+    }
+}
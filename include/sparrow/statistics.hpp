@@ -0,0 +1,239 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "sparrow/array_statistics.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/hashing.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/sketch.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Computes the statistics of an array and the zone map of its blocks.
+     *
+     * The bounds, the null and NaN counts, the order and the zone map are computed in a
+     * single pass over the elements, along with a HyperLogLog sketch of the distinct
+     * values. The number of distinct values is exact for sorted arrays, whose runs of
+     * equal values are counted; for other arrays, it is estimated by the sketch, and a
+     * second pass, hashing the elements, is only done when the estimate does not rule
+     * out that the elements are distinct.
+     *
+     * @param array The array.
+     * @param block_size The number of rows of the blocks of the zone map.
+     * @pre \p block_size must be a positive multiple of 64.
+     */
+    template <hashable_value_type T>
+    array_statistics<T> compute_statistics(const typed_array<T>& array, std::size_t block_size = zone_map_block_size);
+
+    /**
+     * @param array The array.
+     * @param block_size The number of rows of the blocks of the zone map, if the
+     *        statistics are not cached yet.
+     * @return The statistics of \p array, computed by compute_statistics on the first call
+     *         and cached by the array until it is modified.
+     * @pre \p block_size must be a positive multiple of 64.
+     */
+    template <hashable_value_type T>
+    std::shared_ptr<const array_statistics<T>>
+    statistics(const typed_array<T>& array, std::size_t block_size = zone_map_block_size);
+
+    /*****************************
+     * statistics implementation *
+     *****************************/
+
+    namespace impl
+    {
+        /*
+         * Statistics of a range of elements being scanned, the elements being compared
+         * as the keys read by raw_value_reader.
+         */
+        template <class K>
+        struct statistics_accumulator
+        {
+            std::size_t nan_count = 0;
+            std::optional<K> min;
+            std::optional<K> max;
+
+            void add(const K& key)
+            {
+                if (!min.has_value())
+                {
+                    min = key;
+                    max = key;
+                }
+                else if (key < *min)
+                {
+                    min = key;
+                }
+                else if (*max < key)
+                {
+                    max = key;
+                }
+            }
+
+            template <class T>
+            void store(std::optional<T>& min_value, std::optional<T>& max_value) const
+            {
+                if (min.has_value())
+                {
+                    min_value = T(*min);
+                    max_value = T(*max);
+                }
+            }
+        };
+
+        /*
+         * Grants the statistics function access to the cache of typed_array, which
+         * must only hold statistics computed from the elements of the array.
+         */
+        struct statistics_cache
+        {
+            template <class T>
+            static std::shared_ptr<const array_statistics<T>>
+            store(const typed_array<T>& array, array_statistics<T> statistics)
+            {
+                SPARROW_ASSERT_TRUE(
+                    statistics.block_size > 0u && statistics.block_size % bitmap_word_bits == 0u
+                );
+                SPARROW_ASSERT_TRUE(
+                    statistics.zones.size() == (array.size() + statistics.block_size - 1) / statistics.block_size
+                );
+                return array.cache_statistics(std::move(statistics));
+            }
+        };
+    }
+
+    template <hashable_value_type T>
+    array_statistics<T> compute_statistics(const typed_array<T>& array, std::size_t block_size)
+    {
+        SPARROW_ASSERT_TRUE(block_size > 0u && block_size % bitmap_word_bits == 0u);
+        using traits = impl::hash_key_traits<T>;
+        using reader_type = raw_value_reader<typename typed_array<T>::layout_type>;
+        using key_type = typename reader_type::value_type;
+
+        const reader_type values(array.get_data());
+        const bitmap_word_reader validity = make_validity_reader(array.get_data());
+        const std::size_t size = array.size();
+
+        array_statistics<T> res;
+        res.block_size = block_size;
+        res.zones.reserve((size + block_size - 1) / block_size);
+        hyperloglog sketch;
+        impl::statistics_accumulator<key_type> total;
+        std::optional<key_type> previous;
+        std::size_t run_count = 0;
+
+        for (std::size_t block_first = 0; block_first < size; block_first += block_size)
+        {
+            const std::size_t block_last = std::min(size, block_first + block_size);
+            zone_statistics<T>& zone = res.zones.emplace_back();
+            zone.size = block_last - block_first;
+            impl::statistics_accumulator<key_type> block;
+            for (std::size_t first = block_first; first < block_last; first += bitmap_word_bits)
+            {
+                const bitmap_word word = validity.word(first / bitmap_word_bits);
+                const std::size_t count = std::min(bitmap_word_bits, block_last - first);
+                zone.null_count += count - static_cast<std::size_t>(std::popcount(word));
+                for_each_set_bit(
+                    word,
+                    [&](std::size_t j)
+                    {
+                        const key_type key = values[first + j];
+                        if constexpr (std::floating_point<key_type>)
+                        {
+                            if (std::isnan(key))
+                            {
+                                ++block.nan_count;
+                                res.is_sorted = false;
+                                sketch.update_hash(traits::hash(traits::normalize(key)));
+                                return;
+                            }
+                        }
+                        block.add(key);
+                        sketch.update_hash(traits::hash(traits::normalize(key)));
+                        if (!previous.has_value() || *previous < key)
+                        {
+                            ++run_count;
+                        }
+                        else if (key < *previous)
+                        {
+                            res.is_sorted = false;
+                        }
+                        else
+                        {
+                            res.is_unique = false;
+                        }
+                        previous = key;
+                    }
+                );
+            }
+            zone.nan_count = block.nan_count;
+            block.store(zone.min, zone.max);
+            res.null_count += zone.null_count;
+            res.nan_count += block.nan_count;
+            if (block.min.has_value())
+            {
+                total.add(*block.min);
+                total.add(*block.max);
+            }
+        }
+        total.store(res.min, res.max);
+
+        if (res.is_sorted)
+        {
+            res.distinct_count = static_cast<double>(run_count);
+        }
+        else
+        {
+            const std::size_t valid_count = size - res.null_count;
+            res.distinct_count = std::min(sketch.estimate(), static_cast<double>(valid_count));
+            // The relative standard error of the estimate is below 1%
+            if (res.distinct_count < 0.95 * static_cast<double>(valid_count))
+            {
+                res.is_unique = false;
+            }
+            else if (res.is_unique)
+            {
+                const std::size_t distinct_count = impl::compute_distinct_values(array).values.size();
+                res.distinct_count = static_cast<double>(distinct_count);
+                res.is_unique = distinct_count == valid_count;
+            }
+        }
+        return res;
+    }
+
+    template <hashable_value_type T>
+    std::shared_ptr<const array_statistics<T>> statistics(const typed_array<T>& array, std::size_t block_size)
+    {
+        if (std::shared_ptr<const array_statistics<T>> cached = array.cached_statistics())
+        {
+            return cached;
+        }
+        return impl::statistics_cache::store(array, compute_statistics(array, block_size));
+    }
+}
@@ -0,0 +1,264 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array.hpp"
+#include "sparrow/chunked_array.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/record_batch.hpp"
+
+namespace sparrow
+{
+    /**
+     * Named columns made of chunks, one chunked_column per field.
+     *
+     * Like record_batch, a table shares the buffers of its chunks when its columns are
+     * projected or its rows sliced: a slice keeps the columns as they are and records
+     * the range of rows it spans, that starts at offset() in each column.
+     */
+    class table
+    {
+    public:
+
+        using size_type = std::size_t;
+        using const_reference = chunked_column::const_reference;
+
+        /**
+         * @throws std::invalid_argument if the columns do not match the fields of
+         *         \p table_schema, or if their sizes differ.
+         */
+        table(sparrow::schema table_schema, std::vector<chunked_column> columns);
+
+        /**
+         * Builds a table whose chunks are the columns of \p batches. The columns of the
+         * batches that are not slices are not copied.
+         *
+         * @throws std::invalid_argument if the schema of a batch differs from \p table_schema.
+         */
+        table(sparrow::schema table_schema, std::span<const record_batch> batches);
+
+        const sparrow::schema& get_schema() const;
+
+        size_type num_rows() const;
+        size_type num_columns() const;
+
+        /**
+         * @return The row of the columns where the table starts.
+         */
+        size_type offset() const;
+
+        const chunked_column& column(size_type i) const;
+
+        /**
+         * @throws std::out_of_range if no field is named \p name.
+         */
+        const chunked_column& column(std::string_view name) const;
+
+        /**
+         * @return The element of the column \p i at the row \p row of the table.
+         */
+        const_reference value(size_type i, size_type row) const;
+
+        /**
+         * @return The table made of the columns at \p indices; no value is copied.
+         */
+        table select(std::span<const size_type> indices) const;
+
+        /**
+         * @throws std::out_of_range if no field is named after one of \p names.
+         */
+        table select(std::span<const std::string_view> names) const;
+
+        /**
+         * @return The table made of the rows [\p offset, \p offset + \p length); no value
+         *         is copied.
+         */
+        table slice(size_type offset, size_type length) const;
+
+    private:
+
+        table(
+            sparrow::schema table_schema,
+            std::vector<chunked_column> columns,
+            size_type offset,
+            size_type length
+        );
+
+        void check_columns() const;
+        size_type column_index(std::string_view name) const;
+
+        sparrow::schema m_schema;
+        std::vector<chunked_column> m_columns;
+        size_type m_offset = 0;
+        size_type m_num_rows = 0;
+    };
+
+    /************************
+     * table implementation *
+     ************************/
+
+    inline table::table(sparrow::schema table_schema, std::vector<chunked_column> columns)
+        : m_schema(std::move(table_schema))
+        , m_columns(std::move(columns))
+        , m_num_rows(m_columns.empty() ? 0u : m_columns.front().size())
+    {
+        check_columns();
+    }
+
+    inline table::table(sparrow::schema table_schema, std::span<const record_batch> batches)
+        : m_schema(std::move(table_schema))
+        , m_columns(m_schema.size())
+    {
+        for (const record_batch& batch : batches)
+        {
+            if (batch.get_schema().fields() != m_schema.fields())
+            {
+                throw std::invalid_argument(
+                    "table: the schema of a batch differs from the schema of the table"
+                );
+            }
+            const record_batch compacted = batch.compact();
+            for (size_type i = 0; i < m_columns.size(); ++i)
+            {
+                m_columns[i].push_back(compacted.column(i));
+            }
+            m_num_rows += batch.num_rows();
+        }
+        check_columns();
+    }
+
+    inline table::table(
+        sparrow::schema table_schema,
+        std::vector<chunked_column> columns,
+        size_type offset,
+        size_type length
+    )
+        : m_schema(std::move(table_schema))
+        , m_columns(std::move(columns))
+        , m_offset(offset)
+        , m_num_rows(length)
+    {
+    }
+
+    inline const schema& table::get_schema() const
+    {
+        return m_schema;
+    }
+
+    inline auto table::num_rows() const -> size_type
+    {
+        return m_num_rows;
+    }
+
+    inline auto table::num_columns() const -> size_type
+    {
+        return m_columns.size();
+    }
+
+    inline auto table::offset() const -> size_type
+    {
+        return m_offset;
+    }
+
+    inline const chunked_column& table::column(size_type i) const
+    {
+        SPARROW_ASSERT_TRUE(i < num_columns());
+        return m_columns[i];
+    }
+
+    inline const chunked_column& table::column(std::string_view name) const
+    {
+        return m_columns[column_index(name)];
+    }
+
+    inline auto table::value(size_type i, size_type row) const -> const_reference
+    {
+        SPARROW_ASSERT_TRUE(i < num_columns());
+        SPARROW_ASSERT_TRUE(row < num_rows());
+        return m_columns[i][m_offset + row];
+    }
+
+    inline table table::select(std::span<const size_type> indices) const
+    {
+        std::vector<chunked_column> columns;
+        columns.reserve(indices.size());
+        for (const size_type i : indices)
+        {
+            columns.push_back(column(i));
+        }
+        return table(m_schema.select(indices), std::move(columns), m_offset, m_num_rows);
+    }
+
+    inline table table::select(std::span<const std::string_view> names) const
+    {
+        std::vector<size_type> indices;
+        indices.reserve(names.size());
+        for (const std::string_view name : names)
+        {
+            indices.push_back(column_index(name));
+        }
+        return select(std::span<const size_type>(indices));
+    }
+
+    inline table table::slice(size_type offset, size_type length) const
+    {
+        SPARROW_ASSERT_TRUE(offset + length <= num_rows());
+        return table(m_schema, m_columns, m_offset + offset, length);
+    }
+
+    inline void table::check_columns() const
+    {
+        if (m_columns.size() != m_schema.size())
+        {
+            throw std::invalid_argument("table: the number of columns differs from the number of fields");
+        }
+        for (size_type i = 0; i < m_columns.size(); ++i)
+        {
+            const chunked_column& c = m_columns[i];
+            for (size_type k = 0; k < c.chunk_count(); ++k)
+            {
+                if (impl::get_array_data(c.chunk(k)).type.id() != m_schema[i].type)
+                {
+                    throw std::invalid_argument(
+                        "table: the data type of column " + m_schema[i].name + " differs from its field"
+                    );
+                }
+            }
+            if (c.size() != m_num_rows)
+            {
+                throw std::invalid_argument("table: the columns must have the same size");
+            }
+        }
+    }
+
+    inline auto table::column_index(std::string_view name) const -> size_type
+    {
+        const std::optional<size_type> i = m_schema.field_index(name);
+        if (!i.has_value())
+        {
+            throw std::out_of_range("table: no column named " + std::string(name));
+        }
+        return *i;
+    }
+}
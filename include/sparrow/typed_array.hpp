@@ -15,16 +15,21 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <compare>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 
 #include "sparrow/algorithm.hpp"
 #include "sparrow/array_data.hpp"
 #include "sparrow/array_data_factory.hpp"
+#include "sparrow/array_statistics.hpp"
 #include "sparrow/contracts.hpp"
 #include "sparrow/data_traits.hpp"
 #include "sparrow/data_type.hpp"
@@ -42,6 +47,38 @@ namespace sparrow
     template <class U, class M>
     bool operator==(const typed_array<U, M>& ta1, const typed_array<U, M>& ta2);
 
+    namespace impl
+    {
+        struct statistics_cache;
+
+        /*
+         * Lock guarding the statistics cached by a typed_array; the critical sections
+         * only copy or swap a shared_ptr. std::atomic<std::shared_ptr> is not available
+         * in every standard library.
+         */
+        class statistics_lock
+        {
+        public:
+
+            void lock() noexcept
+            {
+                while (m_flag.test_and_set(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            void unlock() noexcept
+            {
+                m_flag.clear(std::memory_order_release);
+            }
+
+        private:
+
+            std::atomic_flag m_flag;
+        };
+    }
+
     /**
      * A class template representing a typed array.
      *
@@ -71,15 +108,24 @@ namespace sparrow
         using const_bitmap_range = typename layout_type::const_bitmap_range;
         using const_value_range = typename layout_type::const_value_range;
 
-        typed_array() = default;
+        typed_array();
+
+        /**
+         * Builds an empty array whose buffers are allocated with \p a.
+         */
+        template <class A>
+            requires(not std::same_as<A, typed_array> and allocator<A>)
+        explicit typed_array(const A& a);
 
         explicit typed_array(array_data data);
 
         typed_array(const typed_array& rhs);
-        typed_array(typed_array&& rhs);
+        typed_array(typed_array&& rhs) noexcept(std::is_nothrow_constructible_v<layout_type, array_data&>);
 
         typed_array& operator=(const typed_array& rhs);
-        typed_array& operator=(typed_array&& rhs);
+        typed_array& operator=(typed_array&& rhs) noexcept;
+
+        ~typed_array();
 
         // Element access
 
@@ -174,6 +220,22 @@ namespace sparrow
          */
         const_value_range values() const;
 
+        /*
+         * @return The array_data holding the buffers of the array. This is meant
+         * for kernels that operate on the raw buffers and bitmaps.
+         */
+        const array_data& get_data() const;
+
+        // Statistics
+
+        /**
+         * @return The statistics cached by the statistics function, or nullptr if none were
+         * cached since the array was last modified. The array drops its statistics when an
+         * element is assigned through one of its references or iterators; the statistics
+         * returned before remain valid, but describe the former elements.
+         */
+        std::shared_ptr<const array_statistics<T>> cached_statistics() const noexcept;
+
         // Capacity
 
         /*
@@ -198,8 +260,21 @@ namespace sparrow
 
     private:
 
+        /*
+         * Caches statistics, unless some are already cached. This method can be called
+         * concurrently with the other const methods.
+         */
+        std::shared_ptr<const array_statistics<T>> cache_statistics(array_statistics<T> statistics) const;
+        void reset_statistics() noexcept;
+        void watch_modifications() noexcept;
+        static void on_modification(void* self) noexcept;
+
         array_data m_data = make_default_array_data<Layout>();
         layout_type m_layout{m_data};
+        mutable impl::statistics_lock m_statistics_lock;
+        mutable std::shared_ptr<const array_statistics<T>> m_statistics;
+
+        friend struct impl::statistics_cache;
     };
 
     /*
@@ -254,12 +329,31 @@ namespace sparrow
     using array_const_value_range_t = typename A::const_value_range;
 
     // Constructors
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    typed_array<T, Layout>::typed_array()
+    {
+        watch_modifications();
+    }
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    template <class A>
+        requires(not std::same_as<A, typed_array<T, Layout>> and allocator<A>)
+    typed_array<T, Layout>::typed_array(const A& a)
+        : m_data(make_default_array_data<Layout>(a))
+        , m_layout(m_data)
+    {
+        watch_modifications();
+    }
+
     template <class T, class Layout>
         requires is_arrow_base_type<T>
     typed_array<T, Layout>::typed_array(array_data data)
         : m_data(std::move(data))
         , m_layout(m_data)
     {
+        watch_modifications();
     }
 
     // Value semantics
@@ -269,35 +363,66 @@ namespace sparrow
     typed_array<T, Layout>::typed_array(const typed_array& rhs)
         : m_data(rhs.m_data)
         , m_layout(m_data)
+        , m_statistics(rhs.cached_statistics())
     {
+        watch_modifications();
     }
 
     template <class T, class Layout>
         requires is_arrow_base_type<T>
     typed_array<T, Layout>::typed_array(typed_array&& rhs)
+        noexcept(std::is_nothrow_constructible_v<layout_type, array_data&>)
         : m_data(std::move(rhs.m_data))
         , m_layout(m_data)
     {
+        {
+            std::lock_guard<impl::statistics_lock> lock(rhs.m_statistics_lock);
+            m_statistics = std::move(rhs.m_statistics);
+        }
+        watch_modifications();
     }
 
     template <class T, class Layout>
         requires is_arrow_base_type<T>
     typed_array<T, Layout>& typed_array<T, Layout>::operator=(const typed_array& rhs)
     {
-        m_data = rhs.m_data;
-        m_layout.rebind_data(m_data);
+        if (this != &rhs)
+        {
+            m_data = rhs.m_data;
+            m_layout.rebind_data(m_data);
+            std::shared_ptr<const array_statistics<T>> statistics = rhs.cached_statistics();
+            std::lock_guard<impl::statistics_lock> lock(m_statistics_lock);
+            m_statistics.swap(statistics);
+        }
         return *this;
     }
 
     template <class T, class Layout>
         requires is_arrow_base_type<T>
-    typed_array<T, Layout>& typed_array<T, Layout>::operator=(typed_array&& rhs)
+    typed_array<T, Layout>& typed_array<T, Layout>::operator=(typed_array&& rhs) noexcept
     {
-        m_data = std::move(rhs.m_data);
-        m_layout.rebind_data(m_data);
+        if (this != &rhs)
+        {
+            // Takes the buffers of rhs along with their allocators: assigning them would
+            // copy the values when the allocators differ.
+            std::destroy_at(&m_data);
+            std::construct_at(&m_data, std::move(rhs.m_data));
+            m_layout.rebind_data(m_data);
+        }
+        std::shared_ptr<const array_statistics<T>> statistics;
+        {
+            std::lock_guard<impl::statistics_lock> lock(rhs.m_statistics_lock);
+            statistics.swap(rhs.m_statistics);
+        }
+        std::lock_guard<impl::statistics_lock> lock(m_statistics_lock);
+        m_statistics.swap(statistics);
         return *this;
     }
 
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    typed_array<T, Layout>::~typed_array() = default;
+
     // Element access
 
     template <class T, class Layout>
@@ -436,6 +561,65 @@ namespace sparrow
         return m_layout.values();
     }
 
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    auto typed_array<T, Layout>::get_data() const -> const array_data&
+    {
+        return m_data;
+    }
+
+    // Statistics
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    auto typed_array<T, Layout>::cached_statistics() const noexcept -> std::shared_ptr<const array_statistics<T>>
+    {
+        std::lock_guard<impl::statistics_lock> lock(m_statistics_lock);
+        return m_statistics;
+    }
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    auto typed_array<T, Layout>::cache_statistics(array_statistics<T> statistics) const
+        -> std::shared_ptr<const array_statistics<T>>
+    {
+        std::shared_ptr<const array_statistics<T>> cached = std::make_shared<const array_statistics<T>>(
+            std::move(statistics)
+        );
+        std::lock_guard<impl::statistics_lock> lock(m_statistics_lock);
+        if (m_statistics == nullptr)
+        {
+            m_statistics = cached;
+        }
+        return m_statistics;
+    }
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    void typed_array<T, Layout>::reset_statistics() noexcept
+    {
+        std::shared_ptr<const array_statistics<T>> statistics;
+        std::lock_guard<impl::statistics_lock> lock(m_statistics_lock);
+        m_statistics.swap(statistics);
+    }
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    void typed_array<T, Layout>::watch_modifications() noexcept
+    {
+        if constexpr (requires(layout_type& layout, modification_hook hook) { layout.set_modification_hook(hook); })
+        {
+            m_layout.set_modification_hook(modification_hook(&typed_array::on_modification, this));
+        }
+    }
+
+    template <class T, class Layout>
+        requires is_arrow_base_type<T>
+    void typed_array<T, Layout>::on_modification(void* self) noexcept
+    {
+        static_cast<typed_array*>(self)->reset_statistics();
+    }
+
     // Capacity
 
     template <class T, class Layout>
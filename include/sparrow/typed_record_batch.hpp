@@ -0,0 +1,384 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array.hpp"
+#include "sparrow/array_data.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/mp_utils.hpp"
+#include "sparrow/record_batch.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Compile-time description of a column of a typed_record_batch.
+     *
+     * @tparam Name The name of the column.
+     * @tparam T The type of the elements of the column.
+     */
+    template <mpl::fixed_string Name, is_arrow_base_type T>
+    struct col
+    {
+        static constexpr std::string_view name = Name.view();
+        static constexpr data_type type = arrow_traits<T>::type_id;
+        using value_type = T;
+        using array_type = typed_array<T>;
+    };
+
+    /**
+     * Matches the instances of col.
+     */
+    template <class C>
+    concept column_descriptor = requires {
+        { C::name } -> std::convertible_to<std::string_view>;
+        { C::type } -> std::convertible_to<data_type>;
+        typename C::value_type;
+        requires std::same_as<typename C::array_type, typed_array<typename C::value_type>>;
+    };
+
+    namespace impl
+    {
+        template <mpl::fixed_string Name>
+        struct column_named
+        {
+            template <template <class...> class W, class C>
+                requires mpl::type_wrapper<W, C>
+            consteval bool operator()(W<C>) const
+            {
+                return C::name == Name.view();
+            }
+        };
+
+        /*
+         * Not a constant expression, so that looking up a missing column does not compile.
+         */
+        inline std::size_t missing_column()
+        {
+            throw std::logic_error("typed_record_batch: no column with this name");
+        }
+
+        template <mpl::fixed_string Name, column_descriptor... Columns>
+        consteval std::size_t column_index()
+        {
+            constexpr std::size_t i = mpl::find_if(mpl::typelist<Columns...>{}, column_named<Name>{});
+            return i < sizeof...(Columns) ? i : missing_column();
+        }
+
+        template <column_descriptor... Columns>
+        consteval bool distinct_column_names()
+        {
+            constexpr std::array<std::string_view, sizeof...(Columns)> names = {Columns::name...};
+            for (std::size_t i = 0; i < names.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j < names.size(); ++j)
+                {
+                    if (names[i] == names[j])
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Record batch whose schema is known at compile time.
+     *
+     * The columns are accessed as typed_array, so that kernels and row visitors are
+     * specialized for the type of each column and never dispatch on data types at
+     * runtime. The columns are shared with the record_batch the typed batch is built
+     * from or converted to: conversions check the schema, but do not copy values.
+     *
+     * @tparam Columns The descriptions of the columns, as col instances with distinct names.
+     */
+    template <column_descriptor... Columns>
+    class typed_record_batch
+    {
+        static_assert(
+            impl::distinct_column_names<Columns...>(),
+            "typed_record_batch: duplicate column names"
+        );
+
+    public:
+
+        using size_type = std::size_t;
+        using column_list = mpl::typelist<Columns...>;
+        using row_type = std::tuple<typename Columns::array_type::const_reference...>;
+
+        template <size_type I>
+        using column_t = std::tuple_element_t<I, std::tuple<Columns...>>;
+
+        static constexpr size_type column_count = sizeof...(Columns);
+
+        /**
+         * The index of the column named \p Name; fails to compile if there is none.
+         */
+        template <mpl::fixed_string Name>
+        static constexpr size_type index_of = impl::column_index<Name, Columns...>();
+
+        /**
+         * @throws std::invalid_argument if the names or the data types of the columns of
+         *         \p batch do not match Columns.
+         */
+        explicit typed_record_batch(const record_batch& batch);
+
+        /**
+         * Moves \p columns into the batch; their buffers are not copied.
+         *
+         * @throws std::invalid_argument if the data types of \p columns do not match
+         *         Columns or if their sizes differ.
+         */
+        explicit typed_record_batch(std::vector<array_data> columns);
+
+        /**
+         * @return The schema described by Columns.
+         */
+        static sparrow::schema get_schema();
+
+        /**
+         * @return The record_batch sharing the columns of this batch.
+         */
+        record_batch to_record_batch() const;
+
+        size_type num_rows() const;
+
+        /**
+         * @return The row of the columns where the batch starts.
+         */
+        size_type offset() const;
+
+        template <size_type I>
+        const typename column_t<I>::array_type& column() const;
+
+        template <mpl::fixed_string Name>
+        const typename column_t<index_of<Name>>::array_type& column() const;
+
+        /**
+         * @return The elements of the row \p i of the batch.
+         */
+        row_type row(size_type i) const;
+
+        /**
+         * Calls `f(values...)` for each row, values being the const_reference of each
+         * column at the row.
+         */
+        template <class F>
+        void for_each_row(F&& f) const;
+
+        /**
+         * @return The batch made of the rows [\p offset, \p offset + \p length); no value
+         *         is copied.
+         */
+        typed_record_batch slice(size_type offset, size_type length) const;
+
+        /**
+         * @return The batch made of the columns named \p Names; no value is copied.
+         */
+        template <mpl::fixed_string... Names>
+        typed_record_batch<column_t<index_of<Names>>...> select() const;
+
+    private:
+
+        using typed_arrays = std::tuple<const typename Columns::array_type*...>;
+
+        typed_record_batch(std::vector<array> columns, size_type offset, size_type num_rows);
+
+        template <size_type... Is>
+        static typed_arrays get_typed_arrays(const std::vector<array>& columns, std::index_sequence<Is...>);
+
+        template <size_type... Is>
+        row_type row(size_type i, std::index_sequence<Is...>) const;
+
+        std::vector<array> m_columns;
+        typed_arrays m_arrays;
+        size_type m_offset = 0;
+        size_type m_num_rows = 0;
+
+        template <column_descriptor... Cs>
+        friend class typed_record_batch;
+    };
+
+    /*************************************
+     * typed_record_batch implementation *
+     *************************************/
+
+    template <column_descriptor... C>
+    typed_record_batch<C...>::typed_record_batch(const record_batch& batch)
+        : typed_record_batch(
+              [&batch]()
+              {
+                  const sparrow::schema& batch_schema = batch.get_schema();
+                  if (batch_schema.size() != column_count)
+                  {
+                      throw std::invalid_argument("typed_record_batch: the number of columns differs");
+                  }
+                  constexpr std::array<std::string_view, column_count> names = {C::name...};
+                  constexpr std::array<data_type, column_count> types = {C::type...};
+                  std::vector<array> columns;
+                  columns.reserve(column_count);
+                  for (size_type i = 0; i < column_count; ++i)
+                  {
+                      if (batch_schema[i].name != names[i] || batch_schema[i].type != types[i])
+                      {
+                          throw std::invalid_argument(
+                              "typed_record_batch: column " + batch_schema[i].name
+                              + " does not match the static schema"
+                          );
+                      }
+                      columns.push_back(batch.column(i));
+                  }
+                  return columns;
+              }(),
+              batch.offset(),
+              batch.num_rows()
+          )
+    {
+    }
+
+    template <column_descriptor... C>
+    typed_record_batch<C...>::typed_record_batch(std::vector<array_data> columns)
+        : typed_record_batch(record_batch(
+              get_schema(),
+              [&columns]()
+              {
+                  std::vector<array> res;
+                  res.reserve(columns.size());
+                  for (array_data& data : columns)
+                  {
+                      res.emplace_back(std::move(data));
+                  }
+                  return res;
+              }()
+          ))
+    {
+    }
+
+    template <column_descriptor... C>
+    typed_record_batch<C...>::typed_record_batch(
+        std::vector<array> columns,
+        size_type offset,
+        size_type num_rows
+    )
+        : m_columns(std::move(columns))
+        , m_arrays(get_typed_arrays(m_columns, std::index_sequence_for<C...>()))
+        , m_offset(offset)
+        , m_num_rows(num_rows)
+    {
+    }
+
+    template <column_descriptor... C>
+    schema typed_record_batch<C...>::get_schema()
+    {
+        return sparrow::schema({field{.name = std::string(C::name), .type = C::type}...});
+    }
+
+    template <column_descriptor... C>
+    record_batch typed_record_batch<C...>::to_record_batch() const
+    {
+        return record_batch(get_schema(), m_columns).slice(m_offset, m_num_rows);
+    }
+
+    template <column_descriptor... C>
+    auto typed_record_batch<C...>::num_rows() const -> size_type
+    {
+        return m_num_rows;
+    }
+
+    template <column_descriptor... C>
+    auto typed_record_batch<C...>::offset() const -> size_type
+    {
+        return m_offset;
+    }
+
+    template <column_descriptor... C>
+    template <std::size_t I>
+    auto typed_record_batch<C...>::column() const -> const typename column_t<I>::array_type&
+    {
+        static_assert(I < column_count, "typed_record_batch: column index out of range");
+        return *std::get<I>(m_arrays);
+    }
+
+    template <column_descriptor... C>
+    template <mpl::fixed_string Name>
+    auto typed_record_batch<C...>::column() const -> const typename column_t<index_of<Name>>::array_type&
+    {
+        return column<index_of<Name>>();
+    }
+
+    template <column_descriptor... C>
+    auto typed_record_batch<C...>::row(size_type i) const -> row_type
+    {
+        SPARROW_ASSERT_TRUE(i < num_rows());
+        return row(m_offset + i, std::index_sequence_for<C...>());
+    }
+
+    template <column_descriptor... C>
+    template <class F>
+    void typed_record_batch<C...>::for_each_row(F&& f) const
+    {
+        [this, &f]<size_type... Is>(std::index_sequence<Is...>)
+        {
+            const size_type end = m_offset + m_num_rows;
+            for (size_type i = m_offset; i < end; ++i)
+            {
+                f((*std::get<Is>(m_arrays))[i]...);
+            }
+        }(std::index_sequence_for<C...>());
+    }
+
+    template <column_descriptor... C>
+    auto typed_record_batch<C...>::slice(size_type offset, size_type length) const -> typed_record_batch
+    {
+        SPARROW_ASSERT_TRUE(offset + length <= num_rows());
+        return typed_record_batch(m_columns, m_offset + offset, length);
+    }
+
+    template <column_descriptor... C>
+    template <mpl::fixed_string... Names>
+    auto typed_record_batch<C...>::select() const -> typed_record_batch<column_t<index_of<Names>>...>
+    {
+        std::vector<array> columns = {m_columns[index_of<Names>]...};
+        return typed_record_batch<column_t<index_of<Names>>...>(std::move(columns), m_offset, m_num_rows);
+    }
+
+    template <column_descriptor... C>
+    template <std::size_t... Is>
+    auto typed_record_batch<C...>::get_typed_arrays(
+        const std::vector<array>& columns,
+        std::index_sequence<Is...>
+    ) -> typed_arrays
+    {
+        return typed_arrays(&columns[Is].template get<typename column_t<Is>::value_type>()...);
+    }
+
+    template <column_descriptor... C>
+    template <std::size_t... Is>
+    auto typed_record_batch<C...>::row(size_type i, std::index_sequence<Is...>) const -> row_type
+    {
+        return row_type((*std::get<Is>(m_arrays))[i]...);
+    }
+}
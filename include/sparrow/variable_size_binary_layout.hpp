@@ -143,8 +143,8 @@ namespace sparrow
         using const_value_range = std::ranges::subrange<const_value_iterator>;
         using const_bitmap_range = std::ranges::subrange<const_bitmap_iterator>;
 
-        explicit variable_size_binary_layout(array_data& data);
-        void rebind_data(array_data& data);
+        explicit variable_size_binary_layout(array_data& data) noexcept;
+        void rebind_data(array_data& data) noexcept;
 
         variable_size_binary_layout(const self_type&) = delete;
         self_type& operator=(const self_type&) = delete;
@@ -240,7 +240,7 @@ namespace sparrow
     template <class L, bool is_const>
     bool vs_binary_value_iterator<L, is_const>::less_than(const self_type& rhs) const
     {
-        return p_layout == rhs.m_layout && m_index < rhs.m_index;
+        return p_layout == rhs.p_layout && m_index < rhs.m_index;
     }
 
     /**********************************************
@@ -248,7 +248,7 @@ namespace sparrow
      **********************************************/
 
     template <class T, class R, class CR, layout_offset OT>
-    variable_size_binary_layout<T, R, CR, OT>::variable_size_binary_layout(array_data& data)
+    variable_size_binary_layout<T, R, CR, OT>::variable_size_binary_layout(array_data& data) noexcept
         : m_data(data)
     {
         SPARROW_ASSERT_TRUE(data_ref().buffers.size() == 2u);
@@ -258,7 +258,7 @@ namespace sparrow
     }
 
     template <class T, class R, class CR, layout_offset OT>
-    void variable_size_binary_layout<T, R, CR, OT>::rebind_data(array_data& data)
+    void variable_size_binary_layout<T, R, CR, OT>::rebind_data(array_data& data) noexcept
     {
         m_data = data;
     }
@@ -0,0 +1,831 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data.hpp"
+#include "sparrow/bitmap_utils.hpp"
+#include "sparrow/contracts.hpp"
+#include "sparrow/data_type.hpp"
+#include "sparrow/kernel_utils.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
+
+namespace sparrow
+{
+    /**
+     * Matches the value types supported by the window kernels.
+     */
+    template <class T>
+    concept window_value_type = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float>
+                                || std::same_as<T, double>;
+
+    /**
+     * Type of the sums and products computed over values of type T: 64-bit integers
+     * for integers, double for floating point values.
+     */
+    template <window_value_type T>
+    using window_sum_t = std::conditional_t<
+        std::floating_point<T>,
+        double,
+        std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+    /**
+     * How the cumulative kernels handle null values.
+     */
+    enum class null_policy
+    {
+        /// Null values are null in the result and do not contribute to the accumulation.
+        skip,
+        /// The result is null from the first null value on.
+        propagate
+    };
+
+    /**
+     * Options of the rolling window kernels.
+     */
+    struct window_options
+    {
+        /// Minimum number of non-null values a window must hold for its result not to be null.
+        std::size_t min_periods = 1;
+    };
+
+    namespace impl
+    {
+        template <class R>
+        array_data make_window_result(array_data::buffer_type values, array_data::bitmap_type validity)
+        {
+            return {
+                .type = data_descriptor(arrow_traits<R>::type_id),
+                .length = static_cast<array_data::length_type>(validity.size()),
+                .offset = 0,
+                .bitmap = std::move(validity),
+                .buffers = {std::move(values)},
+                .child_data = {},
+                .dictionary = nullptr
+            };
+        }
+
+        /*
+         * Accumulates the valid values of the rows [first, last), 64 at a time, from \p acc:
+         * a word without null values runs a plain dependent loop, other words only
+         * accumulate their valid values, the value of a null slot being unspecified. When
+         * store is true, the accumulator is written to \p out after each row.
+         *
+         * @return The accumulator after the row last - 1.
+         */
+        template <bool store, class R, class T, class Op>
+        R scan_words(
+            const T* values,
+            const bitmap_word_reader& validity,
+            R* out,
+            std::size_t first,
+            std::size_t last,
+            R acc,
+            const Op& op
+        )
+        {
+            SPARROW_ASSERT_TRUE(first % bitmap_word_bits == 0u);
+            for (std::size_t i = first / bitmap_word_bits; i < bitmap_word_count(last); ++i)
+            {
+                const std::size_t word_first = i * bitmap_word_bits;
+                const std::size_t count = std::min(bitmap_word_bits, last - word_first);
+                const bitmap_word word = validity.word(i) & low_bits_mask(count);
+                if (word == low_bits_mask(count))
+                {
+                    for (std::size_t j = 0; j < count; ++j)
+                    {
+                        acc = op(acc, static_cast<R>(values[word_first + j]));
+                        if constexpr (store)
+                        {
+                            out[word_first + j] = acc;
+                        }
+                    }
+                    continue;
+                }
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    if (((word >> j) & 1u) != 0u)
+                    {
+                        acc = op(acc, static_cast<R>(values[word_first + j]));
+                    }
+                    if constexpr (store)
+                    {
+                        out[word_first + j] = acc;
+                    }
+                }
+            }
+            return acc;
+        }
+
+        /*
+         * @return The number of rows that are valid in the result of a cumulative scan:
+         * the rows before the first null value with null_policy::propagate, all the rows
+         * otherwise.
+         */
+        inline std::size_t scan_valid_prefix(const bitmap_word_reader& validity, null_policy policy)
+        {
+            if (policy == null_policy::skip || validity.all_set())
+            {
+                return validity.size();
+            }
+            for (std::size_t i = 0; i < validity.word_count(); ++i)
+            {
+                const std::size_t first = i * bitmap_word_bits;
+                const bitmap_word word = validity.word(i);
+                if (word != low_bits_mask(validity.size() - first))
+                {
+                    return first + static_cast<std::size_t>(std::countr_one(word));
+                }
+            }
+            return validity.size();
+        }
+
+        template <class R>
+        typed_array<R> make_scan_result(
+            array_data::buffer_type buffer,
+            const bitmap_word_reader& validity,
+            null_policy policy,
+            std::size_t valid_prefix
+        )
+        {
+            array_data::bitmap_type result_validity = make_bitmap_from_words(
+                validity.size(),
+                [&validity, policy, valid_prefix](std::size_t i)
+                {
+                    if (policy == null_policy::skip)
+                    {
+                        return validity.word(i);
+                    }
+                    const std::size_t first = i * bitmap_word_bits;
+                    return first >= valid_prefix ? bitmap_word(0) : low_bits_mask(valid_prefix - first);
+                }
+            );
+            return typed_array<R>(make_window_result<R>(std::move(buffer), std::move(result_validity)));
+        }
+
+        template <class R, class T, class Op>
+        typed_array<R> cumulative_scan(const typed_array<T>& array, R init, Op op, null_policy policy)
+        {
+            const array_data& data = array.get_data();
+            const std::size_t size = array.size();
+            const T* values = raw_value_reader<fixed_size_layout<T>>(data).data();
+            const bitmap_word_reader validity = make_validity_reader(data);
+            const std::size_t valid_prefix = scan_valid_prefix(validity, policy);
+
+            array_data::buffer_type buffer(size * sizeof(R));
+            R* out = buffer.template data<R>();
+            scan_words<true>(values, validity, out, 0u, valid_prefix, init, op);
+            std::fill(out + valid_prefix, out + size, R(0));
+            return make_scan_result<R>(std::move(buffer), validity, policy, valid_prefix);
+        }
+
+        /*
+         * Two-pass blocked scan: the first pass accumulates the values of each morsel in
+         * parallel, the accumulators of the morsels preceding each morsel are combined
+         * sequentially, and the second pass scans the morsels in parallel from them.
+         * \p op must be associative and \p init must be its identity.
+         */
+        template <class R, class T, class Op>
+        typed_array<R>
+        cumulative_scan(const typed_array<T>& array, R init, Op op, null_policy policy, const parallel_options& options)
+        {
+            const array_data& data = array.get_data();
+            const std::size_t size = array.size();
+            const T* values = raw_value_reader<fixed_size_layout<T>>(data).data();
+            const bitmap_word_reader validity = make_validity_reader(data);
+            const std::size_t valid_prefix = scan_valid_prefix(validity, policy);
+            thread_pool& pool = resolve_pool(options);
+            const std::size_t step = aligned_morsel_size(options.morsel_size);
+
+            std::vector<R> carries((valid_prefix + step - 1u) / step, init);
+            parallel_for_chunks(
+                valid_prefix,
+                step,
+                [&](const morsel& m)
+                {
+                    R* no_output = nullptr;
+                    carries[m.index] = scan_words<false>(values, validity, no_output, m.begin, m.end, init, op);
+                },
+                pool
+            );
+            R acc = init;
+            for (R& carry : carries)
+            {
+                const R total = carry;
+                carry = acc;
+                acc = op(acc, total);
+            }
+
+            array_data::buffer_type buffer(size * sizeof(R));
+            R* out = buffer.template data<R>();
+            parallel_for_chunks(
+                valid_prefix,
+                step,
+                [&](const morsel& m)
+                {
+                    scan_words<true>(values, validity, out, m.begin, m.end, carries[m.index], op);
+                },
+                pool
+            );
+            std::fill(out + valid_prefix, out + size, R(0));
+            return make_scan_result<R>(std::move(buffer), validity, policy, valid_prefix);
+        }
+
+        /*
+         * Accumulators of the cumulative minimum and maximum.
+         */
+        struct minimum
+        {
+            template <class T>
+            T operator()(T lhs, T rhs) const
+            {
+                return std::min(lhs, rhs);
+            }
+        };
+
+        struct maximum
+        {
+            template <class T>
+            T operator()(T lhs, T rhs) const
+            {
+                return std::max(lhs, rhs);
+            }
+        };
+
+        /*
+         * Running sum over the values entering and leaving the window. Infinities and
+         * NaNs are counted apart from the sum of the finite values, since subtracting
+         * them when they leave the window would turn the sum into NaN.
+         */
+        template <class T>
+        class window_sum
+        {
+        public:
+
+            using result_type = window_sum_t<T>;
+
+            void push(std::size_t, T value)
+            {
+                if constexpr (std::floating_point<T>)
+                {
+                    if (!std::isfinite(value))
+                    {
+                        update_non_finite(value, 1);
+                        return;
+                    }
+                }
+                m_sum += static_cast<result_type>(value);
+            }
+
+            void pop(std::size_t, T value)
+            {
+                if constexpr (std::floating_point<T>)
+                {
+                    if (!std::isfinite(value))
+                    {
+                        update_non_finite(value, -1);
+                        return;
+                    }
+                }
+                m_sum -= static_cast<result_type>(value);
+            }
+
+            bool has_result(std::size_t) const
+            {
+                return true;
+            }
+
+            result_type result(std::size_t) const
+            {
+                if constexpr (std::floating_point<T>)
+                {
+                    if (m_nan_count != 0 || (m_positive_inf_count != 0 && m_negative_inf_count != 0))
+                    {
+                        return std::numeric_limits<result_type>::quiet_NaN();
+                    }
+                    if (m_positive_inf_count != 0)
+                    {
+                        return std::numeric_limits<result_type>::infinity();
+                    }
+                    if (m_negative_inf_count != 0)
+                    {
+                        return -std::numeric_limits<result_type>::infinity();
+                    }
+                }
+                return m_sum;
+            }
+
+        private:
+
+            void update_non_finite(T value, std::ptrdiff_t increment)
+            {
+                std::ptrdiff_t& count = std::isnan(value) ? m_nan_count
+                                        : value > T(0)    ? m_positive_inf_count
+                                                          : m_negative_inf_count;
+                count += increment;
+            }
+
+            result_type m_sum = 0;
+            std::ptrdiff_t m_nan_count = 0;
+            std::ptrdiff_t m_positive_inf_count = 0;
+            std::ptrdiff_t m_negative_inf_count = 0;
+        };
+
+        template <class T>
+        class window_mean
+        {
+        public:
+
+            using result_type = double;
+
+            void push(std::size_t, T value)
+            {
+                m_sum.push(0u, value);
+            }
+
+            void pop(std::size_t, T value)
+            {
+                m_sum.pop(0u, value);
+            }
+
+            bool has_result(std::size_t count) const
+            {
+                return count > 0u;
+            }
+
+            result_type result(std::size_t count) const
+            {
+                return static_cast<double>(m_sum.result(count)) / static_cast<double>(count);
+            }
+
+        private:
+
+            window_sum<T> m_sum;
+        };
+
+        /*
+         * Sample standard deviation, updated with Welford's algorithm when a value enters
+         * the window and with its inverse when a value leaves it.
+         */
+        template <class T>
+        class window_std
+        {
+        public:
+
+            using result_type = double;
+
+            void push(std::size_t, T value)
+            {
+                ++m_count;
+                const double x = static_cast<double>(value);
+                const double delta = x - m_mean;
+                m_mean += delta / static_cast<double>(m_count);
+                m_m2 += delta * (x - m_mean);
+            }
+
+            void pop(std::size_t, T value)
+            {
+                --m_count;
+                if (m_count == 0u)
+                {
+                    m_mean = 0.;
+                    m_m2 = 0.;
+                    return;
+                }
+                const double x = static_cast<double>(value);
+                const double delta = x - m_mean;
+                m_mean -= delta / static_cast<double>(m_count);
+                m_m2 -= delta * (x - m_mean);
+            }
+
+            bool has_result(std::size_t count) const
+            {
+                return count > 1u;
+            }
+
+            result_type result(std::size_t count) const
+            {
+                return std::sqrt(std::max(m_m2, 0.) / static_cast<double>(count - 1u));
+            }
+
+        private:
+
+            std::size_t m_count = 0;
+            double m_mean = 0.;
+            double m_m2 = 0.;
+        };
+
+        /*
+         * Minimum or maximum of the window, maintained with a monotonic deque: the deque
+         * holds the candidates in increasing index order and monotonic value order, so
+         * that each value is pushed and popped at most once.
+         */
+        template <class T, class Compare>
+        class window_extremum
+        {
+        public:
+
+            using result_type = T;
+
+            void push(std::size_t index, T value)
+            {
+                while (!m_candidates.empty() && !Compare{}(m_candidates.back().value, value))
+                {
+                    m_candidates.pop_back();
+                }
+                m_candidates.push_back({index, value});
+            }
+
+            void pop(std::size_t index, T)
+            {
+                if (!m_candidates.empty() && m_candidates.front().index == index)
+                {
+                    m_candidates.pop_front();
+                }
+            }
+
+            bool has_result(std::size_t) const
+            {
+                return !m_candidates.empty();
+            }
+
+            result_type result(std::size_t) const
+            {
+                return m_candidates.front().value;
+            }
+
+        private:
+
+            struct candidate
+            {
+                std::size_t index;
+                T value;
+            };
+
+            std::deque<candidate> m_candidates;
+        };
+
+        /*
+         * Evaluates a window aggregate for every element. The window of the element i is
+         * [window_start(i), i]; window_start must be non-decreasing.
+         */
+        template <class Aggregate, class T, class StartF>
+        typed_array<typename Aggregate::result_type>
+        rolling_apply(const typed_array<T>& array, StartF window_start, const window_options& options)
+        {
+            using result_type = typename Aggregate::result_type;
+            const array_data& data = array.get_data();
+            const std::size_t size = array.size();
+            const T* values = raw_value_reader<fixed_size_layout<T>>(data).data();
+            const bitmap_word_reader validity = make_validity_reader(data);
+            const auto is_valid = [&validity](std::size_t i)
+            {
+                return ((validity.word(i / bitmap_word_bits) >> (i % bitmap_word_bits)) & 1u) != 0u;
+            };
+
+            array_data::buffer_type buffer(size * sizeof(result_type));
+            result_type* out = buffer.template data<result_type>();
+            array_data::bitmap_type result_validity(size, true);
+
+            Aggregate aggregate;
+            std::size_t start = 0;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (is_valid(i))
+                {
+                    aggregate.push(i, values[i]);
+                    ++count;
+                }
+                for (const std::size_t new_start = window_start(i); start < new_start; ++start)
+                {
+                    if (is_valid(start))
+                    {
+                        aggregate.pop(start, values[start]);
+                        --count;
+                    }
+                }
+                if (count >= std::max(options.min_periods, std::size_t(1)) && aggregate.has_result(count))
+                {
+                    out[i] = aggregate.result(count);
+                }
+                else
+                {
+                    out[i] = result_type(0);
+                    result_validity.set(i, false);
+                }
+            }
+            return typed_array<result_type>(make_window_result<result_type>(std::move(buffer), std::move(result_validity)));
+        }
+
+        /*
+         * Start of the window of fixed size \p window ending at i.
+         */
+        inline auto fixed_window_start(std::size_t window)
+        {
+            SPARROW_ASSERT_TRUE(window > 0u);
+            return [window](std::size_t i)
+            {
+                return i + 1u >= window ? i + 1u - window : std::size_t(0);
+            };
+        }
+
+        /*
+         * Start of the window (times[i] - window, times[i]], found with a pointer moving
+         * forward since the times are sorted. The window always holds the element i.
+         */
+        inline auto time_window_start(const typed_array<timestamp>& times, std::chrono::nanoseconds window)
+        {
+            SPARROW_ASSERT_TRUE(window > std::chrono::nanoseconds::zero());
+            SPARROW_ASSERT_TRUE(times.get_data().bitmap.null_count() == 0u);
+            const timestamp* t = raw_value_reader<fixed_size_layout<timestamp>>(times.get_data()).data();
+            return [t, window, start = std::size_t(0)](std::size_t i) mutable
+            {
+                const auto lower = t[i].get_sys_time() - window;
+                while (start < i && t[start].get_sys_time() <= lower)
+                {
+                    ++start;
+                }
+                return start;
+            };
+        }
+
+        template <class T>
+        using window_min = window_extremum<T, std::less<>>;
+
+        template <class T>
+        using window_max = window_extremum<T, std::greater<>>;
+    }
+
+    /**
+     * Computes the cumulative sum of an array.
+     *
+     * @param array The values to sum.
+     * @param policy The handling of null values.
+     * @return An array whose element i is the sum of the non-null elements [0, i] of \p array.
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>> cumulative_sum(const typed_array<T>& array, null_policy policy = null_policy::skip)
+    {
+        return impl::cumulative_scan(array, window_sum_t<T>(0), std::plus<>{}, policy);
+    }
+
+    /**
+     * Parallel version of cumulative_sum: a two-pass scan over the morsels of the array.
+     * The floating point sums are accumulated in a different order than by the
+     * sequential version, which may change their rounding.
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>>
+    cumulative_sum(const typed_array<T>& array, null_policy policy, const parallel_options& options)
+    {
+        return impl::cumulative_scan(array, window_sum_t<T>(0), std::plus<>{}, policy, options);
+    }
+
+    /**
+     * Computes the cumulative product of an array.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>> cumulative_prod(const typed_array<T>& array, null_policy policy = null_policy::skip)
+    {
+        return impl::cumulative_scan(array, window_sum_t<T>(1), std::multiplies<>{}, policy);
+    }
+
+    /**
+     * Parallel version of cumulative_prod.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>>
+    cumulative_prod(const typed_array<T>& array, null_policy policy, const parallel_options& options)
+    {
+        return impl::cumulative_scan(array, window_sum_t<T>(1), std::multiplies<>{}, policy, options);
+    }
+
+    /**
+     * Computes the cumulative minimum of an array.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<T> cumulative_min(const typed_array<T>& array, null_policy policy = null_policy::skip)
+    {
+        return impl::cumulative_scan(array, std::numeric_limits<T>::max(), impl::minimum{}, policy);
+    }
+
+    /**
+     * Parallel version of cumulative_min.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<T> cumulative_min(const typed_array<T>& array, null_policy policy, const parallel_options& options)
+    {
+        return impl::cumulative_scan(array, std::numeric_limits<T>::max(), impl::minimum{}, policy, options);
+    }
+
+    /**
+     * Computes the cumulative maximum of an array.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<T> cumulative_max(const typed_array<T>& array, null_policy policy = null_policy::skip)
+    {
+        return impl::cumulative_scan(array, std::numeric_limits<T>::lowest(), impl::maximum{}, policy);
+    }
+
+    /**
+     * Parallel version of cumulative_max.
+     *
+     * @see cumulative_sum
+     */
+    template <window_value_type T>
+    typed_array<T> cumulative_max(const typed_array<T>& array, null_policy policy, const parallel_options& options)
+    {
+        return impl::cumulative_scan(array, std::numeric_limits<T>::lowest(), impl::maximum{}, policy, options);
+    }
+
+    /**
+     * Computes the sum of the non-null values over a trailing window of fixed size.
+     *
+     * @param array The values.
+     * @param window The number of elements of the window, including the current one.
+     * @param options The options of the window.
+     * @return An array whose element i is the sum over [i - window + 1, i], null if the
+     * window holds less than `options.min_periods` non-null values.
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>>
+    rolling_sum(const typed_array<T>& array, std::size_t window, const window_options& options = {})
+    {
+        return impl::rolling_apply<impl::window_sum<T>>(array, impl::fixed_window_start(window), options);
+    }
+
+    /**
+     * Computes the sum of the non-null values over a trailing time window.
+     *
+     * @param array The values.
+     * @param times The times of the values, sorted in increasing order and without null.
+     * @param window The duration of the window: the window of the element i holds the
+     * elements whose time lies in (times[i] - window, times[i]].
+     * @param options The options of the window.
+     * @pre \p window must be positive.
+     */
+    template <window_value_type T>
+    typed_array<window_sum_t<T>> rolling_sum(
+        const typed_array<T>& array,
+        const typed_array<timestamp>& times,
+        std::chrono::nanoseconds window,
+        const window_options& options = {}
+    )
+    {
+        SPARROW_ASSERT_TRUE(array.size() == times.size());
+        return impl::rolling_apply<impl::window_sum<T>>(array, impl::time_window_start(times, window), options);
+    }
+
+    /**
+     * Computes the mean of the non-null values over a trailing window of fixed size.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<double>
+    rolling_mean(const typed_array<T>& array, std::size_t window, const window_options& options = {})
+    {
+        return impl::rolling_apply<impl::window_mean<T>>(array, impl::fixed_window_start(window), options);
+    }
+
+    /**
+     * Computes the mean of the non-null values over a trailing time window.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<double> rolling_mean(
+        const typed_array<T>& array,
+        const typed_array<timestamp>& times,
+        std::chrono::nanoseconds window,
+        const window_options& options = {}
+    )
+    {
+        SPARROW_ASSERT_TRUE(array.size() == times.size());
+        return impl::rolling_apply<impl::window_mean<T>>(array, impl::time_window_start(times, window), options);
+    }
+
+    /**
+     * Computes the sample standard deviation of the non-null values over a trailing
+     * window of fixed size. Windows holding less than two values give null.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<double>
+    rolling_std(const typed_array<T>& array, std::size_t window, const window_options& options = {})
+    {
+        return impl::rolling_apply<impl::window_std<T>>(array, impl::fixed_window_start(window), options);
+    }
+
+    /**
+     * Computes the sample standard deviation of the non-null values over a trailing
+     * time window. Windows holding less than two values give null.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<double> rolling_std(
+        const typed_array<T>& array,
+        const typed_array<timestamp>& times,
+        std::chrono::nanoseconds window,
+        const window_options& options = {}
+    )
+    {
+        SPARROW_ASSERT_TRUE(array.size() == times.size());
+        return impl::rolling_apply<impl::window_std<T>>(array, impl::time_window_start(times, window), options);
+    }
+
+    /**
+     * Computes the minimum of the non-null values over a trailing window of fixed size.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<T> rolling_min(const typed_array<T>& array, std::size_t window, const window_options& options = {})
+    {
+        return impl::rolling_apply<impl::window_min<T>>(array, impl::fixed_window_start(window), options);
+    }
+
+    /**
+     * Computes the minimum of the non-null values over a trailing time window.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<T> rolling_min(
+        const typed_array<T>& array,
+        const typed_array<timestamp>& times,
+        std::chrono::nanoseconds window,
+        const window_options& options = {}
+    )
+    {
+        SPARROW_ASSERT_TRUE(array.size() == times.size());
+        return impl::rolling_apply<impl::window_min<T>>(array, impl::time_window_start(times, window), options);
+    }
+
+    /**
+     * Computes the maximum of the non-null values over a trailing window of fixed size.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<T> rolling_max(const typed_array<T>& array, std::size_t window, const window_options& options = {})
+    {
+        return impl::rolling_apply<impl::window_max<T>>(array, impl::fixed_window_start(window), options);
+    }
+
+    /**
+     * Computes the maximum of the non-null values over a trailing time window.
+     *
+     * @see rolling_sum
+     */
+    template <window_value_type T>
+    typed_array<T> rolling_max(
+        const typed_array<T>& array,
+        const typed_array<timestamp>& times,
+        std::chrono::nanoseconds window,
+        const window_options& options = {}
+    )
+    {
+        SPARROW_ASSERT_TRUE(array.size() == times.size());
+        return impl::rolling_apply<impl::window_max<T>>(array, impl::time_window_start(times, window), options);
+    }
+}
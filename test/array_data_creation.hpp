@@ -14,11 +14,18 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
+#include <optional>
+#include <vector>
 
 #include "sparrow/array_data.hpp"
+#include "sparrow/array_data_factory.hpp"
 #include "sparrow/data_traits.hpp"
+#include "sparrow/typed_array.hpp"
+
+#include "doctest/doctest.h"
 
 namespace sparrow::test
 {
@@ -144,4 +151,49 @@ namespace sparrow::test
             return std::to_string(i);
         }
     }
+
+    // Null element in the vectors of optional values given to make_array and check_array.
+    inline constexpr std::nullopt_t N = std::nullopt;
+
+    // Creates an array_data object of the default layout of T holding the given values.
+    //
+    // param values The values of the array, std::nullopt standing for a null element.
+    // param offset The offset of the array.
+    // return The created array_data object.
+    template <class T>
+    sparrow::array_data
+    make_nullable_array_data(const std::vector<std::optional<T>>& values, std::int64_t offset = 0)
+    {
+        std::vector<T> raw(values.size());
+        sparrow::array_data::bitmap_type bitmap(values.size(), true);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            raw[i] = values[i].value_or(T());
+            bitmap.set(i, values[i].has_value());
+        }
+        using layout_type = typename sparrow::arrow_traits<T>::default_layout;
+        return sparrow::make_default_array_data<layout_type>(raw, bitmap, offset);
+    }
+
+    // Creates a typed_array holding the given values; see make_nullable_array_data.
+    template <class T>
+    sparrow::typed_array<T> make_array(const std::vector<std::optional<T>>& values, std::int64_t offset = 0)
+    {
+        return sparrow::typed_array<T>(make_nullable_array_data(values, offset));
+    }
+
+    // Checks that res holds the expected values, std::nullopt standing for a null element.
+    template <class T>
+    void check_array(const sparrow::typed_array<T>& res, const std::vector<std::optional<T>>& expected)
+    {
+        REQUIRE_EQ(res.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            REQUIRE_EQ(res[i].has_value(), expected[i].has_value());
+            if (expected[i].has_value())
+            {
+                CHECK_EQ(res[i].value(), *expected[i]);
+            }
+        }
+    }
 }
@@ -0,0 +1,191 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "sparrow/appendable_column.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    TEST_SUITE("appendable_column")
+    {
+        TEST_CASE("constructor")
+        {
+            const appendable_column<double> column;
+            CHECK_EQ(column.size(), 0);
+            CHECK_EQ(column.chunk_capacity(), default_chunk_capacity);
+            CHECK(column.snapshot().empty());
+
+            const appendable_column<double> small(100);
+            CHECK_EQ(small.chunk_capacity(), 128);
+        }
+
+        TEST_CASE("push_back")
+        {
+            appendable_column<std::int32_t> column(64);
+            for (std::int32_t i = 0; i < 150; ++i)
+            {
+                if (i % 10 == 3)
+                {
+                    column.push_back_null();
+                }
+                else
+                {
+                    column.push_back(i);
+                }
+            }
+            CHECK_EQ(column.size(), 150);
+
+            const chunked_array<std::int32_t> snapshot = column.snapshot();
+            REQUIRE_EQ(snapshot.size(), 150);
+            REQUIRE_EQ(snapshot.chunk_count(), 3);
+            CHECK_EQ(snapshot.chunk(0).size(), 64);
+            CHECK_EQ(snapshot.chunk(2).size(), 22);
+            for (std::size_t i = 0; i < snapshot.size(); ++i)
+            {
+                if (i % 10 == 3)
+                {
+                    CHECK_FALSE(snapshot[i].has_value());
+                }
+                else
+                {
+                    REQUIRE(snapshot[i].has_value());
+                    CHECK_EQ(snapshot[i].value(), static_cast<std::int32_t>(i));
+                }
+            }
+        }
+
+        TEST_CASE("append")
+        {
+            appendable_column<std::int64_t> column(64);
+            std::vector<std::int64_t> values(1000);
+            std::iota(values.begin(), values.end(), 0);
+            column.append(values);
+            column.append(std::span<const std::int64_t>(values).first(10));
+            CHECK_EQ(column.size(), 1010);
+
+            const chunked_array<std::int64_t> snapshot = column.snapshot();
+            REQUIRE_EQ(snapshot.size(), 1010);
+            CHECK_EQ(snapshot.chunk_count(), 16);
+            CHECK_EQ(snapshot[999].value(), 999);
+            CHECK_EQ(snapshot[1009].value(), 9);
+        }
+
+        TEST_CASE("snapshot")
+        {
+            auto column = std::make_unique<appendable_column<double>>(64);
+            for (std::size_t i = 0; i < 100; ++i)
+            {
+                column->push_back(static_cast<double>(i));
+            }
+            const chunked_array<double> snapshot = column->snapshot();
+
+            SUBCASE("zero copy")
+            {
+                const chunked_array<double> other = column->snapshot();
+                const auto values = [](const chunked_array<double>& s, std::size_t k)
+                {
+                    return s.chunk(k).get_data().buffers[0].data<double>();
+                };
+                CHECK_EQ(values(snapshot, 0), values(other, 0));
+                CHECK_EQ(values(snapshot, 1), values(other, 1));
+            }
+
+            SUBCASE("later appends")
+            {
+                column->push_back_null();
+                column->push_back(-1.);
+                CHECK_EQ(snapshot.size(), 100);
+                CHECK_EQ(snapshot.chunk(1).get_data().bitmap.null_count(), 0);
+                const chunked_array<double> other = column->snapshot();
+                CHECK_EQ(other.size(), 102);
+                CHECK_FALSE(other[100].has_value());
+                CHECK_EQ(other[101].value(), -1.);
+            }
+
+            SUBCASE("outlives the column")
+            {
+                column.reset();
+                CHECK_EQ(snapshot[0].value(), 0.);
+                CHECK_EQ(snapshot[99].value(), 99.);
+            }
+        }
+
+        TEST_CASE("concurrent readers")
+        {
+            constexpr std::int64_t value_count = 20000;
+            appendable_column<std::int64_t> column(64);
+            std::atomic<bool> failed = false;
+            std::atomic<bool> done = false;
+
+            std::vector<std::thread> readers;
+            for (std::size_t r = 0; r < 3; ++r)
+            {
+                readers.emplace_back(
+                    [&column, &failed, &done]()
+                    {
+                        std::size_t previous_size = 0;
+                        while (!done.load())
+                        {
+                            const chunked_array<std::int64_t> snapshot = column.snapshot();
+                            const std::size_t size = snapshot.size();
+                            if (size < previous_size)
+                            {
+                                failed = true;
+                            }
+                            for (std::size_t i = previous_size; i < size; ++i)
+                            {
+                                const auto value = snapshot[i];
+                                const bool expected_null = i % 7 == 0;
+                                if (value.has_value() == expected_null
+                                    || (!expected_null && value.value() != static_cast<std::int64_t>(i)))
+                                {
+                                    failed = true;
+                                }
+                            }
+                            previous_size = size;
+                        }
+                    }
+                );
+            }
+
+            for (std::int64_t i = 0; i < value_count; ++i)
+            {
+                if (i % 7 == 0)
+                {
+                    column.push_back_null();
+                }
+                else
+                {
+                    column.push_back(i);
+                }
+            }
+            done = true;
+            for (std::thread& reader : readers)
+            {
+                reader.join();
+            }
+            CHECK_FALSE(failed.load());
+            CHECK_EQ(column.snapshot().size(), value_count);
+        }
+    }
+}
@@ -236,6 +236,108 @@ TEST_SUITE("array")
 
             CHECK_EQ(iter, iter_end);
         }
+
+        SUBCASE("copy")
+        {
+            const auto ar = make_test_array<T>();
+            const array copy = ar;
+            CHECK_EQ(&copy.template get<T>(), &ar.template get<T>());
+            CHECK_EQ(copy.size(), ar.size());
+        }
+
+        SUBCASE("visit")
+        {
+            const auto ar = make_test_array<T>();
+            const std::size_t size = ar.visit(
+                [](const auto& typed)
+                {
+                    return typed.size();
+                }
+            );
+            CHECK_EQ(size, ar.size());
+        }
+
+        SUBCASE("get")
+        {
+            array ar = make_test_array<T>();
+            const typed_array<T>& typed = std::as_const(ar).get<T>();
+            REQUIRE_EQ(typed.size(), ar.size());
+            for (std::size_t i = 0; i < typed.size(); ++i)
+            {
+                CHECK_EQ(typed[i].value(), to_value_type<T>(i + offset));
+            }
+            CHECK_EQ(&ar.get<T>(), &typed);
+            CHECK_EQ(&ar.get_data(), &typed.get_data());
+            if constexpr (std::same_as<T, float64_t>)
+            {
+                CHECK_THROWS_AS(ar.get<std::int32_t>(), std::invalid_argument);
+            }
+            else
+            {
+                CHECK_THROWS_AS(ar.get<float64_t>(), std::invalid_argument);
+            }
+        }
+
+        SUBCASE("copy on write")
+        {
+            const array ar = make_test_array<T>();
+            array copy = ar;
+            const typed_array<T>& shared = ar.get<T>();
+            typed_array<T>& unshared = copy.get<T>();
+            CHECK_NE(&unshared, &shared);
+            CHECK_EQ(&copy.get<T>(), &unshared);
+            CHECK_EQ(&copy.get_data(), &unshared.get_data());
+            CHECK_EQ(unshared, shared);
+
+            const std::size_t size = copy.visit(
+                [&unshared](auto& typed)
+                {
+                    CHECK_EQ(static_cast<const void*>(&typed), static_cast<const void*>(&unshared));
+                    return typed.size();
+                }
+            );
+            CHECK_EQ(size, ar.size());
+        }
+
+        SUBCASE("algorithms")
+        {
+            const auto ar = make_test_array<T>();
+            std::size_t count = 0;
+            for_each(
+                ar,
+                [&count](const auto& element)
+                {
+                    count += element.has_value() ? 1u : 0u;
+                }
+            );
+            CHECK_EQ(count, ar.size());
+            const auto has_value = [](const auto& element)
+            {
+                return element.has_value();
+            };
+            CHECK_EQ(count_if(ar, has_value), ar.size());
+            CHECK(all_of(ar, has_value));
+            CHECK(any_of(ar, has_value));
+            CHECK_EQ(find_if(ar, has_value), 0);
+
+            const auto is_third = [](const auto& element)
+            {
+                if constexpr (std::same_as<std::decay_t<decltype(element)>, typename typed_array<T>::const_reference>)
+                {
+                    return element.value() == to_value_type<T>(3 + offset);
+                }
+                else
+                {
+                    return false;
+                }
+            };
+            std::size_t expected = 0;
+            while (to_value_type<T>(expected + offset) != to_value_type<T>(3 + offset))
+            {
+                ++expected;
+            }
+            CHECK_EQ(find_if(ar, is_third), expected);
+        }
     }
 
     TEST_CASE_TEMPLATE_INVOKE(
@@ -12,17 +12,102 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "sparrow/array_data_factory.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/typed_array.hpp"
 #include "sparrow/variable_size_binary_layout.hpp"
 
 #include "doctest/doctest.h"
 
 namespace sparrow
 {
+    namespace
+    {
+        // Memory resource counting the bytes it currently holds
+        class counting_resource : public std::pmr::memory_resource
+        {
+        public:
+
+            std::size_t allocated() const
+            {
+                return m_allocated;
+            }
+
+        private:
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                m_allocated += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+            {
+                m_allocated -= bytes;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::size_t m_allocated = 0;
+        };
+
+        void check_allocator(const array_data& data, const array_data_allocator& expected)
+        {
+            CHECK(data.bitmap.get_allocator() == expected);
+            for (const array_data::buffer_type& buffer : data.buffers)
+            {
+                CHECK(buffer.get_allocator() == expected);
+            }
+            if (data.dictionary.has_value())
+            {
+                check_allocator(*data.dictionary, expected);
+            }
+        }
+
+        void check_same_bitmap(const array_data::bitmap_type& bitmap, const array_data::bitmap_type& expected)
+        {
+            REQUIRE_EQ(bitmap.size(), expected.size());
+            CHECK_EQ(bitmap.null_count(), expected.null_count());
+            CHECK(std::equal(expected.data(), expected.data() + expected.block_count(), bitmap.data()));
+        }
+
+        // Deleter counting the arrays it releases
+        struct counting_deleter
+        {
+            std::size_t* p_count;
+
+            void operator()(double* p) const
+            {
+                ++*p_count;
+                delete[] p;
+            }
+        };
+
+        // Counts the releases of an adopted block without freeing it
+        struct release_counter
+        {
+            void operator()(std::size_t* p_count) const
+            {
+                ++*p_count;
+            }
+        };
+    }
+
     TEST_SUITE("array_data_factory")
     {
         TEST_CASE("fixed_size_layout")
@@ -104,5 +189,263 @@ namespace sparrow
                 CHECK_EQ(layout[i].value(), v[i + offset]);
             }
         }
+
+        TEST_CASE("allocator")
+        {
+            using string_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+            using dictionary_layout = dictionary_encoded_layout<size_t, string_layout>;
+
+            counting_resource resource;
+            const std::pmr::polymorphic_allocator<std::uint8_t> alloc(&resource);
+            const array_data_allocator expected(alloc);
+            const std::vector<std::string> v = {"a", "bb", "ccc", "bb"};
+            const dynamic_bitset<std::uint8_t> bitmap(v.size(), true);
+
+            SUBCASE("fixed_size_layout")
+            {
+                const std::vector<std::int64_t> values = {1, 2, 3, 4};
+                const array_data ar = make_array_data_for_fixed_size_layout(values, bitmap, 0, alloc);
+                check_allocator(ar, expected);
+                const std::size_t byte_count = values.size() * sizeof(std::int64_t) + ar.bitmap.block_count();
+                CHECK_EQ(resource.allocated(), byte_count);
+
+                const array_data copy = ar;
+                check_allocator(copy, expected);
+            }
+
+            SUBCASE("variable_size_binary_layout")
+            {
+                const array_data ar = make_default_array_data<string_layout>(v, bitmap, 0, alloc);
+                check_allocator(ar, expected);
+            }
+
+            SUBCASE("dictionary_encoded_layout")
+            {
+                const array_data ar = make_default_array_data<dictionary_layout>(v, bitmap, 0, alloc);
+                check_allocator(ar, expected);
+            }
+
+            SUBCASE("empty")
+            {
+                check_allocator(make_default_array_data<fixed_size_layout<double>>(alloc), expected);
+                check_allocator(make_default_array_data<dictionary_layout>(alloc), expected);
+
+                const typed_array<std::int32_t> empty(alloc);
+                check_allocator(empty.get_data(), expected);
+            }
+
+            CHECK_EQ(resource.allocated(), 0);
+        }
+
+        TEST_CASE("parallel")
+        {
+            using string_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+
+            thread_pool pool(4);
+            const parallel_options options{.morsel_size = 64, .pool = &pool};
+            constexpr std::size_t size = 1000;
+            dynamic_bitset<std::uint8_t> bitmap(size, true);
+            for (std::size_t i = 0; i < size; i += 7)
+            {
+                bitmap.set(i, false);
+            }
+
+            SUBCASE("fixed_size_layout")
+            {
+                std::vector<std::int32_t> values(size);
+                std::iota(values.begin(), values.end(), -500);
+                const std::vector<std::int32_t>& const_values = values;
+                const array_data expected = make_array_data_for_fixed_size_layout(const_values, bitmap, 3);
+                const array_data ar = make_array_data_for_fixed_size_layout(const_values, bitmap, 3, options);
+                CHECK_EQ(ar.type.id(), expected.type.id());
+                CHECK_EQ(ar.length, expected.length);
+                CHECK_EQ(ar.offset, expected.offset);
+                check_same_bitmap(ar.bitmap, expected.bitmap);
+                CHECK_EQ(ar.buffers, expected.buffers);
+            }
+
+            SUBCASE("variable_size_binary_layout")
+            {
+                std::vector<std::string> values;
+                values.reserve(size);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    values.push_back(std::string(i % 13, static_cast<char>('a' + i % 26)));
+                }
+                const std::vector<std::string>& const_values = values;
+                const array_data expected = make_array_data_for_variable_size_binary_layout(const_values, bitmap, 0);
+                array_data ar = make_array_data_for_variable_size_binary_layout(
+                    const_values,
+                    bitmap,
+                    0,
+                    options
+                );
+                CHECK_EQ(ar.type.id(), expected.type.id());
+                CHECK_EQ(ar.length, expected.length);
+                check_same_bitmap(ar.bitmap, expected.bitmap);
+                CHECK_EQ(ar.buffers, expected.buffers);
+
+                const string_layout layout(ar);
+                CHECK_EQ(layout[999].value(), std::string(999 % 13, static_cast<char>('a' + 999 % 26)));
+            }
+
+            SUBCASE("threshold")
+            {
+                std::vector<std::int64_t> values(parallel_construction_threshold);
+                std::iota(values.begin(), values.end(), 0);
+                const std::vector<std::int64_t>& const_values = values;
+                const dynamic_bitset<std::uint8_t> large_bitmap(values.size(), true);
+                const array_data ar = make_array_data_for_fixed_size_layout(const_values, large_bitmap, 0, pool);
+                REQUIRE_EQ(ar.buffers[0].size(), values.size() * sizeof(std::int64_t));
+                CHECK(std::equal(values.begin(), values.end(), ar.buffers[0].data<std::int64_t>()));
+                check_same_bitmap(ar.bitmap, large_bitmap);
+                CHECK_EQ(ar.buffers, make_array_data_for_fixed_size_layout(const_values, large_bitmap, 0).buffers);
+
+                // Below the threshold, the values are copied on the calling thread
+                const std::vector<std::string> small_values = {"a", "bc"};
+                const dynamic_bitset<std::uint8_t> small_bitmap(small_values.size(), true);
+                array_data small = make_array_data_for_variable_size_binary_layout(
+                    small_values,
+                    small_bitmap,
+                    0,
+                    pool
+                );
+                const string_layout small_layout(small);
+                CHECK_EQ(small_layout[1].value(), "bc");
+            }
+        }
+
+        TEST_CASE("adopt")
+        {
+            const dynamic_bitset<std::uint8_t> bitmap(4u, true);
+
+            SUBCASE("vector")
+            {
+                std::vector<std::int64_t> values = {1, 2, 3, 4};
+                const std::int64_t* storage = values.data();
+                const array_data ar = make_array_data_for_fixed_size_layout(std::move(values), bitmap, 1);
+                CHECK_EQ(ar.type.id(), data_type::INT64);
+                CHECK_EQ(ar.length, 4);
+                CHECK_EQ(ar.offset, 1);
+                CHECK_EQ(ar.buffers[0].data<std::int64_t>(), storage);
+                CHECK_EQ(ar.buffers[0].size(), 4 * sizeof(std::int64_t));
+
+                const typed_array<std::int64_t> typed(ar);
+                REQUIRE_EQ(typed.size(), 3);
+                CHECK_EQ(typed[2].value(), 4);
+
+                const array_data copy = ar;
+                CHECK_NE(copy.buffers[0].data<std::int64_t>(), storage);
+                CHECK_EQ(copy.buffers[0], ar.buffers[0]);
+            }
+
+            SUBCASE("buffer")
+            {
+                buffer<float> values = {1.f, 2.f, 3.f, 4.f};
+                const float* storage = values.data();
+                const array_data ar = make_array_data_for_fixed_size_layout(std::move(values), bitmap, 0);
+                CHECK_EQ(ar.type.id(), data_type::FLOAT);
+                CHECK_EQ(ar.buffers[0].data<float>(), storage);
+                CHECK_EQ(ar.buffers[0].data<float>()[3], 4.f);
+            }
+
+            SUBCASE("unique_ptr")
+            {
+                std::size_t release_count = 0;
+                {
+                    std::unique_ptr<double[], counting_deleter> values(
+                        new double[4]{1., 2., 3., 4.},
+                        counting_deleter{&release_count}
+                    );
+                    const double* storage = values.get();
+                    array_data ar = make_array_data_for_fixed_size_layout(std::move(values), 4u, bitmap, 0);
+                    CHECK_EQ(ar.type.id(), data_type::DOUBLE);
+                    CHECK_EQ(ar.buffers[0].data<double>(), storage);
+
+                    array_data moved = std::move(ar);
+                    CHECK_EQ(release_count, 0);
+
+                    // Growing the buffer moves the values to a new block and releases the adopted one
+                    moved.buffers[0].resize(8 * sizeof(double));
+                    CHECK_EQ(release_count, 1);
+                    CHECK_EQ(moved.buffers[0].data<double>()[2], 3.);
+
+                    // The next blocks are std::allocator ones, whatever their address
+                    moved.buffers[0].resize(4 * sizeof(double));
+                    moved.buffers[0].shrink_to_fit();
+                    moved.buffers[0].resize(16 * sizeof(double));
+                    moved.buffers[0].shrink_to_fit();
+                    CHECK_EQ(release_count, 1);
+                    CHECK_EQ(moved.buffers[0].data<double>()[3], 4.);
+                }
+                CHECK_EQ(release_count, 1);
+            }
+
+            SUBCASE("block address reused")
+            {
+                std::size_t release_count = 0;
+                std::uint8_t* block = std::allocator<std::uint8_t>().allocate(8u);
+                adopting_allocator<std::uint8_t> allocator(
+                    block,
+                    std::unique_ptr<std::size_t, release_counter>(&release_count)
+                );
+                const adopting_allocator<std::uint8_t> copy = allocator;
+                allocator.deallocate(block, 8u);
+                CHECK_EQ(release_count, 1);
+                // The owner did not free the block: it now stands for a block that
+                // std::allocator returned at the address of the adopted one
+                adopting_allocator<std::uint8_t>(copy).deallocate(block, 8u);
+                CHECK_EQ(release_count, 1);
+            }
+
+            SUBCASE("concurrent deallocation")
+            {
+                // Copies deallocating their own blocks while one of them releases the adopted block
+                std::size_t release_count = 0;
+                std::uint8_t* block = std::allocator<std::uint8_t>().allocate(8u);
+                const adopting_allocator<std::uint8_t> allocator(
+                    block,
+                    std::unique_ptr<std::size_t, release_counter>(&release_count)
+                );
+                std::vector<std::thread> threads;
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    threads.emplace_back(
+                        [copy = allocator, block, i]() mutable
+                        {
+                            for (std::size_t j = 0; j < 1000; ++j)
+                            {
+                                copy.deallocate(copy.allocate(8u), 8u);
+                            }
+                            if (i == 0)
+                            {
+                                copy.deallocate(block, 8u);
+                            }
+                        }
+                    );
+                }
+                for (std::thread& t : threads)
+                {
+                    t.join();
+                }
+                CHECK_EQ(release_count, 1);
+                std::allocator<std::uint8_t>().deallocate(block, 8u);
+            }
+
+            SUBCASE("release")
+            {
+                std::size_t release_count = 0;
+                {
+                    std::unique_ptr<double[], counting_deleter> values(
+                        new double[4](),
+                        counting_deleter{&release_count}
+                    );
+                    const array_data ar = make_array_data_for_fixed_size_layout(std::move(values), 4u, bitmap, 0);
+                    const array_data copy = ar;
+                    CHECK_EQ(release_count, 0);
+                }
+                CHECK_EQ(release_count, 1);
+            }
+        }
     }
 }
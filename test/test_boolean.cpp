@@ -0,0 +1,144 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/boolean.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using optional_bools = std::vector<std::optional<bool>>;
+
+        typed_array<bool> make_bool_array(const optional_bools& values, std::int64_t offset = 0)
+        {
+            std::vector<bool> raw(values.size());
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                raw[i] = values[i].value_or(false);
+                bitmap.set(i, values[i].has_value());
+            }
+            return typed_array<bool>(make_default_array_data<fixed_size_layout<bool>>(raw, bitmap, offset));
+        }
+
+        void check_result(const packed_boolean_array& res, const optional_bools& expected)
+        {
+            REQUIRE_EQ(res.size(), expected.size());
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                CHECK_EQ(res[i], expected[i]);
+                if (!expected[i].has_value())
+                {
+                    CHECK_FALSE(res.values().test(i));
+                }
+            }
+        }
+
+        constexpr std::optional<bool> T = true;
+        constexpr std::optional<bool> F = false;
+        constexpr std::optional<bool> N = std::nullopt;
+
+        // All the combinations of two three-valued operands.
+        const optional_bools lhs_values = {T, T, T, F, F, F, N, N, N};
+        const optional_bools rhs_values = {T, F, N, T, F, N, T, F, N};
+    }
+
+    TEST_SUITE("boolean")
+    {
+        TEST_CASE("make_packed_boolean_array")
+        {
+            SUBCASE("small")
+            {
+                const auto array = make_bool_array({T, N, F, T, N});
+                check_result(make_packed_boolean_array(array), {T, N, F, T, N});
+            }
+
+            SUBCASE("large with offset")
+            {
+                optional_bools values(200);
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    values[i] = (i % 7 == 0) ? N : std::optional<bool>(i % 3 == 0);
+                }
+                const auto array = make_bool_array(values, 5);
+                const optional_bools expected(values.begin() + 5, values.end());
+                const auto packed = make_packed_boolean_array(array);
+                check_result(packed, expected);
+            }
+
+            SUBCASE("without nulls")
+            {
+                const auto array = make_bool_array({T, F, T});
+                const auto packed = make_packed_boolean_array(array);
+                CHECK_EQ(packed.null_count(), 0);
+                CHECK_EQ(packed.true_count(), 2);
+            }
+        }
+
+        TEST_CASE("null propagating kernels")
+        {
+            const auto lhs = make_bool_array(lhs_values);
+            const auto rhs = make_bool_array(rhs_values);
+            check_result(logical_and(lhs, rhs), {T, F, N, F, F, N, N, N, N});
+            check_result(logical_or(lhs, rhs), {T, T, N, T, F, N, N, N, N});
+            check_result(logical_xor(lhs, rhs), {F, T, N, T, F, N, N, N, N});
+            check_result(logical_not(lhs), {F, F, F, T, T, T, N, N, N});
+        }
+
+        TEST_CASE("kleene kernels")
+        {
+            const auto lhs = make_bool_array(lhs_values);
+            const auto rhs = make_bool_array(rhs_values);
+            check_result(and_kleene(lhs, rhs), {T, F, N, F, F, F, N, F, N});
+            check_result(or_kleene(lhs, rhs), {T, T, T, T, F, N, T, N, N});
+        }
+
+        TEST_CASE("mixed operands")
+        {
+            const auto lhs = make_bool_array(lhs_values);
+            const auto rhs = make_packed_boolean_array(make_bool_array(rhs_values));
+            check_result(and_kleene(lhs, rhs), {T, F, N, F, F, F, N, F, N});
+            check_result(and_kleene(rhs, logical_not(rhs)), {F, F, N, F, F, N, F, F, N});
+        }
+
+        TEST_CASE("large arrays")
+        {
+            constexpr std::size_t n = 300;
+            optional_bools lhs_large(n);
+            optional_bools rhs_large(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                lhs_large[i] = lhs_values[i % lhs_values.size()];
+                rhs_large[i] = rhs_values[i % rhs_values.size()];
+            }
+            const auto lhs = make_bool_array(lhs_large);
+            const auto rhs = make_bool_array(rhs_large);
+            const auto res = or_kleene(lhs, rhs);
+            const optional_bools expected = {T, T, T, T, F, N, T, N, N};
+            REQUIRE_EQ(res.size(), n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                CHECK_EQ(res[i], expected[i % expected.size()]);
+            }
+        }
+    }
+}
@@ -0,0 +1,201 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/cast.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::check_array;
+        using test::N;
+    }
+
+    TEST_SUITE("cast")
+    {
+        TEST_CASE("widening")
+        {
+            const auto array = make_array<std::int8_t>({-1, N, 127, -128});
+            check_array(cast<std::int64_t>(array), std::vector<std::optional<std::int64_t>>{-1, N, 127, -128});
+            check_array(cast<double>(array), std::vector<std::optional<double>>{-1., N, 127., -128.});
+        }
+
+        TEST_CASE("narrowing")
+        {
+            SUBCASE("in range")
+            {
+                const auto array = make_array<std::int64_t>({1000, 2, -3, 4}, 1);
+                check_array(cast<std::int8_t>(array), std::vector<std::optional<std::int8_t>>{2, -3, 4});
+            }
+
+            SUBCASE("out of range")
+            {
+                const auto array = make_array<std::int32_t>({1, 300, 3});
+                CHECK_THROWS_AS(cast<std::uint8_t>(array), std::overflow_error);
+                check_array(
+                    cast<std::uint8_t>(array, cast_mode::unsafe),
+                    std::vector<std::optional<std::uint8_t>>{1, 44, 3}
+                );
+            }
+
+            SUBCASE("out of range values that are null")
+            {
+                const auto array = make_array<std::int32_t>({1, 2, 3});
+                array_data data = array.get_data();
+                data.buffers[0].data<std::int32_t>()[1] = 300;
+                data.bitmap.set(1, false);
+                check_array(cast<std::uint8_t>(typed_array<std::int32_t>(data)), std::vector<std::optional<std::uint8_t>>{1, N, 3});
+            }
+
+            SUBCASE("large arrays")
+            {
+                std::vector<std::optional<std::int16_t>> values(300);
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    values[i] = static_cast<std::int16_t>(i % 100);
+                }
+                CHECK_NOTHROW(cast<std::int8_t>(make_array(values)));
+                values[250] = -129;
+                CHECK_THROWS_AS(cast<std::int8_t>(make_array(values)), std::overflow_error);
+            }
+        }
+
+        TEST_CASE("signedness")
+        {
+            const auto array = make_array<std::int32_t>({1, -1, 3});
+            CHECK_THROWS_AS(cast<std::uint32_t>(array), std::overflow_error);
+            const auto res = cast<std::uint32_t>(array, cast_mode::unsafe);
+            check_array(res, std::vector<std::optional<std::uint32_t>>{1, std::numeric_limits<std::uint32_t>::max(), 3});
+            CHECK_EQ(res.get_data().type.id(), data_type::UINT32);
+        }
+
+        TEST_CASE("floating point to integer")
+        {
+            const auto array = make_array<double>({1.5, N, -2.75, 1e10});
+            CHECK_THROWS_AS(cast<std::int32_t>(array), std::overflow_error);
+            check_array(
+                cast<std::int32_t>(array, cast_mode::unsafe),
+                std::vector<std::optional<std::int32_t>>{1, N, -2, std::numeric_limits<std::int32_t>::max()}
+            );
+            const auto nan = make_array<float>({std::numeric_limits<float>::quiet_NaN()});
+            CHECK_THROWS_AS(cast<std::int64_t>(nan), std::overflow_error);
+            check_array(cast<std::int64_t>(nan, cast_mode::unsafe), std::vector<std::optional<std::int64_t>>{0});
+        }
+
+        TEST_CASE("float16")
+        {
+            const auto array = make_array<std::int32_t>({1, 2, -3});
+            const auto res = cast<float16_t>(array);
+            REQUIRE_EQ(res.size(), 3);
+            CHECK_EQ(static_cast<float>(res[1].value()), 2.f);
+            CHECK_EQ(static_cast<float>(res[2].value()), -3.f);
+            check_array(cast<std::int32_t>(res), std::vector<std::optional<std::int32_t>>{1, 2, -3});
+            CHECK_THROWS_AS(cast<float16_t>(make_array<std::int32_t>({70000})), std::overflow_error);
+        }
+
+        TEST_CASE("floating point narrowing")
+        {
+            constexpr double inf = std::numeric_limits<double>::infinity();
+            const auto array = make_array<double>({1.5, N, 1e300, -inf});
+            CHECK_THROWS_AS(cast<float>(array), std::overflow_error);
+            CHECK_THROWS_AS(cast<float16_t>(array), std::overflow_error);
+            const auto res = cast<float>(array, cast_mode::unsafe);
+            CHECK_EQ(res[2].value(), std::numeric_limits<float>::infinity());
+
+            // Infinite and NaN values are not overflows
+            const auto special = make_array<double>({inf, std::numeric_limits<double>::quiet_NaN(), 3.});
+            const auto floats = cast<float>(special);
+            CHECK_EQ(floats[0].value(), std::numeric_limits<float>::infinity());
+            CHECK(std::isnan(floats[1].value()));
+            CHECK_EQ(static_cast<float>(cast<float16_t>(special)[2].value()), 3.f);
+
+            CHECK_THROWS_AS(cast<float16_t>(make_array<float>({1.f, 1e5f})), std::overflow_error);
+            CHECK_THROWS_AS(cast<float16_t>(make_array<double>({70000.})), std::overflow_error);
+            // Null values are not checked
+            check_array(
+                cast<float>(make_array<double>({N, 2.})),
+                std::vector<std::optional<float>>{N, 2.f}
+            );
+        }
+
+        TEST_CASE("from string")
+        {
+            const auto array = make_array<std::string>({"12", N, "-7", "abc", "300"});
+            CHECK_THROWS_AS(cast<std::int32_t>(array), std::invalid_argument);
+            CHECK_THROWS_AS(cast<std::uint8_t>(make_array<std::string>({"300"})), std::overflow_error);
+            check_array(
+                cast<std::int32_t>(array, cast_mode::unsafe),
+                std::vector<std::optional<std::int32_t>>{12, N, -7, N, 300}
+            );
+            check_array(
+                cast<double>(make_array<std::string>({"1.5", "-2e3"})),
+                std::vector<std::optional<double>>{1.5, -2e3}
+            );
+        }
+
+        TEST_CASE("to string")
+        {
+            check_array(
+                cast<std::string>(make_array<std::int64_t>({12, N, -7}, 0)),
+                std::vector<std::optional<std::string>>{"12", N, "-7"}
+            );
+            check_array(
+                cast<std::string>(make_array<double>({0., 1.5, -0.25}, 1)),
+                std::vector<std::optional<std::string>>{"1.5", "-0.25"}
+            );
+
+#if defined(__cpp_lib_to_chars)
+            // Shortest representations longer than the initial estimate grow the buffer
+            std::vector<std::optional<double>> values;
+            std::vector<std::optional<std::string>> expected;
+            for (int i = 1; i < 200; ++i)
+            {
+                const double value = -1. / (3. * i);
+                std::array<char, 32> buffer{};
+                const auto res = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+                values.emplace_back(value);
+                expected.emplace_back(std::string(buffer.data(), res.ptr));
+            }
+            check_array(cast<std::string>(make_array(values)), expected);
+#endif
+        }
+
+        TEST_CASE("timestamp")
+        {
+            const auto array = make_array<std::int64_t>({0, N, 86400000000000});
+            const auto res = cast<timestamp>(array);
+            REQUIRE_EQ(res.size(), 3);
+            CHECK_FALSE(res[1].has_value());
+            CHECK_EQ(res[2].value().get_sys_time().time_since_epoch(), std::chrono::days(1));
+            check_array(cast<std::int64_t>(res), std::vector<std::optional<std::int64_t>>{0, N, 86400000000000});
+        }
+    }
+}
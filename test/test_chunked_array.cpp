@@ -0,0 +1,281 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/chunked_array.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        // A chunk holding [first, first + size), every fifth value being null
+        typed_array<std::int32_t> make_chunk(std::int32_t first, std::size_t size)
+        {
+            std::vector<std::int32_t> values(size);
+            array_data::bitmap_type bitmap(size, true);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                values[i] = first + static_cast<std::int32_t>(i);
+                bitmap.set(i, values[i] % 5 != 4);
+            }
+            return typed_array<std::int32_t>(
+                make_default_array_data<fixed_size_layout<std::int32_t>>(values, bitmap, 0)
+            );
+        }
+
+        // Sizes of the chunks of the test array; the empty chunks must be skipped
+        const std::vector<std::size_t> chunk_sizes = {3, 0, 10, 1, 0, 2, 7};
+
+        chunked_array<std::int32_t> make_chunked_array()
+        {
+            chunked_array<std::int32_t> res;
+            std::int32_t first = 0;
+            for (const std::size_t size : chunk_sizes)
+            {
+                res.push_back(make_chunk(first, size));
+                first += static_cast<std::int32_t>(size);
+            }
+            return res;
+        }
+
+        template <class C>
+        void check_values(const C& c)
+        {
+            for (std::size_t i = 0; i < c.size(); ++i)
+            {
+                const auto value = c[i];
+                REQUIRE_EQ(value.has_value(), i % 5 != 4);
+                if (value.has_value())
+                {
+                    CHECK_EQ(value.value(), static_cast<std::int32_t>(i));
+                }
+            }
+        }
+    }
+
+    TEST_SUITE("chunked_array")
+    {
+        TEST_CASE("empty")
+        {
+            const chunked_array<std::int32_t> c;
+            CHECK(c.empty());
+            CHECK_EQ(c.chunk_count(), 0);
+            CHECK_EQ(c.begin(), c.end());
+            CHECK_THROWS_AS(c.at(0), std::out_of_range);
+        }
+
+        TEST_CASE("element access")
+        {
+            const auto c = make_chunked_array();
+            CHECK_EQ(c.size(), 23);
+            CHECK_EQ(c.chunk_count(), chunk_sizes.size());
+            CHECK_EQ(c.chunk_offset(2), 3);
+            CHECK_EQ(c.chunk_offset(3), 13);
+            check_values(c);
+            CHECK_EQ(c.at(22).value(), 22);
+            CHECK_THROWS_AS(c.at(23), std::out_of_range);
+        }
+
+        TEST_CASE("zero copy")
+        {
+            auto chunk = make_chunk(0, 4);
+            const auto* buffer = chunk.get_data().buffers[0].data();
+            chunked_array<std::int32_t> c;
+            c.push_back(std::move(chunk));
+            CHECK_EQ(c.chunk(0).get_data().buffers[0].data(), buffer);
+
+            SUBCASE("reallocation")
+            {
+                // The chunks are moved, not copied, when the storage of the chunks grows
+                static_assert(std::is_nothrow_move_constructible_v<typed_array<std::int32_t>>);
+                std::vector<const std::uint8_t*> buffers = {buffer};
+                for (std::int32_t i = 1; i < 40; ++i)
+                {
+                    auto next = make_chunk(4 * i, 4);
+                    buffers.push_back(next.get_data().buffers[0].data());
+                    c.push_back(std::move(next));
+                }
+                REQUIRE_EQ(c.chunk_count(), buffers.size());
+                for (std::size_t i = 0; i < buffers.size(); ++i)
+                {
+                    CHECK_EQ(c.chunk(i).get_data().buffers[0].data(), buffers[i]);
+                }
+                check_values(c);
+            }
+        }
+
+        TEST_CASE("iterators")
+        {
+            const auto c = make_chunked_array();
+            std::size_t i = 0;
+            for (auto it = c.begin(); it != c.end(); ++it, ++i)
+            {
+                CHECK_EQ((*it).has_value(), i % 5 != 4);
+                if ((*it).has_value())
+                {
+                    CHECK_EQ((*it).value(), static_cast<std::int32_t>(i));
+                }
+            }
+            CHECK_EQ(i, c.size());
+            CHECK_EQ(std::distance(c.begin(), c.end()), 23);
+        }
+
+        TEST_CASE("for_each_chunk")
+        {
+            const auto c = make_chunked_array();
+            std::vector<std::size_t> offsets;
+            c.for_each_chunk(
+                [&offsets](const typed_array<std::int32_t>& chunk, std::size_t offset)
+                {
+                    if (chunk.size() != 0 && chunk[0].has_value())
+                    {
+                        CHECK_EQ(chunk[0].value(), static_cast<std::int32_t>(offset));
+                    }
+                    offsets.push_back(offset);
+                }
+            );
+            CHECK_EQ(offsets, std::vector<std::size_t>{0, 3, 3, 13, 14, 14, 16});
+        }
+
+        TEST_CASE("rechunk")
+        {
+            auto c = make_chunked_array();
+            const auto* large_buffer = c.chunk(2).get_data().buffers[0].data();
+            c.rechunk(5);
+            // {3, 0} -> 3, {10}, {1, 0, 2} -> 3, {7}
+            REQUIRE_EQ(c.chunk_count(), 4);
+            CHECK_EQ(c.chunk(0).size(), 3);
+            CHECK_EQ(c.chunk(1).size(), 10);
+            CHECK_EQ(c.chunk(2).size(), 3);
+            CHECK_EQ(c.chunk(3).size(), 7);
+            CHECK_EQ(c.chunk(1).get_data().buffers[0].data(), large_buffer);
+            check_values(c);
+
+            auto d = make_chunked_array();
+            d.rechunk(3);
+            // {3}, {0}, {10}, {1, 0, 2}, {7}
+            REQUIRE_EQ(d.chunk_count(), 5);
+            CHECK_EQ(d.chunk_offset(3), 13);
+            check_values(d);
+
+            auto e = make_chunked_array();
+            e.rechunk(100);
+            REQUIRE_EQ(e.chunk_count(), 1);
+            CHECK_EQ(e.size(), 23);
+            check_values(e);
+            CHECK_NE(e.chunk(0).get_data().buffers[0].data(), large_buffer);
+        }
+
+        TEST_CASE("rechunk keeps large chunks")
+        {
+            chunked_array<std::int32_t> c;
+            c.push_back(make_chunk(0, 2));
+            c.push_back(make_chunk(2, 20));
+            c.push_back(make_chunk(22, 3));
+            c.push_back(make_chunk(25, 4));
+            const auto* large_buffer = c.chunk(1).get_data().buffers[0].data();
+            c.rechunk(10);
+            // {2}, {20}, {3, 4} -> 7
+            REQUIRE_EQ(c.chunk_count(), 3);
+            CHECK_EQ(c.chunk(0).size(), 2);
+            CHECK_EQ(c.chunk(1).size(), 20);
+            CHECK_EQ(c.chunk(1).get_data().buffers[0].data(), large_buffer);
+            CHECK_EQ(c.chunk(2).size(), 7);
+            check_values(c);
+        }
+
+        TEST_CASE("default iterators")
+        {
+            const chunked_array<std::int32_t>::const_iterator it{};
+            const chunked_array<std::int32_t>::const_iterator other{};
+            CHECK_EQ(it, other);
+            const auto c = make_chunked_array();
+            CHECK_NE(it, c.begin());
+            CHECK_NE(c.end(), it);
+        }
+    }
+
+    TEST_SUITE("chunked_column")
+    {
+        TEST_CASE("element access")
+        {
+            chunked_column c;
+            std::int32_t first = 0;
+            for (const std::size_t size : chunk_sizes)
+            {
+                c.push_back(make_chunk(first, size).get_data());
+                first += static_cast<std::int32_t>(size);
+            }
+            CHECK_EQ(c.size(), 23);
+            using const_ref = typed_array<std::int32_t>::const_reference;
+            for (std::size_t i = 0; i < c.size(); ++i)
+            {
+                const const_ref value = std::get<const_ref>(c[i]);
+                REQUIRE_EQ(value.has_value(), i % 5 != 4);
+            }
+            CHECK_EQ(std::get<const_ref>(c.at(7)).value(), 7);
+            CHECK_THROWS_AS(c.at(23), std::out_of_range);
+
+            std::size_t count = 0;
+            c.for_each_chunk(
+                [&count](const array& chunk, std::size_t offset)
+                {
+                    CHECK_EQ(offset, count);
+                    count += chunk.size();
+                }
+            );
+            CHECK_EQ(count, 23);
+
+            c.rechunk(8);
+            // {3, 0} -> 3, {10}, {1, 0, 2, 7} -> 10
+            CHECK_EQ(c.chunk_count(), 3);
+            CHECK_EQ(c.size(), 23);
+            for (std::size_t i = 0; i < c.size(); ++i)
+            {
+                const const_ref value = std::get<const_ref>(c[i]);
+                REQUIRE_EQ(value.has_value(), i % 5 != 4);
+                if (value.has_value())
+                {
+                    CHECK_EQ(value.value(), static_cast<std::int32_t>(i));
+                }
+            }
+        }
+
+        TEST_CASE("mixed types")
+        {
+            chunked_column c;
+            c.push_back(make_chunk(0, 3).get_data());
+            std::vector<double> values = {1., 2.};
+            CHECK_THROWS_AS(
+                c.push_back(make_default_array_data<fixed_size_layout<double>>(
+                    values,
+                    array_data::bitmap_type(2, true),
+                    0
+                )),
+                std::invalid_argument
+            );
+            CHECK_EQ(c.chunk_count(), 1);
+        }
+    }
+}
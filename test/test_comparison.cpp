@@ -0,0 +1,231 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/comparison.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        typed_array<T>
+        make_array(const std::vector<T>& values, const std::vector<std::size_t>& nulls = {}, std::int64_t offset = 0)
+        {
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (const auto i : nulls)
+            {
+                bitmap.set(i, false);
+            }
+            using layout_type = typename arrow_traits<T>::default_layout;
+            return typed_array<T>(make_default_array_data<layout_type>(values, bitmap, offset));
+        }
+
+        using expected_type = std::vector<std::optional<bool>>;
+
+        void check_result(const packed_boolean_array& res, const expected_type& expected)
+        {
+            REQUIRE_EQ(res.size(), expected.size());
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                CHECK_EQ(res[i], expected[i]);
+            }
+        }
+    }
+
+    TEST_SUITE("bitmap_utils")
+    {
+        TEST_CASE("pack_bools")
+        {
+            std::vector<std::uint8_t> src(70);
+            for (std::size_t i = 0; i < src.size(); ++i)
+            {
+                src[i] = static_cast<std::uint8_t>(i % 3 == 0);
+            }
+            const bool* p = reinterpret_cast<const bool*>(src.data());
+            const bitmap_word word = pack_bools(p, 64);
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                CHECK_EQ(((word >> i) & 1u) != 0u, i % 3 == 0);
+            }
+            const bitmap_word tail = pack_bools(p + 64, 6);
+            CHECK_EQ(tail, bitmap_word(0b100100));
+
+            bool unpacked[64];
+            unpack_bools(word, 64, unpacked);
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                CHECK_EQ(unpacked[i], i % 3 == 0);
+            }
+        }
+
+        TEST_CASE("bitmap_word_reader")
+        {
+            array_data::bitmap_type bitmap(150, true);
+            bitmap.set(3, false);
+            bitmap.set(70, false);
+            bitmap.set(149, false);
+
+            SUBCASE("aligned")
+            {
+                const bitmap_word_reader reader(bitmap, 0u, 150u);
+                CHECK_EQ(reader.word_count(), 3);
+                CHECK_FALSE(reader.all_set());
+                CHECK_EQ(reader.word(0), ~(bitmap_word(1) << 3));
+                CHECK_EQ(reader.word(1), ~(bitmap_word(1) << 6));
+                CHECK_EQ(reader.word(2), low_bits_mask(21));
+            }
+
+            SUBCASE("unaligned")
+            {
+                const bitmap_word_reader reader(bitmap, 3u, 100u);
+                CHECK_EQ(reader.word_count(), 2);
+                CHECK_EQ(reader.word(0), ~bitmap_word(1));
+                CHECK_EQ(reader.word(1), low_bits_mask(36) & ~(bitmap_word(1) << 3));
+            }
+
+            SUBCASE("no null")
+            {
+                const array_data::bitmap_type full(10, true);
+                const bitmap_word_reader reader(full, 2u, 8u);
+                CHECK(reader.all_set());
+                CHECK_EQ(reader.word(0), low_bits_mask(8));
+            }
+        }
+
+        TEST_CASE("make_bitmap_from_words")
+        {
+            const auto bitmap = make_bitmap_from_words(
+                70,
+                [](std::size_t)
+                {
+                    return ~bitmap_word(0);
+                }
+            );
+            CHECK_EQ(bitmap.size(), 70);
+            CHECK_EQ(bitmap.null_count(), 0);
+        }
+    }
+
+    TEST_SUITE("comparison")
+    {
+        TEST_CASE("array-array")
+        {
+            const auto lhs = make_array<std::int32_t>({1, 2, 3, 4, 5, 6}, {4});
+            const auto rhs = make_array<std::int32_t>({1, 3, 2, 4, 7, 5}, {5});
+
+            check_result(equal(lhs, rhs), {true, false, false, true, std::nullopt, std::nullopt});
+            check_result(not_equal(lhs, rhs), {false, true, true, false, std::nullopt, std::nullopt});
+            check_result(less(lhs, rhs), {false, true, false, false, std::nullopt, std::nullopt});
+            check_result(less_equal(lhs, rhs), {true, true, false, true, std::nullopt, std::nullopt});
+            check_result(greater(lhs, rhs), {false, false, true, false, std::nullopt, std::nullopt});
+            check_result(greater_equal(lhs, rhs), {true, false, true, true, std::nullopt, std::nullopt});
+        }
+
+        TEST_CASE("array-scalar")
+        {
+            const auto lhs = make_array<double>({1., 2., 3., 4.}, {1});
+            check_result(equal(lhs, 3.), {false, std::nullopt, true, false});
+            check_result(less(lhs, 3.), {true, std::nullopt, false, false});
+            check_result(greater_equal(lhs, 3.), {false, std::nullopt, true, true});
+        }
+
+        TEST_CASE("offset")
+        {
+            const auto lhs = make_array<std::int64_t>({10, 1, 2, 3}, {0}, 1);
+            const auto rhs = make_array<std::int64_t>({0, 3, 2, 1}, {}, 1);
+            check_result(less(lhs, rhs), {true, false, false});
+            check_result(less(lhs, std::int64_t(2)), {true, false, false});
+        }
+
+        TEST_CASE("strings")
+        {
+            const auto lhs = make_array<std::string>({"a", "bb", "ccc", "d"}, {3});
+            const auto rhs = make_array<std::string>({"a", "ba", "cd", "d"});
+            check_result(equal(lhs, rhs), {true, false, false, std::nullopt});
+            check_result(less(lhs, rhs), {false, false, true, std::nullopt});
+            check_result(greater(lhs, std::string("b")), {false, true, true, std::nullopt});
+        }
+
+        TEST_CASE("large arrays")
+        {
+            constexpr std::size_t n = 150;
+            constexpr std::size_t offset = 3;
+            const std::vector<std::size_t> nulls = {5, 64, 100, 149};
+            const typed_array<std::uint16_t> values(test::make_test_array_data<std::uint16_t>(n, offset, nulls));
+            const auto res = less(values, std::uint16_t(80));
+            REQUIRE_EQ(res.size(), n - offset);
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                const std::size_t pos = i + offset;
+                const bool is_null = std::ranges::find(nulls, pos) != nulls.end();
+                if (is_null)
+                {
+                    CHECK_FALSE(res[i].has_value());
+                    CHECK_FALSE(res.values().test(i));
+                }
+                else
+                {
+                    CHECK_EQ(res[i], pos < 80);
+                }
+            }
+            CHECK_EQ(res.null_count(), 4);
+            CHECK_EQ(res.true_count(), 80 - offset - 2);
+        }
+
+        TEST_CASE("between")
+        {
+            const auto values = make_array<std::int32_t>({1, 5, 10, 15, 20}, {3});
+
+            SUBCASE("scalar bounds")
+            {
+                check_result(between(values, 5, 15), {false, true, true, std::nullopt, false});
+            }
+
+            SUBCASE("array bounds")
+            {
+                const auto low = make_array<std::int32_t>({0, 6, 10, 0, 0}, {4});
+                const auto high = make_array<std::int32_t>({1, 9, 20, 20, 20});
+                check_result(between(values, low, high), {true, false, true, std::nullopt, std::nullopt});
+            }
+
+            SUBCASE("strings")
+            {
+                const auto strings = make_array<std::string>({"apple", "banana", "cherry"});
+                check_result(between(strings, std::string("b"), std::string("c")), {false, true, false});
+            }
+        }
+
+        TEST_CASE("to_array_data")
+        {
+            const auto lhs = make_array<std::int32_t>({1, 2, 3}, {1});
+            const typed_array<bool> res(less(lhs, 3).to_array_data());
+            REQUIRE_EQ(res.size(), 3);
+            CHECK(res[0].has_value());
+            CHECK(res[0].value());
+            CHECK_FALSE(res[1].has_value());
+            CHECK(res[2].has_value());
+            CHECK_FALSE(res[2].value());
+        }
+    }
+}
@@ -0,0 +1,176 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/concatenate.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::check_array;
+        using test::N;
+
+        template <class T>
+        array_data make_data(const std::vector<std::optional<T>>& values, std::int64_t offset = 0)
+        {
+            return test::make_nullable_array_data(values, offset);
+        }
+    }
+
+    TEST_SUITE("concatenate")
+    {
+        TEST_CASE("bitmap_word_writer")
+        {
+            array_data::bitmap_type bitmap(150, true);
+            bitmap.set(3, false);
+            bitmap.set(64, false);
+            bitmap.set(149, false);
+            bitmap_word_writer writer(157);
+            writer.append(0b101, 3);
+            writer.append(bitmap_word_reader(bitmap, 0, 150));
+            writer.append(~bitmap_word(0), 4);
+            const array_data::bitmap_type res = std::move(writer).finish();
+            REQUIRE_EQ(res.size(), 157);
+            CHECK_EQ(res.null_count(), 4);
+            CHECK(res.test(0));
+            CHECK_FALSE(res.test(1));
+            CHECK_FALSE(res.test(6));
+            CHECK_FALSE(res.test(67));
+            CHECK_FALSE(res.test(152));
+            CHECK(res.test(153));
+            CHECK(res.test(156));
+        }
+
+        TEST_CASE("fixed size")
+        {
+            using values_type = std::vector<std::optional<std::int32_t>>;
+            std::vector<std::optional<std::int32_t>> large(100);
+            values_type expected = {2, N, 4};
+            for (std::size_t i = 0; i < large.size(); ++i)
+            {
+                if (i % 3 != 0)
+                {
+                    large[i] = static_cast<std::int32_t>(i);
+                }
+            }
+            expected.insert(expected.end(), large.begin() + 5, large.end());
+            expected.insert(expected.end(), {7, 8});
+
+            const std::vector<array_data> arrays = {
+                make_data<std::int32_t>({1, 2, N, 4}, 1),
+                make_data<std::int32_t>(large, 5),
+                make_data<std::int32_t>({}),
+                make_data<std::int32_t>({7, 8})
+            };
+            const array_data res = concatenate(std::span<const array_data>(arrays));
+            CHECK_EQ(res.offset, 0);
+            CHECK_EQ(res.buffers[0].size(), expected.size() * sizeof(std::int32_t));
+            check_array(typed_array<std::int32_t>(res), expected);
+        }
+
+        TEST_CASE("without nulls")
+        {
+            const std::vector<typed_array<double>> arrays = {
+                typed_array<double>(make_data<double>({1., 2.})),
+                typed_array<double>(make_data<double>({3.}))
+            };
+            const auto res = concatenate(std::span<const typed_array<double>>(arrays));
+            CHECK_EQ(res.get_data().bitmap.null_count(), 0);
+            check_array(res, std::vector<std::optional<double>>{1., 2., 3.});
+        }
+
+        TEST_CASE("variable size")
+        {
+            const std::vector<array_data> arrays = {
+                make_data<std::string>({"skipped", "ab", N, "cde"}, 1),
+                make_data<std::string>({"", "fghi"})
+            };
+            const array_data res = concatenate(std::span<const array_data>(arrays));
+            CHECK_EQ(res.buffers[1].size(), 9);
+            check_array(
+                typed_array<std::string>(res),
+                std::vector<std::optional<std::string>>{"ab", N, "cde", "", "fghi"}
+            );
+        }
+
+        TEST_CASE("dictionary")
+        {
+            using sub_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+            using layout = dictionary_encoded_layout<std::uint64_t, sub_layout>;
+            const std::vector<std::string> words = {"a", "b", "a", "c"};
+            const std::vector<std::string> other_words = {"x", "b", "y"};
+            array_data lhs = make_default_array_data<layout>(words, array_data::bitmap_type(words.size(), true), 0);
+            lhs.bitmap.set(1, false);
+            const array_data other = make_default_array_data<layout>(
+                other_words,
+                array_data::bitmap_type(other_words.size(), true),
+                1
+            );
+
+            SUBCASE("shared dictionary")
+            {
+                const std::vector<array_data> arrays = {lhs, lhs};
+                array_data res = concatenate(std::span<const array_data>(arrays));
+                REQUIRE(res.dictionary.has_value());
+                CHECK_EQ(res.dictionary->length, lhs.dictionary->length);
+                const layout l(res);
+                REQUIRE_EQ(l.size(), 8);
+                CHECK_EQ(l[4].value(), "a");
+                CHECK_FALSE(l[5].has_value());
+                CHECK_EQ(l[7].value(), "c");
+            }
+
+            SUBCASE("different dictionaries")
+            {
+                const std::vector<array_data> arrays = {lhs, other};
+                array_data res = concatenate(std::span<const array_data>(arrays));
+                REQUIRE(res.dictionary.has_value());
+                CHECK_EQ(res.dictionary->length, lhs.dictionary->length + other.dictionary->length);
+                const layout l(res);
+                REQUIRE_EQ(l.size(), 6);
+                CHECK_EQ(l[0].value(), "a");
+                CHECK_FALSE(l[1].has_value());
+                CHECK_EQ(l[3].value(), "c");
+                CHECK_EQ(l[4].value(), "b");
+                CHECK_EQ(l[5].value(), "y");
+            }
+        }
+
+        TEST_CASE("null layout")
+        {
+            const std::vector<array_data> arrays = {make_array_data_for_null_layout(3), make_array_data_for_null_layout(2)};
+            const array_data res = concatenate(std::span<const array_data>(arrays));
+            CHECK_EQ(res.type.id(), data_type::NA);
+            CHECK_EQ(res.length, 5);
+        }
+
+        TEST_CASE("mismatched types")
+        {
+            const std::vector<array_data> arrays = {make_data<std::int32_t>({1}), make_data<double>({1.})};
+            CHECK_THROWS_AS(concatenate(std::span<const array_data>(arrays)), std::invalid_argument);
+        }
+    }
+}
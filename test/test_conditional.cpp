@@ -0,0 +1,214 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/conditional.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::check_array;
+        using test::N;
+
+        packed_boolean_array make_condition(const std::vector<std::optional<bool>>& values)
+        {
+            return make_packed_boolean_array(make_array<bool>(values));
+        }
+
+        using int_values = std::vector<std::optional<std::int32_t>>;
+        using string_values = std::vector<std::optional<std::string>>;
+    }
+
+    TEST_SUITE("conditional")
+    {
+        TEST_CASE("if_else")
+        {
+            const auto condition = make_condition({true, false, N, true, false});
+
+            SUBCASE("fixed size")
+            {
+                const auto lhs = make_array<std::int32_t>({1, 2, 3, N, 5});
+                const auto rhs = make_array<std::int32_t>({10, 20, 30, 40, N});
+                check_array(if_else(condition, lhs, rhs), int_values{1, 20, N, N, N});
+            }
+
+            SUBCASE("strings")
+            {
+                const auto lhs = make_array<std::string>({"a", "b", "c", "d", "e"});
+                const auto rhs = make_array<std::string>({"aa", "bb", "cc", "dd", N});
+                check_array(if_else(condition, lhs, rhs), string_values{"a", "bb", N, "d", N});
+            }
+
+            SUBCASE("unpacked condition")
+            {
+                const auto cond = make_array<bool>({true, false, N});
+                const auto lhs = make_array<double>({1., 2., 3.});
+                const auto rhs = make_array<double>({4., 5., 6.});
+                check_array(if_else(cond, lhs, rhs), std::vector<std::optional<double>>{1., 5., N});
+            }
+
+            SUBCASE("large arrays")
+            {
+                constexpr std::size_t n = 200;
+                std::vector<std::optional<bool>> cond_values(n);
+                int_values lhs_values(n);
+                int_values rhs_values(n);
+                int_values expected(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    // Full words from each side, then mixed words
+                    cond_values[i] = i < 64 || (i >= 128 && i % 3 == 0);
+                    lhs_values[i] = static_cast<std::int32_t>(i);
+                    rhs_values[i] = -static_cast<std::int32_t>(i);
+                    expected[i] = *cond_values[i] ? lhs_values[i] : rhs_values[i];
+                }
+                check_array(
+                    if_else(make_condition(cond_values), make_array(lhs_values), make_array(rhs_values)),
+                    expected
+                );
+            }
+        }
+
+        TEST_CASE("case_when")
+        {
+            const std::vector<packed_boolean_array> conditions = {
+                make_condition({true, false, false, N, true}),
+                make_condition({true, true, false, false, N})
+            };
+
+            SUBCASE("without default")
+            {
+                const std::vector<typed_array<std::int32_t>> cases = {
+                    make_array<std::int32_t>({1, 2, 3, 4, 5}),
+                    make_array<std::int32_t>({10, 20, 30, 40, 50})
+                };
+                check_array(case_when(conditions, cases), int_values{1, 20, N, N, 5});
+            }
+
+            SUBCASE("with default")
+            {
+                const std::vector<typed_array<std::string>> cases = {
+                    make_array<std::string>({"a", "b", "c", "d", "e"}),
+                    make_array<std::string>({"aa", "bb", "cc", "dd", "ee"}),
+                    make_array<std::string>({"x", "y", "z", N, "t"})
+                };
+                check_array(case_when(conditions, cases), string_values{"a", "bb", "z", N, "e"});
+            }
+        }
+
+        TEST_CASE("coalesce")
+        {
+            SUBCASE("fixed size")
+            {
+                const auto a = make_array<std::int32_t>({1, N, N, N});
+                const auto b = make_array<std::int32_t>({10, 20, N, N});
+                const auto c = make_array<std::int32_t>({100, 200, 300, N});
+                check_array(coalesce(a, b, c), int_values{1, 20, 300, N});
+                check_array(coalesce(a), int_values{1, N, N, N});
+            }
+
+            SUBCASE("strings with offset")
+            {
+                const auto a = make_array<std::string>({"skipped", "a", N, N}, 1);
+                const auto b = make_array<std::string>({"skipped", "b", "bb", N}, 1);
+                check_array(coalesce(a, b), string_values{"a", "bb", N});
+            }
+        }
+
+        TEST_CASE("fill_null")
+        {
+            SUBCASE("scalar")
+            {
+                const auto a = make_array<std::int32_t>({1, N, 3, N});
+                const auto res = fill_null(a, 7);
+                check_array(res, int_values{1, 7, 3, 7});
+                CHECK_EQ(res.get_data().bitmap.null_count(), 0);
+            }
+
+            SUBCASE("string scalar")
+            {
+                const auto a = make_array<std::string>({N, "a", N, "bcd"});
+                check_array(fill_null(a, std::string("zz")), string_values{"zz", "a", "zz", "bcd"});
+            }
+
+            SUBCASE("array")
+            {
+                const auto a = make_array<std::int32_t>({1, N, 3, N});
+                const auto b = make_array<std::int32_t>({10, 20, N, N});
+                check_array(fill_null(a, b), int_values{1, 20, 3, N});
+            }
+        }
+
+        TEST_CASE("dictionary")
+        {
+            using sub_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+            using layout = dictionary_encoded_layout<std::uint64_t, sub_layout>;
+            const std::vector<std::string> words = {"a", "b", "a", "c"};
+            const array_data::bitmap_type bitmap(words.size(), true);
+            const array_data lhs = make_default_array_data<layout>(words, bitmap, 0);
+            // Same dictionary, different indices
+            array_data rhs = lhs;
+            std::uint64_t* rhs_data = rhs.buffers[0].data<std::uint64_t>();
+            std::reverse(rhs_data, rhs_data + words.size());
+            const auto condition = make_condition({true, false, N, false});
+
+            SUBCASE("if_else")
+            {
+                const array_data res = dictionary_if_else(condition, lhs, rhs);
+                REQUIRE(res.dictionary.has_value());
+                CHECK_EQ(res.type.id(), data_type::UINT64);
+                CHECK_EQ(res.length, 4);
+                const std::uint64_t* indices = res.buffers[0].data<std::uint64_t>();
+                const std::uint64_t* lhs_indices = lhs.buffers[0].data<std::uint64_t>();
+                const std::uint64_t* rhs_indices = rhs.buffers[0].data<std::uint64_t>();
+                CHECK_EQ(indices[0], lhs_indices[0]);
+                CHECK_EQ(indices[1], rhs_indices[1]);
+                CHECK_EQ(indices[3], rhs_indices[3]);
+                CHECK(res.bitmap.test(0));
+                CHECK_FALSE(res.bitmap.test(2));
+            }
+
+            SUBCASE("coalesce")
+            {
+                array_data with_nulls = lhs;
+                with_nulls.bitmap.set(1, false);
+                const array_data res = dictionary_coalesce({&with_nulls, &rhs});
+                const std::uint64_t* indices = res.buffers[0].data<std::uint64_t>();
+                CHECK_EQ(indices[0], lhs.buffers[0].data<std::uint64_t>()[0]);
+                CHECK_EQ(indices[1], rhs.buffers[0].data<std::uint64_t>()[1]);
+                CHECK_EQ(res.bitmap.null_count(), 0);
+            }
+
+            SUBCASE("different dictionaries")
+            {
+                const std::vector<std::string> other_words = {"x", "y", "z", "t"};
+                const array_data other = make_default_array_data<layout>(other_words, bitmap, 0);
+                CHECK_THROWS_AS(dictionary_if_else(condition, lhs, other), std::invalid_argument);
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/float16_conversion.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        std::vector<float16_t> all_halves()
+        {
+            std::vector<float16_t> res(65536);
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                res[i] = std::bit_cast<float16_t>(static_cast<std::uint16_t>(i));
+            }
+            return res;
+        }
+
+        bool same_float(float lhs, float rhs)
+        {
+            return (std::isnan(lhs) && std::isnan(rhs)) || std::bit_cast<std::uint32_t>(lhs) == std::bit_cast<std::uint32_t>(rhs);
+        }
+    }
+
+    TEST_SUITE("float16_conversion")
+    {
+        TEST_CASE("half to float")
+        {
+            CHECK_EQ(impl::half_bits_to_float(0x3c00), 1.f);
+            CHECK_EQ(impl::half_bits_to_float(0xc000), -2.f);
+            CHECK_EQ(impl::half_bits_to_float(0x7bff), 65504.f);
+            CHECK_EQ(impl::half_bits_to_float(0x0001), std::ldexp(1.f, -24));
+            CHECK_EQ(impl::half_bits_to_float(0x7c00), std::numeric_limits<float>::infinity());
+            CHECK(std::isnan(impl::half_bits_to_float(0x7e00)));
+            CHECK(std::signbit(impl::half_bits_to_float(0x8000)));
+        }
+
+        TEST_CASE("float to half")
+        {
+            CHECK_EQ(impl::float_to_half_bits(1.f), 0x3c00);
+            CHECK_EQ(impl::float_to_half_bits(-2.f), 0xc000);
+            CHECK_EQ(impl::float_to_half_bits(65504.f), 0x7bff);
+            CHECK_EQ(impl::float_to_half_bits(1e6f), 0x7c00);
+            CHECK_EQ(impl::float_to_half_bits(std::ldexp(1.f, -24)), 0x0001);
+            CHECK_EQ(impl::float_to_half_bits(std::ldexp(1.f, -26)), 0x0000);
+            CHECK_EQ(impl::float_to_half_bits(std::numeric_limits<float>::quiet_NaN()), 0x7e00);
+            // Ties round to even
+            CHECK_EQ(impl::float_to_half_bits(1.f + std::ldexp(1.f, -11)), 0x3c00);
+            CHECK_EQ(impl::float_to_half_bits(1.f + 3.f * std::ldexp(1.f, -11)), 0x3c02);
+        }
+
+        TEST_CASE("round trip of every half")
+        {
+            const std::vector<float16_t> halves = all_halves();
+            std::vector<float> floats(halves.size());
+            convert_float16_to_float32(halves, floats);
+            std::vector<float16_t> back(halves.size());
+            convert_float32_to_float16(floats, back);
+            for (std::size_t i = 0; i < halves.size(); ++i)
+            {
+                const auto bits = std::bit_cast<std::uint16_t>(halves[i]);
+                REQUIRE(same_float(floats[i], impl::half_bits_to_float(bits)));
+                if (!std::isnan(floats[i]))
+                {
+                    REQUIRE_EQ(std::bit_cast<std::uint16_t>(back[i]), bits);
+                }
+            }
+        }
+
+        TEST_CASE("software and dispatched conversions agree")
+        {
+            std::vector<float> floats;
+            for (std::uint32_t bits = 0; bits < 0xffffffffu - 0x10001u; bits += 0x10001u)
+            {
+                floats.push_back(std::bit_cast<float>(bits));
+            }
+            std::vector<float16_t> dispatched(floats.size());
+            std::vector<float16_t> software(floats.size());
+            convert_float32_to_float16(floats, dispatched);
+            impl::software_float32_to_float16(floats.data(), software.data(), floats.size());
+            for (std::size_t i = 0; i < floats.size(); ++i)
+            {
+                if (!std::isnan(floats[i]))
+                {
+                    REQUIRE_EQ(std::bit_cast<std::uint16_t>(dispatched[i]), std::bit_cast<std::uint16_t>(software[i]));
+                }
+            }
+        }
+
+        TEST_CASE("typed_array")
+        {
+            const std::vector<float> values = {1.f, 0.5f, -3.25f, 100.f, 7.f};
+            array_data::bitmap_type bitmap(values.size(), true);
+            bitmap.set(3, false);
+            const typed_array<float> array(make_default_array_data<fixed_size_layout<float>>(values, bitmap, 1));
+            const typed_array<float16_t> halves = to_float16_array(array);
+            REQUIRE_EQ(halves.size(), 4);
+            CHECK_FALSE(halves[2].has_value());
+            const typed_array<float> floats = to_float32_array(halves);
+            REQUIRE_EQ(floats.size(), 4);
+            CHECK_EQ(floats[0].value(), 0.5f);
+            CHECK_EQ(floats[1].value(), -3.25f);
+            CHECK_FALSE(floats[2].has_value());
+            CHECK_EQ(floats[3].value(), 7.f);
+        }
+    }
+}
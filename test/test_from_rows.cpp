@@ -0,0 +1,175 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "sparrow/from_rows.hpp"
+#include "sparrow/typed_array.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        struct trade
+        {
+            std::int64_t id;
+            double price;
+            std::string symbol;
+            std::optional<std::int32_t> qty;
+            bool buy;
+        };
+
+        static_assert(impl::aggregate_field_count<trade>() == 5);
+
+        std::vector<trade> make_trades(std::size_t count)
+        {
+            std::vector<trade> res;
+            res.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto id = static_cast<std::int64_t>(i);
+                res.push_back(
+                    {id,
+                     static_cast<double>(i) * 0.5,
+                     std::string(i % 7, 'a'),
+                     i % 3 == 0 ? std::nullopt : std::optional<std::int32_t>(static_cast<std::int32_t>(i)),
+                     i % 2 == 0}
+                );
+            }
+            return res;
+        }
+
+        template <class T>
+        void check_same_values(const array_data& lhs, const array_data& rhs)
+        {
+            const typed_array<T> lhs_array(lhs);
+            const typed_array<T> rhs_array(rhs);
+            REQUIRE_EQ(lhs_array.size(), rhs_array.size());
+            for (std::size_t i = 0; i < lhs_array.size(); ++i)
+            {
+                REQUIRE_EQ(lhs_array[i].has_value(), rhs_array[i].has_value());
+                if (lhs_array[i].has_value())
+                {
+                    CHECK_EQ(lhs_array[i].value(), rhs_array[i].value());
+                }
+            }
+        }
+
+        void check_same_columns(const std::vector<array_data>& lhs, const std::vector<array_data>& rhs)
+        {
+            REQUIRE_EQ(lhs.size(), rhs.size());
+            check_same_values<std::int64_t>(lhs[0], rhs[0]);
+            check_same_values<double>(lhs[1], rhs[1]);
+            check_same_values<std::string>(lhs[2], rhs[2]);
+            check_same_values<std::int32_t>(lhs[3], rhs[3]);
+            check_same_values<bool>(lhs[4], rhs[4]);
+        }
+    }
+
+    TEST_SUITE("from_rows")
+    {
+        TEST_CASE("aggregates")
+        {
+            const std::vector<trade> rows = make_trades(10);
+            const std::vector<array_data> columns = columns_from_rows(rows, 2);
+            REQUIRE_EQ(columns.size(), 5);
+            CHECK_EQ(columns[0].type.id(), data_type::INT64);
+            CHECK_EQ(columns[2].type.id(), data_type::STRING);
+            CHECK_EQ(columns[4].type.id(), data_type::BOOL);
+
+            const typed_array<std::int64_t> ids(columns[0]);
+            const typed_array<double> prices(columns[1]);
+            const typed_array<std::string> symbols(columns[2]);
+            const typed_array<std::int32_t> quantities(columns[3]);
+            const typed_array<bool> sides(columns[4]);
+            CHECK_EQ(columns[0].bitmap.null_count(), 0);
+            CHECK_EQ(columns[3].bitmap.null_count(), 4);
+            for (std::size_t i = 0; i < rows.size(); ++i)
+            {
+                CHECK_EQ(ids[i].value(), rows[i].id);
+                CHECK_EQ(prices[i].value(), rows[i].price);
+                CHECK_EQ(symbols[i].value(), rows[i].symbol);
+                CHECK_EQ(quantities[i].has_value(), rows[i].qty.has_value());
+                if (rows[i].qty.has_value())
+                {
+                    CHECK_EQ(quantities[i].value(), *rows[i].qty);
+                }
+                CHECK_EQ(sides[i].value(), rows[i].buy);
+            }
+        }
+
+        TEST_CASE("tuples")
+        {
+            const std::vector<std::tuple<std::string_view, std::uint8_t>> rows = {
+                {"one", 1},
+                {"", 2},
+                {"three", 3}
+            };
+            const std::vector<array_data> columns = columns_from_rows(rows);
+            REQUIRE_EQ(columns.size(), 2);
+            const typed_array<std::string> names(columns[0]);
+            const typed_array<std::uint8_t> values(columns[1]);
+            REQUIRE_EQ(names.size(), 3);
+            CHECK_EQ(names[0].value(), "one");
+            CHECK_EQ(names[1].value(), "");
+            CHECK_EQ(names[2].value(), "three");
+            CHECK_EQ(values[2].value(), 3);
+        }
+
+        TEST_CASE("empty")
+        {
+            const std::vector<trade> rows;
+            const std::vector<array_data> columns = columns_from_rows(rows);
+            REQUIRE_EQ(columns.size(), 5);
+            CHECK_EQ(array_data_size(columns[2]), 0);
+            CHECK_EQ(array_data_size(columns[3]), 0);
+            check_same_columns(columns, columns_from_rows(rows, parallel_options{.morsel_size = 64}));
+        }
+
+        TEST_CASE("parallel")
+        {
+            const std::vector<trade> rows = make_trades(1000);
+            const std::vector<array_data> sequential = columns_from_rows(rows);
+            thread_pool pool(4);
+            const std::vector<array_data> parallel = columns_from_rows(
+                rows,
+                parallel_options{.morsel_size = 100, .pool = &pool},
+                1
+            );
+            check_same_columns(sequential, parallel);
+        }
+
+        TEST_CASE("record_batch_from_rows")
+        {
+            const std::vector<trade> rows = make_trades(5);
+            const record_batch batch = record_batch_from_rows(rows, {"id", "price", "symbol", "qty", "buy"});
+            CHECK_EQ(batch.num_rows(), 5);
+            CHECK_EQ(batch.get_schema()[2].type, data_type::STRING);
+            CHECK_FALSE(batch.get_schema()[0].nullable);
+            CHECK(batch.get_schema()[3].nullable);
+            CHECK_EQ(batch.column("price").get<double>()[4].value(), 2.);
+
+            CHECK_THROWS_AS(record_batch_from_rows(rows, {"id", "price"}), std::invalid_argument);
+        }
+    }
+}
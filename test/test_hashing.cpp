@@ -0,0 +1,198 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/hashing.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::check_array;
+        using test::N;
+
+        void check_membership(const packed_boolean_array& res, const std::vector<std::optional<bool>>& expected)
+        {
+            REQUIRE_EQ(res.size(), expected.size());
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                CHECK_EQ(res[i], expected[i]);
+            }
+        }
+
+        using int_values = std::vector<std::optional<std::int64_t>>;
+        using string_values = std::vector<std::optional<std::string>>;
+        using count_values = std::vector<std::optional<std::int64_t>>;
+    }
+
+    TEST_SUITE("hashing")
+    {
+        TEST_CASE("hash_set_index")
+        {
+            impl::hash_set_index<std::string> set;
+            std::vector<std::string> words;
+            for (std::size_t i = 0; i < 1000; ++i)
+            {
+                words.push_back("word_" + std::to_string(i));
+            }
+            for (std::size_t i = 0; i < words.size(); ++i)
+            {
+                const auto [id, inserted] = set.insert(words[i]);
+                CHECK_EQ(id, i);
+                CHECK(inserted);
+            }
+            CHECK_EQ(set.size(), words.size());
+            CHECK_EQ(set.insert(words[17]).first, 17);
+            CHECK_FALSE(set.insert(words[17]).second);
+            for (std::size_t i = 0; i < words.size(); ++i)
+            {
+                CHECK_EQ(set.find(words[i]), i);
+            }
+            CHECK_EQ(set.find("missing"), impl::hash_set_index<std::string>::npos);
+        }
+
+        TEST_CASE("unique")
+        {
+            SUBCASE("small range integers")
+            {
+                const auto array = make_array<std::int64_t>({3, 1, N, 3, -2, 1, N});
+                check_array(unique(array), int_values{3, 1, N, -2});
+            }
+
+            SUBCASE("large range integers")
+            {
+                const auto array = make_array<std::int64_t>(
+                    {std::numeric_limits<std::int64_t>::max(), 0, N, std::numeric_limits<std::int64_t>::min(), 0}
+                );
+                check_array(
+                    unique(array),
+                    int_values{std::numeric_limits<std::int64_t>::max(), 0, N, std::numeric_limits<std::int64_t>::min()}
+                );
+            }
+
+            SUBCASE("floating point")
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                const auto res = unique(make_array<double>({0., -0., nan, 1.5, -nan}));
+                REQUIRE_EQ(res.size(), 3);
+                CHECK_EQ(res[0].value(), 0.);
+                CHECK(std::isnan(res[1].value()));
+                CHECK_EQ(res[2].value(), 1.5);
+            }
+
+            SUBCASE("strings")
+            {
+                const auto array = make_array<std::string>({"skipped", "b", "a", N, "b", "", "a"}, 1);
+                check_array(unique(array), string_values{"b", "a", N, ""});
+            }
+
+            SUBCASE("without nulls")
+            {
+                const auto res = unique(make_array<std::uint8_t>({7, 7, 7}));
+                CHECK_EQ(res.get_data().bitmap.null_count(), 0);
+                check_array(res, std::vector<std::optional<std::uint8_t>>{7});
+            }
+        }
+
+        TEST_CASE("value_counts")
+        {
+            SUBCASE("integers")
+            {
+                const auto res = value_counts(make_array<std::int32_t>({N, 5, 4, 5, N, 5}));
+                check_array(res.values, std::vector<std::optional<std::int32_t>>{N, 5, 4});
+                check_array(res.counts, count_values{2, 3, 1});
+            }
+
+            SUBCASE("strings")
+            {
+                const auto res = value_counts(make_array<std::string>({"x", "y", "x", "x"}));
+                check_array(res.values, string_values{"x", "y"});
+                check_array(res.counts, count_values{3, 1});
+            }
+
+            SUBCASE("large")
+            {
+                std::vector<std::optional<std::uint32_t>> values;
+                for (std::uint32_t i = 0; i < 5000; ++i)
+                {
+                    values.emplace_back((i * 7919u) % 997u);
+                }
+                const auto res = value_counts(make_array<std::uint32_t>(values));
+                REQUIRE_EQ(res.values.size(), 997);
+                std::int64_t total = 0;
+                for (std::size_t i = 0; i < res.counts.size(); ++i)
+                {
+                    total += res.counts[i].value();
+                }
+                CHECK_EQ(total, 5000);
+            }
+        }
+
+        TEST_CASE("is_in")
+        {
+            SUBCASE("small range integers")
+            {
+                const auto array = make_array<std::int16_t>({1, 2, N, 4, -7});
+                const auto value_set = make_array<std::int16_t>({4, N, -7, 4});
+                check_membership(is_in(array, value_set), {false, false, N, true, true});
+                check_array(index_in(array, value_set), std::vector<std::optional<std::int32_t>>{N, N, N, 0, 2});
+            }
+
+            SUBCASE("large range integers")
+            {
+                const auto array = make_array<std::uint64_t>({0, 1, std::numeric_limits<std::uint64_t>::max()});
+                const auto value_set = make_array<std::uint64_t>({std::numeric_limits<std::uint64_t>::max(), 0});
+                check_membership(is_in(array, value_set), {true, false, true});
+                check_array(index_in(array, value_set), std::vector<std::optional<std::int32_t>>{1, N, 0});
+            }
+
+            SUBCASE("strings")
+            {
+                const auto array = make_array<std::string>({"apple", "kiwi", N, "pear"});
+                const auto value_set = make_array<std::string>({"pear", "apple"});
+                check_membership(is_in(array, value_set), {true, false, N, true});
+                check_array(index_in(array, value_set), std::vector<std::optional<std::int32_t>>{1, N, N, 0});
+            }
+        }
+
+        TEST_CASE("dictionary")
+        {
+            using sub_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+            using layout = dictionary_encoded_layout<std::uint64_t, sub_layout>;
+            const std::vector<std::string> words = {"a", "b", "a", "c", "b"};
+            array_data array = make_default_array_data<layout>(words, array_data::bitmap_type(words.size(), true), 0);
+            array.bitmap.set(3, false);
+            const auto value_set = make_array<std::string>({"c", "b"});
+
+            check_membership(dictionary_is_in(array, value_set), {false, true, false, N, true});
+            check_array(
+                dictionary_index_in(array, value_set),
+                std::vector<std::optional<std::int32_t>>{N, 1, N, N, 1}
+            );
+            CHECK_THROWS_AS(dictionary_is_in(value_set.get_data(), value_set), std::invalid_argument);
+        }
+    }
+}
@@ -0,0 +1,324 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/cast.hpp"
+#include "sparrow/comparison.hpp"
+#include "sparrow/hashing.hpp"
+#include "sparrow/parallel.hpp"
+#include "sparrow/quantile_sketch.hpp"
+#include "sparrow/sketch.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+
+        // Pseudo-random values in [0, 1000), every seventh value being null
+        typed_array<std::int64_t> make_values(std::size_t size)
+        {
+            std::vector<std::optional<std::int64_t>> values;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (i % 7 == 3)
+                {
+                    values.emplace_back();
+                }
+                else
+                {
+                    values.emplace_back(static_cast<std::int64_t>((i * 2654435761u) % 1000u));
+                }
+            }
+            return make_array(values);
+        }
+
+        void check_same(const packed_boolean_array& lhs, const packed_boolean_array& rhs)
+        {
+            REQUIRE_EQ(lhs.size(), rhs.size());
+            for (std::size_t i = 0; i < lhs.size(); ++i)
+            {
+                CHECK_EQ(lhs[i], rhs[i]);
+            }
+        }
+    }
+
+    TEST_SUITE("parallel")
+    {
+        TEST_CASE("thread_pool")
+        {
+            thread_pool pool(4);
+            CHECK_EQ(pool.thread_count(), 4);
+
+            SUBCASE("every task runs once")
+            {
+                for (const std::size_t task_count : {0u, 1u, 3u, 1000u})
+                {
+                    std::vector<std::atomic<int>> runs(task_count);
+                    pool.run(
+                        task_count,
+                        [&runs](std::size_t i)
+                        {
+                            ++runs[i];
+                        }
+                    );
+                    for (const std::atomic<int>& r : runs)
+                    {
+                        CHECK_EQ(r.load(), 1);
+                    }
+                }
+            }
+
+            SUBCASE("nested batches")
+            {
+                std::atomic<std::size_t> count = 0;
+                pool.run(
+                    8,
+                    [&pool, &count](std::size_t)
+                    {
+                        pool.run(
+                            8,
+                            [&count](std::size_t)
+                            {
+                                ++count;
+                            }
+                        );
+                    }
+                );
+                CHECK_EQ(count.load(), 64);
+            }
+
+            SUBCASE("exceptions")
+            {
+                CHECK_THROWS_AS(
+                    pool.run(
+                        100,
+                        [](std::size_t i)
+                        {
+                            if (i == 42)
+                            {
+                                throw std::runtime_error("task failed");
+                            }
+                        }
+                    ),
+                    std::runtime_error
+                );
+                std::atomic<std::size_t> count = 0;
+                pool.run(
+                    100,
+                    [&count](std::size_t)
+                    {
+                        ++count;
+                    }
+                );
+                CHECK_EQ(count.load(), 100);
+            }
+        }
+
+        TEST_CASE("parallel_for_chunks")
+        {
+            thread_pool pool(3);
+            const auto array = make_values(1000);
+            std::vector<std::atomic<int>> visits(array.size());
+            std::vector<std::atomic<int>> morsels(8);
+            parallel_for_chunks(
+                array,
+                100,
+                [&visits, &morsels](const morsel& m)
+                {
+                    CHECK_EQ(m.begin, m.index * 128);
+                    ++morsels[m.index];
+                    for (std::size_t i = m.begin; i < m.end; ++i)
+                    {
+                        ++visits[i];
+                    }
+                },
+                pool
+            );
+            for (const std::atomic<int>& v : visits)
+            {
+                CHECK_EQ(v.load(), 1);
+            }
+            for (const std::atomic<int>& m : morsels)
+            {
+                CHECK_EQ(m.load(), 1);
+            }
+        }
+
+        TEST_CASE("make_bitmap_from_words")
+        {
+            thread_pool pool(3);
+            const parallel_options options{100, &pool};
+            const auto word_at = [](std::size_t i)
+            {
+                return bitmap_word{0x5555555555555555u} << (i % 2u);
+            };
+            const auto bitmap = make_bitmap_from_words(1000, word_at, options);
+            const auto expected = make_bitmap_from_words(1000, word_at);
+            REQUIRE_EQ(bitmap.size(), expected.size());
+            CHECK_EQ(bitmap.null_count(), expected.null_count());
+            for (std::size_t i = 0; i < bitmap.size(); ++i)
+            {
+                CHECK_EQ(bitmap.test(i), expected.test(i));
+            }
+
+            // The storage of the bitmap is released when a word cannot be computed
+            const auto throwing_word_at = [](std::size_t i) -> bitmap_word
+            {
+                if (i == 7u)
+                {
+                    throw std::runtime_error("word");
+                }
+                return 0u;
+            };
+            CHECK_THROWS_AS(make_bitmap_from_words(1000, throwing_word_at, options), std::runtime_error);
+            CHECK_THROWS_AS(make_bitmap_from_words(1000, throwing_word_at), std::runtime_error);
+        }
+
+        TEST_CASE("parallel_reduce")
+        {
+            // Floating point additions are not associative: the result is deterministic
+            // only because the partial sums are folded in the order of the morsels.
+            const auto reduce = [](thread_pool& pool)
+            {
+                return parallel_reduce(
+                    100000,
+                    parallel_options{256, &pool},
+                    0.,
+                    [](const morsel& m)
+                    {
+                        double res = 0.;
+                        for (std::size_t i = m.begin; i < m.end; ++i)
+                        {
+                            res += 1. / static_cast<double>(i + 1u);
+                        }
+                        return res;
+                    },
+                    [](double& res, double morsel_res)
+                    {
+                        res += morsel_res;
+                    }
+                );
+            };
+            thread_pool single(1);
+            thread_pool pool(4);
+            const double expected = reduce(single);
+            for (int i = 0; i < 5; ++i)
+            {
+                CHECK_EQ(reduce(pool), expected);
+            }
+        }
+
+        TEST_CASE("kernels")
+        {
+            thread_pool pool(4);
+            const parallel_options options{1000, &pool};
+            const auto array = make_values(10000);
+
+            SUBCASE("compare")
+            {
+                check_same(compare(array, 500, std::less<>{}, options), compare(array, 500, std::less<>{}));
+                const typed_array<std::int64_t> shifted(make_default_array_data<fixed_size_layout<std::int64_t>>(
+                    std::vector<std::int64_t>(10000, 300),
+                    array_data::bitmap_type(10000, true),
+                    0
+                ));
+                check_same(
+                    compare(array, shifted, std::greater_equal<>{}, options),
+                    compare(array, shifted, std::greater_equal<>{})
+                );
+                const packed_boolean_array no_nulls = compare(shifted, 300, std::equal_to<>{}, options);
+                CHECK_EQ(no_nulls.validity().null_count(), 0);
+            }
+
+            SUBCASE("cast")
+            {
+                const auto res = cast<std::int16_t>(array, cast_mode::safe, options);
+                const auto expected = cast<std::int16_t>(array);
+                REQUIRE_EQ(res.size(), expected.size());
+                for (std::size_t i = 0; i < res.size(); ++i)
+                {
+                    REQUIRE_EQ(res[i].has_value(), expected[i].has_value());
+                    if (expected[i].has_value())
+                    {
+                        CHECK_EQ(res[i].value(), expected[i].value());
+                    }
+                }
+                CHECK_THROWS_AS(cast<std::int8_t>(array, cast_mode::safe, options), std::overflow_error);
+                CHECK_EQ(cast<std::uint64_t>(array, cast_mode::safe, options).size(), array.size());
+            }
+
+            SUBCASE("sketches")
+            {
+                hyperloglog hll;
+                hll.update(array);
+                hyperloglog parallel_hll;
+                parallel_hll.update(array, options);
+                CHECK_EQ(parallel_hll, hll);
+
+                count_min_sketch cms(256, 3);
+                cms.update(array);
+                count_min_sketch parallel_cms(256, 3);
+                parallel_cms.update(array, options);
+                CHECK_EQ(parallel_cms, cms);
+
+                tdigest digest;
+                digest.update(array, options);
+                CHECK_EQ(digest.count(), static_cast<double>(cms.total_count()));
+                CHECK_LT(std::abs(digest.quantile(0.5) - 500.), 20.);
+                tdigest other;
+                other.update(array, parallel_options{1000, nullptr});
+                CHECK_EQ(other.quantile(0.9), digest.quantile(0.9));
+            }
+
+            SUBCASE("hashing")
+            {
+                CHECK_EQ(unique(array, options), unique(array));
+                const auto counts = value_counts(array, options);
+                const auto expected_counts = value_counts(array);
+                CHECK_EQ(counts.values, expected_counts.values);
+                CHECK_EQ(counts.counts, expected_counts.counts);
+
+                const auto value_set = make_array<std::int64_t>({999, std::nullopt, 3, 500, 3});
+                check_same(is_in(array, value_set, options), is_in(array, value_set));
+                CHECK_EQ(index_in(array, value_set, options), index_in(array, value_set));
+
+                // Values first met in a later morsel than the first null, and high
+                // cardinality strings spread over every partition
+                std::vector<std::optional<std::string>> words;
+                for (std::size_t i = 0; i < 5000; ++i)
+                {
+                    words.push_back(i == 1500 ? std::nullopt : std::optional(std::to_string(i * i % 3001)));
+                }
+                const auto strings = make_array(words);
+                CHECK_EQ(unique(strings, options), unique(strings));
+                CHECK_EQ(value_counts(strings, options).counts, value_counts(strings).counts);
+                CHECK_EQ(unique(make_array<double>({}), options).size(), 0);
+            }
+        }
+    }
+}
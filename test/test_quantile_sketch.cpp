@@ -0,0 +1,175 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/quantile_sketch.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::N;
+
+        // A permutation of [0, count), with a null after every value
+        typed_array<std::int64_t> make_shuffled(std::int64_t count)
+        {
+            std::vector<std::optional<std::int64_t>> values;
+            for (std::int64_t i = 0; i < count; ++i)
+            {
+                values.emplace_back((i * 7919) % count);
+                values.emplace_back();
+            }
+            return make_array(values);
+        }
+
+        // Checks that the rank of the estimate of each quantile is close to the quantile
+        void check_quantiles(const tdigest& digest, double count)
+        {
+            for (const double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999})
+            {
+                const double estimate = digest.quantile(q);
+                const double tolerance = q < 0.05 || q > 0.95 ? 0.002 : 0.01;
+                CHECK_LT(std::abs(estimate / count - q), tolerance);
+            }
+        }
+    }
+
+    TEST_SUITE("quantile_sketch")
+    {
+        TEST_CASE("empty")
+        {
+            const tdigest digest;
+            CHECK(std::isnan(digest.quantile(0.5)));
+            CHECK(std::isnan(digest.min()));
+            CHECK_EQ(digest.count(), 0.);
+        }
+
+        TEST_CASE("small")
+        {
+            tdigest digest;
+            digest.update(make_array<double>({3., N, 1., std::nan(""), 2.}));
+            CHECK_EQ(digest.count(), 3.);
+            CHECK_EQ(digest.min(), 1.);
+            CHECK_EQ(digest.max(), 3.);
+            CHECK_EQ(digest.quantile(0.), 1.);
+            CHECK_EQ(digest.quantile(0.5), 2.);
+            CHECK_EQ(digest.quantile(1.), 3.);
+        }
+
+        TEST_CASE("accuracy")
+        {
+            const std::int64_t count = 100000;
+            tdigest digest;
+            digest.update(make_shuffled(count));
+            CHECK_EQ(digest.count(), static_cast<double>(count));
+            CHECK_LE(digest.centroids().size(), 100);
+            CHECK_EQ(digest.min(), 0.);
+            CHECK_EQ(digest.max(), static_cast<double>(count - 1));
+            check_quantiles(digest, static_cast<double>(count));
+        }
+
+        TEST_CASE("merge")
+        {
+            const std::int64_t count = 100000;
+            const auto array = make_shuffled(count);
+            const std::size_t part_size = array.size() / 4;
+            tdigest digest;
+            for (std::size_t part = 0; part < 4; ++part)
+            {
+                std::vector<std::optional<std::int64_t>> values;
+                for (std::size_t i = part * part_size; i < (part + 1) * part_size; ++i)
+                {
+                    values.push_back(array[i].has_value() ? std::optional(array[i].value()) : std::nullopt);
+                }
+                tdigest part_digest;
+                part_digest.update(make_array(values));
+                digest.merge(part_digest);
+            }
+            CHECK_EQ(digest.count(), static_cast<double>(count));
+            check_quantiles(digest, static_cast<double>(count));
+
+            digest.merge(digest);
+            CHECK_EQ(digest.count(), static_cast<double>(2 * count));
+            check_quantiles(digest, static_cast<double>(count));
+        }
+
+        TEST_CASE("serialize")
+        {
+            tdigest digest(50.);
+            digest.update(make_array<float>({4.f, 1.5f, N, -2.f}));
+            digest.update(make_shuffled(5000));
+            const tdigest res = tdigest::deserialize(digest.serialize());
+            CHECK_EQ(res.compression(), 50.);
+            CHECK_EQ(res.min(), -2.);
+            CHECK_EQ(res.count(), digest.count());
+            CHECK_EQ(res.quantile(0.3), digest.quantile(0.3));
+            CHECK_THROWS_AS(tdigest::deserialize(hyperloglog().serialize()), std::invalid_argument);
+
+            const tdigest empty = tdigest::deserialize(tdigest().serialize());
+            CHECK_EQ(empty.count(), 0.);
+            CHECK(std::isnan(empty.min()));
+
+            SUBCASE("invalid fields")
+            {
+                // Header, compression, min, max, size, then the mean and weight of each centroid
+                const auto with_double =
+                    [](std::vector<std::uint8_t> bytes, std::size_t position, double value)
+                {
+                    const auto bits = std::bit_cast<std::uint64_t>(value);
+                    for (std::size_t i = 0; i < 8; ++i)
+                    {
+                        bytes[position + i] = static_cast<std::uint8_t>(bits >> (8 * i));
+                    }
+                    return bytes;
+                };
+                const auto with_bounds =
+                    [&with_double](std::vector<std::uint8_t> bytes, double min, double max)
+                {
+                    return with_double(with_double(std::move(bytes), 10, min), 18, max);
+                };
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                const double inf = std::numeric_limits<double>::infinity();
+                const std::vector<std::uint8_t> bytes = digest.serialize();
+                CHECK_EQ(tdigest::deserialize(with_bounds(bytes, -2., 4999.)).min(), -2.);
+                CHECK_THROWS_AS(tdigest::deserialize(with_bounds(bytes, 5., -2.)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_bounds(bytes, nan, 4999.)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_bounds(bytes, -2., nan)), std::invalid_argument);
+                CHECK_THROWS_AS(
+                    tdigest::deserialize(with_bounds(tdigest().serialize(), 1., 0.)),
+                    std::invalid_argument
+                );
+
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 2, 1e300)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 2, inf)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 34, nan)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 42, inf)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 42, nan)), std::invalid_argument);
+                CHECK_THROWS_AS(tdigest::deserialize(with_double(bytes, 34, 1e9)), std::invalid_argument);
+            }
+        }
+    }
+}
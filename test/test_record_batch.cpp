@@ -0,0 +1,227 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/record_batch.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::N;
+
+        template <class T>
+        array make_array(const std::vector<std::optional<T>>& values)
+        {
+            return array(test::make_nullable_array_data(values));
+        }
+
+        record_batch make_batch()
+        {
+            const schema batch_schema(
+                {{.name = "id", .type = data_type::INT32, .nullable = false},
+                 {.name = "price", .type = data_type::DOUBLE, .metadata = {{"unit", "EUR"}}},
+                 {.name = "name", .type = data_type::STRING},
+                 {.name = "flag", .type = data_type::BOOL}},
+                {{"source", "test"}}
+            );
+            return record_batch(
+                batch_schema,
+                {make_array<std::int32_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}),
+                 make_array<double>({0.5, N, 2.5, 3.5, N, 5.5, 6.5, 7.5, 8.5, 9.5}),
+                 make_array<std::string>({"a", "bb", N, "dddd", "", "ffffff", "g", N, "ii", "j"}),
+                 make_array<bool>({true, false, true, N, true, true, false, false, N, true})}
+            );
+        }
+
+        // Checks that the rows of rhs are the rows of lhs starting at first
+        void check_rows(const record_batch& lhs, const record_batch& rhs, std::size_t first)
+        {
+            REQUIRE_EQ(lhs.num_columns(), rhs.num_columns());
+            for (std::size_t row = 0; row < rhs.num_rows(); ++row)
+            {
+                for (std::size_t i = 0; i < rhs.num_columns(); ++i)
+                {
+                    CHECK_EQ(rhs.value(i, row), lhs.value(i, first + row));
+                }
+            }
+        }
+
+        template <class T>
+        std::optional<T> get(const record_batch& batch, std::size_t i, std::size_t row)
+        {
+            const auto ref = std::get<typename typed_array<T>::const_reference>(batch.value(i, row));
+            return ref.has_value() ? std::optional<T>(ref.value()) : std::nullopt;
+        }
+    }
+
+    TEST_SUITE("record_batch")
+    {
+        TEST_CASE("constructor")
+        {
+            const record_batch batch = make_batch();
+            CHECK_EQ(batch.num_rows(), 10);
+            CHECK_EQ(batch.num_columns(), 4);
+            CHECK_EQ(batch.get_schema().field_index("name"), 2);
+            CHECK_FALSE(batch.get_schema().field_index("other").has_value());
+            CHECK_EQ(batch.column("price").size(), 10);
+            CHECK_THROWS_AS(batch.column("other"), std::out_of_range);
+            CHECK_EQ(get<double>(batch, 1, 2), 2.5);
+            CHECK_EQ(get<std::string>(batch, 2, 3), "dddd");
+            CHECK_FALSE(get<bool>(batch, 3, 8).has_value());
+
+            const schema one_field({{.name = "id", .type = data_type::INT32}});
+            CHECK_THROWS_AS(
+                record_batch(one_field, {make_array<std::int32_t>({1}), make_array<std::int32_t>({2})}),
+                std::invalid_argument
+            );
+            CHECK_THROWS_AS(record_batch(one_field, {make_array<double>({1.})}), std::invalid_argument);
+            const schema two_fields(
+                {{.name = "a", .type = data_type::INT32}, {.name = "b", .type = data_type::INT32}}
+            );
+            CHECK_THROWS_AS(
+                record_batch(two_fields, {make_array<std::int32_t>({1}), make_array<std::int32_t>({2, 3})}),
+                std::invalid_argument
+            );
+        }
+
+        TEST_CASE("select")
+        {
+            const record_batch batch = make_batch();
+            const std::vector<std::string_view> names = {"name", "id"};
+            const record_batch projected = batch.select(std::span<const std::string_view>(names));
+            REQUIRE_EQ(projected.num_columns(), 2);
+            CHECK_EQ(projected.get_schema()[0].name, "name");
+            CHECK_EQ(projected.get_schema().metadata(), batch.get_schema().metadata());
+            CHECK_EQ(&projected.column(0).get<std::string>(), &batch.column(2).get<std::string>());
+            CHECK_EQ(get<std::int32_t>(projected, 1, 4), 4);
+
+            const std::vector<std::string_view> unknown = {"other"};
+            CHECK_THROWS_AS(batch.select(std::span<const std::string_view>(unknown)), std::out_of_range);
+        }
+
+        TEST_CASE("slice")
+        {
+            const record_batch batch = make_batch();
+            const record_batch slice = batch.slice(2, 6).slice(1, 4);
+            CHECK_EQ(slice.num_rows(), 4);
+            CHECK_EQ(slice.offset(), 3);
+            CHECK_EQ(&slice.column(1).get<double>(), &batch.column(1).get<double>());
+            check_rows(batch, slice, 3);
+
+            const record_batch compacted = slice.compact();
+            CHECK_EQ(compacted.offset(), 0);
+            CHECK_EQ(compacted.column(0).size(), 4);
+            CHECK_EQ(compacted.column(2).size(), 4);
+            check_rows(batch, compacted, 3);
+            CHECK_EQ(get<std::string>(compacted, 2, 2), "ffffff");
+
+            const record_batch whole = batch.compact();
+            CHECK_EQ(&whole.column(0).get<std::int32_t>(), &batch.column(0).get<std::int32_t>());
+        }
+
+        TEST_CASE("C data interface")
+        {
+            const record_batch batch = make_batch();
+
+            SUBCASE("export")
+            {
+                const arrow_schema_unique_ptr c_schema = to_arrow_schema(batch.get_schema());
+                CHECK_EQ(std::string_view(c_schema->format), "+s");
+                REQUIRE_EQ(c_schema->n_children, 4);
+                CHECK_EQ(std::string_view(c_schema->children[0]->format), "i");
+                CHECK_EQ(std::string_view(c_schema->children[2]->format), "U");
+                CHECK_EQ(std::string_view(c_schema->children[3]->name), "flag");
+                CHECK_EQ(c_schema->children[0]->flags, 0);
+                CHECK_EQ(c_schema->children[1]->flags, static_cast<std::int64_t>(ArrowFlag::NULLABLE));
+
+                const arrow_array_unique_ptr c_array = to_arrow_array(batch);
+                CHECK_EQ(c_array->length, 10);
+                REQUIRE_EQ(c_array->n_children, 4);
+                const ArrowArray& price = *c_array->children[1];
+                CHECK_EQ(price.n_buffers, 2);
+                CHECK_EQ(price.null_count, -1);
+                CHECK_EQ(price.buffers[1], batch.column(1).get<double>().get_data().buffers[0].data());
+                CHECK_EQ(c_array->children[0]->null_count, 0);
+                CHECK_EQ(c_array->children[0]->buffers[0], nullptr);
+                CHECK_EQ(c_array->children[2]->n_buffers, 3);
+            }
+
+            SUBCASE("round trip")
+            {
+                const arrow_schema_unique_ptr c_schema = to_arrow_schema(batch.get_schema());
+                arrow_array_unique_ptr c_array = to_arrow_array(batch);
+                const record_batch res = from_arrow(*c_array, *c_schema);
+                CHECK_EQ(c_array->release, nullptr);
+                CHECK_EQ(res.get_schema(), batch.get_schema());
+                CHECK_EQ(res.num_rows(), batch.num_rows());
+                check_rows(batch, res, 0);
+            }
+
+            SUBCASE("round trip of a slice")
+            {
+                const record_batch slice = batch.slice(3, 5);
+                const arrow_schema_unique_ptr c_schema = to_arrow_schema(slice.get_schema());
+                arrow_array_unique_ptr c_array = to_arrow_array(slice);
+                CHECK_EQ(c_array->children[0]->offset, 3);
+                const record_batch res = from_arrow(*c_array, *c_schema);
+                CHECK_EQ(res.num_rows(), 5);
+                CHECK_EQ(res.offset(), 0);
+                check_rows(batch, res, 3);
+            }
+
+            SUBCASE("null struct rows")
+            {
+                const arrow_schema_unique_ptr c_schema = to_arrow_schema(batch.get_schema());
+                arrow_array_unique_ptr c_array = to_arrow_array(batch);
+                // Rows 1 and 8 of the struct array are null
+                const std::array<std::uint8_t, 2> validity = {0xFD, 0xFE};
+                std::array<const void*, 1> buffers = {validity.data()};
+                c_array->buffers = buffers.data();
+                c_array->null_count = 2;
+                const record_batch res = from_arrow(*c_array, *c_schema);
+                for (std::size_t i = 0; i < res.num_columns(); ++i)
+                {
+                    CHECK_FALSE(res.column(i).get_data().bitmap.test(1));
+                    CHECK_FALSE(res.column(i).get_data().bitmap.test(8));
+                }
+                CHECK_EQ(get<std::int32_t>(res, 0, 0), 0);
+                CHECK_EQ(get<std::int32_t>(res, 0, 1), std::nullopt);
+                CHECK_EQ(get<double>(res, 1, 2), 2.5);
+                CHECK_EQ(get<std::string>(res, 2, 8), std::nullopt);
+                CHECK_EQ(get<std::string>(res, 2, 9), "j");
+            }
+
+            SUBCASE("unsupported types")
+            {
+                const arrow_schema_unique_ptr c_schema = to_arrow_schema(batch.get_schema());
+                arrow_array_unique_ptr c_array = to_arrow_array(batch);
+                CHECK_THROWS_AS(from_arrow(*c_array, *c_schema->children[0]), std::invalid_argument);
+            }
+        }
+    }
+}
@@ -0,0 +1,201 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/row_format.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        array_data make_data(const std::vector<T>& values, const std::vector<bool>& validity = {})
+        {
+            using layout_type = typename arrow_traits<T>::default_layout;
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (std::size_t i = 0; i < validity.size(); ++i)
+            {
+                bitmap.set(i, validity[i]);
+            }
+            return make_default_array_data<layout_type>(values, bitmap, 0);
+        }
+
+        std::vector<array_data> make_columns(std::size_t size)
+        {
+            std::vector<std::int32_t> ids(size);
+            std::vector<double> prices(size);
+            std::vector<std::string> symbols(size);
+            std::vector<bool> validity(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                ids[i] = static_cast<std::int32_t>(i);
+                prices[i] = static_cast<double>(i) * 0.25;
+                symbols[i] = std::string(i % 5, static_cast<char>('a' + i % 26));
+                validity[i] = i % 4 != 1;
+            }
+            std::vector<array_data> columns;
+            columns.push_back(make_data(ids));
+            columns.push_back(make_data(prices, validity));
+            columns.push_back(make_data(symbols, validity));
+            return columns;
+        }
+
+        template <class T>
+        void check_same_values(const array_data& lhs, const array_data& rhs)
+        {
+            const typed_array<T> lhs_array(lhs);
+            const typed_array<T> rhs_array(rhs);
+            REQUIRE_EQ(lhs_array.size(), rhs_array.size());
+            for (std::size_t i = 0; i < lhs_array.size(); ++i)
+            {
+                REQUIRE_EQ(lhs_array[i].has_value(), rhs_array[i].has_value());
+                if (lhs_array[i].has_value())
+                {
+                    CHECK_EQ(lhs_array[i].value(), rhs_array[i].value());
+                }
+            }
+        }
+    }
+
+    TEST_SUITE("row_format")
+    {
+        TEST_CASE("row_layout")
+        {
+            const row_layout layout({data_type::INT32, data_type::STRING, data_type::BOOL});
+            CHECK_EQ(layout.size(), 3);
+            CHECK_EQ(layout.validity_size(), 1);
+            CHECK_EQ(layout.field_offset(0), 1);
+            CHECK_EQ(layout.field_offset(1), 5);
+            CHECK_EQ(layout.field_offset(2), 5 + sizeof(row_heap_ref));
+            CHECK_EQ(layout.fixed_size(), 6 + sizeof(row_heap_ref));
+            CHECK(layout.is_variable_size(1));
+            CHECK_FALSE(layout.is_variable_size(2));
+
+            CHECK_THROWS_AS(row_layout({data_type::NA}), std::invalid_argument);
+        }
+
+        TEST_CASE("encode_rows")
+        {
+            const std::vector<array_data> columns = make_columns(6);
+            const row_buffer rows = encode_rows(columns);
+            REQUIRE_EQ(rows.size(), 6);
+            const row_layout& layout = rows.layout();
+
+            const std::span<const std::uint8_t> row = rows.row(3);
+            CHECK_EQ(row.size(), layout.fixed_size() + 3u);
+            std::int32_t id = 0;
+            std::memcpy(&id, row.data() + layout.field_offset(0), sizeof(id));
+            CHECK_EQ(id, 3);
+            row_heap_ref ref{};
+            std::memcpy(&ref, row.data() + layout.field_offset(2), sizeof(ref));
+            CHECK_EQ(ref.offset, layout.fixed_size());
+            CHECK_EQ(ref.length, 3);
+            CHECK_EQ(std::string(row.begin() + ref.offset, row.end()), "ddd");
+
+            CHECK(rows.is_valid(1, 0));
+            CHECK_FALSE(rows.is_valid(1, 1));
+            CHECK_FALSE(rows.is_valid(1, 2));
+            CHECK(rows.is_valid(2, 2));
+
+            std::vector<array_data> wrong_sizes = make_columns(6);
+            wrong_sizes.push_back(make_data<std::int8_t>({1, 2}));
+            CHECK_THROWS_AS(encode_rows(wrong_sizes), std::invalid_argument);
+
+            using string_layout = variable_size_binary_layout<std::string, std::string_view, const std::string_view>;
+            using dictionary_layout = dictionary_encoded_layout<std::size_t, string_layout>;
+            std::vector<array_data> dictionary_encoded = make_columns(3);
+            dictionary_encoded.push_back(make_default_array_data<dictionary_layout>(
+                std::vector<std::string>{"x", "y", "x"},
+                array_data::bitmap_type(3, true),
+                0
+            ));
+            CHECK_THROWS_AS(encode_rows(dictionary_encoded), std::invalid_argument);
+        }
+
+        TEST_CASE("typed arrays")
+        {
+            const typed_array<std::int64_t> ids(make_data<std::int64_t>({1, 2, 3}));
+            const typed_array<std::string> names(make_data<std::string>({"a", "bb", "ccc"}));
+            const row_buffer rows = encode_rows(ids, names);
+            CHECK_EQ(rows.layout(), row_layout({data_type::INT64, data_type::STRING}));
+            CHECK_EQ(rows.data().size(), 3u * rows.layout().fixed_size() + 6u);
+        }
+
+        TEST_CASE("round trip")
+        {
+            const std::vector<array_data> columns = make_columns(1000);
+            const row_buffer rows = encode_rows(columns, 100);
+            const std::vector<array_data> decoded = decode_rows(rows, 200);
+            REQUIRE_EQ(decoded.size(), 3);
+            check_same_values<std::int32_t>(decoded[0], columns[0]);
+            check_same_values<double>(decoded[1], columns[1]);
+            check_same_values<std::string>(decoded[2], columns[2]);
+            CHECK_EQ(decoded[1].bitmap.null_count(), 250);
+        }
+
+        TEST_CASE("timestamps")
+        {
+            const auto at = [](std::int64_t nanoseconds)
+            {
+                return timestamp(std::chrono::sys_time<std::chrono::nanoseconds>(std::chrono::nanoseconds(nanoseconds)));
+            };
+            const std::vector<array_data> columns = {
+                make_data<timestamp>({at(5), at(-7), at(1700000000000000000)}, {true, false, true})
+            };
+            const row_buffer rows = encode_rows(columns);
+            CHECK_EQ(rows.layout().fixed_size(), 1u + sizeof(std::int64_t));
+            std::int64_t count = 0;
+            std::memcpy(&count, rows.row(2).data() + rows.layout().field_offset(0), sizeof(count));
+            CHECK_EQ(count, 1700000000000000000);
+
+            const std::vector<array_data> decoded = decode_rows(rows);
+            REQUIRE_EQ(decoded.size(), 1);
+            check_same_values<timestamp>(decoded[0], columns[0]);
+        }
+
+        TEST_CASE("offset columns")
+        {
+            std::vector<array_data> columns = make_columns(10);
+            for (array_data& data : columns)
+            {
+                data.offset = 3;
+            }
+            const std::vector<array_data> decoded = decode_rows(encode_rows(columns));
+            REQUIRE_EQ(array_data_size(decoded[0]), 7);
+            CHECK_EQ(typed_array<std::int32_t>(decoded[0])[0].value(), 3);
+            CHECK_EQ(typed_array<std::string>(decoded[2])[0].value(), "ddd");
+            CHECK_FALSE(typed_array<double>(decoded[1])[2].has_value());
+        }
+
+        TEST_CASE("empty")
+        {
+            const row_buffer rows = encode_rows(make_columns(0));
+            CHECK_EQ(rows.size(), 0);
+            const std::vector<array_data> decoded = decode_rows(rows);
+            REQUIRE_EQ(decoded.size(), 3);
+            CHECK_EQ(array_data_size(decoded[2]), 0);
+        }
+    }
+}
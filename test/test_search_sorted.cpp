@@ -0,0 +1,171 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/search_sorted.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        typed_array<T> make_array(const std::vector<T>& values, std::size_t null_count = 0)
+        {
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (std::size_t i = values.size() - null_count; i < values.size(); ++i)
+            {
+                bitmap.set(i, false);
+            }
+            using layout_type = typename arrow_traits<T>::default_layout;
+            return typed_array<T>(make_default_array_data<layout_type>(values, bitmap, 0));
+        }
+
+        // Sorted values with runs of equal values
+        std::vector<std::int64_t> make_sorted_values(std::size_t size)
+        {
+            std::vector<std::int64_t> res(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                res[i] = static_cast<std::int64_t>(3 * (i / 2));
+            }
+            return res;
+        }
+
+        std::size_t expected_position(const std::vector<std::int64_t>& sorted, std::int64_t value, search_side side)
+        {
+            const auto it = side == search_side::left ? std::lower_bound(sorted.begin(), sorted.end(), value)
+                                                      : std::upper_bound(sorted.begin(), sorted.end(), value);
+            return static_cast<std::size_t>(it - sorted.begin());
+        }
+    }
+
+    TEST_SUITE("search_sorted")
+    {
+        TEST_CASE("scalar")
+        {
+            const auto array = make_array<std::int32_t>({1, 3, 3, 3, 7, 0, 0}, 2);
+            CHECK_EQ(search_sorted(array, 3), 1);
+            CHECK_EQ(search_sorted(array, 3, search_side::right), 4);
+            CHECK_EQ(search_sorted(array, 0), 0);
+            CHECK_EQ(search_sorted(array, 4), 4);
+            CHECK_EQ(search_sorted(array, 100), 5);
+            CHECK_EQ(search_sorted(make_array<std::int32_t>({}), 1), 0);
+        }
+
+        TEST_CASE("sizes")
+        {
+            for (std::size_t size = 0; size < 140; ++size)
+            {
+                const std::vector<std::int64_t> sorted = make_sorted_values(size);
+                const auto array = make_array(sorted);
+                const sorted_search_index<typed_array<std::int64_t>> index(array);
+                CHECK_EQ(index.size(), size);
+                for (std::int64_t value = -1; value < static_cast<std::int64_t>(3 * size / 2 + 2); ++value)
+                {
+                    for (const search_side side : {search_side::left, search_side::right})
+                    {
+                        const std::size_t expected = expected_position(sorted, value, side);
+                        CHECK_EQ(search_sorted(array, value, side), expected);
+                        CHECK_EQ(index.search(value, side), expected);
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("batched")
+        {
+            const std::vector<std::int64_t> sorted = make_sorted_values(1000);
+            const auto array = make_array(sorted);
+            std::vector<std::int64_t> lookups;
+            for (std::int64_t value = -5; value < 1510; value += 7)
+            {
+                lookups.push_back(value);
+            }
+            lookups.push_back(0);
+            const auto values = make_array(lookups, 1);
+            const sorted_search_index<typed_array<std::int64_t>> index(array);
+
+            for (const search_side side : {search_side::left, search_side::right})
+            {
+                const typed_array<std::int64_t> res = search_sorted(array, values, side);
+                const typed_array<std::int64_t> index_res = index.search(values, side);
+                REQUIRE_EQ(res.size(), lookups.size());
+                REQUIRE_EQ(index_res.size(), lookups.size());
+                for (std::size_t i = 0; i + 1 < lookups.size(); ++i)
+                {
+                    const auto expected = static_cast<std::int64_t>(expected_position(sorted, lookups[i], side));
+                    CHECK_EQ(res[i].value(), expected);
+                    CHECK_EQ(index_res[i].value(), expected);
+                }
+                CHECK_FALSE(res[lookups.size() - 1].has_value());
+                CHECK_FALSE(index_res[lookups.size() - 1].has_value());
+            }
+        }
+
+        TEST_CASE("range")
+        {
+            const std::vector<std::int64_t> sorted = make_sorted_values(100);
+            const auto array = make_array(sorted);
+            const sorted_search_index<typed_array<std::int64_t>> index(array);
+            const auto expected = std::make_pair(std::size_t(4), std::size_t(10));
+            CHECK_EQ(search_range(array, std::int64_t(5), std::int64_t(12)), expected);
+            CHECK_EQ(index.range(std::int64_t(5), std::int64_t(12)), expected);
+            const auto empty = search_range(array, std::int64_t(12), std::int64_t(5));
+            CHECK_EQ(empty.first, empty.second);
+        }
+
+        TEST_CASE("strings")
+        {
+            const auto array = make_array<std::string>({"apple", "banana", "banana", "cherry", "fig", ""}, 1);
+            CHECK_EQ(search_sorted(array, std::string("banana")), 1);
+            CHECK_EQ(search_sorted(array, std::string("banana"), search_side::right), 3);
+            CHECK_EQ(search_sorted(array, std::string("zzz")), 5);
+
+            const sorted_search_index<typed_array<std::string>> index(array);
+            CHECK_EQ(index.search(std::string("cherry")), 3);
+            CHECK_EQ(index.search(std::string("a")), 0);
+
+            const auto values = make_array<std::string>({"banana", "date", "aa"});
+            const typed_array<std::int64_t> res = search_sorted(array, values, search_side::right);
+            CHECK_EQ(res[0].value(), 3);
+            CHECK_EQ(res[1].value(), 4);
+            CHECK_EQ(res[2].value(), 0);
+            CHECK_EQ(index.range(std::string("b"), std::string("d")), std::make_pair(std::size_t(1), std::size_t(4)));
+        }
+
+        TEST_CASE("timestamps")
+        {
+            const auto day = [](int d)
+            {
+                return timestamp(date::sys_days(date::year(2024) / date::January / date::day(1)) + date::days(d));
+            };
+            const auto array = make_array<timestamp>({day(1), day(3), day(3), day(10)});
+            CHECK_EQ(search_sorted(array, day(3)), 1);
+            CHECK_EQ(search_sorted(array, day(3), search_side::right), 3);
+            CHECK_EQ(search_sorted(array, day(5)), 3);
+            const sorted_search_index<typed_array<timestamp>> index(array);
+            CHECK_EQ(index.search(day(11)), 4);
+        }
+    }
+}
@@ -0,0 +1,323 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/comparison.hpp"
+#include "sparrow/selection.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        typed_array<T>
+        make_array(const std::vector<T>& values, const std::vector<std::size_t>& nulls = {}, std::int64_t offset = 0)
+        {
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (const auto i : nulls)
+            {
+                bitmap.set(i, false);
+            }
+            using layout_type = typename arrow_traits<T>::default_layout;
+            return typed_array<T>(make_default_array_data<layout_type>(values, bitmap, offset));
+        }
+
+        std::vector<std::size_t> selected_rows(const selection_vector& selection)
+        {
+            std::vector<std::size_t> res;
+            selection.for_each(
+                [&res](std::size_t i)
+                {
+                    res.push_back(i);
+                }
+            );
+            return res;
+        }
+
+        using rows_type = std::vector<std::size_t>;
+    }
+
+    TEST_SUITE("selection")
+    {
+        TEST_CASE("selection_vector")
+        {
+            SUBCASE("default")
+            {
+                const selection_vector selection;
+                CHECK(selection.empty());
+                CHECK_EQ(selection.source_size(), 0);
+                CHECK_EQ(selection.selectivity(), 1.);
+            }
+
+            SUBCASE("all")
+            {
+                const selection_vector selection = selection_vector::all(100);
+                CHECK_EQ(selection.size(), 100);
+                CHECK_EQ(selection.representation(), selection_vector::kind::bitmap);
+                CHECK_EQ(selection.selectivity(), 1.);
+                CHECK(selection.contains(99));
+            }
+
+            SUBCASE("sparse indices")
+            {
+                const selection_vector selection = selection_vector::from_indices({3, 70, 900}, 1000);
+                CHECK_EQ(selection.representation(), selection_vector::kind::indices);
+                CHECK_EQ(selection.size(), 3);
+                CHECK(selection.contains(70));
+                CHECK_FALSE(selection.contains(71));
+                CHECK_EQ(selected_rows(selection), rows_type{3, 70, 900});
+            }
+
+            SUBCASE("dense indices")
+            {
+                const selection_vector selection = selection_vector::from_indices({1, 5, 64, 65}, 100);
+                CHECK_EQ(selection.representation(), selection_vector::kind::bitmap);
+                CHECK_EQ(selection.size(), 4);
+                CHECK_EQ(selected_rows(selection), rows_type{1, 5, 64, 65});
+            }
+
+            SUBCASE("sparse bitmap")
+            {
+                selection_vector::bitmap_type bitmap(1000, false);
+                bitmap.set(10, true);
+                bitmap.set(999, true);
+                const selection_vector selection = selection_vector::from_bitmap(std::move(bitmap));
+                CHECK_EQ(selection.representation(), selection_vector::kind::indices);
+                CHECK_EQ(selection.indices().size(), 2);
+                CHECK_EQ(selected_rows(selection), rows_type{10, 999});
+            }
+
+            SUBCASE("packed_boolean_array")
+            {
+                const auto values = make_array<std::int32_t>({1, 5, 2, 7, 9}, {3});
+                const selection_vector selection(greater(values, 4));
+                CHECK_EQ(selected_rows(selection), rows_type{1, 4});
+            }
+        }
+
+        TEST_CASE("refine")
+        {
+            const auto is_even = [](std::size_t i)
+            {
+                return i % 2 == 0;
+            };
+
+            SUBCASE("bitmap")
+            {
+                const selection_vector selection = selection_vector::all(200).refine(is_even);
+                CHECK_EQ(selection.representation(), selection_vector::kind::bitmap);
+                CHECK_EQ(selection.size(), 100);
+                CHECK(selection.contains(198));
+                CHECK_FALSE(selection.contains(199));
+            }
+
+            SUBCASE("switch to indices")
+            {
+                const selection_vector selection = selection_vector::all(200).refine(
+                    [](std::size_t i)
+                    {
+                        return i % 50 == 0;
+                    }
+                );
+                CHECK_EQ(selection.representation(), selection_vector::kind::indices);
+                CHECK_EQ(selected_rows(selection), rows_type{0, 50, 100, 150});
+            }
+
+            SUBCASE("indices")
+            {
+                const selection_vector selection = selection_vector::from_indices({1, 2, 500, 800}, 1000)
+                                                       .refine(is_even);
+                CHECK_EQ(selected_rows(selection), rows_type{2, 500, 800});
+            }
+
+            SUBCASE("only selected rows")
+            {
+                std::size_t call_count = 0;
+                const selection_vector selection = selection_vector::from_indices({1, 2, 500}, 1000)
+                                                       .refine(
+                                                           [&call_count](std::size_t)
+                                                           {
+                                                               ++call_count;
+                                                               return true;
+                                                           }
+                                                       );
+                CHECK_EQ(call_count, 3);
+                CHECK_EQ(selection.size(), 3);
+            }
+        }
+
+        TEST_CASE("filter")
+        {
+            std::vector<double> values(300);
+            std::iota(values.begin(), values.end(), 0.);
+            const auto array = make_array<double>(values, {10, 250});
+            const selection_view<typed_array<double>> view(array);
+            CHECK_EQ(view.size(), 300);
+
+            SUBCASE("predicate")
+            {
+                const auto res = filter(
+                    view,
+                    [](double v)
+                    {
+                        return v >= 5. && v < 15.;
+                    }
+                );
+                CHECK_EQ(&res.array(), &array);
+                CHECK_EQ(res.size(), 9);
+                CHECK_FALSE(res.selection().contains(10));
+                CHECK_EQ(res.selection().representation(), selection_vector::kind::indices);
+            }
+
+            SUBCASE("chained")
+            {
+                const auto first = filter(
+                    view,
+                    [](double v)
+                    {
+                        return v > 200.;
+                    }
+                );
+                const auto second = filter(first, less(array, 260.));
+                CHECK_EQ(second.size(), 58);
+                CHECK_FALSE(second.selection().contains(250));
+                CHECK(second.selection().contains(259));
+            }
+
+            SUBCASE("strings")
+            {
+                const auto strings = make_array<std::string>({"apple", "banana", "avocado", "cherry", "apricot"}, {4});
+                const auto res = filter(
+                    selection_view<typed_array<std::string>>(strings),
+                    [](std::string_view v)
+                    {
+                        return v.starts_with("a");
+                    }
+                );
+                CHECK_EQ(selected_rows(res.selection()), rows_type{0, 2});
+            }
+
+            SUBCASE("offset")
+            {
+                const auto shifted = make_array<std::int32_t>({100, 1, 2, 3, 4}, {2}, 1);
+                const auto res = filter(
+                    selection_view<typed_array<std::int32_t>>(shifted),
+                    [](std::int32_t v)
+                    {
+                        return v > 1;
+                    }
+                );
+                CHECK_EQ(selected_rows(res.selection()), rows_type{2, 3});
+            }
+        }
+
+        TEST_CASE("filter_is_in")
+        {
+            const auto array = make_array<std::int64_t>({4, 8, 15, 16, 23, 42, 8}, {1});
+            const auto value_set = make_array<std::int64_t>({8, 42, 99});
+            const auto view = filter(
+                selection_view<typed_array<std::int64_t>>(array),
+                [](std::int64_t v)
+                {
+                    return v > 4;
+                }
+            );
+            const auto res = filter_is_in(view, value_set);
+            CHECK_EQ(selected_rows(res.selection()), rows_type{5, 6});
+
+            const auto strings = make_array<std::string>({"x", "y", "z", "y"}, {3});
+            const auto string_set = make_array<std::string>({"y", "z"});
+            const auto string_res = filter_is_in(selection_view<typed_array<std::string>>(strings), string_set);
+            CHECK_EQ(selected_rows(string_res.selection()), rows_type{1, 2});
+        }
+
+        TEST_CASE("aggregations")
+        {
+            const auto array = make_array<std::int32_t>({5, -3, 8, 1, 12, 7}, {4});
+            const selection_view<typed_array<std::int32_t>> all(array);
+            const selection_view<typed_array<std::int32_t>> view(
+                array,
+                selection_vector::from_indices({1, 3, 4}, array.size())
+            );
+
+            CHECK_EQ(count(all), 5);
+            CHECK_EQ(sum(all), 18);
+            CHECK_EQ(min(all), std::optional<std::int32_t>(-3));
+            CHECK_EQ(max(all), std::optional<std::int32_t>(8));
+
+            CHECK_EQ(count(view), 2);
+            CHECK_EQ(sum(view), -2);
+            CHECK_EQ(min(view), std::optional<std::int32_t>(-3));
+            CHECK_EQ(max(view), std::optional<std::int32_t>(1));
+
+            const selection_view<typed_array<std::int32_t>> nulls(
+                array,
+                selection_vector::from_indices({4}, array.size())
+            );
+            CHECK_EQ(count(nulls), 0);
+            CHECK_EQ(sum(nulls), 0);
+            CHECK_FALSE(min(nulls).has_value());
+        }
+
+        TEST_CASE("take")
+        {
+            SUBCASE("fixed size")
+            {
+                const auto array = make_array<std::int32_t>({100, 0, 1, 2, 3, 4}, {3}, 1);
+                const selection_view<typed_array<std::int32_t>> view(
+                    array,
+                    selection_vector::from_indices({0, 2, 4}, array.size())
+                );
+                const typed_array<std::int32_t> res = take(view);
+                REQUIRE_EQ(res.size(), 3);
+                CHECK_EQ(res[0].value(), 0);
+                CHECK_FALSE(res[1].has_value());
+                CHECK_EQ(res[2].value(), 4);
+            }
+
+            SUBCASE("strings")
+            {
+                const auto array = make_array<std::string>({"a", "bb", "ccc", "dddd"}, {1});
+                const selection_view<typed_array<std::string>> view(
+                    array,
+                    selection_vector::from_indices({1, 2, 3}, array.size())
+                );
+                const typed_array<std::string> res = take(view);
+                REQUIRE_EQ(res.size(), 3);
+                CHECK_FALSE(res[0].has_value());
+                CHECK_EQ(res[1].value(), "ccc");
+                CHECK_EQ(res[2].value(), "dddd");
+            }
+
+            SUBCASE("empty")
+            {
+                const auto array = make_array<double>({1., 2.});
+                const selection_view<typed_array<double>> view(
+                    array,
+                    selection_vector::from_indices({}, array.size())
+                );
+                CHECK_EQ(take(view).size(), 0);
+            }
+        }
+    }
+}
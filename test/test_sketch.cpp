@@ -0,0 +1,275 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/sketch.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::N;
+
+        // Values [first, first + count), every tenth value being null
+        typed_array<std::int64_t> make_range(std::int64_t first, std::int64_t count)
+        {
+            std::vector<std::optional<std::int64_t>> values;
+            for (std::int64_t i = 0; i < count; ++i)
+            {
+                if (i % 10 == 9)
+                {
+                    values.emplace_back();
+                }
+                else
+                {
+                    values.emplace_back(first + i);
+                }
+            }
+            return make_array(values);
+        }
+
+        // Value i occurs 1000 / (i + 1) times, followed by 2000 distinct values
+        std::vector<std::optional<std::string>> make_skewed_words()
+        {
+            std::vector<std::optional<std::string>> words;
+            for (std::size_t i = 0; i < 10; ++i)
+            {
+                for (std::size_t j = 0; j < 1000 / (i + 1); ++j)
+                {
+                    words.emplace_back("frequent_" + std::to_string(i));
+                }
+            }
+            for (std::size_t i = 0; i < 2000; ++i)
+            {
+                words.emplace_back("rare_" + std::to_string(i));
+                words.emplace_back();
+            }
+            return words;
+        }
+    }
+
+    TEST_SUITE("sketch")
+    {
+        TEST_CASE("hyperloglog")
+        {
+            SUBCASE("empty")
+            {
+                CHECK_EQ(hyperloglog().estimate(), 0.);
+                CHECK_THROWS_AS(hyperloglog(3), std::invalid_argument);
+                CHECK_THROWS_AS(hyperloglog(19), std::invalid_argument);
+            }
+
+            SUBCASE("small cardinality")
+            {
+                hyperloglog sketch;
+                sketch.update(make_array<std::int32_t>({1, 2, N, 3, 2, 1, 3}));
+                CHECK_EQ(std::round(sketch.estimate()), 3.);
+            }
+
+            SUBCASE("accuracy")
+            {
+                hyperloglog sketch(12);
+                const auto array = make_range(0, 200000);
+                sketch.update(array);
+                sketch.update(array);
+                const double expected = 180000.;
+                CHECK_LT(std::abs(sketch.estimate() - expected) / expected, 0.05);
+            }
+
+            SUBCASE("merge")
+            {
+                hyperloglog lhs(10);
+                hyperloglog rhs(10);
+                hyperloglog all(10);
+                lhs.update(make_range(0, 30000));
+                rhs.update(make_range(20000, 30000));
+                all.update(make_range(0, 30000));
+                all.update(make_range(20000, 30000));
+                lhs.merge(rhs);
+                CHECK_EQ(lhs, all);
+                CHECK_THROWS_AS(lhs.merge(hyperloglog(11)), std::invalid_argument);
+            }
+
+            SUBCASE("strings")
+            {
+                hyperloglog sketch;
+                sketch.update(make_array<std::string>(make_skewed_words()));
+                const double expected = 2010.;
+                CHECK_LT(std::abs(sketch.estimate() - expected) / expected, 0.05);
+            }
+
+            SUBCASE("serialize")
+            {
+                hyperloglog sketch(8);
+                sketch.update(make_range(0, 1000));
+                const std::vector<std::uint8_t> bytes = sketch.serialize();
+                CHECK_EQ(hyperloglog::deserialize(bytes), sketch);
+                CHECK_THROWS_AS(
+                    hyperloglog::deserialize(std::span(bytes).first(bytes.size() - 1)),
+                    std::invalid_argument
+                );
+                CHECK_THROWS_AS(count_min_sketch::deserialize(bytes), std::invalid_argument);
+
+                // Registers hold at most 64 - precision + 1
+                std::vector<std::uint8_t> forged = bytes;
+                forged[3] = 57;
+                CHECK_EQ(hyperloglog::deserialize(forged).precision(), 8);
+                forged[3] = 58;
+                CHECK_THROWS_AS(hyperloglog::deserialize(forged), std::invalid_argument);
+            }
+        }
+
+        TEST_CASE("count_min_sketch")
+        {
+            const auto words = make_array<std::string>(make_skewed_words());
+            count_min_sketch sketch(1000, 4);
+            CHECK_EQ(sketch.width(), 1024);
+            sketch.update(words);
+            CHECK_EQ(sketch.total_count(), 2927 + 2000);
+            for (std::size_t i = 0; i < 10; ++i)
+            {
+                const std::uint64_t count = 1000 / (i + 1);
+                const std::uint64_t estimate = sketch.estimate<std::string>("frequent_" + std::to_string(i));
+                CHECK_GE(estimate, count);
+                CHECK_LE(estimate, count + 2 * sketch.total_count() / sketch.width());
+            }
+
+            SUBCASE("merge")
+            {
+                count_min_sketch other(1000, 4);
+                other.update(make_array<std::string>({"frequent_0", "other"}));
+                const std::uint64_t before = sketch.estimate<std::string>("frequent_0");
+                sketch.merge(other);
+                CHECK_GE(sketch.estimate<std::string>("frequent_0"), before + 1);
+                CHECK_GE(sketch.estimate<std::string>("other"), 1);
+                CHECK_THROWS_AS(sketch.merge(count_min_sketch(1000, 3)), std::invalid_argument);
+            }
+
+            SUBCASE("serialize")
+            {
+                std::vector<std::uint8_t> bytes = sketch.serialize();
+                CHECK_EQ(count_min_sketch::deserialize(bytes), sketch);
+
+                // Dimensions whose product wraps around to the counter count
+                const auto forge = [&bytes](std::uint64_t width, std::uint64_t depth)
+                {
+                    std::vector<std::uint8_t> forged = bytes;
+                    for (std::size_t i = 0; i < 8; ++i)
+                    {
+                        forged[2 + i] = static_cast<std::uint8_t>(width >> (8 * i));
+                        forged[10 + i] = static_cast<std::uint8_t>(depth >> (8 * i));
+                    }
+                    return forged;
+                };
+                const std::uint64_t counter_count = sketch.width() * sketch.depth();
+                CHECK_EQ(count_min_sketch::deserialize(forge(sketch.width(), sketch.depth())), sketch);
+                CHECK_THROWS_AS(
+                    count_min_sketch::deserialize(
+                        forge(counter_count, (std::uint64_t{0} - counter_count) / counter_count + 2)
+                    ),
+                    std::invalid_argument
+                );
+                CHECK_THROWS_AS(
+                    count_min_sketch::deserialize(forge(sketch.width(), sketch.depth() + 1)),
+                    std::invalid_argument
+                );
+                bytes.pop_back();
+                CHECK_THROWS_AS(count_min_sketch::deserialize(bytes), std::invalid_argument);
+            }
+        }
+
+        TEST_CASE("space_saving")
+        {
+            SUBCASE("top values")
+            {
+                space_saving<std::string> summary(50);
+                summary.update(make_array<std::string>(make_skewed_words()));
+                CHECK_EQ(summary.size(), 50);
+                const auto top = summary.top(5);
+                REQUIRE_EQ(top.size(), 5);
+                for (std::size_t i = 0; i < top.size(); ++i)
+                {
+                    const std::uint64_t count = 1000 / (i + 1);
+                    CHECK_EQ(top[i].value, "frequent_" + std::to_string(i));
+                    CHECK_GE(top[i].count, count);
+                    CHECK_LE(top[i].count - top[i].error, count);
+                }
+            }
+
+            SUBCASE("exact below capacity")
+            {
+                space_saving<std::int64_t> summary(10);
+                summary.update(make_array<std::int64_t>({4, 4, N, 7, 4, 7, 1}));
+                const auto top = summary.top(10);
+                REQUIRE_EQ(top.size(), 3);
+                CHECK_EQ(top[0], space_saving<std::int64_t>::entry{4, 3, 0});
+                CHECK_EQ(top[1], space_saving<std::int64_t>::entry{7, 2, 0});
+                CHECK_EQ(top[2], space_saving<std::int64_t>::entry{1, 1, 0});
+            }
+
+            SUBCASE("merge")
+            {
+                const auto words = make_skewed_words();
+                const std::size_t half = words.size() / 2;
+                space_saving<std::string> lhs(50);
+                space_saving<std::string> rhs(50);
+                lhs.update(make_array<std::string>({words.begin(), words.begin() + static_cast<std::ptrdiff_t>(half)}));
+                rhs.update(make_array<std::string>({words.begin() + static_cast<std::ptrdiff_t>(half), words.end()}));
+                lhs.merge(rhs);
+                CHECK_EQ(lhs.size(), 50);
+                const auto top = lhs.top(3);
+                REQUIRE_EQ(top.size(), 3);
+                for (std::size_t i = 0; i < top.size(); ++i)
+                {
+                    const std::uint64_t count = 1000 / (i + 1);
+                    CHECK_EQ(top[i].value, "frequent_" + std::to_string(i));
+                    CHECK_GE(top[i].count, count);
+                    CHECK_LE(top[i].count - top[i].error, count);
+                }
+            }
+
+            SUBCASE("serialize")
+            {
+                space_saving<double> summary(3);
+                summary.update(make_array<double>({1.5, 1.5, 1.5, 1.5, 2.5, -0., 0., 0., 8.}));
+                const auto res = space_saving<double>::deserialize(summary.serialize());
+                CHECK_EQ(res.capacity(), 3);
+                CHECK_EQ(res.top(3), summary.top(3));
+
+                const std::vector<std::uint8_t> bytes = summary.serialize();
+                std::vector<std::uint8_t> huge_capacity = bytes;
+                huge_capacity[7] = 1;
+                CHECK_THROWS_AS(space_saving<double>::deserialize(huge_capacity), std::invalid_argument);
+
+                // The entries follow the capacity and the size, as value, count and error
+                std::vector<std::uint8_t> duplicate = bytes;
+                std::copy(bytes.begin() + 18, bytes.begin() + 26, duplicate.begin() + 42);
+                CHECK_THROWS_AS(space_saving<double>::deserialize(duplicate), std::invalid_argument);
+            }
+        }
+    }
+}
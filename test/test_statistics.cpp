@@ -0,0 +1,274 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/comparison.hpp"
+#include "sparrow/hashing.hpp"
+#include "sparrow/statistics.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        typed_array<T> make_array(const std::vector<T>& values, const std::vector<std::size_t>& nulls = {})
+        {
+            array_data::bitmap_type bitmap(values.size(), true);
+            for (const auto i : nulls)
+            {
+                bitmap.set(i, false);
+            }
+            using layout_type = typename arrow_traits<T>::default_layout;
+            return typed_array<T>(make_default_array_data<layout_type>(values, bitmap, 0));
+        }
+
+        void check_same_result(const packed_boolean_array& lhs, const packed_boolean_array& rhs)
+        {
+            REQUIRE_EQ(lhs.size(), rhs.size());
+            for (std::size_t i = 0; i < lhs.size(); ++i)
+            {
+                CHECK_EQ(lhs[i], rhs[i]);
+            }
+        }
+    }
+
+    TEST_SUITE("statistics")
+    {
+        TEST_CASE("compute_statistics")
+        {
+            SUBCASE("sorted")
+            {
+                const auto array = make_array<std::int32_t>({1, 2, 2, 5, 8, 13}, {1});
+                const array_statistics<std::int32_t> res = compute_statistics(array);
+                CHECK_EQ(res.null_count, 1);
+                CHECK_EQ(res.min, std::optional<std::int32_t>(1));
+                CHECK_EQ(res.max, std::optional<std::int32_t>(13));
+                CHECK(res.is_sorted);
+                CHECK(res.is_unique);
+                CHECK_EQ(res.distinct_count, 5.);
+                REQUIRE_EQ(res.zones.size(), 1);
+                CHECK_EQ(res.zones[0].size, 6);
+            }
+
+            SUBCASE("duplicates")
+            {
+                const auto array = make_array<std::int64_t>({3, 3, 4});
+                const array_statistics<std::int64_t> res = compute_statistics(array);
+                CHECK(res.is_sorted);
+                CHECK_FALSE(res.is_unique);
+                CHECK_EQ(res.distinct_count, 2.);
+            }
+
+            SUBCASE("unsorted")
+            {
+                const auto array = make_array<std::int64_t>({7, -2, 9, 4});
+                const array_statistics<std::int64_t> res = compute_statistics(array);
+                CHECK_FALSE(res.is_sorted);
+                CHECK(res.is_unique);
+                CHECK_EQ(res.min, std::optional<std::int64_t>(-2));
+                CHECK_EQ(res.max, std::optional<std::int64_t>(9));
+                CHECK_EQ(res.distinct_count, 4.);
+
+                const auto duplicates = make_array<std::int64_t>({7, -2, 9, 7});
+                CHECK_FALSE(compute_statistics(duplicates).is_unique);
+            }
+
+            SUBCASE("NaN")
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                const auto array = make_array<double>({1., nan, 3.});
+                const array_statistics<double> res = compute_statistics(array);
+                CHECK_EQ(res.nan_count, 1);
+                CHECK_FALSE(res.is_sorted);
+                CHECK_EQ(res.min, std::optional<double>(1.));
+                CHECK_EQ(res.max, std::optional<double>(3.));
+            }
+
+            SUBCASE("strings")
+            {
+                const auto array = make_array<std::string>({"pear", "apple", "zucchini", "fig"}, {2});
+                const array_statistics<std::string> res = compute_statistics(array);
+                CHECK_EQ(res.min, std::optional<std::string>("apple"));
+                CHECK_EQ(res.max, std::optional<std::string>("pear"));
+                CHECK_FALSE(res.is_sorted);
+                CHECK(res.is_unique);
+            }
+
+            SUBCASE("zone map")
+            {
+                std::vector<std::int32_t> values(200);
+                std::iota(values.begin(), values.end(), 0);
+                std::vector<std::size_t> nulls(64);
+                std::iota(nulls.begin(), nulls.end(), std::size_t(64));
+                const auto array = make_array<std::int32_t>(values, nulls);
+                const array_statistics<std::int32_t> res = compute_statistics(array, 64);
+                REQUIRE_EQ(res.zones.size(), 4);
+                CHECK_EQ(res.zones[0].min, std::optional<std::int32_t>(0));
+                CHECK_EQ(res.zones[0].max, std::optional<std::int32_t>(63));
+                CHECK_EQ(res.zones[1].null_count, 64);
+                CHECK_FALSE(res.zones[1].min.has_value());
+                CHECK_EQ(res.zones[3].size, 8);
+                CHECK_EQ(res.zones[3].min, std::optional<std::int32_t>(192));
+                CHECK_EQ(res.null_count, 64);
+            }
+
+            SUBCASE("empty")
+            {
+                const array_statistics<double> res = compute_statistics(make_array<double>({}));
+                CHECK_FALSE(res.min.has_value());
+                CHECK(res.zones.empty());
+                CHECK_EQ(res.distinct_count, 0.);
+            }
+        }
+
+        TEST_CASE("cache")
+        {
+            auto array = make_array<std::int32_t>({4, 1, 3});
+            CHECK_EQ(array.cached_statistics(), nullptr);
+            const std::shared_ptr<const array_statistics<std::int32_t>> res = statistics(array);
+            REQUIRE_NE(res, nullptr);
+            CHECK_EQ(array.cached_statistics(), res);
+            CHECK_EQ(statistics(array), res);
+            CHECK_EQ(res->max, std::optional<std::int32_t>(4));
+
+            SUBCASE("copy")
+            {
+                const typed_array<std::int32_t> copy(array);
+                CHECK_EQ(copy.cached_statistics(), res);
+
+                typed_array<std::int32_t> moved(std::move(array));
+                CHECK_EQ(moved.cached_statistics(), res);
+            }
+
+            SUBCASE("reads")
+            {
+                std::int32_t sum = 0;
+                for (const auto& value : array)
+                {
+                    sum += value.value();
+                }
+                sum += array[1].value() + array.front().value() + array.at(2).value();
+                CHECK_EQ(sum, 16);
+                CHECK_EQ(array.cached_statistics(), res);
+            }
+
+            SUBCASE("modification")
+            {
+                array[0] = 10;
+                CHECK_EQ(array.cached_statistics(), nullptr);
+                CHECK_EQ(res->max, std::optional<std::int32_t>(4));
+                CHECK_EQ(statistics(array)->max, std::optional<std::int32_t>(10));
+
+                *array.begin() = std::nullopt;
+                CHECK_EQ(array.cached_statistics(), nullptr);
+                CHECK_EQ(statistics(array)->null_count, 1);
+            }
+
+            SUBCASE("swap")
+            {
+                auto other = make_array<std::int32_t>({2, 7, 5});
+                statistics(other);
+                auto lhs = array[0];
+                auto rhs = other[1];
+                swap(lhs, rhs);
+                CHECK_EQ(array.cached_statistics(), nullptr);
+                CHECK_EQ(other.cached_statistics(), nullptr);
+            }
+        }
+
+        TEST_CASE("zone pruning")
+        {
+            std::vector<std::int64_t> values(1000);
+            std::iota(values.begin(), values.end(), 0);
+            const auto plain = make_array<std::int64_t>(values, {10, 500, 999});
+            auto array = plain;
+            statistics(array, 128);
+
+            check_same_result(greater(array, std::int64_t(300)), greater(plain, std::int64_t(300)));
+            check_same_result(less_equal(array, std::int64_t(127)), less_equal(plain, std::int64_t(127)));
+            check_same_result(equal(array, std::int64_t(600)), equal(plain, std::int64_t(600)));
+            check_same_result(not_equal(array, std::int64_t(2000)), not_equal(plain, std::int64_t(2000)));
+            check_same_result(
+                between(array, std::int64_t(200), std::int64_t(700)),
+                between(plain, std::int64_t(200), std::int64_t(700))
+            );
+            check_same_result(
+                compare(array, std::int64_t(300), std::greater<>{}, parallel_options{.morsel_size = 256}),
+                greater(plain, std::int64_t(300))
+            );
+
+            SUBCASE("blocks are not read")
+            {
+                // Statistics that contradict the values show which blocks are skipped
+                array_statistics<std::int64_t> wrong = compute_statistics(plain, 128);
+                wrong.zones[0].max = -1;
+                const auto other = plain;
+                impl::statistics_cache::store(other, std::move(wrong));
+                const packed_boolean_array res = greater(other, std::int64_t(0));
+                CHECK_EQ(res[5], std::optional<bool>(false));
+                CHECK_EQ(res[200], std::optional<bool>(true));
+                CHECK_FALSE(res[10].has_value());
+            }
+        }
+
+        TEST_CASE("zone pruning with NaN")
+        {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            std::vector<double> values(256, 2.);
+            values[200] = nan;
+            const auto plain = make_array<double>(values, {3});
+            auto array = plain;
+            statistics(array, 128);
+
+            // The first block is constant, its bounds are equal
+            const packed_boolean_array equal_res = equal(array, nan);
+            const packed_boolean_array not_equal_res = not_equal(array, nan);
+            CHECK_EQ(equal_res[0], std::optional<bool>(false));
+            CHECK_EQ(not_equal_res[0], std::optional<bool>(true));
+            check_same_result(equal_res, equal(plain, nan));
+            check_same_result(not_equal_res, not_equal(plain, nan));
+            check_same_result(less(array, nan), less(plain, nan));
+            check_same_result(between(array, nan, 3.), between(plain, nan, 3.));
+        }
+
+        TEST_CASE("sorted unique")
+        {
+            const auto plain = make_array<std::int64_t>({1, 1, 2, 2, 2, 9, 100000000, 100000000}, {3});
+            auto array = plain;
+            statistics(array);
+            const typed_array<std::int64_t> expected = unique(plain);
+            const typed_array<std::int64_t> res = unique(array);
+            REQUIRE_EQ(res.size(), expected.size());
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                CHECK_EQ(res[i], expected[i]);
+            }
+
+            const auto counts = value_counts(array);
+            CHECK_EQ(counts.counts[1].value(), 2);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/table.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        template <class T>
+        array make_array(const std::vector<T>& values)
+        {
+            using layout_type = typename arrow_traits<T>::default_layout;
+            return array(
+                make_default_array_data<layout_type>(values, array_data::bitmap_type(values.size(), true), 0)
+            );
+        }
+
+        const schema table_schema(
+            {{.name = "id", .type = data_type::INT64}, {.name = "name", .type = data_type::STRING}}
+        );
+
+        // Batch holding the ids [first, first + size)
+        record_batch make_batch(std::int64_t first, std::size_t size)
+        {
+            std::vector<std::int64_t> ids;
+            std::vector<std::string> names;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                ids.push_back(first + static_cast<std::int64_t>(i));
+                names.push_back(std::to_string(ids.back()));
+            }
+            return record_batch(table_schema, {make_array(ids), make_array(names)});
+        }
+
+        std::int64_t id_at(const table& t, std::size_t row)
+        {
+            using const_ref = typed_array<std::int64_t>::const_reference;
+            return std::get<const_ref>(t.value(0, row)).value();
+        }
+    }
+
+    TEST_SUITE("table")
+    {
+        TEST_CASE("from batches")
+        {
+            const std::vector<record_batch> batches = {
+                make_batch(0, 4),
+                make_batch(2, 10).slice(2, 5),
+                make_batch(9, 3)
+            };
+            const table t(table_schema, batches);
+            CHECK_EQ(t.num_rows(), 12);
+            CHECK_EQ(t.num_columns(), 2);
+            CHECK_EQ(t.column("id").chunk_count(), 3);
+            CHECK_EQ(&t.column(0).chunk(0).get<std::int64_t>(), &batches[0].column(0).get<std::int64_t>());
+            for (std::size_t row = 0; row < t.num_rows(); ++row)
+            {
+                CHECK_EQ(id_at(t, row), static_cast<std::int64_t>(row));
+            }
+
+            const schema other({{.name = "id", .type = data_type::INT64}});
+            CHECK_THROWS_AS(table(other, batches), std::invalid_argument);
+        }
+
+        TEST_CASE("from columns")
+        {
+            chunked_column ids;
+            ids.push_back(make_array(std::vector<std::int64_t>{0, 1}));
+            ids.push_back(make_array(std::vector<std::int64_t>{2}));
+            chunked_column names({make_array(std::vector<std::string>{"0", "1", "2"})});
+            const table t(table_schema, {ids, names});
+            CHECK_EQ(t.num_rows(), 3);
+            CHECK_THROWS_AS(table(table_schema, {ids, ids}), std::invalid_argument);
+            CHECK_THROWS_AS(table(table_schema, {ids}), std::invalid_argument);
+            CHECK_THROWS_AS(
+                table(table_schema, {ids, chunked_column({make_array(std::vector<std::string>{"0"})})}),
+                std::invalid_argument
+            );
+        }
+
+        TEST_CASE("select and slice")
+        {
+            const std::vector<record_batch> batches = {make_batch(0, 4), make_batch(4, 4)};
+            const table t(table_schema, batches);
+
+            const std::vector<std::string_view> names = {"name"};
+            const table projected = t.select(std::span<const std::string_view>(names));
+            REQUIRE_EQ(projected.num_columns(), 1);
+            CHECK_EQ(projected.get_schema()[0].name, "name");
+            CHECK_EQ(
+                &projected.column(0).chunk(1).get<std::string>(),
+                &t.column(1).chunk(1).get<std::string>()
+            );
+
+            const table slice = t.slice(3, 4).slice(1, 2);
+            CHECK_EQ(slice.num_rows(), 2);
+            CHECK_EQ(slice.offset(), 4);
+            CHECK_EQ(id_at(slice, 0), 4);
+            CHECK_EQ(id_at(slice, 1), 5);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/typed_record_batch.hpp"
+
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using trades = typed_record_batch<
+            col<"price", double>,
+            col<"qty", std::int64_t>,
+            col<"sym", std::string>>;
+
+        template <class T>
+        array_data make_data(const std::vector<T>& values)
+        {
+            using layout_type = typename arrow_traits<T>::default_layout;
+            const array_data::bitmap_type bitmap(values.size(), true);
+            return make_default_array_data<layout_type>(values, bitmap, 0);
+        }
+
+        std::vector<array_data> make_columns()
+        {
+            std::vector<array_data> columns;
+            columns.push_back(make_data<double>({10.5, 11., 9.75, 10.25}));
+            columns.push_back(make_data<std::int64_t>({100, 20, 5, 40}));
+            columns.push_back(make_data<std::string>({"ABC", "XYZ", "ABC", "DEF"}));
+            return columns;
+        }
+
+        static_assert(trades::column_count == 3);
+        static_assert(trades::index_of<"qty"> == 1);
+        static_assert(std::same_as<trades::column_t<2>::value_type, std::string>);
+    }
+
+    TEST_SUITE("typed_record_batch")
+    {
+        TEST_CASE("constructors")
+        {
+            const trades batch(make_columns());
+            CHECK_EQ(batch.num_rows(), 4);
+            CHECK_EQ(batch.column<"price">()[2].value(), 9.75);
+            CHECK_EQ(batch.column<1>()[0].value(), 100);
+            CHECK_EQ(trades::get_schema()[2].name, "sym");
+            CHECK_EQ(trades::get_schema()[2].type, data_type::STRING);
+
+            std::vector<array_data> wrong_type = make_columns();
+            wrong_type[1] = make_data<std::int32_t>({1, 2, 3, 4});
+            CHECK_THROWS_AS(trades(std::move(wrong_type)), std::invalid_argument);
+
+            std::vector<array_data> too_few = make_columns();
+            too_few.pop_back();
+            CHECK_THROWS_AS(trades(std::move(too_few)), std::invalid_argument);
+        }
+
+        TEST_CASE("record_batch conversions")
+        {
+            const trades batch(make_columns());
+            const record_batch erased = batch.to_record_batch();
+            CHECK_EQ(erased.get_schema(), trades::get_schema());
+            CHECK_EQ(&erased.column(0).get<double>(), &batch.column<0>());
+
+            const trades back(erased.slice(1, 2));
+            CHECK_EQ(back.num_rows(), 2);
+            CHECK_EQ(back.offset(), 1);
+            CHECK_EQ(&back.column<"sym">(), &batch.column<"sym">());
+            CHECK_EQ(std::get<2>(back.row(0)).value(), "XYZ");
+
+            using renamed = typed_record_batch<
+                col<"cost", double>,
+                col<"qty", std::int64_t>,
+                col<"sym", std::string>>;
+            CHECK_THROWS_AS(renamed{erased}, std::invalid_argument);
+        }
+
+        TEST_CASE("rows")
+        {
+            const trades batch = trades(make_columns()).slice(1, 3);
+            double notional = 0.;
+            std::size_t count = 0;
+            batch.for_each_row(
+                [&](const auto& price, const auto& qty, const auto& sym)
+                {
+                    if (sym.value() == "ABC")
+                    {
+                        notional += price.value() * static_cast<double>(qty.value());
+                    }
+                    ++count;
+                }
+            );
+            CHECK_EQ(count, 3);
+            CHECK_EQ(notional, 9.75 * 5.);
+
+            const auto [price, qty, sym] = batch.row(2);
+            CHECK_EQ(price.value(), 10.25);
+            CHECK_EQ(qty.value(), 40);
+            CHECK_EQ(sym.value(), "DEF");
+        }
+
+        TEST_CASE("select")
+        {
+            const trades batch = trades(make_columns()).slice(2, 2);
+            const auto projected = batch.select<"sym", "price">();
+            static_assert(std::same_as<
+                          std::remove_const_t<decltype(projected)>,
+                          typed_record_batch<col<"sym", std::string>, col<"price", double>>>);
+            CHECK_EQ(projected.num_rows(), 2);
+            CHECK_EQ(&projected.column<1>(), &batch.column<0>());
+            CHECK_EQ(std::get<0>(projected.row(1)).value(), "DEF");
+        }
+    }
+}
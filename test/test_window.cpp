@@ -0,0 +1,238 @@
+// Copyright 2024 Man Group Operations Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "sparrow/array_data_factory.hpp"
+#include "sparrow/cast.hpp"
+#include "sparrow/window.hpp"
+
+#include "array_data_creation.hpp"
+#include "doctest/doctest.h"
+
+namespace sparrow
+{
+    namespace
+    {
+        using test::make_array;
+        using test::check_array;
+        using test::N;
+
+        typed_array<timestamp> make_times(const std::vector<std::int64_t>& seconds)
+        {
+            std::vector<std::optional<std::int64_t>> nanoseconds;
+            for (const std::int64_t s : seconds)
+            {
+                nanoseconds.emplace_back(s * 1000000000);
+            }
+            return cast<timestamp>(make_array<std::int64_t>(nanoseconds));
+        }
+    }
+
+    TEST_SUITE("window")
+    {
+        TEST_CASE("cumulative_sum")
+        {
+            const auto array = make_array<std::int32_t>({1, 2, N, 4, 5});
+            check_array(cumulative_sum(array), std::vector<std::optional<std::int64_t>>{1, 3, N, 7, 12});
+            check_array(
+                cumulative_sum(array, null_policy::propagate),
+                std::vector<std::optional<std::int64_t>>{1, 3, N, N, N}
+            );
+
+            SUBCASE("null slots are not accumulated")
+            {
+                // The values under the null slots would overflow the sum
+                constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+                std::vector<std::int64_t> raw = {1, max, 2, max};
+                array_data::bitmap_type bitmap(raw.size(), true);
+                bitmap.set(1, false);
+                bitmap.set(3, false);
+                const typed_array<std::int64_t> with_nulls(
+                    make_default_array_data<fixed_size_layout<std::int64_t>>(raw, bitmap, 0)
+                );
+                check_array(cumulative_sum(with_nulls), std::vector<std::optional<std::int64_t>>{1, N, 3, N});
+            }
+
+            SUBCASE("with offset")
+            {
+                const auto shifted = make_array<double>({10., 1., 2., 3.}, 1);
+                check_array(cumulative_sum(shifted), std::vector<std::optional<double>>{1., 3., 6.});
+            }
+        }
+
+        TEST_CASE("cumulative_prod_min_max")
+        {
+            const auto array = make_array<std::int16_t>({3, N, -2, 5, 1});
+            check_array(cumulative_prod(array), std::vector<std::optional<std::int64_t>>{3, N, -6, -30, -30});
+            check_array(cumulative_min(array), std::vector<std::optional<std::int16_t>>{3, N, -2, -2, -2});
+            check_array(cumulative_max(array), std::vector<std::optional<std::int16_t>>{3, N, 3, 5, 5});
+            check_array(
+                cumulative_max(array, null_policy::propagate),
+                std::vector<std::optional<std::int16_t>>{3, N, N, N, N}
+            );
+        }
+
+        TEST_CASE("cumulative_sum large")
+        {
+            constexpr std::size_t size = 200;
+            std::vector<std::optional<std::uint32_t>> values(size);
+            std::vector<std::optional<std::uint64_t>> expected(size);
+            std::uint64_t acc = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (i % 7 == 3)
+                {
+                    continue;
+                }
+                values[i] = static_cast<std::uint32_t>(i);
+                acc += i;
+                expected[i] = acc;
+            }
+            check_array(cumulative_sum(make_array<std::uint32_t>(values)), expected);
+
+            std::vector<std::optional<std::uint64_t>> propagated(expected.begin(), expected.begin() + 3);
+            propagated.resize(size);
+            check_array(cumulative_sum(make_array<std::uint32_t>(values), null_policy::propagate), propagated);
+        }
+
+        TEST_CASE("cumulative parallel")
+        {
+            constexpr std::size_t size = 5000;
+            std::vector<std::optional<std::int32_t>> values(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (i % 11 != 5)
+                {
+                    values[i] = static_cast<std::int32_t>((i * 7919) % 201) - 100;
+                }
+            }
+            const auto array = make_array<std::int32_t>(values);
+            std::vector<std::optional<std::int32_t>> late_values(size, 1);
+            late_values[3000] = std::nullopt;
+            const auto late_null = make_array<std::int32_t>(late_values);
+            thread_pool pool(4);
+            const parallel_options options{.morsel_size = 100, .pool = &pool};
+
+            for (const null_policy policy : {null_policy::skip, null_policy::propagate})
+            {
+                CHECK_EQ(cumulative_sum(array, policy, options), cumulative_sum(array, policy));
+                CHECK_EQ(cumulative_min(array, policy, options), cumulative_min(array, policy));
+                CHECK_EQ(cumulative_max(array, policy, options), cumulative_max(array, policy));
+            }
+            const auto small = make_array<std::int16_t>({3, N, -2, 5, 1});
+            CHECK_EQ(cumulative_prod(small, null_policy::skip, options), cumulative_prod(small));
+            const auto propagated = cumulative_sum(late_null, null_policy::propagate, options);
+            CHECK_EQ(propagated, cumulative_sum(late_null, null_policy::propagate));
+            CHECK_EQ(propagated[2999].value(), 3000);
+            CHECK_FALSE(propagated[3000].has_value());
+            CHECK_EQ(cumulative_sum(make_array<std::int32_t>({}), null_policy::skip, options).size(), 0);
+        }
+
+        TEST_CASE("rolling_sum_mean")
+        {
+            const auto array = make_array<std::int32_t>({1, 2, N, 4, 5, 6});
+            check_array(rolling_sum(array, 3), std::vector<std::optional<std::int64_t>>{1, 3, 3, 6, 9, 15});
+            check_array(
+                rolling_sum(array, 3, {.min_periods = 3}),
+                std::vector<std::optional<std::int64_t>>{N, N, N, N, N, 15}
+            );
+            check_array(rolling_mean(array, 2), std::vector<std::optional<double>>{1., 1.5, 2., 4., 4.5, 5.5});
+        }
+
+        TEST_CASE("rolling_sum non-finite")
+        {
+            const double inf = std::numeric_limits<double>::infinity();
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            const auto array = make_array<double>({1., inf, 2., 3., -inf, nan, 4., 5.});
+            const auto sums = rolling_sum(array, 2);
+            CHECK_EQ(sums[0].value(), 1.);
+            CHECK_EQ(sums[1].value(), inf);
+            CHECK_EQ(sums[2].value(), inf);
+            CHECK_EQ(sums[3].value(), 5.);
+            CHECK_EQ(sums[4].value(), -inf);
+            CHECK(std::isnan(sums[5].value()));
+            CHECK(std::isnan(sums[6].value()));
+            CHECK_EQ(sums[7].value(), 9.);
+
+            const auto means = rolling_mean(array, 2);
+            CHECK_EQ(means[2].value(), inf);
+            CHECK_EQ(means[3].value(), 2.5);
+            CHECK(std::isnan(means[6].value()));
+            CHECK_EQ(means[7].value(), 4.5);
+        }
+
+        TEST_CASE("rolling_min_max")
+        {
+            const auto array = make_array<double>({5., 3., N, 4., 8., 1., 2., 7.});
+            check_array(rolling_min(array, 3), std::vector<std::optional<double>>{5., 3., 3., 3., 4., 1., 1., 1.});
+            check_array(rolling_max(array, 3), std::vector<std::optional<double>>{5., 5., 5., 4., 8., 8., 8., 7.});
+            check_array(
+                rolling_max(make_array<double>({N, N, 1.}), 2),
+                std::vector<std::optional<double>>{N, N, 1.}
+            );
+        }
+
+        TEST_CASE("rolling_std")
+        {
+            const auto array = make_array<float>({2.f, 4.f, 4.f, 4.f, 5.f, 5.f, 7.f, 9.f});
+            const auto res = rolling_std(array, 8);
+            REQUIRE_EQ(res.size(), 8);
+            CHECK_FALSE(res[0].has_value());
+            CHECK_EQ(res[1].value(), doctest::Approx(std::sqrt(2.)));
+            CHECK_EQ(res[7].value(), doctest::Approx(std::sqrt(32. / 7.)));
+
+            const auto sliding = rolling_std(array, 2);
+            CHECK_EQ(sliding[3].value(), doctest::Approx(0.));
+            CHECK_EQ(sliding[7].value(), doctest::Approx(std::sqrt(2.)));
+        }
+
+        TEST_CASE("time windows")
+        {
+            const auto times = make_times({0, 1, 2, 10, 11, 30});
+            const auto array = make_array<std::int64_t>({1, 2, 3, 4, N, 6});
+            const std::chrono::seconds window(5);
+            check_array(rolling_sum(array, times, window), std::vector<std::optional<std::int64_t>>{1, 3, 6, 4, 4, 6});
+            check_array(
+                rolling_mean(array, times, window),
+                std::vector<std::optional<double>>{1., 1.5, 2., 4., 4., 6.}
+            );
+            check_array(
+                rolling_min(array, times, window),
+                std::vector<std::optional<std::int64_t>>{1, 1, 1, 4, 4, 6}
+            );
+            check_array(
+                rolling_max(array, times, window),
+                std::vector<std::optional<std::int64_t>>{1, 2, 3, 4, 4, 6}
+            );
+            const auto std_res = rolling_std(array, times, window);
+            CHECK_FALSE(std_res[0].has_value());
+            CHECK_EQ(std_res[2].value(), doctest::Approx(1.));
+            CHECK_FALSE(std_res[3].has_value());
+
+            // The window of an element holds at least the element
+            const auto same_times = make_times({0, 0, 3});
+            check_array(
+                rolling_sum(make_array<std::int64_t>({1, 2, 3}), same_times, std::chrono::nanoseconds(1)),
+                std::vector<std::optional<std::int64_t>>{1, 3, 3}
+            );
+        }
+    }
+}